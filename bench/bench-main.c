@@ -0,0 +1,414 @@
+/*
+  Benchmark driver for jsw-lib containers
+
+    > Created (agent): October 14, 2026
+
+  Links against the same adapters as test-main.c (see
+  test/test-containers.h), so every container the tests
+  cover can be measured the same way. A run loads n keys,
+  then performs a mix of lookups and writes, where a write
+  removes the key if it is there and inserts it otherwise.
+
+    bench-<lib> [-n size] [-m ops] [-d uniform|zipf|seq]
+                [-r read%] [-z theta] [-s seed] [-j]
+
+  Reports ns/op for the load and the mix, latency
+  percentiles of the mix, peak RSS and the allocator
+  calls (malloc, calloc, realloc, strdup) made per op.
+  With -j the report is one line of JSON instead.
+
+  Allocations are counted with the linker's --wrap option,
+  so only calls from the adapters and libraries count.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "test-containers.h"
+
+/* Room for any 64-bit key index, zero padded */
+#define KEY_LEN 21
+
+enum dist { UNIFORM, ZIPF, SEQUENTIAL };
+
+static const char *dist_names[] = { "uniform", "zipf", "seq" };
+
+typedef struct config {
+    size_t    n;      /* Keys loaded before the mix */
+    size_t    ops;    /* Operations in the mix */
+    enum dist dist;   /* Key distribution of the mix */
+    unsigned  read;   /* Percentage of the mix that only looks up */
+    double    theta;  /* Zipf skew */
+    uint64_t  seed;   /* Seeds the keys, the mix and the container */
+    int       json;   /* One line of JSON instead of a table */
+} config_t;
+
+/* Zipf generator state (Gray et al., "Quickly Generating Billion-Record
+   Synthetic Databases", SIGMOD 1994) */
+typedef struct zipf {
+    double n, theta, alpha, zetan, eta;
+} zipf_t;
+
+static size_t allocs;
+static size_t digits;
+static uint64_t rng;
+
+void *__real_malloc (size_t size);
+void *__real_calloc (size_t n, size_t size);
+void *__real_realloc (void *p, size_t size);
+char *__real_strdup (const char *s);
+
+void *__wrap_malloc (size_t size)
+{
+    ++allocs;
+    return __real_malloc (size);
+}
+
+void *__wrap_calloc (size_t n, size_t size)
+{
+    ++allocs;
+    return __real_calloc (n, size);
+}
+
+void *__wrap_realloc (void *p, size_t size)
+{
+    ++allocs;
+    return __real_realloc (p, size);
+}
+
+char *__wrap_strdup (const char *s)
+{
+    ++allocs;
+    return __real_strdup (s);
+}
+
+/* xorshift64* */
+static uint64_t next_rand (void)
+{
+    rng ^= rng >> 12;
+    rng ^= rng << 25;
+    rng ^= rng >> 27;
+
+    return rng * 2685821657736338717ULL;
+}
+
+/* Uniform double in [0, 1) */
+static double next_unit (void)
+{
+    return (next_rand() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double now_ns (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Zero padding keeps string order the same as numeric order */
+static void make_key (char *buf, size_t i)
+{
+    snprintf (buf, KEY_LEN, "%0*lu", (int) digits, (unsigned long) i);
+}
+
+static void zipf_init (zipf_t *z, size_t n, double theta)
+{
+    double zeta2 = 1.0 + pow (0.5, theta);
+    size_t i;
+
+    z->n = (double) n;
+    z->theta = theta;
+    z->alpha = 1.0 / (1.0 - theta);
+    z->zetan = 0;
+
+    for (i = 1; i <= n; i++) {
+        z->zetan += 1.0 / pow ((double) i, theta);
+    }
+
+    z->eta = (1.0 - pow (2.0 / z->n, 1.0 - theta)) / (1.0 - zeta2 / z->zetan);
+}
+
+/* Rank of the next key, 0 being the hottest */
+static size_t zipf_next (const zipf_t *z)
+{
+    double u = next_unit();
+    double uz = u * z->zetan;
+    size_t r;
+
+    if (uz < 1.0) {
+        return 0;
+    }
+
+    if (uz < 1.0 + pow (0.5, z->theta)) {
+        return 1;
+    }
+
+    r = (size_t) (z->n * pow (z->eta * u - z->eta + 1.0, z->alpha));
+
+    return r < (size_t) z->n ? r : (size_t) z->n - 1;
+}
+
+/* Index of the next key the mix touches */
+static size_t next_key (const config_t *cfg, const zipf_t *z, size_t i)
+{
+    switch (cfg->dist) {
+    case ZIPF:
+        /* Spread the hot ranks over the key space */
+        return (size_t) ((zipf_next (z) * 11400714819323198485ULL) % cfg->n);
+    case SEQUENTIAL:
+        return i % cfg->n;
+    default:
+        return (size_t) (next_rand() % cfg->n);
+    }
+}
+
+static int by_value (const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *) a;
+    uint32_t y = *(const uint32_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+static uint32_t percentile (const uint32_t *lat, size_t n, double p)
+{
+    size_t i = (size_t) (p * (double) (n - 1) + 0.5);
+
+    return n == 0 ? 0 : lat[i];
+}
+
+static void usage (const char *prog)
+{
+    fprintf (stderr, "usage: %s [-n size] [-m ops] [-d uniform|zipf|seq] "
+             "[-r read%%] [-z theta] [-s seed] [-j]\n", prog);
+    exit (1);
+}
+
+static void parse (config_t *cfg, int argc, char **argv)
+{
+    int i, d;
+
+    cfg->n = 100000;
+    cfg->ops = 1000000;
+    cfg->dist = UNIFORM;
+    cfg->read = 90;
+    cfg->theta = 0.99;
+    cfg->seed = (uint64_t) time (NULL);
+    cfg->json = 0;
+
+    for (i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+
+        if (strcmp (arg, "-j") == 0) {
+            cfg->json = 1;
+            continue;
+        }
+
+        if (arg[0] != '-' || arg[1] == '\0' || arg[2] != '\0'
+            || i + 1 >= argc) {
+            usage (argv[0]);
+        }
+
+        arg = argv[++i];
+
+        switch (argv[i - 1][1]) {
+        case 'n':
+            cfg->n = (size_t) strtod (arg, NULL);
+            break;
+        case 'm':
+            cfg->ops = (size_t) strtod (arg, NULL);
+            break;
+        case 'r':
+            cfg->read = (unsigned) strtoul (arg, NULL, 0);
+            break;
+        case 'z':
+            cfg->theta = strtod (arg, NULL);
+            break;
+        case 's':
+            cfg->seed = (uint64_t) strtoull (arg, NULL, 0);
+            break;
+        case 'd':
+            for (d = 0; d < 3; d++) {
+                if (strcmp (arg, dist_names[d]) == 0) {
+                    break;
+                }
+            }
+            if (d == 3) {
+                usage (argv[0]);
+            }
+            cfg->dist = (enum dist) d;
+            break;
+        default:
+            usage (argv[0]);
+        }
+    }
+
+    if (cfg->n == 0 || cfg->read > 100 || cfg->theta <= 0
+        || cfg->theta == 1.0) {
+        usage (argv[0]);
+    }
+}
+
+int main (int argc, char **argv)
+{
+    config_t cfg;
+    zipf_t z = { 0 };
+    const char *name;
+    char *keys;
+    size_t *order;
+    uint32_t *lat;
+    void *c;
+    double t0, t1, load_ns, mix_ns;
+    size_t load_allocs, mix_allocs, hits = 0;
+    size_t i;
+    struct rusage ru;
+
+    parse (&cfg, argc, argv);
+
+    name = test_name();
+    if (strncmp (name, "test-", 5) == 0) {
+        name += 5;
+    }
+
+    rng = cfg.seed * 0x9e3779b97f4a7c15ULL + 1;
+    set_seed ((unsigned) cfg.seed);
+
+    for (digits = 1, i = cfg.n - 1; i >= 10; i /= 10) {
+        digits++;
+    }
+
+    keys = malloc (cfg.n * KEY_LEN);
+    order = malloc (cfg.n * sizeof *order);
+    lat = malloc ((cfg.ops > 0 ? cfg.ops : 1) * sizeof *lat);
+    if (keys == NULL || order == NULL || lat == NULL) {
+        fprintf (stderr, "bench-%s: out of memory for %lu keys\n",
+                 name, (unsigned long) cfg.n);
+        return 1;
+    }
+
+    for (i = 0; i < cfg.n; i++) {
+        make_key (keys + i * KEY_LEN, i);
+        order[i] = i;
+    }
+
+    /* Sequential runs load in order, the others shuffled */
+    if (cfg.dist != SEQUENTIAL) {
+        for (i = cfg.n - 1; i > 0; i--) {
+            size_t j = (size_t) (next_rand() % (i + 1));
+            size_t save = order[i];
+
+            order[i] = order[j];
+            order[j] = save;
+        }
+    }
+
+    if (cfg.dist == ZIPF) {
+        zipf_init (&z, cfg.n, cfg.theta);
+    }
+
+    c = new_container();
+    if (c == NULL) {
+        fprintf (stderr, "bench-%s: failed to allocate container\n", name);
+        return 1;
+    }
+
+    allocs = 0;
+    t0 = now_ns();
+    for (i = 0; i < cfg.n; i++) {
+        if (! insert_item (c, keys + order[i] * KEY_LEN)) {
+            fprintf (stderr, "bench-%s: load failed at %lu\n",
+                     name, (unsigned long) i);
+            return 2;
+        }
+    }
+    load_ns = now_ns() - t0;
+    load_allocs = allocs;
+
+    allocs = 0;
+    t0 = now_ns();
+    for (i = 0; i < cfg.ops; i++) {
+        const char *key = keys + next_key (&cfg, &z, i) * KEY_LEN;
+
+        if (next_rand() % 100 < cfg.read) {
+            hits += lookup_item (c, key);
+        } else if (! remove_item (c, key)) {
+            insert_item (c, key);
+        }
+
+        t1 = now_ns();
+        lat[i] = (uint32_t) (t1 - t0 < 4e9 ? t1 - t0 : 4e9);
+        t0 = t1;
+    }
+    mix_allocs = allocs;
+
+    for (mix_ns = 0, i = 0; i < cfg.ops; i++) {
+        mix_ns += lat[i];
+    }
+
+    qsort (lat, cfg.ops, sizeof *lat, by_value);
+    getrusage (RUSAGE_SELF, &ru);
+
+    if (cfg.json) {
+        printf ("{\"container\":\"%s\",\"size\":%lu,\"ops\":%lu,"
+                "\"dist\":\"%s\",\"read_pct\":%u,\"theta\":%g,"
+                "\"seed\":%llu,"
+                "\"load\":{\"ns_per_op\":%.1f,\"allocs_per_op\":%.3f},"
+                "\"mix\":{\"ns_per_op\":%.1f,\"allocs_per_op\":%.3f,"
+                "\"hits\":%lu,\"p50\":%u,\"p90\":%u,\"p99\":%u,"
+                "\"p999\":%u,\"max\":%u},"
+                "\"peak_rss_kb\":%ld}\n",
+                name, (unsigned long) cfg.n, (unsigned long) cfg.ops,
+                dist_names[cfg.dist], cfg.read, cfg.theta,
+                (unsigned long long) cfg.seed,
+                load_ns / cfg.n, (double) load_allocs / cfg.n,
+                cfg.ops ? mix_ns / cfg.ops : 0.0,
+                cfg.ops ? (double) mix_allocs / cfg.ops : 0.0,
+                (unsigned long) hits,
+                percentile (lat, cfg.ops, 0.50),
+                percentile (lat, cfg.ops, 0.90),
+                percentile (lat, cfg.ops, 0.99),
+                percentile (lat, cfg.ops, 0.999),
+                percentile (lat, cfg.ops, 1.0), ru.ru_maxrss);
+    } else {
+        printf ("%-8s n=%lu ops=%lu %s read=%u%%\n", name,
+                (unsigned long) cfg.n, (unsigned long) cfg.ops,
+                dist_names[cfg.dist], cfg.read);
+        printf ("  load  %8.1f ns/op  %6.3f allocs/op\n",
+                load_ns / cfg.n, (double) load_allocs / cfg.n);
+        printf ("  mix   %8.1f ns/op  %6.3f allocs/op  "
+                "p50 %u  p90 %u  p99 %u  p99.9 %u  max %u ns\n",
+                cfg.ops ? mix_ns / cfg.ops : 0.0,
+                cfg.ops ? (double) mix_allocs / cfg.ops : 0.0,
+                percentile (lat, cfg.ops, 0.50),
+                percentile (lat, cfg.ops, 0.90),
+                percentile (lat, cfg.ops, 0.99),
+                percentile (lat, cfg.ops, 0.999),
+                percentile (lat, cfg.ops, 1.0));
+        printf ("  peak RSS %ld KB\n", ru.ru_maxrss);
+    }
+
+    delete_container (c);
+    free (lat);
+    free (order);
+    free (keys);
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#!/usr/bin/perl -w
+
+# Benchmarks for jsw-lib containers
+#
+#   > Created (agent): October 14, 2026
+#
+# Builds bench-<lib> for every container from bench-main.c
+# and the test adapters, then runs each one with the
+# arguments given here (see bench-main.c), e.g.
+#
+#   ./run-bench.pl -n 1e6 -m 1e7 -d zipf -r 95 -j > results.json
+#
+# Commands are echoed on stderr, so with -j stdout holds
+# nothing but one JSON line per container.
+#
+# This code is in the public domain. Anyone may
+# use it or change it in any way that they see
+# fit. The author assumes no responsibility for
+# damages incurred through use of the original
+# code or any variations thereof.
+#
+# It is requested, but not required, that due
+# credit is given to the original author and
+# anyone who has modified the code through
+# a header comment, such as this one.
+
+use strict;
+use FindBin;
+
+chdir ($FindBin::Bin) or die;
+
+my $cc = "gcc";
+
+my @libs = qw(atree avltree rbtree btree slib cslib hlib chlib flat);
+
+my $red = "\e[31m";
+my $off = "\e[0m";
+my $bold = "\e[1m";
+
+sub mysystem {
+    my @cmd = @_;
+    print STDERR $bold, join(" ", @cmd), $off, "\n";
+    if (system (@cmd) != 0) {
+        if ($? == -1) {
+            die "$red*** fatal: $!$off\n";
+        } elsif ($? & 127) {
+            die (sprintf ("$red*** fatal: signal %d$off\n", $? & 127));
+        } else {
+            die (sprintf ("$red*** fatal: exit code %d$off\n", $? >> 8));
+        }
+    }
+}
+
+foreach my $lib (@libs) {
+    my $libdir = "../jsw_$lib";
+    my $benchname = "bench-$lib";
+    my @cmd = ($cc, "-Wall", "-O2", "-g", "-DNDEBUG", "-o", $benchname,
+               "-I$libdir", "-I../jsw_alloc", "-I../test");
+    if ($lib eq "slib" || $lib eq "cslib") {
+        push @cmd, "-I../jsw_rand";
+        push @cmd, "../jsw_rand/jsw_rand.c";
+    }
+    if ($lib eq "chlib") {
+        push @cmd, "-pthread", "-I../jsw_hlib";
+    }
+    push @cmd, "$libdir/jsw_$lib.c";
+    push @cmd, "../jsw_alloc/jsw_alloc.c";
+    push @cmd, "../test/test-$lib.c";
+    push @cmd, "bench-main.c";
+    push @cmd, "-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=strdup";
+    push @cmd, "-lm";
+
+    mysystem (@cmd);
+}
+
+mysystem ($cc, "-Wall", "-O2", "-o", "bench-hpow2", "-I../jsw_hlib",
+          "-I../jsw_alloc", "../jsw_hlib/jsw_hlib.c",
+          "../jsw_alloc/jsw_alloc.c", "bench-hpow2.c");
+
+foreach my $lib (@libs) {
+    mysystem ("./bench-$lib", @ARGV);
+}
+
+# Its report isn't JSON, so leave it out of machine readable runs
+mysystem ("./bench-hpow2") unless grep { $_ eq "-j" } @ARGV;
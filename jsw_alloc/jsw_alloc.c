@@ -0,0 +1,236 @@
+/*
+  Node allocator hooks and pool allocator
+
+    > Created (agent): October 14, 2026
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+#include "jsw_alloc.h"
+
+#ifdef __cplusplus
+#include <cstdlib>
+
+using std::malloc;
+using std::free;
+#else
+#include <stdlib.h>
+#endif
+
+#ifndef POOL_SLAB
+#define POOL_SLAB 65536 /* Default bytes per slab */
+#endif
+
+#define ALIGN     16                      /* Block size granularity */
+#define NCLASS    32                      /* Size classes up to ALIGN * NCLASS */
+#define CLASS(n)  ( ( (n) + ALIGN - 1 ) / ALIGN )
+
+/* Header for slabs and oversized blocks, padded to ALIGN */
+typedef union jsw_chunk {
+  struct {
+    union jsw_chunk *prev, *next;
+  } link;
+  char pad[ALIGN * ( ( 2 * sizeof ( void * ) + ALIGN - 1 ) / ALIGN )];
+} jsw_chunk_t;
+
+struct jsw_pool {
+  void        *free[NCLASS + 1]; /* Free list for each size class */
+  jsw_chunk_t *slabs;            /* Every slab, current one first in reuse */
+  jsw_chunk_t *curr;             /* Slab being carved */
+  size_t       used;             /* Bytes carved from curr */
+  size_t       slab;             /* Usable bytes per slab */
+  jsw_chunk_t *big;              /* Blocks bigger than any size class */
+};
+
+jsw_pool_t *jsw_poolnew ( size_t slab )
+{
+  jsw_pool_t *pool = (jsw_pool_t *)malloc ( sizeof *pool );
+  size_t i;
+
+  if ( pool == NULL )
+    return NULL;
+
+  if ( slab == 0 )
+    slab = POOL_SLAB;
+
+  /* A slab must hold at least one block of the biggest class */
+  slab = ALIGN * CLASS ( slab );
+
+  if ( slab < ALIGN * NCLASS )
+    slab = ALIGN * NCLASS;
+
+  for ( i = 0; i <= NCLASS; i++ )
+    pool->free[i] = NULL;
+
+  pool->slabs = pool->curr = NULL;
+  pool->used = pool->slab = slab;
+  pool->big = NULL;
+
+  return pool;
+}
+
+static void release_big ( jsw_pool_t *pool )
+{
+  jsw_chunk_t *it, *save;
+
+  for ( it = pool->big; it != NULL; it = save ) {
+    save = it->link.next;
+    free ( it );
+  }
+
+  pool->big = NULL;
+}
+
+void jsw_pooldelete ( jsw_pool_t *pool )
+{
+  jsw_chunk_t *it, *save;
+
+  for ( it = pool->slabs; it != NULL; it = save ) {
+    save = it->link.next;
+    free ( it );
+  }
+
+  release_big ( pool );
+  free ( pool );
+}
+
+void *jsw_poolalloc ( jsw_pool_t *pool, size_t size )
+{
+  size_t c = CLASS ( size );
+  void *p;
+
+  if ( c == 0 )
+    c = 1;
+
+  if ( c > NCLASS ) {
+    jsw_chunk_t *chunk;
+
+    if ( size > (size_t)-1 - sizeof *chunk )
+      return NULL;
+
+    chunk = (jsw_chunk_t *)malloc ( sizeof *chunk + size );
+
+    if ( chunk == NULL )
+      return NULL;
+
+    chunk->link.prev = NULL;
+    chunk->link.next = pool->big;
+
+    if ( pool->big != NULL )
+      pool->big->link.prev = chunk;
+
+    pool->big = chunk;
+
+    return chunk + 1;
+  }
+
+  if ( pool->free[c] != NULL ) {
+    p = pool->free[c];
+    pool->free[c] = *(void **)p;
+
+    return p;
+  }
+
+  if ( pool->slab - pool->used < c * ALIGN ) {
+    /* Reuse a slab kept by jsw_poolpurge before making a new one */
+    jsw_chunk_t *next = pool->curr != NULL
+      ? pool->curr->link.next : pool->slabs;
+
+    if ( next == NULL ) {
+      next = (jsw_chunk_t *)malloc ( sizeof *next + pool->slab );
+
+      if ( next == NULL )
+        return NULL;
+
+      next->link.next = NULL;
+      next->link.prev = pool->curr;
+
+      if ( pool->curr != NULL )
+        pool->curr->link.next = next;
+      else
+        pool->slabs = next;
+    }
+
+    pool->curr = next;
+    pool->used = 0;
+  }
+
+  p = (char *)( pool->curr + 1 ) + pool->used;
+  pool->used += c * ALIGN;
+
+  return p;
+}
+
+void jsw_poolrelease ( jsw_pool_t *pool, void *p, size_t size )
+{
+  size_t c = CLASS ( size );
+
+  if ( p == NULL )
+    return;
+
+  if ( c == 0 )
+    c = 1;
+
+  if ( c > NCLASS ) {
+    jsw_chunk_t *chunk = (jsw_chunk_t *)p - 1;
+
+    if ( chunk->link.prev != NULL )
+      chunk->link.prev->link.next = chunk->link.next;
+    else
+      pool->big = chunk->link.next;
+
+    if ( chunk->link.next != NULL )
+      chunk->link.next->link.prev = chunk->link.prev;
+
+    free ( chunk );
+  }
+  else {
+    *(void **)p = pool->free[c];
+    pool->free[c] = p;
+  }
+}
+
+void jsw_poolpurge ( jsw_pool_t *pool )
+{
+  size_t i;
+
+  for ( i = 0; i <= NCLASS; i++ )
+    pool->free[i] = NULL;
+
+  /* Carving restarts at the first slab */
+  pool->curr = NULL;
+  pool->used = pool->slab;
+
+  release_big ( pool );
+}
+
+static void *pool_alloc ( void *ctx, size_t size )
+{
+  return jsw_poolalloc ( (jsw_pool_t *)ctx, size );
+}
+
+static void pool_release ( void *ctx, void *p, size_t size )
+{
+  jsw_poolrelease ( (jsw_pool_t *)ctx, p, size );
+}
+
+static void pool_purge ( void *ctx )
+{
+  jsw_poolpurge ( (jsw_pool_t *)ctx );
+}
+
+void jsw_poolhooks ( jsw_pool_t *pool, jsw_alloc_t *alloc )
+{
+  alloc->alloc = pool_alloc;
+  alloc->release = pool_release;
+  alloc->purge = pool_purge;
+  alloc->ctx = pool;
+}
@@ -0,0 +1,84 @@
+#ifndef JSW_ALLOC_H
+#define JSW_ALLOC_H
+
+/*
+  Node allocator hooks and pool allocator
+
+    > Created (agent): October 14, 2026
+
+  Every container library can be created with a jsw_alloc_t,
+  which it copies and then uses for all of its nodes. Leaving
+  purge NULL means nodes are released one at a time. With a
+  purge hook, deleting a container calls it once instead of
+  releasing every node, so the allocator must not be shared
+  with anything else that is still alive. Clearing a container
+  calls it the same way and keeps allocating from it after.
+
+  The pool allocator carves blocks out of large slabs, with a
+  free list for each block size. It is not thread safe.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+#ifdef __cplusplus
+#include <cstddef>
+
+using std::size_t;
+
+extern "C" {
+#else
+#include <stddef.h>
+#endif
+
+typedef struct jsw_alloc {
+  void *(*alloc) ( void *ctx, size_t size );            /* NULL on failure */
+  void  (*release) ( void *ctx, void *p, size_t size ); /* Size as allocated */
+  void  (*purge) ( void *ctx );                         /* Optional, or NULL */
+  void   *ctx;                                          /* User context */
+} jsw_alloc_t;
+
+typedef struct jsw_pool jsw_pool_t;
+
+/*
+  Create a new pool that grabs memory slab bytes at a
+  time (0 picks a default)
+
+  Returns: An empty pool, or NULL on failure
+*/
+jsw_pool_t *jsw_poolnew ( size_t slab );
+
+/* Release the pool and every block allocated from it */
+void        jsw_pooldelete ( jsw_pool_t *pool );
+
+/*
+  Allocate a block of at least size bytes
+
+  Returns: The block, or NULL on failure
+*/
+void       *jsw_poolalloc ( jsw_pool_t *pool, size_t size );
+
+/* Return a block to the pool, size must match the request */
+void        jsw_poolrelease ( jsw_pool_t *pool, void *p, size_t size );
+
+/*
+  Release every block at once, keeping the slabs for reuse.
+  This is O(1) except for blocks too big for a slab
+*/
+void        jsw_poolpurge ( jsw_pool_t *pool );
+
+/* Fill in hooks that allocate from the pool */
+void        jsw_poolhooks ( jsw_pool_t *pool, jsw_alloc_t *alloc );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef JSW_COMMON_H
+#define JSW_COMMON_H
+
+/*
+  Types shared by several container libraries
+
+    > Created (agent): October 14, 2026
+
+  Containers built with JSW_STATS report their counters in
+  the same jsw_stats_t, and the trees' set operations and the
+  hash table's bulk calls take the same jsw_fork_t.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+/*
+  Counters kept by a container built with JSW_STATS. They are
+  plain increments, bumped by lookups too, so a container read
+  from several threads needs a lock around every call
+*/
+typedef struct jsw_stats {
+  unsigned long cmps;      /* Comparator calls */
+  unsigned long rotations; /* Tree rotations, a double counts as two */
+  unsigned long probes;    /* Hash chain links or skip list steps searched */
+  unsigned long maxprobe;  /* Longest hash chain walk by one search */
+  unsigned long resizes;   /* Hash table resizes */
+  unsigned long allocs;    /* Nodes (and chain heads) allocated */
+  unsigned long releases;  /* Nodes released one at a time, not purged */
+} jsw_stats_t;
+
+/* A piece of work for a jsw_fork_t */
+typedef void (*jsw_task_f) ( void *arg );
+
+/*
+  Fork-join hook for parallel container work. fork has to run
+  task ( a ) and task ( b ), at the same time if it likes,
+  and return once both are done. Only the top depth levels
+  of the recursion fork, so up to 2^depth tasks exist, and
+  the rest runs in whichever thread got there
+*/
+typedef struct jsw_fork {
+  void  (*fork) ( void *ctx, jsw_task_f task, void *a, void *b );
+  void   *ctx;   /* User context */
+  int     depth; /* Levels that fork, 0 for none */
+} jsw_fork_t;
+
+#endif
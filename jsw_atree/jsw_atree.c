@@ -12,6 +12,10 @@
            Condition should test for nil
       4) Bug in jsw_aerase:
            Search for successor should save the path
+    > Modified (agent): October 14, 2026
+      Added allocator hooks, intrusive nodes, building
+      from sorted input, bounds and range visits,
+      JSW_STATS counters and clear
 */
 #include "jsw_atree.h"
 
@@ -29,11 +33,20 @@ using std::size_t;
 #define HEIGHT_LIMIT 64 /* Tallest allowable tree */
 #endif
 
-typedef struct jsw_anode {
-  int               level;   /* Horizontal level for balance */
-  void             *data;    /* User-defined content */
-  struct jsw_anode *link[2]; /* Left (0) and right (1) links */
-} jsw_anode_t;
+/*
+  Hot path counters, kept only with JSW_STATS. Without it
+  these do nothing and the tree has no stats field
+*/
+#ifdef JSW_STATS
+#define STAT_ADD(t,f,n) ( (void)( (t)->stats.f += (unsigned long)(n) ) )
+#else
+#define STAT_ADD(t,f,n) ( (void)0 )
+#endif
+#define STAT(t,f) STAT_ADD ( t, f, 1 )
+#define CMP(t,a,b) ( STAT ( t, cmps ), (t)->cmp ( (a), (b) ) )
+
+/* All zero, for new trees and for builds without JSW_STATS */
+static const jsw_stats_t no_stats = { 0 };
 
 struct jsw_atree {
   jsw_anode_t *root; /* Top of the tree */
@@ -42,6 +55,12 @@ struct jsw_atree {
   dup_f        dup;  /* Clone an item (user-defined) */
   rel_f        rel;  /* Destroy an item (user-defined) */
   size_t       size; /* Number of items (user-defined) */
+  jsw_alloc_t  mem;  /* Node allocator */
+  int          intrusive; /* Nodes are embedded in the items */
+  size_t       offset;    /* Offset of the node in each item */
+#ifdef JSW_STATS
+  jsw_stats_t  stats;     /* Hot path counters */
+#endif
 };
 
 struct jsw_atrav {
@@ -52,41 +71,87 @@ struct jsw_atrav {
 };
 
 /* Remove left horizontal links */
-#define skew(t) do {                                      \
+#define skew(tree,t) do {                                 \
   if ( t->link[0]->level == t->level && t->level != 0 ) { \
     jsw_anode_t *save = t->link[0];                       \
     t->link[0] = save->link[1];                           \
     save->link[1] = t;                                    \
     t = save;                                             \
+    STAT ( tree, rotations );                             \
   }                                                       \
 } while(0)
 
 /* Remove consecutive horizontal links */
-#define split(t) do {                                              \
+#define split(tree,t) do {                                         \
   if ( t->link[1]->link[1]->level == t->level && t->level != 0 ) { \
     jsw_anode_t *save = t->link[1];                                \
     t->link[1] = save->link[0];                                    \
     save->link[0] = t;                                             \
     t = save;                                                      \
     ++t->level;                                                    \
+    STAT ( tree, rotations );                                      \
   }                                                                \
 } while(0)
 
+/* Default node allocator hooks */
+static void *std_alloc ( void *ctx, size_t size )
+{
+  (void)ctx;
+  return malloc ( size );
+}
+
+static void std_release ( void *ctx, void *p, size_t size )
+{
+  (void)ctx;
+  (void)size;
+  free ( p );
+}
+
+/* Intrusive trees never own memory */
+static void no_release ( void *ctx, void *p, size_t size )
+{
+  (void)ctx;
+  (void)p;
+  (void)size;
+}
+
+static void no_rel ( void *p )
+{
+  (void)p;
+}
+
+/* Intrusive trees use the node embedded in the data */
 static jsw_anode_t *new_node ( jsw_atree_t *tree, void *data )
 {
-  jsw_anode_t *rn = (jsw_anode_t *)malloc ( sizeof *rn );
+  jsw_anode_t *rn;
 
-  if ( rn == NULL )
-    return tree->nil;
+  if ( tree->intrusive ) {
+    rn = (jsw_anode_t *)( (char *)data + tree->offset );
+    rn->data = data;
+  }
+  else {
+    rn = (jsw_anode_t *)tree->mem.alloc ( tree->mem.ctx, sizeof *rn );
+
+    if ( rn == NULL )
+      return tree->nil;
+
+    STAT ( tree, allocs );
+    rn->data = tree->dup ( data );
+  }
 
   rn->level = 1;
-  rn->data = tree->dup ( data );
   rn->link[0] = rn->link[1] = tree->nil;
 
   return rn;
 }
 
 jsw_atree_t *jsw_anew ( cmp_f cmp, dup_f dup, rel_f rel )
+{
+  return jsw_anew_alloc ( cmp, dup, rel, NULL );
+}
+
+jsw_atree_t *jsw_anew_alloc ( cmp_f cmp, dup_f dup, rel_f rel,
+                              const jsw_alloc_t *alloc )
 {
   jsw_atree_t *rt = (jsw_atree_t *)malloc ( sizeof *rt );
 
@@ -108,16 +173,58 @@ jsw_atree_t *jsw_anew ( cmp_f cmp, dup_f dup, rel_f rel )
   rt->root = rt->nil;
   rt->cmp = cmp;
   rt->dup = dup;
-  rt->rel = rel;
+  rt->rel = rel != NULL ? rel : no_rel;
   rt->size = 0;
+  rt->intrusive = 0;
+  rt->offset = 0;
+#ifdef JSW_STATS
+  rt->stats = no_stats;
+#endif
+
+  /* The sentinel stays with malloc so purging never touches it */
+  if ( alloc != NULL )
+    rt->mem = *alloc;
+  else {
+    rt->mem.alloc = std_alloc;
+    rt->mem.release = std_release;
+    rt->mem.purge = NULL;
+    rt->mem.ctx = NULL;
+  }
 
   return rt;
 }
 
-void jsw_adelete ( jsw_atree_t *tree )
+/*
+  Items embed a jsw_anode_t at offset, which is linked
+  directly. rel (if not NULL) sees items leaving the tree
+*/
+jsw_atree_t *jsw_anew_intrusive ( cmp_f cmp, rel_f rel, size_t offset )
+{
+  jsw_atree_t *rt = jsw_anew ( cmp, NULL, rel );
+
+  if ( rt == NULL )
+    return NULL;
+
+  rt->intrusive = 1;
+  rt->offset = offset;
+  rt->mem.release = no_release;
+
+  return rt;
+}
+
+/*
+  Release every node, leaving the root dangling. Nodes are
+  only visited when an item needs releasing or a node has
+  no purge hook to go back with
+*/
+static void release_nodes ( jsw_atree_t *tree )
 {
   jsw_anode_t *it = tree->root;
   jsw_anode_t *save;
+  int each = tree->mem.purge == NULL && !tree->intrusive;
+
+  if ( tree->rel == no_rel && !each )
+    it = tree->nil;
 
   /* Destruction by rotation */
   while ( it != tree->nil ) {
@@ -125,7 +232,10 @@ void jsw_adelete ( jsw_atree_t *tree )
       /* Remove node */
       save = it->link[1];
       tree->rel ( it->data );
-      free ( it );
+
+      /* A purge hook releases every node at the end */
+      if ( each )
+        tree->mem.release ( tree->mem.ctx, it, sizeof *it );
     }
     else {
       /* Rotate right */
@@ -137,17 +247,34 @@ void jsw_adelete ( jsw_atree_t *tree )
     it = save;
   }
 
-  /* Finalize destruction */
+  if ( tree->mem.purge != NULL )
+    tree->mem.purge ( tree->mem.ctx );
+}
+
+void jsw_adelete ( jsw_atree_t *tree )
+{
+  release_nodes ( tree );
   free ( tree->nil );
   free ( tree );
 }
 
+/*
+  Empty the tree for reuse. O(1) with a purge hook and
+  externally owned items (rel was NULL)
+*/
+void jsw_aclear ( jsw_atree_t *tree )
+{
+  release_nodes ( tree );
+  tree->root = tree->nil;
+  tree->size = 0;
+}
+
 void *jsw_afind ( jsw_atree_t *tree, void *data )
 {
   jsw_anode_t *it = tree->root;
 
   while ( it != tree->nil ) {
-    int cmp = tree->cmp ( it->data, data );
+    int cmp = CMP ( tree, it->data, data );
 
     if ( cmp == 0 )
       break;
@@ -175,7 +302,7 @@ int jsw_ainsert ( jsw_atree_t *tree, void *data )
     /* Find a spot and save the path */
     for ( ; ; ) {
       path[top++] = it;
-      dir = tree->cmp ( it->data, data ) < 0;
+      dir = CMP ( tree, it->data, data ) < 0;
 
       if ( it->link[dir] == tree->nil )
         break;
@@ -194,8 +321,8 @@ int jsw_ainsert ( jsw_atree_t *tree, void *data )
       if ( top != 0 )
         dir = path[top - 1]->link[1] == path[top];
 
-      skew ( path[top] );
-      split ( path[top] );
+      skew ( tree, path[top] );
+      split ( tree, path[top] );
 
       /* Fix the parent */
       if ( top != 0 )
@@ -226,7 +353,7 @@ int jsw_aerase ( jsw_atree_t *tree, void *data )
       if ( it == tree->nil )
         return 0;
 
-      cmp = tree->cmp ( it->data, data );
+      cmp = CMP ( tree, it->data, data );
       if ( cmp == 0 )
         break;
 
@@ -248,12 +375,14 @@ int jsw_aerase ( jsw_atree_t *tree, void *data )
         tree->root = it->link[1];
 
       tree->rel ( it->data );
-      free ( it );
+      tree->mem.release ( tree->mem.ctx, it, sizeof *it );
+      STAT_ADD ( tree, releases, !tree->intrusive );
     }
     else {
       /* Two child case */
       jsw_anode_t *heir = it->link[1];
       jsw_anode_t *prev = it;
+      int at = top - 1;
 
       while ( heir->link[0] != tree->nil ) {
         path[top++] = prev = heir;
@@ -261,13 +390,24 @@ int jsw_aerase ( jsw_atree_t *tree, void *data )
       }
 
       /*
-        Order is important!
-        (free item, replace item, free heir)
+        Order is important! (unlink heir, move heir into
+        the item's place, free item). Relinking instead of
+        copying data keeps intrusive nodes with their items
       */
-      tree->rel ( it->data );
-      it->data = heir->data;
       prev->link[prev == it] = heir->link[1];
-      free ( heir );
+      heir->link[0] = it->link[0];
+      heir->link[1] = it->link[1];
+      heir->level = it->level;
+      path[at] = heir;
+
+      if ( at != 0 )
+        path[at - 1]->link[dir] = heir;
+      else
+        tree->root = heir;
+
+      tree->rel ( it->data );
+      tree->mem.release ( tree->mem.ctx, it, sizeof *it );
+      STAT_ADD ( tree, releases, !tree->intrusive );
     }
 
     /* Walk back up and rebalance */
@@ -285,11 +425,11 @@ int jsw_aerase ( jsw_atree_t *tree, void *data )
           up->link[1]->level = up->level;
 
         /* Order is important! */
-        skew ( up );
-        skew ( up->link[1] );
-        skew ( up->link[1]->link[1] );
-        split ( up );
-        split ( up->link[1] );
+        skew ( tree, up );
+        skew ( tree, up->link[1] );
+        skew ( tree, up->link[1]->link[1] );
+        split ( tree, up );
+        split ( tree, up->link[1] );
       }
 
       /* Fix the parent */
@@ -310,6 +450,99 @@ size_t jsw_asize ( jsw_atree_t *tree )
   return tree->size;
 }
 
+/* Copy out the hot path counters, non-zero if built with JSW_STATS */
+int jsw_astats ( jsw_atree_t *tree, jsw_stats_t *stats )
+{
+#ifdef JSW_STATS
+  *stats = tree->stats;
+  return 1;
+#else
+  (void)tree;
+  *stats = no_stats;
+  return 0;
+#endif
+}
+
+/* Release a subtree built by build_tree (balanced, so recursion is safe) */
+static void release_tree ( jsw_atree_t *tree, jsw_anode_t *root )
+{
+  if ( root != tree->nil ) {
+    release_tree ( tree, root->link[0] );
+    release_tree ( tree, root->link[1] );
+    tree->rel ( root->data );
+    tree->mem.release ( tree->mem.ctx, root, sizeof *root );
+  }
+}
+
+/*
+  Build a balanced subtree from n > 0 sorted items, nil on
+  failure. A subtree of n nodes gets level floor(log2(n + 1)),
+  which puts left children one level down and only lets a
+  full right subtree share its parent's level
+*/
+static jsw_anode_t *build_tree ( jsw_atree_t *tree, void **items, size_t n )
+{
+  size_t mid = ( n - 1 ) / 2;
+  jsw_anode_t *rn = new_node ( tree, items[mid] );
+  size_t m;
+
+  if ( rn == tree->nil )
+    return tree->nil;
+
+  for ( rn->level = 0, m = n + 1; m > 1; m >>= 1 )
+    ++rn->level;
+
+  if ( mid > 0 ) {
+    rn->link[0] = build_tree ( tree, items, mid );
+
+    if ( rn->link[0] == tree->nil ) {
+      release_tree ( tree, rn );
+      return tree->nil;
+    }
+  }
+
+  if ( n - mid > 1 ) {
+    rn->link[1] = build_tree ( tree, items + mid + 1, n - mid - 1 );
+
+    if ( rn->link[1] == tree->nil ) {
+      release_tree ( tree, rn );
+      return tree->nil;
+    }
+  }
+
+  return rn;
+}
+
+/*
+  Fill an empty tree from strictly increasing items in linear
+  time. Fails, leaving the tree unchanged, if the tree isn't
+  empty, the items are out of order, or an allocation fails
+*/
+int jsw_abuild ( jsw_atree_t *tree, void **items, size_t n )
+{
+  size_t i;
+
+  if ( tree->root != tree->nil )
+    return 0;
+
+  for ( i = 1; i < n; i++ ) {
+    if ( CMP ( tree, items[i - 1], items[i] ) >= 0 )
+      return 0;
+  }
+
+  if ( n == 0 )
+    return 1;
+
+  tree->root = build_tree ( tree, items, n );
+
+  if ( tree->root == tree->nil )
+    return 0;
+
+  tree->size = n;
+
+  return 1;
+}
+
 jsw_atrav_t *jsw_atnew ( void )
 {
   return malloc ( sizeof ( jsw_atrav_t ) );
@@ -399,3 +632,76 @@ void *jsw_atprev ( jsw_atrav_t *trav )
 {
   return move ( trav, 0 ); /* Toward smaller items */
 }
+
+/*
+  Start at the first item that isn't less than data,
+  or that is greater than data for an upper bound. The
+  path to the best candidate is kept for later moves
+*/
+static void *bound ( jsw_atrav_t *trav, jsw_atree_t *tree, void *data,
+                     int upper )
+{
+  jsw_anode_t *it = tree->root;
+  size_t top = 0;
+
+  trav->tree = tree;
+  trav->it = tree->nil;
+  trav->top = 0;
+
+  while ( it != tree->nil ) {
+    int cmp = CMP ( tree, it->data, data );
+
+    if ( cmp > 0 || ( cmp == 0 && !upper ) ) {
+      /* A candidate, but a better one could be to the left */
+      trav->it = it;
+      trav->top = top;
+
+      if ( cmp == 0 )
+        break;
+
+      trav->path[top++] = it;
+      it = it->link[0];
+    }
+    else {
+      trav->path[top++] = it;
+      it = it->link[1];
+    }
+  }
+
+  /* Could be nil, but nil->data == NULL */
+  return trav->it->data;
+}
+
+void *jsw_atlower ( jsw_atrav_t *trav, jsw_atree_t *tree, void *data )
+{
+  return bound ( trav, tree, data, 0 ); /* First item >= data */
+}
+
+void *jsw_atupper ( jsw_atrav_t *trav, jsw_atree_t *tree, void *data )
+{
+  return bound ( trav, tree, data, 1 ); /* First item > data */
+}
+
+/*
+  Visit items from lo to hi inclusive in ascending order,
+  stopping early if visit returns 0. Returns the number of
+  items passed to visit
+*/
+size_t jsw_arange ( jsw_atree_t *tree, void *lo, void *hi,
+                    visit_f visit, void *arg )
+{
+  jsw_atrav_t trav;
+  void *it = bound ( &trav, tree, lo, 0 );
+  size_t n = 0;
+
+  while ( it != NULL && CMP ( tree, it, hi ) <= 0 ) {
+    ++n;
+
+    if ( !visit ( it, arg ) )
+      break;
+
+    it = move ( &trav, 1 );
+  }
+
+  return n;
+}
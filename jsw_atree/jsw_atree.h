@@ -5,6 +5,10 @@
   Andersson tree library
 
     > Created (Julienne Walker): September 10, 2005
+    > Modified (agent): October 14, 2026
+      Added allocator hooks, intrusive nodes, building
+      from sorted input, bounds and range visits,
+      JSW_STATS counters and clear
 
   This code is in the public domain. Anyone may
   use it or change it in any way that they see
@@ -27,22 +31,43 @@ extern "C" {
 #include <stddef.h>
 #endif
 
+#include "jsw_alloc.h"
+#include "jsw_common.h"
+
 /* Opaque types */
 typedef struct jsw_atree jsw_atree_t;
 typedef struct jsw_atrav jsw_atrav_t;
 
-/* User-defined item handling */
+/* Tree node, embed one in each item for intrusive trees */
+typedef struct jsw_anode {
+  int               level;   /* Horizontal level for balance */
+  void             *data;    /* User-defined content */
+  struct jsw_anode *link[2]; /* Left (0) and right (1) links */
+} jsw_anode_t;
+
+/* User-defined item handling, a NULL rel leaves items alone */
 typedef int   (*cmp_f) ( const void *p1, const void *p2 );
 typedef void *(*dup_f) ( void *p );
 typedef void  (*rel_f) ( void *p );
 
+/* Called for each item in a range, returns 0 to stop */
+typedef int   (*visit_f) ( void *p, void *arg );
+
 /* Andersson tree functions */
 jsw_atree_t *jsw_anew ( cmp_f cmp, dup_f dup, rel_f rel );
+jsw_atree_t *jsw_anew_alloc ( cmp_f cmp, dup_f dup, rel_f rel,
+                              const jsw_alloc_t *alloc );
+jsw_atree_t *jsw_anew_intrusive ( cmp_f cmp, rel_f rel, size_t offset );
 void         jsw_adelete ( jsw_atree_t *tree );
+void         jsw_aclear ( jsw_atree_t *tree );
 void        *jsw_afind ( jsw_atree_t *tree, void *data );
 int          jsw_ainsert ( jsw_atree_t *tree, void *data );
 int          jsw_aerase ( jsw_atree_t *tree, void *data );
 size_t       jsw_asize ( jsw_atree_t *tree );
+int          jsw_astats ( jsw_atree_t *tree, jsw_stats_t *stats );
+int          jsw_abuild ( jsw_atree_t *tree, void **items, size_t n );
+size_t       jsw_arange ( jsw_atree_t *tree, void *lo, void *hi,
+                          visit_f visit, void *arg );
 
 /* Traversal functions */
 jsw_atrav_t *jsw_atnew ( void );
@@ -51,6 +76,10 @@ void        *jsw_atfirst ( jsw_atrav_t *trav, jsw_atree_t *tree );
 void        *jsw_atlast ( jsw_atrav_t *trav, jsw_atree_t *tree );
 void        *jsw_atnext ( jsw_atrav_t *trav );
 void        *jsw_atprev ( jsw_atrav_t *trav );
+void        *jsw_atlower ( jsw_atrav_t *trav, jsw_atree_t *tree,
+                           void *data );
+void        *jsw_atupper ( jsw_atrav_t *trav, jsw_atree_t *tree,
+                           void *data );
 
 #ifdef __cplusplus
 }
@@ -3,6 +3,11 @@
 
     > Created (Julienne Walker): June 17, 2003
     > Modified (Julienne Walker): September 24, 2005
+    > Modified (agent): October 14, 2026
+      Compared once per level, and added allocator
+      hooks, intrusive nodes, building from sorted
+      input, bounds and range visits, rank and select,
+      JSW_STATS counters, clear and set operations
 */
 #include "jsw_avltree.h"
 
@@ -20,11 +25,36 @@ using std::size_t;
 #define HEIGHT_LIMIT 64 /* Tallest allowable tree */
 #endif
 
-typedef struct jsw_avlnode {
-  int                 balance; /* Balance factor */
-  void               *data;    /* User-defined content */
-  struct jsw_avlnode *link[2]; /* Left (0) and right (1) links */
-} jsw_avlnode_t;
+/*
+  Subtree sizes for rank and select, kept only with JSW_RANK.
+  Without it these do nothing and the node has no count field
+*/
+#ifdef JSW_RANK
+#define COUNT(n)       ( (n) == NULL ? 0 : (n)->count )
+#define ADD_COUNT(n,d) ( (n)->count += (size_t)(d) )
+#define SET_COUNT(n,c) ( (n)->count = (c) )
+#define RECOUNT(n) \
+  ( (n)->count = 1 + COUNT ( (n)->link[0] ) + COUNT ( (n)->link[1] ) )
+#else
+#define RECOUNT(n)     ( (void)0 )
+#define ADD_COUNT(n,d) ( (void)0 )
+#define SET_COUNT(n,c) ( (void)0 )
+#endif
+
+/*
+  Hot path counters, kept only with JSW_STATS. Without it
+  these do nothing and the tree has no stats field
+*/
+#ifdef JSW_STATS
+#define STAT_ADD(t,f,n) ( (void)( (t)->stats.f += (unsigned long)(n) ) )
+#else
+#define STAT_ADD(t,f,n) ( (void)0 )
+#endif
+#define STAT(t,f) STAT_ADD ( t, f, 1 )
+#define CMP(t,a,b) ( STAT ( t, cmps ), (t)->cmp ( (a), (b) ) )
+
+/* All zero, for new trees and for builds without JSW_STATS */
+static const jsw_stats_t no_stats = { 0 };
 
 struct jsw_avltree {
   jsw_avlnode_t *root; /* Top of the tree */
@@ -32,6 +62,12 @@ struct jsw_avltree {
   dup_f          dup;    /* Clone an item (user-defined) */
   rel_f          rel;    /* Destroy an item (user-defined) */
   size_t         size;   /* Number of items (user-defined) */
+  jsw_alloc_t    mem;    /* Node allocator */
+  int            intrusive; /* Nodes are embedded in the items */
+  size_t         offset;    /* Offset of the node in each item */
+#ifdef JSW_STATS
+  jsw_stats_t    stats;     /* Hot path counters */
+#endif
 };
 
 struct jsw_avltrav {
@@ -41,11 +77,13 @@ struct jsw_avltrav {
   size_t         top;                /* Top of stack */
 };
 
-/* Two way single rotation */
+/* Two way single rotation (the subtree keeps its size) */
 #define jsw_single(root,dir) do {         \
   jsw_avlnode_t *save = root->link[!dir]; \
   root->link[!dir] = save->link[dir];     \
   save->link[dir] = root;                 \
+  SET_COUNT ( save, root->count );        \
+  RECOUNT ( root );                       \
   root = save;                            \
 } while (0)
 
@@ -58,6 +96,9 @@ struct jsw_avltrav {
   save = root->link[!dir];                           \
   root->link[!dir] = save->link[dir];                \
   save->link[dir] = root;                            \
+  SET_COUNT ( save, root->count );                   \
+  RECOUNT ( root );                                  \
+  RECOUNT ( save->link[!dir] );                      \
   root = save;                                       \
 } while (0)
 
@@ -79,54 +120,104 @@ struct jsw_avltrav {
 } while (0)
 
 /* Rebalance after insertion */
-#define jsw_insert_balance(root,dir) do {  \
-  jsw_avlnode_t *n = root->link[dir];      \
-  int bal = dir == 0 ? -1 : +1;            \
-  if ( n->balance == bal ) {               \
-    root->balance = n->balance = 0;        \
-    jsw_single ( root, !dir );             \
-  }                                        \
-  else { /* n->balance == -bal */          \
-    jsw_adjust_balance ( root, dir, bal ); \
-    jsw_double ( root, !dir );             \
-  }                                        \
-} while (0)
-
-/* Rebalance after deletion */
-#define jsw_remove_balance(root,dir,done) do { \
-  jsw_avlnode_t *n = root->link[!dir];         \
+#define jsw_insert_balance(tree,root,dir) do { \
+  jsw_avlnode_t *n = root->link[dir];          \
   int bal = dir == 0 ? -1 : +1;                \
-  if ( n->balance == -bal ) {                  \
+  if ( n->balance == bal ) {                   \
     root->balance = n->balance = 0;            \
-    jsw_single ( root, dir );                  \
-  }                                            \
-  else if ( n->balance == bal ) {              \
-    jsw_adjust_balance ( root, !dir, -bal );   \
-    jsw_double ( root, dir );                  \
+    jsw_single ( root, !dir );                 \
+    STAT ( tree, rotations );                  \
   }                                            \
-  else { /* n->balance == 0 */                 \
-    root->balance = -bal;                      \
-    n->balance = bal;                          \
-    jsw_single ( root, dir );                  \
-    done = 1;                                  \
+  else { /* n->balance == -bal */              \
+    jsw_adjust_balance ( root, dir, bal );     \
+    jsw_double ( root, !dir );                 \
+    STAT_ADD ( tree, rotations, 2 );           \
   }                                            \
 } while (0)
 
+/* Rebalance after deletion */
+#define jsw_remove_balance(tree,root,dir,done) do { \
+  jsw_avlnode_t *n = root->link[!dir];              \
+  int bal = dir == 0 ? -1 : +1;                     \
+  if ( n->balance == -bal ) {                       \
+    root->balance = n->balance = 0;                 \
+    jsw_single ( root, dir );                       \
+    STAT ( tree, rotations );                       \
+  }                                                 \
+  else if ( n->balance == bal ) {                   \
+    jsw_adjust_balance ( root, !dir, -bal );        \
+    jsw_double ( root, dir );                       \
+    STAT_ADD ( tree, rotations, 2 );                \
+  }                                                 \
+  else { /* n->balance == 0 */                      \
+    root->balance = -bal;                           \
+    n->balance = bal;                               \
+    jsw_single ( root, dir );                       \
+    STAT ( tree, rotations );                       \
+    done = 1;                                       \
+  }                                                 \
+} while (0)
+
+/* Default node allocator hooks */
+static void *std_alloc ( void *ctx, size_t size )
+{
+  (void)ctx;
+  return malloc ( size );
+}
+
+static void std_release ( void *ctx, void *p, size_t size )
+{
+  (void)ctx;
+  (void)size;
+  free ( p );
+}
+
+/* Intrusive trees never own memory */
+static void no_release ( void *ctx, void *p, size_t size )
+{
+  (void)ctx;
+  (void)p;
+  (void)size;
+}
+
+static void no_rel ( void *p )
+{
+  (void)p;
+}
+
+/* Intrusive trees use the node embedded in the data */
 static jsw_avlnode_t *new_node ( jsw_avltree_t *tree, void *data )
 {
-  jsw_avlnode_t *rn = (jsw_avlnode_t *)malloc ( sizeof *rn );
+  jsw_avlnode_t *rn;
 
-  if ( rn == NULL )
-    return NULL;
+  if ( tree->intrusive ) {
+    rn = (jsw_avlnode_t *)( (char *)data + tree->offset );
+    rn->data = data;
+  }
+  else {
+    rn = (jsw_avlnode_t *)tree->mem.alloc ( tree->mem.ctx, sizeof *rn );
+
+    if ( rn == NULL )
+      return NULL;
+
+    STAT ( tree, allocs );
+    rn->data = tree->dup ( data );
+  }
 
   rn->balance = 0;
-  rn->data = tree->dup ( data );
   rn->link[0] = rn->link[1] = NULL;
+  SET_COUNT ( rn, 1 );
 
   return rn;
 }
 
 jsw_avltree_t *jsw_avlnew ( cmp_f cmp, dup_f dup, rel_f rel )
+{
+  return jsw_avlnew_alloc ( cmp, dup, rel, NULL );
+}
+
+jsw_avltree_t *jsw_avlnew_alloc ( cmp_f cmp, dup_f dup, rel_f rel,
+                                  const jsw_alloc_t *alloc )
 {
   jsw_avltree_t *rt = (jsw_avltree_t *)malloc ( sizeof *rt );
 
@@ -136,16 +227,57 @@ jsw_avltree_t *jsw_avlnew ( cmp_f cmp, dup_f dup, rel_f rel )
   rt->root = NULL;
   rt->cmp = cmp;
   rt->dup = dup;
-  rt->rel = rel;
+  rt->rel = rel != NULL ? rel : no_rel;
   rt->size = 0;
+  rt->intrusive = 0;
+  rt->offset = 0;
+#ifdef JSW_STATS
+  rt->stats = no_stats;
+#endif
+
+  if ( alloc != NULL )
+    rt->mem = *alloc;
+  else {
+    rt->mem.alloc = std_alloc;
+    rt->mem.release = std_release;
+    rt->mem.purge = NULL;
+    rt->mem.ctx = NULL;
+  }
 
   return rt;
 }
 
-void jsw_avldelete ( jsw_avltree_t *tree )
+/*
+  Items embed a jsw_avlnode_t at offset, which is linked
+  directly. rel (if not NULL) sees items leaving the tree
+*/
+jsw_avltree_t *jsw_avlnew_intrusive ( cmp_f cmp, rel_f rel, size_t offset )
+{
+  jsw_avltree_t *rt = jsw_avlnew ( cmp, NULL, rel );
+
+  if ( rt == NULL )
+    return NULL;
+
+  rt->intrusive = 1;
+  rt->offset = offset;
+  rt->mem.release = no_release;
+
+  return rt;
+}
+
+/*
+  Release every node, leaving the root dangling. Nodes are
+  only visited when an item needs releasing or a node has
+  no purge hook to go back with
+*/
+static void release_nodes ( jsw_avltree_t *tree )
 {
   jsw_avlnode_t *it = tree->root;
   jsw_avlnode_t *save;
+  int each = tree->mem.purge == NULL && !tree->intrusive;
+
+  if ( tree->rel == no_rel && !each )
+    it = NULL;
 
   /* Destruction by rotation */
   while ( it != NULL ) {
@@ -153,7 +285,10 @@ void jsw_avldelete ( jsw_avltree_t *tree )
       /* Remove node */
       save = it->link[1];
       tree->rel ( it->data );
-      free ( it );
+
+      /* A purge hook releases every node at the end */
+      if ( each )
+        tree->mem.release ( tree->mem.ctx, it, sizeof *it );
     }
     else {
       /* Rotate right */
@@ -165,15 +300,33 @@ void jsw_avldelete ( jsw_avltree_t *tree )
     it = save;
   }
 
+  if ( tree->mem.purge != NULL )
+    tree->mem.purge ( tree->mem.ctx );
+}
+
+void jsw_avldelete ( jsw_avltree_t *tree )
+{
+  release_nodes ( tree );
   free ( tree );
 }
 
+/*
+  Empty the tree for reuse. O(1) with a purge hook and
+  externally owned items (rel was NULL)
+*/
+void jsw_avlclear ( jsw_avltree_t *tree )
+{
+  release_nodes ( tree );
+  tree->root = NULL;
+  tree->size = 0;
+}
+
 void *jsw_avlfind ( jsw_avltree_t *tree, void *data )
 {
   jsw_avlnode_t *it = tree->root;
 
   while ( it != NULL ) {
-    int cmp = tree->cmp ( it->data, data );
+    int cmp = CMP ( tree, it->data, data );
 
     if ( cmp == 0 )
       break;
@@ -196,7 +349,14 @@ int jsw_avlinsert ( jsw_avltree_t *tree, void *data )
     jsw_avlnode_t head = {0}; /* Temporary tree root */
     jsw_avlnode_t *s, *t;     /* Place to rebalance and parent */
     jsw_avlnode_t *p, *q;     /* Iterator and save pointer */
-    int dir;
+    jsw_avlnode_t *n;         /* The new node */
+    int upd[HEIGHT_LIMIT];    /* Directions taken from s down */
+    int dir, top = 0;
+
+    /* Allocate first, so every node passed can count it */
+    n = new_node ( tree, data );
+    if ( n == NULL )
+      return 0;
 
     /* Set up false root to ease maintenance */
     t = &head;
@@ -204,7 +364,9 @@ int jsw_avlinsert ( jsw_avltree_t *tree, void *data )
 
     /* Search down the tree, saving rebalance points */
     for ( s = p = t->link[1]; ; p = q ) {
-      dir = tree->cmp ( p->data, data ) < 0;
+      ADD_COUNT ( p, 1 );
+      dir = CMP ( tree, p->data, data ) < 0;
+      upd[top++] = dir;
       q = p->link[dir];
 
       if ( q == NULL )
@@ -213,16 +375,15 @@ int jsw_avlinsert ( jsw_avltree_t *tree, void *data )
       if ( q->balance != 0 ) {
         t = p;
         s = q;
+        top = 0;
       }
     }
 
-    p->link[dir] = q = new_node ( tree, data );
-    if ( q == NULL )
-      return 0;
+    p->link[dir] = q = n;
 
-    /* Update balance factors */
-    for ( p = s; p != q; p = p->link[dir] ) {
-      dir = tree->cmp ( p->data, data ) < 0;
+    /* Update balance factors, reusing the saved directions */
+    for ( p = s, top = 0; p != q; p = p->link[dir] ) {
+      dir = upd[top++];
       p->balance += dir == 0 ? -1 : +1;
     }
 
@@ -230,8 +391,8 @@ int jsw_avlinsert ( jsw_avltree_t *tree, void *data )
 
     /* Rebalance if necessary */
     if ( abs ( s->balance ) > 1 ) {
-      dir = tree->cmp ( s->data, data ) < 0;
-      jsw_insert_balance ( s, dir );
+      dir = upd[0];
+      jsw_insert_balance ( tree, s, dir );
     }
 
     /* Fix parent */
@@ -257,13 +418,18 @@ int jsw_avlerase ( jsw_avltree_t *tree, void *data )
 
     /* Search down tree and save path */
     for ( ; ; ) {
+      int cmp;
+
       if ( it == NULL )
         return 0;
-      else if ( tree->cmp ( it->data, data ) == 0 )
+
+      cmp = CMP ( tree, it->data, data );
+
+      if ( cmp == 0 )
         break;
 
       /* Push direction and node onto stack */
-      upd[top] = tree->cmp ( it->data, data ) < 0;
+      upd[top] = cmp < 0;
       up[top++] = it;
 
       it = it->link[upd[top - 1]];
@@ -281,12 +447,13 @@ int jsw_avlerase ( jsw_avltree_t *tree, void *data )
         tree->root = it->link[dir];
 
       tree->rel ( it->data );
-      free ( it );
+      tree->mem.release ( tree->mem.ctx, it, sizeof *it );
+      STAT_ADD ( tree, releases, !tree->intrusive );
     }
     else {
       /* Find the inorder successor */
       jsw_avlnode_t *heir = it->link[1];
-      void *save;
+      int at = top;
       
       /* Save this path too */
       upd[top] = 1;
@@ -298,17 +465,38 @@ int jsw_avlerase ( jsw_avltree_t *tree, void *data )
         heir = heir->link[0];
       }
 
-      /* Swap data */
-      save = it->data;
-      it->data = heir->data;
-      heir->data = save;
-
       /* Unlink successor and fix parent */
       up[top - 1]->link[up[top - 1] == it] = heir->link[1];
+      SET_COUNT ( heir, it->count );
+
+      /*
+        Move the successor into the removed node's place
+        (rather than swapping data, for intrusive nodes)
+      */
+      heir->link[0] = it->link[0];
+      heir->link[1] = it->link[1];
+      heir->balance = it->balance;
+      up[at] = heir;
+
+      if ( at != 0 )
+        up[at - 1]->link[upd[at - 1]] = heir;
+      else
+        tree->root = heir;
 
-      tree->rel ( heir->data );
-      free ( heir );
+      tree->rel ( it->data );
+      tree->mem.release ( tree->mem.ctx, it, sizeof *it );
+      STAT_ADD ( tree, releases, !tree->intrusive );
+    }
+
+#ifdef JSW_RANK
+    {
+      /* Everything above the unlinked node lost one */
+      int i;
+
+      for ( i = 0; i < top; i++ )
+        --up[i]->count;
     }
+#endif
 
     /* Walk back up the search path */
     while ( --top >= 0 && !done ) {
@@ -319,7 +507,7 @@ int jsw_avlerase ( jsw_avltree_t *tree, void *data )
       if ( abs ( up[top]->balance ) == 1 )
         break;
       else if ( abs ( up[top]->balance ) > 1 ) {
-        jsw_remove_balance ( up[top], upd[top], done );
+        jsw_remove_balance ( tree, up[top], upd[top], done );
 
         /* Fix parent */
         if ( top != 0 )
@@ -330,9 +518,11 @@ int jsw_avlerase ( jsw_avltree_t *tree, void *data )
     }
 
     --tree->size;
+
+    return 1;
   }
 
-  return 1;
+  return 0;
 }
 
 size_t jsw_avlsize ( jsw_avltree_t *tree )
@@ -340,6 +530,686 @@ size_t jsw_avlsize ( jsw_avltree_t *tree )
   return tree->size;
 }
 
+/* Copy out the hot path counters, non-zero if built with JSW_STATS */
+int jsw_avlstats ( jsw_avltree_t *tree, jsw_stats_t *stats )
+{
+#ifdef JSW_STATS
+  *stats = tree->stats;
+  return 1;
+#else
+  (void)tree;
+  *stats = no_stats;
+  return 0;
+#endif
+}
+
+#ifdef JSW_RANK
+/* The k-th smallest item (from 0), or NULL if k >= size */
+void *jsw_avlselect ( jsw_avltree_t *tree, size_t k )
+{
+  jsw_avlnode_t *it = tree->root;
+
+  while ( it != NULL ) {
+    size_t left = COUNT ( it->link[0] );
+
+    if ( k == left )
+      return it->data;
+
+    if ( k < left )
+      it = it->link[0];
+    else {
+      k -= left + 1;
+      it = it->link[1];
+    }
+  }
+
+  return NULL;
+}
+
+/* Number of items smaller than data, present or not */
+size_t jsw_avlrank ( jsw_avltree_t *tree, void *data )
+{
+  jsw_avlnode_t *it = tree->root;
+  size_t rank = 0;
+
+  while ( it != NULL ) {
+    int cmp = CMP ( tree, it->data, data );
+
+    if ( cmp == 0 )
+      return rank + COUNT ( it->link[0] );
+
+    if ( cmp < 0 ) {
+      rank += COUNT ( it->link[0] ) + 1;
+      it = it->link[1];
+    }
+    else
+      it = it->link[0];
+  }
+
+  return rank;
+}
+#endif
+
+/* Height of a perfectly balanced tree with n nodes */
+static int build_height ( size_t n )
+{
+  int h = 0;
+
+  for ( ; n > 0; n >>= 1 )
+    ++h;
+
+  return h;
+}
+
+/* Release a subtree built by build_tree (balanced, so recursion is safe) */
+static void release_tree ( jsw_avltree_t *tree, jsw_avlnode_t *root )
+{
+  if ( root != NULL ) {
+    release_tree ( tree, root->link[0] );
+    release_tree ( tree, root->link[1] );
+    tree->rel ( root->data );
+    tree->mem.release ( tree->mem.ctx, root, sizeof *root );
+  }
+}
+
+/* Build a balanced subtree from n > 0 sorted items, NULL on failure */
+static jsw_avlnode_t *build_tree ( jsw_avltree_t *tree, void **items,
+                                   size_t n )
+{
+  size_t mid = ( n - 1 ) / 2;
+  jsw_avlnode_t *rn = new_node ( tree, items[mid] );
+
+  if ( rn == NULL )
+    return NULL;
+
+  /* The right side gets the extra node, if any */
+  rn->balance = build_height ( n - mid - 1 ) - build_height ( mid );
+
+  if ( mid > 0 ) {
+    rn->link[0] = build_tree ( tree, items, mid );
+
+    if ( rn->link[0] == NULL ) {
+      release_tree ( tree, rn );
+      return NULL;
+    }
+  }
+
+  if ( n - mid > 1 ) {
+    rn->link[1] = build_tree ( tree, items + mid + 1, n - mid - 1 );
+
+    if ( rn->link[1] == NULL ) {
+      release_tree ( tree, rn );
+      return NULL;
+    }
+  }
+
+  RECOUNT ( rn );
+
+  return rn;
+}
+
+/*
+  Fill an empty tree from strictly increasing items in linear
+  time. Fails, leaving the tree unchanged, if the tree isn't
+  empty, the items are out of order, or an allocation fails
+*/
+int jsw_avlbuild ( jsw_avltree_t *tree, void **items, size_t n )
+{
+  size_t i;
+
+  if ( tree->root != NULL )
+    return 0;
+
+  for ( i = 1; i < n; i++ ) {
+    if ( CMP ( tree, items[i - 1], items[i] ) >= 0 )
+      return 0;
+  }
+
+  if ( n == 0 )
+    return 1;
+
+  tree->root = build_tree ( tree, items, n );
+
+  if ( tree->root == NULL )
+    return 0;
+
+  tree->size = n;
+
+  return 1;
+}
+
+/*
+  Set operations, built on join: joining two trees around a
+  key costs O(|h(l) - h(r)|), so splitting costs O(log n)
+  and union, intersection and difference of trees of sizes
+  m <= n cost O(m log(n/m + 1)). Heights (NULL is 0) are
+  worked out from balance factors on the way down
+*/
+#define SET_UNION      0
+#define SET_INTERSECT  1
+#define SET_DIFFERENCE 2
+
+/*
+  One subproblem of a set operation. Each task of a parallel
+  run has its own, and nodes leaving either tree are kept on
+  a list instead of released, as the allocator may not be
+  thread safe
+*/
+typedef struct jsw_avlset {
+  cmp_f             cmp;       /* Compare two items */
+  const jsw_fork_t *fork;      /* Fork-join hook, or NULL */
+  int               depth;     /* Levels left to fork */
+  int               kind;      /* SET_UNION, SET_INTERSECT or SET_DIFFERENCE */
+  jsw_avlnode_t    *in[2];     /* Subtrees of the first and second trees */
+  int               inh[2];    /* Their heights */
+  jsw_avlnode_t    *out;       /* The result */
+  int               outh;      /* Its height */
+  size_t            matches;   /* Items found in both subtrees */
+  jsw_avlnode_t    *drop[2];   /* Nodes leaving each tree, linked by link[0] */
+  jsw_avlnode_t    *last[2];   /* Tails of the drop lists */
+  unsigned long     cmps;      /* Comparisons made */
+  unsigned long     rotations; /* Rotations made */
+} jsw_avlset_t;
+
+static void set_init ( jsw_avlset_t *set, cmp_f cmp,
+                       const jsw_fork_t *fork, int kind )
+{
+  set->cmp = cmp;
+  set->fork = fork;
+  set->depth = fork != NULL ? fork->depth : 0;
+  set->kind = kind;
+  set->in[0] = set->in[1] = NULL;
+  set->inh[0] = set->inh[1] = 0;
+  set->out = NULL;
+  set->outh = 0;
+  set->matches = 0;
+  set->drop[0] = set->drop[1] = NULL;
+  set->last[0] = set->last[1] = NULL;
+  set->cmps = 0;
+  set->rotations = 0;
+}
+
+/* Height of a subtree, following the taller side down */
+static int tree_height ( jsw_avlnode_t *root )
+{
+  int h = 0;
+
+  for ( ; root != NULL; root = root->link[root->balance > 0] )
+    ++h;
+
+  return h;
+}
+
+/* Height of one child of a subtree of height h */
+static int child_height ( jsw_avlnode_t *root, int h, int dir )
+{
+  return h - 1 - ( dir ? root->balance < 0 : root->balance > 0 );
+}
+
+/* Hang a on the !dir side of root and b on the dir side */
+static int attach ( jsw_avlnode_t *root, jsw_avlnode_t *a, int ha,
+                    jsw_avlnode_t *b, int hb, int dir )
+{
+  root->link[!dir] = a;
+  root->link[dir] = b;
+  root->balance = dir ? hb - ha : ha - hb;
+  RECOUNT ( root );
+
+  return 1 + ( ha > hb ? ha : hb );
+}
+
+/*
+  Join a key and a subtree s at least two shorter onto the
+  dir side of root, walking down that side until the heights
+  are close enough, and rotating on the way back up
+*/
+static jsw_avlnode_t *join_side ( jsw_avlset_t *set, jsw_avlnode_t *root,
+                                  int h, jsw_avlnode_t *key,
+                                  jsw_avlnode_t *s, int hs, int dir,
+                                  int *outh )
+{
+  jsw_avlnode_t *l = root->link[!dir];
+  jsw_avlnode_t *c = root->link[dir];
+  int hl = child_height ( root, h, !dir );
+  int hc = child_height ( root, h, dir );
+  jsw_avlnode_t *x0, *x1;
+  int hk, hx0, hx1;
+
+  if ( hc <= hs + 1 ) {
+    hk = attach ( key, c, hc, s, hs, dir );
+
+    if ( hk <= hl + 1 ) {
+      *outh = attach ( root, l, hl, key, hk, dir );
+      return root;
+    }
+
+    /* Double rotation, c ends up on top */
+    x0 = c->link[!dir];
+    x1 = c->link[dir];
+    hx0 = child_height ( c, hc, !dir );
+    hx1 = child_height ( c, hc, dir );
+    hl = attach ( root, l, hl, x0, hx0, dir );
+    hk = attach ( key, x1, hx1, s, hs, dir );
+    *outh = attach ( c, root, hl, key, hk, dir );
+    set->rotations += 2;
+
+    return c;
+  }
+
+  c = join_side ( set, c, hc, key, s, hs, dir, &hc );
+
+  if ( hc <= hl + 1 ) {
+    *outh = attach ( root, l, hl, c, hc, dir );
+    return root;
+  }
+
+  /* Single rotation, the joined child ends up on top */
+  x0 = c->link[!dir];
+  x1 = c->link[dir];
+  hx0 = child_height ( c, hc, !dir );
+  hx1 = child_height ( c, hc, dir );
+  hl = attach ( root, l, hl, x0, hx0, dir );
+  *outh = attach ( c, root, hl, x1, hx1, dir );
+  ++set->rotations;
+
+  return c;
+}
+
+/* Join l and r around a key that sorts between them */
+static jsw_avlnode_t *join ( jsw_avlset_t *set, jsw_avlnode_t *l, int hl,
+                             jsw_avlnode_t *key, jsw_avlnode_t *r, int hr,
+                             int *h )
+{
+  if ( hl > hr + 1 )
+    return join_side ( set, l, hl, key, r, hr, 1, h );
+
+  if ( hr > hl + 1 )
+    return join_side ( set, r, hr, key, l, hl, 0, h );
+
+  *h = attach ( key, l, hl, r, hr, 1 );
+
+  return key;
+}
+
+/* Remove the last node of a non-empty subtree, returning the rest */
+static jsw_avlnode_t *split_last ( jsw_avlset_t *set, jsw_avlnode_t *root,
+                                   int h, jsw_avlnode_t **last, int *resth )
+{
+  jsw_avlnode_t *rest;
+  int hl = child_height ( root, h, 0 );
+
+  if ( root->link[1] == NULL ) {
+    *last = root;
+    *resth = hl;
+
+    return root->link[0];
+  }
+
+  rest = split_last ( set, root->link[1], child_height ( root, h, 1 ),
+    last, resth );
+
+  return join ( set, root->link[0], hl, root, rest, *resth, resth );
+}
+
+/* Join l and r, every item of l sorting before r */
+static jsw_avlnode_t *join2 ( jsw_avlset_t *set, jsw_avlnode_t *l, int hl,
+                              jsw_avlnode_t *r, int hr, int *h )
+{
+  jsw_avlnode_t *key;
+
+  if ( l == NULL ) {
+    *h = hr;
+    return r;
+  }
+
+  l = split_last ( set, l, hl, &key, &hl );
+
+  return join ( set, l, hl, key, r, hr, h );
+}
+
+/*
+  Split a subtree into the items before and after data,
+  returning a node that matches it, or NULL
+*/
+static jsw_avlnode_t *split ( jsw_avlset_t *set, jsw_avlnode_t *root, int h,
+                              void *data, jsw_avlnode_t **l, int *hl,
+                              jsw_avlnode_t **r, int *hr )
+{
+  jsw_avlnode_t *found, *sub;
+  int cmp, h0, h1, hsub;
+
+  if ( root == NULL ) {
+    *l = *r = NULL;
+    *hl = *hr = 0;
+
+    return NULL;
+  }
+
+  h0 = child_height ( root, h, 0 );
+  h1 = child_height ( root, h, 1 );
+  ++set->cmps;
+  cmp = set->cmp ( root->data, data );
+
+  if ( cmp == 0 ) {
+    *l = root->link[0];
+    *r = root->link[1];
+    *hl = h0;
+    *hr = h1;
+
+    return root;
+  }
+
+  if ( cmp < 0 ) {
+    found = split ( set, root->link[1], h1, data, &sub, &hsub, r, hr );
+    *l = join ( set, root->link[0], h0, root, sub, hsub, hl );
+  }
+  else {
+    found = split ( set, root->link[0], h0, data, l, hl, &sub, &hsub );
+    *r = join ( set, sub, hsub, root, root->link[1], h1, hr );
+  }
+
+  return found;
+}
+
+/* Put a node leaving one tree (side 0 or 1) on its drop list */
+static void drop ( jsw_avlset_t *set, int side, jsw_avlnode_t *node )
+{
+  node->link[0] = NULL;
+
+  if ( set->drop[side] == NULL )
+    set->drop[side] = node;
+  else
+    set->last[side]->link[0] = node;
+
+  set->last[side] = node;
+}
+
+static void drop_tree ( jsw_avlset_t *set, int side, jsw_avlnode_t *root )
+{
+  if ( root != NULL ) {
+    jsw_avlnode_t *r = root->link[1];
+
+    drop_tree ( set, side, root->link[0] );
+    drop ( set, side, root );
+    drop_tree ( set, side, r );
+  }
+}
+
+/*
+  Run one subproblem: the root of one input splits the
+  other, the halves run as tasks of their own (in parallel
+  while forking levels are left), and the results are
+  joined back around that root, or without it
+*/
+static void set_task ( void *arg )
+{
+  jsw_avlset_t *set = (jsw_avlset_t *)arg;
+  jsw_avlset_t sub[2];
+  jsw_avlnode_t *key, *found, *half[2];
+  int halfh[2], keyh[2];
+  int pivot, i;
+
+  if ( set->in[0] == NULL || set->in[1] == NULL ) {
+    /* What is left of an input stays or goes whole */
+    for ( i = 0; i < 2; i++ ) {
+      if ( set->in[i] == NULL )
+        continue;
+
+      if ( set->kind == SET_UNION
+        || ( set->kind == SET_DIFFERENCE && i == 0 ) )
+      {
+        set->out = set->in[i];
+        set->outh = set->inh[i];
+      }
+      else
+        drop_tree ( set, i, set->in[i] );
+    }
+
+    return;
+  }
+
+  /* A difference keeps what the second tree's keys don't split off */
+  pivot = set->kind == SET_DIFFERENCE;
+  key = set->in[pivot];
+  keyh[0] = child_height ( key, set->inh[pivot], 0 );
+  keyh[1] = child_height ( key, set->inh[pivot], 1 );
+  found = split ( set, set->in[!pivot], set->inh[!pivot], key->data,
+    &half[0], &halfh[0], &half[1], &halfh[1] );
+
+  for ( i = 0; i < 2; i++ ) {
+    set_init ( &sub[i], set->cmp, set->fork, set->kind );
+    sub[i].depth = set->depth - 1;
+    sub[i].in[pivot] = key->link[i];
+    sub[i].inh[pivot] = keyh[i];
+    sub[i].in[!pivot] = half[i];
+    sub[i].inh[!pivot] = halfh[i];
+  }
+
+  if ( set->depth > 0 )
+    set->fork->fork ( set->fork->ctx, set_task, &sub[0], &sub[1] );
+  else {
+    set_task ( &sub[0] );
+    set_task ( &sub[1] );
+  }
+
+  /* Take over what the halves did */
+  for ( i = 0; i < 2; i++ ) {
+    int side;
+
+    for ( side = 0; side < 2; side++ ) {
+      if ( sub[i].drop[side] == NULL )
+        continue;
+
+      if ( set->drop[side] == NULL )
+        set->drop[side] = sub[i].drop[side];
+      else
+        set->last[side]->link[0] = sub[i].drop[side];
+
+      set->last[side] = sub[i].last[side];
+    }
+
+    set->matches += sub[i].matches;
+    set->cmps += sub[i].cmps;
+    set->rotations += sub[i].rotations;
+  }
+
+  if ( found != NULL ) {
+    ++set->matches;
+    drop ( set, !pivot, found );
+  }
+
+  if ( set->kind == SET_UNION
+    || ( set->kind == SET_INTERSECT && found != NULL ) )
+  {
+    set->out = join ( set, sub[0].out, sub[0].outh, key,
+      sub[1].out, sub[1].outh, &set->outh );
+  }
+  else {
+    drop ( set, pivot, key );
+    set->out = join2 ( set, sub[0].out, sub[0].outh,
+      sub[1].out, sub[1].outh, &set->outh );
+  }
+}
+
+/*
+  Nodes can move between distinct trees that handle them alike.
+  Not with a purge hook: each tree would still purge the shared
+  allocator when deleted, under the nodes the other one holds
+*/
+static int compatible ( jsw_avltree_t *a, jsw_avltree_t *b )
+{
+  return a != b && a->intrusive == b->intrusive && a->offset == b->offset
+    && a->mem.alloc == b->mem.alloc && a->mem.release == b->mem.release
+    && a->mem.purge == NULL && b->mem.purge == NULL
+    && a->mem.ctx == b->mem.ctx;
+}
+
+/* Release the nodes on a drop list, and their items */
+static void release_list ( jsw_avltree_t *tree, jsw_avlnode_t *it )
+{
+  while ( it != NULL ) {
+    /* The item may hold the node */
+    jsw_avlnode_t *save = it->link[0];
+
+    tree->rel ( it->data );
+    tree->mem.release ( tree->mem.ctx, it, sizeof *it );
+    STAT_ADD ( tree, releases, !tree->intrusive );
+    it = save;
+  }
+}
+
+/* Nodes in a subtree, linear unless JSW_RANK keeps counts */
+static size_t count_nodes ( jsw_avlnode_t *root )
+{
+#ifdef JSW_RANK
+  return COUNT ( root );
+#else
+  if ( root == NULL )
+    return 0;
+
+  return 1 + count_nodes ( root->link[0] ) + count_nodes ( root->link[1] );
+#endif
+}
+
+/* Leave the result of a set operation in a, and b empty */
+static int set_op ( jsw_avltree_t *a, jsw_avltree_t *b,
+                    const jsw_fork_t *fork, int kind )
+{
+  jsw_avlset_t set;
+
+  if ( !compatible ( a, b ) )
+    return 0;
+
+  set_init ( &set, a->cmp, fork, kind );
+  set.in[0] = a->root;
+  set.inh[0] = tree_height ( a->root );
+  set.in[1] = b->root;
+  set.inh[1] = tree_height ( b->root );
+
+  set_task ( &set );
+
+  a->root = set.out;
+
+  if ( kind == SET_UNION )
+    a->size += b->size - set.matches;
+  else if ( kind == SET_INTERSECT )
+    a->size = set.matches;
+  else
+    a->size -= set.matches;
+
+  b->root = NULL;
+  b->size = 0;
+
+  STAT_ADD ( a, cmps, set.cmps );
+  STAT_ADD ( a, rotations, set.rotations );
+  release_list ( a, set.drop[0] );
+  release_list ( b, set.drop[1] );
+
+  return 1;
+}
+
+/*
+  Move every item of b onto the end of a in O(log n), if
+  none sorts before the last item of a. Fails, changing
+  neither tree, if they overlap or aren't compatible (made
+  the same way: intrusive with the same offset, or with the
+  same allocator and no purge hook)
+*/
+int jsw_avljoin ( jsw_avltree_t *a, jsw_avltree_t *b )
+{
+  jsw_avlnode_t *hi, *lo;
+  jsw_avlset_t set;
+  int h;
+
+  if ( !compatible ( a, b ) )
+    return 0;
+
+  if ( a->root != NULL && b->root != NULL ) {
+    for ( hi = a->root; hi->link[1] != NULL; hi = hi->link[1] )
+      ;
+
+    for ( lo = b->root; lo->link[0] != NULL; lo = lo->link[0] )
+      ;
+
+    /* Duplicates are allowed, so equal ends are fine */
+    if ( CMP ( a, hi->data, lo->data ) > 0 )
+      return 0;
+  }
+
+  set_init ( &set, a->cmp, NULL, SET_UNION );
+  a->root = join2 ( &set, a->root, tree_height ( a->root ),
+    b->root, tree_height ( b->root ), &h );
+  a->size += b->size;
+  b->root = NULL;
+  b->size = 0;
+  STAT_ADD ( a, rotations, set.rotations );
+
+  return 1;
+}
+
+/*
+  Move the items not less than data into the empty tree
+  right, in O(log n) with JSW_RANK (without it the moved
+  items are counted). Fails, changing neither tree, if right
+  isn't empty or the trees aren't compatible
+*/
+int jsw_avlsplit ( jsw_avltree_t *tree, void *data, jsw_avltree_t *right )
+{
+  jsw_avlnode_t *found, *l, *r;
+  jsw_avlset_t set;
+  int hl, hr;
+  size_t n;
+
+  if ( right->root != NULL || !compatible ( tree, right ) )
+    return 0;
+
+  set_init ( &set, tree->cmp, NULL, SET_UNION );
+  found = split ( &set, tree->root, tree_height ( tree->root ), data,
+    &l, &hl, &r, &hr );
+
+  /* A matching item goes right, in front of the others */
+  if ( found != NULL )
+    r = join ( &set, NULL, 0, found, r, hr, &hr );
+
+  tree->root = l;
+  right->root = r;
+
+  n = count_nodes ( r );
+  tree->size -= n;
+  right->size = n;
+  STAT_ADD ( tree, cmps, set.cmps );
+  STAT_ADD ( tree, rotations, set.rotations );
+
+  return 1;
+}
+
+/*
+  Merge, intersect or subtract b into a in O(m log(n/m + 1))
+  for sizes m <= n, leaving b empty. Items in both keep a's
+  copy, and items leaving the trees are released with their
+  own tree's rel once any parallel tasks are done. With a
+  fork hook cmp has to be thread safe. The trees are then
+  treated as sets, so which duplicates match is unspecified.
+  Fails, changing neither tree, if they aren't compatible
+*/
+int jsw_avlunion ( jsw_avltree_t *a, jsw_avltree_t *b,
+                   const jsw_fork_t *fork )
+{
+  return set_op ( a, b, fork, SET_UNION );
+}
+
+int jsw_avlintersect ( jsw_avltree_t *a, jsw_avltree_t *b,
+                       const jsw_fork_t *fork )
+{
+  return set_op ( a, b, fork, SET_INTERSECT );
+}
+
+int jsw_avldifference ( jsw_avltree_t *a, jsw_avltree_t *b,
+                        const jsw_fork_t *fork )
+{
+  return set_op ( a, b, fork, SET_DIFFERENCE );
+}
+
 jsw_avltrav_t *jsw_avltnew ( void )
 {
   return malloc ( sizeof ( jsw_avltrav_t ) );
@@ -424,3 +1294,75 @@ void *jsw_avltprev ( jsw_avltrav_t *trav )
 {
   return move ( trav, 0 ); /* Toward smaller items */
 }
+
+/*
+  Start at the first item that isn't less than data,
+  or that is greater than data for an upper bound. The
+  path to the best candidate is kept for later moves
+*/
+static void *bound ( jsw_avltrav_t *trav, jsw_avltree_t *tree, void *data,
+                     int upper )
+{
+  jsw_avlnode_t *it = tree->root;
+  size_t top = 0;
+
+  trav->tree = tree;
+  trav->it = NULL;
+  trav->top = 0;
+
+  while ( it != NULL ) {
+    int cmp = CMP ( tree, it->data, data );
+
+    if ( cmp > 0 || ( cmp == 0 && !upper ) ) {
+      /* A candidate, but a better one could be to the left */
+      trav->it = it;
+      trav->top = top;
+
+      if ( cmp == 0 )
+        break;
+
+      trav->path[top++] = it;
+      it = it->link[0];
+    }
+    else {
+      trav->path[top++] = it;
+      it = it->link[1];
+    }
+  }
+
+  return trav->it == NULL ? NULL : trav->it->data;
+}
+
+void *jsw_avltlower ( jsw_avltrav_t *trav, jsw_avltree_t *tree, void *data )
+{
+  return bound ( trav, tree, data, 0 ); /* First item >= data */
+}
+
+void *jsw_avltupper ( jsw_avltrav_t *trav, jsw_avltree_t *tree, void *data )
+{
+  return bound ( trav, tree, data, 1 ); /* First item > data */
+}
+
+/*
+  Visit items from lo to hi inclusive in ascending order,
+  stopping early if visit returns 0. Returns the number of
+  items passed to visit
+*/
+size_t jsw_avlrange ( jsw_avltree_t *tree, void *lo, void *hi,
+                      visit_f visit, void *arg )
+{
+  jsw_avltrav_t trav;
+  void *it = bound ( &trav, tree, lo, 0 );
+  size_t n = 0;
+
+  while ( it != NULL && CMP ( tree, it, hi ) <= 0 ) {
+    ++n;
+
+    if ( !visit ( it, arg ) )
+      break;
+
+    it = move ( &trav, 1 );
+  }
+
+  return n;
+}
@@ -6,6 +6,11 @@
 
     > Created (Julienne Walker): June 17, 2003
     > Modified (Julienne Walker): September 24, 2005
+    > Modified (agent): October 14, 2026
+      Added allocator hooks, intrusive nodes, building
+      from sorted input, bounds and range visits, rank
+      and select, JSW_STATS counters, clear and set
+      operations
 
   This code is in the public domain. Anyone may
   use it or change it in any way that they see
@@ -28,22 +33,68 @@ extern "C" {
 #include <stddef.h>
 #endif
 
+#include "jsw_alloc.h"
+#include "jsw_common.h"
+
 /* Opaque types */
 typedef struct jsw_avltree jsw_avltree_t;
 typedef struct jsw_avltrav jsw_avltrav_t;
 
-/* User-defined item handling */
+/* Tree node, embed one in each item for intrusive trees */
+typedef struct jsw_avlnode {
+  int                 balance; /* Balance factor */
+  void               *data;    /* User-defined content */
+  struct jsw_avlnode *link[2]; /* Left (0) and right (1) links */
+#ifdef JSW_RANK
+  size_t              count;   /* Nodes in this subtree */
+#endif
+} jsw_avlnode_t;
+
+/* User-defined item handling, a NULL rel leaves items alone */
 typedef int   (*cmp_f) ( const void *p1, const void *p2 );
 typedef void *(*dup_f) ( void *p );
 typedef void  (*rel_f) ( void *p );
 
+/* Called for each item in a range, returns 0 to stop */
+typedef int   (*visit_f) ( void *p, void *arg );
+
 /* AVL tree functions */
 jsw_avltree_t *jsw_avlnew ( cmp_f cmp, dup_f dup, rel_f rel );
+jsw_avltree_t *jsw_avlnew_alloc ( cmp_f cmp, dup_f dup, rel_f rel,
+                                  const jsw_alloc_t *alloc );
+jsw_avltree_t *jsw_avlnew_intrusive ( cmp_f cmp, rel_f rel, size_t offset );
 void           jsw_avldelete ( jsw_avltree_t *tree );
+void           jsw_avlclear ( jsw_avltree_t *tree );
 void          *jsw_avlfind ( jsw_avltree_t *tree, void *data );
 int            jsw_avlinsert ( jsw_avltree_t *tree, void *data );
 int            jsw_avlerase ( jsw_avltree_t *tree, void *data );
 size_t         jsw_avlsize ( jsw_avltree_t *tree );
+int            jsw_avlstats ( jsw_avltree_t *tree, jsw_stats_t *stats );
+int            jsw_avlbuild ( jsw_avltree_t *tree, void **items, size_t n );
+size_t         jsw_avlrange ( jsw_avltree_t *tree, void *lo, void *hi,
+                              visit_f visit, void *arg );
+
+/*
+  Set operations, which move nodes between compatible trees:
+  both intrusive with the same offset, or both on the same
+  allocator without a purge hook, since either tree would
+  purge it when deleted
+*/
+int            jsw_avljoin ( jsw_avltree_t *a, jsw_avltree_t *b );
+int            jsw_avlsplit ( jsw_avltree_t *tree, void *data,
+                              jsw_avltree_t *right );
+int            jsw_avlunion ( jsw_avltree_t *a, jsw_avltree_t *b,
+                              const jsw_fork_t *fork );
+int            jsw_avlintersect ( jsw_avltree_t *a, jsw_avltree_t *b,
+                                  const jsw_fork_t *fork );
+int            jsw_avldifference ( jsw_avltree_t *a, jsw_avltree_t *b,
+                                   const jsw_fork_t *fork );
+
+#ifdef JSW_RANK
+/* Order statistics, when every file is built with JSW_RANK */
+void          *jsw_avlselect ( jsw_avltree_t *tree, size_t k );
+size_t         jsw_avlrank ( jsw_avltree_t *tree, void *data );
+#endif
 
 /* Traversal functions */
 jsw_avltrav_t *jsw_avltnew ( void );
@@ -52,6 +103,10 @@ void          *jsw_avltfirst ( jsw_avltrav_t *trav, jsw_avltree_t *tree );
 void          *jsw_avltlast ( jsw_avltrav_t *trav, jsw_avltree_t *tree );
 void          *jsw_avltnext ( jsw_avltrav_t *trav );
 void          *jsw_avltprev ( jsw_avltrav_t *trav );
+void          *jsw_avltlower ( jsw_avltrav_t *trav, jsw_avltree_t *tree,
+                               void *data );
+void          *jsw_avltupper ( jsw_avltrav_t *trav, jsw_avltree_t *tree,
+                               void *data );
 
 #ifdef __cplusplus
 }
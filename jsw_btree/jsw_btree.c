@@ -0,0 +1,960 @@
+/*
+  B+tree library
+
+    > Created (agent): October 14, 2026
+*/
+#include "jsw_btree.h"
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstring>
+
+using std::malloc;
+using std::free;
+using std::memcpy;
+using std::memmove;
+using std::size_t;
+#else
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#ifndef JSW_BORDER
+#define JSW_BORDER 32 /* Most items in a node, at least 3 */
+#endif
+
+#ifndef HEIGHT_LIMIT
+#define HEIGHT_LIMIT 64 /* Tallest allowable tree */
+#endif
+
+#define MIN_ITEMS ( JSW_BORDER / 2 ) /* Fewest items below the root */
+
+/*
+  Leaves use link[0] and link[1] for the previous and next
+  leaves, so only a branch is allocated with the whole array
+*/
+typedef struct jsw_bnode {
+  int               leaf;                 /* Holds items, not links */
+  int               n;                    /* Number of items in use */
+  void             *data[JSW_BORDER];     /* Items or separators, in order */
+  struct jsw_bnode *link[JSW_BORDER + 1]; /* Children, or leaf neighbors */
+} jsw_bnode_t;
+
+#define LEAF_SIZE ( offsetof ( jsw_bnode_t, link ) + 2 * sizeof ( jsw_bnode_t * ) )
+#define BRANCH_SIZE ( sizeof ( jsw_bnode_t ) )
+#define NODE_SIZE(node) ( (node)->leaf ? LEAF_SIZE : BRANCH_SIZE )
+
+struct jsw_btree {
+  jsw_bnode_t *root; /* Top of the tree */
+  cmp_f        cmp;  /* Compare two items */
+  dup_f        dup;  /* Clone an item (user-defined) */
+  rel_f        rel;  /* Destroy an item (user-defined) */
+  size_t       size; /* Number of items (user-defined) */
+  jsw_alloc_t  mem;  /* Node allocator */
+};
+
+struct jsw_btrav {
+  jsw_btree_t *tree; /* Paired tree */
+  jsw_bnode_t *it;   /* Current leaf */
+  int          pos;  /* Current item in the leaf */
+};
+
+/**
+  <summary>
+  Default node allocator hooks, using malloc and free
+  <summary>
+  <remarks>For jsw_btree.c internal use only</remarks>
+*/
+static void *std_alloc ( void *ctx, size_t size )
+{
+  (void)ctx;
+  return malloc ( size );
+}
+
+static void std_release ( void *ctx, void *p, size_t size )
+{
+  (void)ctx;
+  (void)size;
+  free ( p );
+}
+
+/**
+  <summary>
+  Allocates an empty leaf or branch
+  <summary>
+  <param name="tree">The tree this node is being created for</param>
+  <param name="leaf">1 for a leaf, 0 for a branch</param>
+  <returns>A pointer to the new node</returns>
+  <remarks>
+  For jsw_btree.c internal use only. The returned pointer
+  must be freed using the same tree's release hook
+  </remarks>
+*/
+static jsw_bnode_t *new_node ( jsw_btree_t *tree, int leaf )
+{
+  jsw_bnode_t *node = (jsw_bnode_t *)tree->mem.alloc ( tree->mem.ctx,
+    leaf ? LEAF_SIZE : BRANCH_SIZE );
+
+  if ( node == NULL )
+    return NULL;
+
+  node->leaf = leaf;
+  node->n = 0;
+  node->link[0] = node->link[1] = NULL;
+
+  return node;
+}
+
+static void release_node ( jsw_btree_t *tree, jsw_bnode_t *node )
+{
+  tree->mem.release ( tree->mem.ctx, node, NODE_SIZE ( node ) );
+}
+
+/**
+  <summary>
+  Binary search within one node
+  <summary>
+  <param name="tree">The tree the node belongs to</param>
+  <param name="node">The node to search</param>
+  <param name="data">The data value to search for</param>
+  <param name="found">Set to 1 on an exact match, 0 otherwise</param>
+  <returns>
+  The index of the match, or of the first larger item
+  </returns>
+  <remarks>
+  For jsw_btree.c internal use only. An exact match stops
+  the search, so no item is compared twice
+  </remarks>
+*/
+static int search ( jsw_btree_t *tree, jsw_bnode_t *node, void *data,
+                    int *found )
+{
+  int lo = 0, hi = node->n;
+
+  while ( lo < hi ) {
+    int mid = ( lo + hi ) / 2;
+    int cmp = tree->cmp ( node->data[mid], data );
+
+    if ( cmp == 0 ) {
+      *found = 1;
+      return mid;
+    }
+
+    if ( cmp < 0 )
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  *found = 0;
+
+  return lo;
+}
+
+/**
+  <summary>
+  Creates and initializes an empty B+tree with user-defined
+  comparison, data copy, and data release operations
+  <summary>
+  <param name="cmp">User-defined data comparison function</param>
+  <param name="dup">User-defined data copy function</param>
+  <param name="rel">User-defined data release function</param>
+  <returns>A pointer to the new tree</returns>
+  <remarks>
+  The returned pointer must be released with jsw_bdelete
+  </remarks>
+*/
+jsw_btree_t *jsw_bnew ( cmp_f cmp, dup_f dup, rel_f rel )
+{
+  return jsw_bnew_alloc ( cmp, dup, rel, NULL );
+}
+
+/**
+  <summary>
+  Creates and initializes an empty B+tree whose
+  nodes come from a user-defined allocator
+  <summary>
+  <param name="cmp">User-defined data comparison function</param>
+  <param name="dup">User-defined data copy function</param>
+  <param name="rel">User-defined data release function</param>
+  <param name="alloc">Node allocator hooks, or NULL for malloc</param>
+  <returns>A pointer to the new tree</returns>
+  <remarks>
+  The hooks are copied. Leaves and branches have different
+  sizes. The returned pointer must be released with jsw_bdelete
+  </remarks>
+*/
+jsw_btree_t *jsw_bnew_alloc ( cmp_f cmp, dup_f dup, rel_f rel,
+                              const jsw_alloc_t *alloc )
+{
+  jsw_btree_t *bt = (jsw_btree_t *)malloc ( sizeof *bt );
+
+  if ( bt == NULL )
+    return NULL;
+
+  bt->root = NULL;
+  bt->cmp = cmp;
+  bt->dup = dup;
+  bt->rel = rel;
+  bt->size = 0;
+
+  if ( alloc != NULL )
+    bt->mem = *alloc;
+  else {
+    bt->mem.alloc = std_alloc;
+    bt->mem.release = std_release;
+    bt->mem.purge = NULL;
+    bt->mem.ctx = NULL;
+  }
+
+  return bt;
+}
+
+/**
+  <summary>
+  Releases every item and node in a subtree
+  <summary>
+  <param name="tree">The tree the nodes belong to</param>
+  <param name="node">The subtree to release</param>
+  <remarks>
+  For jsw_btree.c internal use only. Recursion is safe
+  because every leaf is at the same, shallow depth
+  </remarks>
+*/
+static void release_tree ( jsw_btree_t *tree, jsw_bnode_t *node )
+{
+  int i;
+
+  if ( node->leaf ) {
+    for ( i = 0; i < node->n; i++ )
+      tree->rel ( node->data[i] );
+  }
+  else {
+    for ( i = 0; i <= node->n; i++ )
+      release_tree ( tree, node->link[i] );
+  }
+
+  if ( tree->mem.purge == NULL )
+    release_node ( tree, node );
+}
+
+/**
+  <summary>
+  Releases a valid B+tree
+  <summary>
+  <param name="tree">The tree to release</param>
+  <remarks>
+  The tree must have been created using jsw_bnew. With a
+  purge hook, nodes are released all at once by the allocator
+  </remarks>
+*/
+void jsw_bdelete ( jsw_btree_t *tree )
+{
+  if ( tree->root != NULL )
+    release_tree ( tree, tree->root );
+
+  if ( tree->mem.purge != NULL )
+    tree->mem.purge ( tree->mem.ctx );
+
+  free ( tree );
+}
+
+/**
+  <summary>
+  Search for a copy of the specified
+  node data in a B+tree
+  <summary>
+  <param name="tree">The tree to search</param>
+  <param name="data">The data value to search for</param>
+  <returns>
+  A pointer to the data value stored in the tree,
+  or a null pointer if no data could be found
+  </returns>
+*/
+void *jsw_bfind ( jsw_btree_t *tree, void *data )
+{
+  jsw_bnode_t *it = tree->root;
+
+  while ( it != NULL ) {
+    int found;
+    int i = search ( tree, it, data, &found );
+
+    if ( it->leaf )
+      return found ? it->data[i] : NULL;
+
+    /* A separator equal to data starts the subtree to its right */
+    it = it->link[i + found];
+  }
+
+  return NULL;
+}
+
+/**
+  <summary>
+  Adds an item, and the link to its right for a branch,
+  to a node that has room
+  <summary>
+  <param name="node">The node to change</param>
+  <param name="pos">Where the item goes</param>
+  <param name="data">The item or separator</param>
+  <param name="right">The new child after data, for branches</param>
+  <remarks>For jsw_btree.c internal use only</remarks>
+*/
+static void put ( jsw_bnode_t *node, int pos, void *data, jsw_bnode_t *right )
+{
+  memmove ( node->data + pos + 1, node->data + pos,
+    ( node->n - pos ) * sizeof node->data[0] );
+  node->data[pos] = data;
+
+  if ( !node->leaf ) {
+    memmove ( node->link + pos + 2, node->link + pos + 1,
+      ( node->n - pos ) * sizeof node->link[0] );
+    node->link[pos + 1] = right;
+  }
+
+  ++node->n;
+}
+
+/**
+  <summary>
+  Splits a full node around an item that doesn't fit
+  <summary>
+  <param name="node">The full node, which keeps the lower half</param>
+  <param name="pos">Where the new item goes</param>
+  <param name="data">The new item or separator</param>
+  <param name="right">The new child after data, for branches</param>
+  <param name="sibling">An empty node that takes the upper half</param>
+  <returns>The separator to add to the parent</returns>
+  <remarks>
+  For jsw_btree.c internal use only. A leaf copies its new
+  first item up, while a branch moves its middle separator up
+  </remarks>
+*/
+static void *split ( jsw_bnode_t *node, int pos, void *data,
+                     jsw_bnode_t *right, jsw_bnode_t *sibling )
+{
+  void        *items[JSW_BORDER + 1];
+  jsw_bnode_t *links[JSW_BORDER + 2];
+  int          i, half;
+
+  memcpy ( items, node->data, pos * sizeof items[0] );
+  items[pos] = data;
+  memcpy ( items + pos + 1, node->data + pos,
+    ( JSW_BORDER - pos ) * sizeof items[0] );
+
+  if ( node->leaf ) {
+    half = ( JSW_BORDER + 1 ) / 2;
+    node->n = half;
+    sibling->n = JSW_BORDER + 1 - half;
+    memcpy ( node->data, items, half * sizeof items[0] );
+    memcpy ( sibling->data, items + half, sibling->n * sizeof items[0] );
+
+    /* Splice the new leaf into the chain */
+    sibling->link[0] = node;
+    sibling->link[1] = node->link[1];
+
+    if ( node->link[1] != NULL )
+      node->link[1]->link[0] = sibling;
+
+    node->link[1] = sibling;
+
+    return sibling->data[0];
+  }
+
+  memcpy ( links, node->link, ( pos + 1 ) * sizeof links[0] );
+  links[pos + 1] = right;
+  memcpy ( links + pos + 2, node->link + pos + 1,
+    ( JSW_BORDER - pos ) * sizeof links[0] );
+
+  half = JSW_BORDER / 2;
+  node->n = half;
+  sibling->n = JSW_BORDER - half;
+
+  for ( i = 0; i < half; i++ ) {
+    node->data[i] = items[i];
+    node->link[i] = links[i];
+  }
+
+  node->link[half] = links[half];
+
+  for ( i = 0; i < sibling->n; i++ ) {
+    sibling->data[i] = items[half + 1 + i];
+    sibling->link[i] = links[half + 1 + i];
+  }
+
+  sibling->link[sibling->n] = links[JSW_BORDER + 1];
+
+  return items[half];
+}
+
+/**
+  <summary>
+  Insert a copy of the user-specified
+  data into a B+tree
+  <summary>
+  <param name="tree">The tree to insert into</param>
+  <param name="data">The data value to insert</param>
+  <returns>
+  1 if the value was inserted successfully,
+  0 if the insertion failed for any reason
+  </returns>
+  <remarks>
+  Every node that has to split is allocated up front,
+  so a failed allocation leaves the tree unchanged
+  </remarks>
+*/
+int jsw_binsert ( jsw_btree_t *tree, void *data )
+{
+  jsw_bnode_t *path[HEIGHT_LIMIT];  /* Nodes from the root down */
+  int          at[HEIGHT_LIMIT];    /* Position taken in each node */
+  jsw_bnode_t *spare[HEIGHT_LIMIT]; /* New nodes for splits */
+  jsw_bnode_t *it = tree->root, *right = NULL;
+  int          top = 0, nspare = 0, used = 0, found, i;
+  void        *item;
+
+  if ( it == NULL ) {
+    it = new_node ( tree, 1 );
+
+    if ( it == NULL )
+      return 0;
+
+    it->data[0] = tree->dup ( data );
+    it->n = 1;
+    tree->root = it;
+    tree->size = 1;
+
+    return 1;
+  }
+
+  for ( ;; ) {
+    i = search ( tree, it, data, &found );
+    path[top] = it;
+
+    if ( it->leaf ) {
+      /* Don't allow duplicates */
+      if ( found )
+        return 0;
+
+      at[top++] = i;
+      break;
+    }
+
+    at[top++] = i + found;
+    it = it->link[i + found];
+  }
+
+  /* Full nodes from the leaf up split, plus a new root if they all do */
+  for ( i = top - 1; i >= 0 && path[i]->n == JSW_BORDER; i-- )
+    ++nspare;
+
+  if ( i < 0 )
+    ++nspare;
+
+  for ( i = 0; i < nspare; i++ ) {
+    spare[i] = new_node ( tree, i == 0 );
+
+    if ( spare[i] == NULL ) {
+      while ( --i >= 0 )
+        release_node ( tree, spare[i] );
+
+      return 0;
+    }
+  }
+
+  item = tree->dup ( data );
+
+  for ( i = top - 1; i >= 0; i-- ) {
+    if ( path[i]->n < JSW_BORDER ) {
+      put ( path[i], at[i], item, right );
+      break;
+    }
+
+    item = split ( path[i], at[i], item, right, spare[used] );
+    right = spare[used++];
+  }
+
+  if ( i < 0 ) {
+    /* The root split, so the tree grows a level */
+    jsw_bnode_t *root = spare[used];
+
+    root->n = 1;
+    root->data[0] = item;
+    root->link[0] = tree->root;
+    root->link[1] = right;
+    tree->root = root;
+  }
+
+  ++tree->size;
+
+  return 1;
+}
+
+/**
+  <summary>
+  Moves one item from link[j] to link[j + 1], rotating
+  through the separator between them
+  <summary>
+  <param name="up">The parent of both nodes</param>
+  <param name="j">The separator between the nodes</param>
+  <remarks>For jsw_btree.c internal use only</remarks>
+*/
+static void shift_right ( jsw_bnode_t *up, int j )
+{
+  jsw_bnode_t *l = up->link[j], *r = up->link[j + 1];
+
+  memmove ( r->data + 1, r->data, r->n * sizeof r->data[0] );
+
+  if ( r->leaf ) {
+    r->data[0] = l->data[--l->n];
+    up->data[j] = r->data[0];
+  }
+  else {
+    memmove ( r->link + 1, r->link, ( r->n + 1 ) * sizeof r->link[0] );
+    r->data[0] = up->data[j];
+    r->link[0] = l->link[l->n];
+    up->data[j] = l->data[--l->n];
+  }
+
+  ++r->n;
+}
+
+/**
+  <summary>
+  Moves one item from link[j + 1] to link[j], rotating
+  through the separator between them
+  <summary>
+  <param name="up">The parent of both nodes</param>
+  <param name="j">The separator between the nodes</param>
+  <remarks>For jsw_btree.c internal use only</remarks>
+*/
+static void shift_left ( jsw_bnode_t *up, int j )
+{
+  jsw_bnode_t *l = up->link[j], *r = up->link[j + 1];
+
+  if ( l->leaf ) {
+    l->data[l->n++] = r->data[0];
+    memmove ( r->data, r->data + 1, --r->n * sizeof r->data[0] );
+    up->data[j] = r->data[0];
+  }
+  else {
+    l->data[l->n] = up->data[j];
+    l->link[++l->n] = r->link[0];
+    up->data[j] = r->data[0];
+    --r->n;
+    memmove ( r->data, r->data + 1, r->n * sizeof r->data[0] );
+    memmove ( r->link, r->link + 1, ( r->n + 1 ) * sizeof r->link[0] );
+  }
+}
+
+/**
+  <summary>
+  Merges link[j + 1] into link[j] and drops the
+  separator between them from the parent
+  <summary>
+  <param name="tree">The tree the nodes belong to</param>
+  <param name="up">The parent of both nodes</param>
+  <param name="j">The separator between the nodes</param>
+  <remarks>For jsw_btree.c internal use only</remarks>
+*/
+static void merge ( jsw_btree_t *tree, jsw_bnode_t *up, int j )
+{
+  jsw_bnode_t *l = up->link[j], *r = up->link[j + 1];
+
+  if ( l->leaf ) {
+    l->link[1] = r->link[1];
+
+    if ( r->link[1] != NULL )
+      r->link[1]->link[0] = l;
+  }
+  else {
+    /* A branch pulls the separator down between the halves */
+    l->data[l->n++] = up->data[j];
+    memcpy ( l->link + l->n, r->link, ( r->n + 1 ) * sizeof r->link[0] );
+  }
+
+  memcpy ( l->data + l->n, r->data, r->n * sizeof r->data[0] );
+  l->n += r->n;
+  release_node ( tree, r );
+
+  --up->n;
+  memmove ( up->data + j, up->data + j + 1, ( up->n - j ) * sizeof up->data[0] );
+  memmove ( up->link + j + 1, up->link + j + 2,
+    ( up->n - j ) * sizeof up->link[0] );
+}
+
+/**
+  <summary>
+  Remove a data value from a B+tree
+  <summary>
+  <param name="tree">The tree to remove from</param>
+  <param name="data">The data value to remove</param>
+  <returns>
+  1 if the value was removed successfully,
+  0 if the value wasn't found
+  </returns>
+  <remarks>
+  Underfull nodes borrow from a sibling when it can spare an
+  item and merge with it otherwise, from the leaf up
+  </remarks>
+*/
+int jsw_berase ( jsw_btree_t *tree, void *data )
+{
+  jsw_bnode_t *path[HEIGHT_LIMIT]; /* Nodes from the root down */
+  int          at[HEIGHT_LIMIT];   /* Position taken in each node */
+  jsw_bnode_t *it = tree->root, *leaf;
+  int          top = 0, is_sep = 0, found, i;
+  void        *old;
+
+  if ( it == NULL )
+    return 0;
+
+  for ( ;; ) {
+    i = search ( tree, it, data, &found );
+    path[top] = it;
+
+    if ( it->leaf ) {
+      if ( !found )
+        return 0;
+
+      at[top++] = i;
+      break;
+    }
+
+    is_sep |= found;
+    at[top++] = i + found;
+    it = it->link[i + found];
+  }
+
+  leaf = path[top - 1];
+  old = leaf->data[at[top - 1]];
+  --leaf->n;
+  memmove ( leaf->data + at[top - 1], leaf->data + at[top - 1] + 1,
+    ( leaf->n - at[top - 1] ) * sizeof leaf->data[0] );
+
+  for ( i = top - 1; i > 0 && path[i]->n < MIN_ITEMS; i-- ) {
+    jsw_bnode_t *up = path[i - 1];
+    int ci = at[i - 1];
+
+    if ( ci > 0 && up->link[ci - 1]->n > MIN_ITEMS )
+      shift_right ( up, ci - 1 );
+    else if ( ci < up->n && up->link[ci + 1]->n > MIN_ITEMS )
+      shift_left ( up, ci );
+    else if ( ci > 0 )
+      merge ( tree, up, ci - 1 );
+    else
+      merge ( tree, up, ci );
+  }
+
+  /* An empty root gives way to its only child */
+  if ( tree->root->n == 0 ) {
+    jsw_bnode_t *save = tree->root;
+
+    tree->root = save->leaf ? NULL : save->link[0];
+    release_node ( tree, save );
+  }
+
+  /*
+    A separator can still point at the removed item, so it's
+    replaced with the smallest item to its right, which may
+    have moved during rebalancing
+  */
+  if ( is_sep ) {
+    it = tree->root;
+
+    while ( it != NULL && !it->leaf ) {
+      i = search ( tree, it, old, &found );
+
+      if ( found ) {
+        jsw_bnode_t *heir = it->link[i + 1];
+
+        while ( !heir->leaf )
+          heir = heir->link[0];
+
+        it->data[i] = heir->data[0];
+        break;
+      }
+
+      it = it->link[i];
+    }
+  }
+
+  tree->rel ( old );
+  --tree->size;
+
+  return 1;
+}
+
+/**
+  <summary>
+  Gets the number of items in a B+tree
+  <summary>
+  <param name="tree">The tree to calculate a size for</param>
+  <returns>The number of items in the tree</returns>
+*/
+size_t jsw_bsize ( jsw_btree_t *tree )
+{
+  return tree->size;
+}
+
+/**
+  <summary>
+  Create a new traversal object
+  <summary>
+  <returns>A pointer to the new object</returns>
+  <remarks>
+  The traversal object is not initialized until
+  jsw_btfirst or jsw_btlast are called.
+  The pointer must be released with jsw_btdelete
+  </remarks>
+*/
+jsw_btrav_t *jsw_btnew ( void )
+{
+  return (jsw_btrav_t*)malloc ( sizeof ( jsw_btrav_t ) );
+}
+
+/**
+  <summary>
+  Release a traversal object
+  <summary>
+  <param name="trav">The object to release</param>
+  <remarks>
+  The object must have been created with jsw_btnew
+  </remarks>
+*/
+void jsw_btdelete ( jsw_btrav_t *trav )
+{
+  free ( trav );
+}
+
+/**
+  <summary>
+  Initialize a traversal object. The user-specified
+  direction determines whether to begin traversal at the
+  smallest or largest valued item
+  <summary>
+  <param name="trav">The traversal object to initialize</param>
+  <param name="tree">The tree that the object will be attached to</param>
+  <param name="dir">
+  The direction to traverse (0 = ascending, 1 = descending)
+  </param>
+  <returns>A pointer to the smallest or largest data value</returns>
+  <remarks>For jsw_btree.c internal use only</remarks>
+*/
+static void *start ( jsw_btrav_t *trav, jsw_btree_t *tree, int dir )
+{
+  trav->tree = tree;
+  trav->it = tree->root;
+  trav->pos = 0;
+
+  if ( trav->it == NULL )
+    return NULL;
+
+  while ( !trav->it->leaf )
+    trav->it = trav->it->link[dir ? trav->it->n : 0];
+
+  trav->pos = dir ? trav->it->n - 1 : 0;
+
+  return trav->it->data[trav->pos];
+}
+
+/**
+  <summary>
+  Traverse a B+tree in the user-specified direction
+  <summary>
+  <param name="trav">The initialized traversal object</param>
+  <param name="dir">
+  The direction to traverse (0 = descending, 1 = ascending)
+  </param>
+  <returns>
+  A pointer to the next data value in the specified direction
+  </returns>
+  <remarks>
+  For jsw_btree.c internal use only. The leaf links match
+  dir, so crossing into a neighbor is a single step
+  </remarks>
+*/
+static void *move ( jsw_btrav_t *trav, int dir )
+{
+  trav->pos += dir ? 1 : -1;
+
+  if ( trav->pos < 0 || trav->pos >= trav->it->n ) {
+    trav->it = trav->it->link[dir];
+
+    if ( trav->it == NULL )
+      return NULL;
+
+    trav->pos = dir ? 0 : trav->it->n - 1;
+  }
+
+  return trav->it->data[trav->pos];
+}
+
+/**
+  <summary>
+  Initialize a traversal object to the smallest valued item
+  <summary>
+  <param name="trav">The traversal object to initialize</param>
+  <param name="tree">The tree that the object will be attached to</param>
+  <returns>A pointer to the smallest data value</returns>
+*/
+void *jsw_btfirst ( jsw_btrav_t *trav, jsw_btree_t *tree )
+{
+  return start ( trav, tree, 0 ); /* Min value */
+}
+
+/**
+  <summary>
+  Initialize a traversal object to the largest valued item
+  <summary>
+  <param name="trav">The traversal object to initialize</param>
+  <param name="tree">The tree that the object will be attached to</param>
+  <returns>A pointer to the largest data value</returns>
+*/
+void *jsw_btlast ( jsw_btrav_t *trav, jsw_btree_t *tree )
+{
+  return start ( trav, tree, 1 ); /* Max value */
+}
+
+/**
+  <summary>
+  Traverse to the next value in ascending order
+  <summary>
+  <param name="trav">The initialized traversal object</param>
+  <returns>A pointer to the next value in ascending order</returns>
+*/
+void *jsw_btnext ( jsw_btrav_t *trav )
+{
+  return move ( trav, 1 ); /* Toward larger items */
+}
+
+/**
+  <summary>
+  Traverse to the next value in descending order
+  <summary>
+  <param name="trav">The initialized traversal object</param>
+  <returns>A pointer to the next value in descending order</returns>
+*/
+void *jsw_btprev ( jsw_btrav_t *trav )
+{
+  return move ( trav, 0 ); /* Toward smaller items */
+}
+
+/**
+  <summary>
+  Initialize a traversal object to the first item that isn't
+  less than data, or that is greater than data for an upper bound
+  <summary>
+  <param name="trav">The traversal object to initialize</param>
+  <param name="tree">The tree that the object will be attached to</param>
+  <param name="data">The data value to search for</param>
+  <param name="upper">1 to skip an equal item, 0 to stop on it</param>
+  <returns>A pointer to the data value found, or NULL if none</returns>
+  <remarks>
+  For jsw_btree.c internal use only. Only one leaf is searched,
+  and the answer is at worst the first item of the next leaf
+  </remarks>
+*/
+static void *bound ( jsw_btrav_t *trav, jsw_btree_t *tree, void *data,
+                     int upper )
+{
+  jsw_bnode_t *it = tree->root;
+  int found, i;
+
+  trav->tree = tree;
+  trav->it = NULL;
+  trav->pos = 0;
+
+  if ( it == NULL )
+    return NULL;
+
+  for ( ;; ) {
+    i = search ( tree, it, data, &found );
+
+    if ( it->leaf )
+      break;
+
+    it = it->link[i + found];
+  }
+
+  if ( found && upper )
+    ++i;
+
+  if ( i == it->n ) {
+    it = it->link[1];
+    i = 0;
+
+    if ( it == NULL )
+      return NULL;
+  }
+
+  trav->it = it;
+  trav->pos = i;
+
+  return it->data[i];
+}
+
+/**
+  <summary>
+  Initialize a traversal object to the smallest item
+  that isn't less than the specified data
+  <summary>
+  <param name="trav">The traversal object to initialize</param>
+  <param name="tree">The tree that the object will be attached to</param>
+  <param name="data">The data value to search for</param>
+  <returns>A pointer to the data value found, or NULL if none</returns>
+*/
+void *jsw_btlower ( jsw_btrav_t *trav, jsw_btree_t *tree, void *data )
+{
+  return bound ( trav, tree, data, 0 );
+}
+
+/**
+  <summary>
+  Initialize a traversal object to the smallest item
+  that is greater than the specified data
+  <summary>
+  <param name="trav">The traversal object to initialize</param>
+  <param name="tree">The tree that the object will be attached to</param>
+  <param name="data">The data value to search for</param>
+  <returns>A pointer to the data value found, or NULL if none</returns>
+*/
+void *jsw_btupper ( jsw_btrav_t *trav, jsw_btree_t *tree, void *data )
+{
+  return bound ( trav, tree, data, 1 );
+}
+
+/**
+  <summary>
+  Visit the items from lo to hi, inclusive, in ascending order
+  <summary>
+  <param name="tree">The tree to search</param>
+  <param name="lo">The smallest data value to visit</param>
+  <param name="hi">The largest data value to visit</param>
+  <param name="visit">Called with each item and arg</param>
+  <param name="arg">User-defined argument for visit</param>
+  <returns>The number of items passed to visit</returns>
+  <remarks>
+  The walk stops at the first item past hi, or as soon as
+  visit returns 0. After the first leaf it is a sequential
+  scan along the leaf links. The tree must not change
+  during the walk
+  </remarks>
+*/
+size_t jsw_brange ( jsw_btree_t *tree, void *lo, void *hi,
+                    visit_f visit, void *arg )
+{
+  jsw_btrav_t trav;
+  void *it = bound ( &trav, tree, lo, 0 );
+  size_t n = 0;
+
+  while ( it != NULL && tree->cmp ( it, hi ) <= 0 ) {
+    ++n;
+
+    if ( !visit ( it, arg ) )
+      break;
+
+    it = move ( &trav, 1 );
+  }
+
+  return n;
+}
@@ -0,0 +1,76 @@
+#ifndef JSW_BTREE_H
+#define JSW_BTREE_H
+
+/*
+  B+tree library
+
+    > Created (agent): October 14, 2026
+
+  Items live in wide leaves that are linked in order, so a
+  lookup touches one node per level and a traversal walks
+  the leaves sequentially. Branches hold only separators.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+#ifdef __cplusplus
+#include <cstddef>
+
+using std::size_t;
+
+extern "C" {
+#else
+#include <stddef.h>
+#endif
+
+#include "jsw_alloc.h"
+
+/* Opaque types */
+typedef struct jsw_btree jsw_btree_t;
+typedef struct jsw_btrav jsw_btrav_t;
+
+/* User-defined item handling */
+typedef int   (*cmp_f) ( const void *p1, const void *p2 );
+typedef void *(*dup_f) ( void *p );
+typedef void  (*rel_f) ( void *p );
+
+/* Called for each item in a range, returns 0 to stop */
+typedef int   (*visit_f) ( void *p, void *arg );
+
+/* B+tree functions */
+jsw_btree_t *jsw_bnew ( cmp_f cmp, dup_f dup, rel_f rel );
+jsw_btree_t *jsw_bnew_alloc ( cmp_f cmp, dup_f dup, rel_f rel,
+                              const jsw_alloc_t *alloc );
+void         jsw_bdelete ( jsw_btree_t *tree );
+void        *jsw_bfind ( jsw_btree_t *tree, void *data );
+int          jsw_binsert ( jsw_btree_t *tree, void *data );
+int          jsw_berase ( jsw_btree_t *tree, void *data );
+size_t       jsw_bsize ( jsw_btree_t *tree );
+size_t       jsw_brange ( jsw_btree_t *tree, void *lo, void *hi,
+                          visit_f visit, void *arg );
+
+/* Traversal functions */
+jsw_btrav_t *jsw_btnew ( void );
+void         jsw_btdelete ( jsw_btrav_t *trav );
+void        *jsw_btfirst ( jsw_btrav_t *trav, jsw_btree_t *tree );
+void        *jsw_btlast ( jsw_btrav_t *trav, jsw_btree_t *tree );
+void        *jsw_btnext ( jsw_btrav_t *trav );
+void        *jsw_btprev ( jsw_btrav_t *trav );
+void        *jsw_btlower ( jsw_btrav_t *trav, jsw_btree_t *tree,
+                           void *data );
+void        *jsw_btupper ( jsw_btrav_t *trav, jsw_btree_t *tree,
+                           void *data );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
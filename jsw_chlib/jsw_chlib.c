@@ -0,0 +1,475 @@
+/*
+  Concurrent hash table library
+
+    > Created (agent): October 14, 2026
+
+  Bucket and stripe both come from the low bits of the
+  mixed hash, and the capacity is a power of two no less
+  than the stripe count, so every bucket belongs to one
+  stripe for the life of the table and a resize never
+  moves a key to a different stripe.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+#include "jsw_chlib.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#ifndef JSW_CHSTRIPES
+#define JSW_CHSTRIPES 64 /* Stripes when the caller asks for zero */
+#endif
+
+typedef struct jsw_chnode {
+  void              *key;  /* Key used for searching */
+  void              *item; /* Actual content of a node */
+  unsigned           hash; /* Full mixed hash of the key */
+  struct jsw_chnode *next; /* Next link in the chain */
+} jsw_chnode_t;
+
+/* One lock per stripe, padded so neighbours never share a cache line */
+typedef union jsw_stripe {
+  struct {
+    pthread_rwlock_t lock; /* Guards every bucket in the stripe */
+    size_t           size; /* Items in the stripe's buckets */
+  } s;
+  char pad[128];
+} jsw_stripe_t;
+
+struct jsw_chash {
+  jsw_chnode_t **table;    /* Chains, guarded by their stripes */
+  size_t         capacity; /* Current table size, changed under every stripe */
+  double         maxload;  /* Load factor that triggers growth (0 = never) */
+  jsw_stripe_t  *stripes;  /* Lock stripes */
+  size_t         nstripes; /* Number of stripes, a power of two */
+  hash_f         hash;     /* User defined key hash function */
+  cmp_f          cmp;      /* User defined key comparison function */
+  keydup_f       keydup;   /* User defined key copy function */
+  itemdup_f      itemdup;  /* User defined item copy function */
+  keyrel_f       keyrel;   /* User defined key delete function */
+  itemrel_f      itemrel;  /* User defined item delete function */
+};
+
+/*
+  Hash a key for this table. Buckets and stripes are both
+  picked with a mask, so the user hash gets the MurmurHash3
+  finalizer to spread weak hashes across the low bits
+*/
+static unsigned hash_key ( jsw_chash_t *htab, const void *key )
+{
+  unsigned h = htab->hash ( key );
+
+  h ^= h >> 16;
+  h *= 0x85ebca6bU;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35U;
+  h ^= h >> 16;
+
+  return h;
+}
+
+/* Stands in for a NULL keyrel or itemrel */
+static void no_rel ( void *p )
+{
+  (void)p;
+}
+
+/* Smallest power of two at least size, or 0 on overflow */
+static size_t pow2 ( size_t size )
+{
+  size_t n = 1;
+
+  while ( n < size ) {
+    if ( n > (size_t)-1 / 2 )
+      return 0;
+
+    n *= 2;
+  }
+
+  return n;
+}
+
+static jsw_stripe_t *stripe_for ( jsw_chash_t *htab, unsigned h )
+{
+  return &htab->stripes[h & ( htab->nstripes - 1 )];
+}
+
+/* Search a chain for key, checking stored hashes first */
+static jsw_chnode_t *chain_find ( jsw_chash_t *htab, jsw_chnode_t *it,
+  const void *key, unsigned h )
+{
+  for ( ; it != NULL; it = it->next ) {
+    if ( it->hash == h && htab->cmp ( key, it->key ) == 0 )
+      return it;
+  }
+
+  return NULL;
+}
+
+/* Take every stripe in order, so two resizes can't deadlock */
+static void lock_all ( jsw_chash_t *htab, int write )
+{
+  size_t i;
+
+  for ( i = 0; i < htab->nstripes; i++ ) {
+    if ( write )
+      pthread_rwlock_wrlock ( &htab->stripes[i].s.lock );
+    else
+      pthread_rwlock_rdlock ( &htab->stripes[i].s.lock );
+  }
+}
+
+static void unlock_all ( jsw_chash_t *htab )
+{
+  size_t i;
+
+  for ( i = htab->nstripes; i-- > 0; )
+    pthread_rwlock_unlock ( &htab->stripes[i].s.lock );
+}
+
+/*
+  Move every node into a table of new_size buckets.
+  The caller holds every stripe
+
+  Returns: non-zero for success, zero for failure
+*/
+static int rehash ( jsw_chash_t *htab, size_t new_size )
+{
+  jsw_chnode_t **new_table;
+  jsw_chnode_t *it, *next;
+  size_t i;
+
+  if ( new_size < htab->nstripes )
+    new_size = htab->nstripes;
+
+  new_size = pow2 ( new_size );
+
+  if ( new_size == 0 )
+    return 0;
+
+  new_table = (jsw_chnode_t **)calloc ( new_size, sizeof *new_table );
+
+  if ( new_table == NULL )
+    return 0;
+
+  /* Nodes carry their hash, so nothing can fail from here */
+  for ( i = 0; i < htab->capacity; i++ ) {
+    for ( it = htab->table[i]; it != NULL; it = next ) {
+      size_t h = it->hash & ( new_size - 1 );
+
+      next = it->next;
+      it->next = new_table[h];
+      new_table[h] = it;
+    }
+  }
+
+  free ( htab->table );
+  htab->table = new_table;
+  htab->capacity = new_size;
+
+  return 1;
+}
+
+/*
+  Double a table that was seen at capacity cap. Another
+  thread may have grown it while we waited for the locks
+*/
+static void grow ( jsw_chash_t *htab, size_t cap )
+{
+  lock_all ( htab, 1 );
+
+  if ( htab->capacity == cap && cap <= (size_t)-1 / 2 )
+    rehash ( htab, cap * 2 );
+
+  unlock_all ( htab );
+}
+
+jsw_chash_t *jsw_chnew ( size_t size, size_t stripes,
+  hash_f hash, cmp_f cmp, keydup_f keydup, itemdup_f itemdup,
+  keyrel_f keyrel, itemrel_f itemrel )
+{
+  jsw_chash_t *htab = (jsw_chash_t *)malloc ( sizeof *htab );
+  size_t i;
+
+  if ( htab == NULL )
+    return NULL;
+
+  if ( stripes == 0 )
+    stripes = JSW_CHSTRIPES;
+
+  stripes = pow2 ( stripes );
+  size = pow2 ( size < stripes ? stripes : size );
+
+  if ( stripes == 0 || size == 0 ) {
+    free ( htab );
+    return NULL;
+  }
+
+  htab->table = (jsw_chnode_t **)calloc ( size, sizeof *htab->table );
+  htab->stripes = (jsw_stripe_t *)malloc ( stripes * sizeof *htab->stripes );
+
+  if ( htab->table == NULL || htab->stripes == NULL ) {
+    free ( htab->table );
+    free ( htab->stripes );
+    free ( htab );
+    return NULL;
+  }
+
+  for ( i = 0; i < stripes; i++ ) {
+    if ( pthread_rwlock_init ( &htab->stripes[i].s.lock, NULL ) != 0 ) {
+      while ( i-- > 0 )
+        pthread_rwlock_destroy ( &htab->stripes[i].s.lock );
+
+      free ( htab->table );
+      free ( htab->stripes );
+      free ( htab );
+      return NULL;
+    }
+
+    htab->stripes[i].s.size = 0;
+  }
+
+  htab->capacity = size;
+  htab->maxload = 0;
+  htab->nstripes = stripes;
+  htab->hash = hash;
+  htab->cmp = cmp;
+  htab->keydup = keydup;
+  htab->itemdup = itemdup;
+  htab->keyrel = keyrel != NULL ? keyrel : no_rel;
+  htab->itemrel = itemrel != NULL ? itemrel : no_rel;
+
+  return htab;
+}
+
+void jsw_chdelete ( jsw_chash_t *htab )
+{
+  jsw_chnode_t *it, *save;
+  size_t i;
+
+  for ( i = 0; i < htab->capacity; i++ ) {
+    for ( it = htab->table[i]; it != NULL; it = save ) {
+      save = it->next;
+      htab->keyrel ( it->key );
+      htab->itemrel ( it->item );
+      free ( it );
+    }
+  }
+
+  for ( i = 0; i < htab->nstripes; i++ )
+    pthread_rwlock_destroy ( &htab->stripes[i].s.lock );
+
+  free ( htab->table );
+  free ( htab->stripes );
+  free ( htab );
+}
+
+void *jsw_chfind ( jsw_chash_t *htab, void *key )
+{
+  unsigned h = hash_key ( htab, key );
+  jsw_stripe_t *st = stripe_for ( htab, h );
+  jsw_chnode_t *it;
+  void *copy = NULL;
+
+  pthread_rwlock_rdlock ( &st->s.lock );
+
+  it = chain_find ( htab, htab->table[h & ( htab->capacity - 1 )], key, h );
+
+  if ( it != NULL )
+    copy = htab->itemdup ( it->item );
+
+  pthread_rwlock_unlock ( &st->s.lock );
+
+  return copy;
+}
+
+int jsw_chinsert ( jsw_chash_t *htab, void *key, void *item )
+{
+  unsigned h = hash_key ( htab, key );
+  jsw_stripe_t *st = stripe_for ( htab, h );
+  jsw_chnode_t *node = (jsw_chnode_t *)malloc ( sizeof *node );
+  jsw_chnode_t **chain;
+  size_t cap = 0;
+
+  if ( node == NULL )
+    return 0;
+
+  /* Copy outside the lock to keep the stripe free */
+  node->key = htab->keydup ( key );
+  node->item = htab->itemdup ( item );
+  node->hash = h;
+
+  pthread_rwlock_wrlock ( &st->s.lock );
+
+  chain = &htab->table[h & ( htab->capacity - 1 )];
+
+  /* Disallow duplicate keys */
+  if ( chain_find ( htab, *chain, key, h ) != NULL ) {
+    pthread_rwlock_unlock ( &st->s.lock );
+
+    htab->keyrel ( node->key );
+    htab->itemrel ( node->item );
+    free ( node );
+    return 0;
+  }
+
+  /* Insert at the front of the chain */
+  node->next = *chain;
+  *chain = node;
+
+  /* Each stripe holds its share of the load */
+  if ( ++st->s.size > htab->maxload * htab->capacity / htab->nstripes
+    && htab->maxload > 0 )
+  {
+    cap = htab->capacity;
+  }
+
+  pthread_rwlock_unlock ( &st->s.lock );
+
+  if ( cap != 0 )
+    grow ( htab, cap );
+
+  return 1;
+}
+
+int jsw_cherase ( jsw_chash_t *htab, void *key )
+{
+  unsigned h = hash_key ( htab, key );
+  jsw_stripe_t *st = stripe_for ( htab, h );
+  jsw_chnode_t **it;
+  jsw_chnode_t *node = NULL;
+
+  pthread_rwlock_wrlock ( &st->s.lock );
+
+  it = &htab->table[h & ( htab->capacity - 1 )];
+
+  for ( ; *it != NULL; it = &( *it )->next ) {
+    if ( ( *it )->hash == h && htab->cmp ( key, ( *it )->key ) == 0 ) {
+      node = *it;
+      *it = node->next;
+      --st->s.size;
+      break;
+    }
+  }
+
+  pthread_rwlock_unlock ( &st->s.lock );
+
+  if ( node == NULL )
+    return 0;
+
+  /* Nobody can reach the node now, release it unlocked */
+  htab->keyrel ( node->key );
+  htab->itemrel ( node->item );
+  free ( node );
+
+  return 1;
+}
+
+int jsw_chresize ( jsw_chash_t *htab, size_t new_size )
+{
+  int rc;
+
+  lock_all ( htab, 1 );
+  rc = rehash ( htab, new_size );
+  unlock_all ( htab );
+
+  return rc;
+}
+
+int jsw_chgrowth ( jsw_chash_t *htab, double load )
+{
+  if ( load < 0 )
+    return 0;
+
+  lock_all ( htab, 1 );
+  htab->maxload = load;
+  unlock_all ( htab );
+
+  return 1;
+}
+
+size_t jsw_chsize ( jsw_chash_t *htab )
+{
+  size_t n = 0;
+  size_t i;
+
+  for ( i = 0; i < htab->nstripes; i++ ) {
+    pthread_rwlock_rdlock ( &htab->stripes[i].s.lock );
+    n += htab->stripes[i].s.size;
+    pthread_rwlock_unlock ( &htab->stripes[i].s.lock );
+  }
+
+  return n;
+}
+
+size_t jsw_chcapacity ( jsw_chash_t *htab )
+{
+  size_t cap;
+
+  /* A resize holds every stripe, so any one of them will do */
+  pthread_rwlock_rdlock ( &htab->stripes[0].s.lock );
+  cap = htab->capacity;
+  pthread_rwlock_unlock ( &htab->stripes[0].s.lock );
+
+  return cap;
+}
+
+jsw_hstat_t *jsw_chstat ( jsw_chash_t *htab )
+{
+  jsw_hstat_t *stat = NULL;
+  double sum = 0, used = 0;
+  jsw_chnode_t *it;
+  size_t i, len;
+
+  lock_all ( htab, 0 );
+
+  for ( i = 0; i < htab->nstripes; i++ )
+    sum += htab->stripes[i].s.size;
+
+  /* No stats for an empty table */
+  if ( sum == 0 )
+    goto done;
+
+  stat = (jsw_hstat_t *)malloc ( sizeof *stat );
+
+  if ( stat == NULL )
+    goto done;
+
+  stat->lchain = 0;
+  stat->schain = (size_t)-1;
+
+  for ( i = 0; i < htab->capacity; i++ ) {
+    if ( htab->table[i] == NULL )
+      continue;
+
+    len = 0;
+
+    for ( it = htab->table[i]; it != NULL; it = it->next )
+      ++len;
+
+    ++used; /* Non-empty buckets */
+
+    if ( len > stat->lchain )
+      stat->lchain = len;
+
+    if ( len < stat->schain )
+      stat->schain = len;
+  }
+
+  stat->load = used / htab->capacity;
+  stat->achain = sum / used;
+
+done:
+  unlock_all ( htab );
+
+  return stat;
+}
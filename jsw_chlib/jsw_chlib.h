@@ -0,0 +1,109 @@
+#ifndef JSW_CHLIB_H
+#define JSW_CHLIB_H
+
+/*
+  Concurrent hash table library
+
+    > Created (agent): October 14, 2026
+
+  The chained table from jsw_hlib, shared between threads.
+  Buckets are split into a power of two number of stripes,
+  each with its own reader-writer lock, so lookups in any
+  stripe run in parallel and writers only block their own
+  stripe. A resize takes every stripe.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+/* Callbacks and statistics are shared with jsw_hlib */
+#include "jsw_hlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct jsw_chash jsw_chash_t;
+
+/*
+  Create a new concurrent hash table with a capacity of
+  size and the given number of lock stripes. Both are
+  rounded up to powers of two, and the capacity is never
+  less than the stripe count. Zero stripes picks a default.
+  A NULL keyrel or itemrel leaves keys or items alone, as
+  in jsw_hlib
+
+  Returns: An empty hash table, or NULL on failure.
+*/
+jsw_chash_t *jsw_chnew ( size_t size, size_t stripes,
+                         hash_f hash, cmp_f cmp,
+                         keydup_f keydup, itemdup_f itemdup,
+                         keyrel_f keyrel, itemrel_f itemrel );
+
+/* Release all memory used by the table. No thread may still use it */
+void         jsw_chdelete ( jsw_chash_t *htab );
+
+/*
+  Find an item with the selected key. The item is copied
+  with itemdup while its stripe is locked, so another
+  thread erasing it can't pull it away. The caller owns
+  the copy
+
+  Returns: A copy of the item, or NULL if not found
+*/
+void        *jsw_chfind ( jsw_chash_t *htab, void *key );
+
+/*
+  Insert an item with the selected key. Key and item are
+  copied before the stripe is locked
+
+  Returns: non-zero for success, zero for failure
+*/
+int          jsw_chinsert ( jsw_chash_t *htab, void *key, void *item );
+
+/*
+  Remove an item with the selected key
+
+  Returns: non-zero for success, zero for failure
+*/
+int          jsw_cherase ( jsw_chash_t *htab, void *key );
+
+/*
+  Grow or shrink the table, rounding new_size up to a
+  power of two. Locks every stripe while it runs
+
+  Returns: non-zero for success, zero for failure
+*/
+int          jsw_chresize ( jsw_chash_t *htab, size_t new_size );
+
+/*
+  Double the table automatically once the items in any
+  stripe pass load times that stripe's share of buckets.
+  A load of zero turns automatic growth off (the default)
+
+  Returns: non-zero for success, zero for failure
+*/
+int          jsw_chgrowth ( jsw_chash_t *htab, double load );
+
+/* Current number of items, only exact while no thread writes */
+size_t       jsw_chsize ( jsw_chash_t *htab );
+
+/* Total allowable number of items without resizing */
+size_t       jsw_chcapacity ( jsw_chash_t *htab );
+
+/* Get statistics for the hash table, release them with free */
+jsw_hstat_t *jsw_chstat ( jsw_chash_t *htab );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,648 @@
+/*
+  Lock-free concurrent skip list library
+
+    > Created (agent): October 14, 2026
+
+  Links are tagged pointers. A set low bit marks the
+  node that owns the link as erased, so a CAS that
+  expects an unmarked link can never attach a node
+  behind one that is being removed. Nodes are marked
+  from the top level down, and the mark at level 0
+  decides which erase owns the node.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+#include "jsw_rand.h"
+#include "jsw_cslib.h"
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifndef HEIGHT_LIMIT
+#define HEIGHT_LIMIT 64 /* Tallest column, sizes the search arrays */
+#endif
+
+#ifndef RETIRE_SCAN
+#define RETIRE_SCAN 64  /* Retired nodes between epoch advances */
+#endif
+
+/* Epochs wrap at a multiple of 3 so limbo lists never collide */
+#define EPOCH_WRAP ( 3UL << 24 )
+
+/* Low bit of a link, set once its node is erased */
+#define MARK ( (uintptr_t)1 )
+#define MARKED(link) ( ( (link) & MARK ) != 0 )
+#define NODE(link) ( (jsw_csnode_t *)( (link) & ~MARK ) )
+
+typedef struct jsw_csnode {
+  void              *item;    /* Data item with combined key */
+  size_t             height;  /* Column height of this node */
+  struct jsw_csnode *retired; /* Limbo list link once unlinked */
+  _Atomic uintptr_t  next[1]; /* Tagged next links, allocated with the node */
+} jsw_csnode_t;
+
+/* Bytes needed for a node with a column of height links */
+#define NODE_SIZE(height) \
+  ( offsetof ( jsw_csnode_t, next ) + (height) * sizeof ( _Atomic uintptr_t ) )
+
+struct jsw_csthread {
+  jsw_cskip_t         *skip;     /* List this handle is attached to */
+  struct jsw_csthread *link;     /* Next handle, fixed once published */
+  atomic_int           busy;     /* Non-zero while a thread owns it */
+  atomic_ulong         state;    /* Pinned epoch << 1, low bit if pinned */
+  unsigned             nest;     /* Depth of nested pins */
+  unsigned long        rng;      /* Private xorshift state for levels */
+  jsw_csnode_t        *limbo[3]; /* Retired nodes, by epoch % 3 */
+  unsigned long        tag[3];   /* Epoch each limbo list was started in */
+  size_t               retires;  /* Nodes retired through this handle */
+  jsw_csnode_t        *curl;     /* Current link for traversal */
+};
+
+struct jsw_cskip {
+  jsw_csnode_t              *head;    /* Full height header node */
+  size_t                     maxh;    /* Tallest possible column */
+  atomic_size_t              curh;    /* Tallest column ever linked */
+  atomic_size_t              size;    /* Number of items at level 0 */
+  atomic_ulong               epoch;   /* Global reclamation epoch */
+  _Atomic(jsw_csthread_t *)  threads; /* Every handle ever attached */
+  cmp_f                      cmp;     /* User defined item compare function */
+  dup_f                      dup;     /* User defined item copy function */
+  rel_f                      rel;     /* User defined delete function */
+};
+
+/* Next 32-bit value from the thread's own xorshift generator */
+static unsigned long xorshift ( jsw_csthread_t *thr )
+{
+  unsigned long x = thr->rng;
+
+  x ^= ( x << 13 ) & 0xffffffffUL;
+  x ^= x >> 17;
+  x ^= ( x << 5 ) & 0xffffffffUL;
+
+  return thr->rng = x;
+}
+
+/* Number of trailing zero bits in a non-zero 32-bit value */
+static size_t ctz32 ( unsigned long x )
+{
+#if defined ( __GNUC__ )
+  return (size_t)__builtin_ctzl ( x );
+#else
+  size_t n = 0;
+
+  while ( ( x & 1 ) == 0 ) {
+    x >>= 1;
+    ++n;
+  }
+
+  return n;
+#endif
+}
+
+/* Weighted random level with probability 1/2 */
+static size_t rlevel ( jsw_csthread_t *thr )
+{
+  size_t h = ctz32 ( xorshift ( thr ) ) + 1;
+
+  if ( h >= thr->skip->maxh )
+    h = thr->skip->maxh - 1;
+
+  return h;
+}
+
+/* This function makes a copy of the item */
+static jsw_csnode_t *new_node ( jsw_cskip_t *skip, void *item, size_t height )
+{
+  jsw_csnode_t *node = (jsw_csnode_t *)malloc ( NODE_SIZE ( height ) );
+  size_t i;
+
+  if ( node == NULL )
+    return NULL;
+
+  if ( item != NULL ) {
+    node->item = skip->dup ( item );
+
+    if ( node->item == NULL ) {
+      free ( node );
+      return NULL;
+    }
+  }
+  else
+    node->item = NULL;
+
+  node->height = height;
+  node->retired = NULL;
+
+  for ( i = 0; i < height; i++ )
+    atomic_init ( &node->next[i], (uintptr_t)0 );
+
+  return node;
+}
+
+/* Release retired nodes and their items */
+static void release_list ( jsw_cskip_t *skip, jsw_csnode_t *it )
+{
+  jsw_csnode_t *save;
+
+  while ( it != NULL ) {
+    save = it->retired;
+    skip->rel ( it->item );
+    free ( it );
+    it = save;
+  }
+}
+
+/*
+  Move the global epoch forward if every pinned
+  thread has already seen the current one
+*/
+static void advance ( jsw_cskip_t *skip )
+{
+  unsigned long e = atomic_load ( &skip->epoch );
+  jsw_csthread_t *it = atomic_load ( &skip->threads );
+  unsigned long s;
+
+  for ( ; it != NULL; it = it->link ) {
+    s = atomic_load ( &it->state );
+
+    if ( ( s & 1 ) != 0 && ( s >> 1 ) != e )
+      return;
+  }
+
+  atomic_compare_exchange_strong ( &skip->epoch, &e, ( e + 1 ) % EPOCH_WRAP );
+}
+
+/*
+  Queue an unlinked node for release. A thread that
+  found the node may be pinned one epoch behind, and
+  an insert still linking its upper levels may expose
+  it for one more, so each limbo list waits until its
+  slot comes around again, three epochs later
+*/
+static void retire ( jsw_csthread_t *thr, jsw_csnode_t *node )
+{
+  jsw_cskip_t *skip = thr->skip;
+  unsigned long e = atomic_load ( &skip->epoch );
+  size_t b = (size_t)( e % 3 );
+
+  if ( thr->tag[b] != e ) {
+    release_list ( skip, thr->limbo[b] );
+    thr->limbo[b] = NULL;
+    thr->tag[b] = e;
+  }
+
+  node->retired = thr->limbo[b];
+  thr->limbo[b] = node;
+
+  if ( ++thr->retires % RETIRE_SCAN == 0 )
+    advance ( skip );
+}
+
+/* Raise the search start to at least h levels */
+static void raise_height ( jsw_cskip_t *skip, size_t h )
+{
+  size_t curh = atomic_load ( &skip->curh );
+
+  while ( curh < h
+    && !atomic_compare_exchange_weak ( &skip->curh, &curh, h ) )
+    ;
+}
+
+/*
+  Fill preds and succs with the nodes on either side of
+  the item at every level, unlinking marked nodes along
+  the way. When this returns, no marked node with the
+  item's key is reachable from the nodes it passed
+
+  Returns: non-zero if the item is at level 0
+*/
+static int search ( jsw_cskip_t *skip, void *item,
+                    jsw_csnode_t **preds, jsw_csnode_t **succs )
+{
+  jsw_csnode_t *pred, *curr = NULL;
+  uintptr_t succ, expect;
+  size_t i;
+  int cmp = 1;
+
+retry:
+  pred = skip->head;
+
+  for ( i = atomic_load ( &skip->curh ); i-- > 0; ) {
+    curr = NODE ( atomic_load ( &pred->next[i] ) );
+
+    while ( curr != NULL ) {
+      succ = atomic_load ( &curr->next[i] );
+
+      if ( MARKED ( succ ) ) {
+        expect = (uintptr_t)curr;
+
+        /* Someone else changed pred first, start over */
+        if ( !atomic_compare_exchange_strong ( &pred->next[i],
+          &expect, succ & ~MARK ) )
+        {
+          goto retry;
+        }
+
+        curr = NODE ( succ );
+        continue;
+      }
+
+      cmp = skip->cmp ( curr->item, item );
+
+      if ( cmp >= 0 )
+        break;
+
+      pred = curr;
+      curr = NODE ( succ );
+    }
+
+    preds[i] = pred;
+    succs[i] = curr;
+  }
+
+  return curr != NULL && cmp == 0;
+}
+
+/* First node after node at level 0 that isn't erased */
+static jsw_csnode_t *next_live ( jsw_csnode_t *node )
+{
+  jsw_csnode_t *it = NODE ( atomic_load ( &node->next[0] ) );
+
+  while ( it != NULL && MARKED ( atomic_load ( &it->next[0] ) ) )
+    it = NODE ( atomic_load ( &it->next[0] ) );
+
+  return it;
+}
+
+jsw_cskip_t *jsw_csnew ( size_t max, cmp_f cmp, dup_f dup, rel_f rel )
+{
+  jsw_cskip_t *skip = (jsw_cskip_t *)malloc ( sizeof *skip );
+
+  if ( skip == NULL )
+    return NULL;
+
+  if ( max >= HEIGHT_LIMIT )
+    max = HEIGHT_LIMIT - 1;
+
+  skip->head = new_node ( skip, NULL, ++max );
+
+  if ( skip->head == NULL ) {
+    free ( skip );
+    return NULL;
+  }
+
+  skip->maxh = max;
+  atomic_init ( &skip->curh, (size_t)0 );
+  atomic_init ( &skip->size, (size_t)0 );
+  atomic_init ( &skip->epoch, 0UL );
+  atomic_init ( &skip->threads, (jsw_csthread_t *)NULL );
+  skip->cmp = cmp;
+  skip->dup = dup;
+  skip->rel = rel;
+
+  return skip;
+}
+
+void jsw_csdelete ( jsw_cskip_t *skip )
+{
+  jsw_csnode_t *it = NODE ( atomic_load ( &skip->head->next[0] ) );
+  jsw_csthread_t *thr = atomic_load ( &skip->threads );
+  jsw_csnode_t *save;
+  jsw_csthread_t *next;
+  size_t b;
+
+  /* With every thread gone, retired nodes are all unlinked */
+  while ( it != NULL ) {
+    save = NODE ( atomic_load ( &it->next[0] ) );
+    skip->rel ( it->item );
+    free ( it );
+    it = save;
+  }
+
+  while ( thr != NULL ) {
+    next = thr->link;
+
+    for ( b = 0; b < 3; b++ )
+      release_list ( skip, thr->limbo[b] );
+
+    free ( thr );
+    thr = next;
+  }
+
+  free ( skip->head );
+  free ( skip );
+}
+
+jsw_csthread_t *jsw_csattach ( jsw_cskip_t *skip )
+{
+  jsw_csthread_t *thr = atomic_load ( &skip->threads );
+  size_t b;
+  int idle;
+
+  /* Reuse a detached handle, along with its limbo lists */
+  for ( ; thr != NULL; thr = thr->link ) {
+    idle = 0;
+
+    if ( atomic_load ( &thr->busy ) == 0
+      && atomic_compare_exchange_strong ( &thr->busy, &idle, 1 ) )
+    {
+      thr->curl = NULL;
+      return thr;
+    }
+  }
+
+  thr = (jsw_csthread_t *)malloc ( sizeof *thr );
+
+  if ( thr == NULL )
+    return NULL;
+
+  thr->skip = skip;
+  atomic_init ( &thr->busy, 1 );
+  atomic_init ( &thr->state, 0UL );
+  thr->nest = 0;
+
+  for ( b = 0; b < 3; b++ ) {
+    thr->limbo[b] = NULL;
+    thr->tag[b] = 0;
+  }
+
+  thr->retires = 0;
+  thr->curl = NULL;
+
+  /* Handles made in the same second still get different levels */
+  jsw_csseed ( thr, jsw_time_seed() ^ (unsigned long)(size_t)thr );
+
+  thr->link = atomic_load ( &skip->threads );
+
+  while ( !atomic_compare_exchange_weak ( &skip->threads, &thr->link, thr ) )
+    ;
+
+  return thr;
+}
+
+void jsw_csdetach ( jsw_csthread_t *thr )
+{
+  thr->nest = 0;
+  thr->curl = NULL;
+  atomic_store ( &thr->state, 0UL );
+  atomic_store ( &thr->busy, 0 );
+}
+
+void jsw_csseed ( jsw_csthread_t *thr, unsigned long seed )
+{
+  /* Spread the seed over all 32 bits (lowbias32) */
+  seed &= 0xffffffffUL;
+  seed ^= seed >> 16;
+  seed = ( seed * 0x7feb352dUL ) & 0xffffffffUL;
+  seed ^= seed >> 15;
+  seed = ( seed * 0x846ca68bUL ) & 0xffffffffUL;
+  seed ^= seed >> 16;
+
+  /* Zero is the one state xorshift can't leave */
+  thr->rng = seed != 0 ? seed : 0x9e3779b9UL;
+}
+
+void jsw_cspin ( jsw_csthread_t *thr )
+{
+  unsigned long e, now;
+
+  if ( thr->nest++ != 0 )
+    return;
+
+  /* The epoch can move before others see the pin, so check again */
+  e = atomic_load ( &thr->skip->epoch );
+
+  for ( ;; ) {
+    atomic_store ( &thr->state, e << 1 | 1 );
+    now = atomic_load ( &thr->skip->epoch );
+
+    if ( now == e )
+      break;
+
+    e = now;
+  }
+}
+
+void jsw_csunpin ( jsw_csthread_t *thr )
+{
+  if ( --thr->nest == 0 )
+    atomic_store_explicit ( &thr->state, 0UL, memory_order_release );
+}
+
+void *jsw_csfind ( jsw_csthread_t *thr, void *item )
+{
+  jsw_cskip_t *skip = thr->skip;
+  jsw_csnode_t *pred = skip->head;
+  jsw_csnode_t *curr;
+  void *found = NULL;
+  uintptr_t succ;
+  size_t i;
+  int cmp;
+
+  jsw_cspin ( thr );
+
+  /* Step over marked nodes instead of unlinking them */
+  for ( i = atomic_load ( &skip->curh ); i-- > 0; ) {
+    curr = NODE ( atomic_load ( &pred->next[i] ) );
+
+    while ( curr != NULL ) {
+      succ = atomic_load ( &curr->next[i] );
+
+      if ( MARKED ( succ ) ) {
+        curr = NODE ( succ );
+        continue;
+      }
+
+      cmp = skip->cmp ( curr->item, item );
+
+      /* Unmarked at any level means not yet erased at level 0 */
+      if ( cmp == 0 ) {
+        found = curr->item;
+        goto done;
+      }
+
+      if ( cmp > 0 )
+        break;
+
+      pred = curr;
+      curr = NODE ( succ );
+    }
+  }
+
+done:
+  jsw_csunpin ( thr );
+
+  return found;
+}
+
+int jsw_csinsert ( jsw_csthread_t *thr, void *item )
+{
+  jsw_cskip_t *skip = thr->skip;
+  jsw_csnode_t *preds[HEIGHT_LIMIT];
+  jsw_csnode_t *succs[HEIGHT_LIMIT];
+  jsw_csnode_t *node = NULL;
+  size_t h = rlevel ( thr );
+  uintptr_t expect;
+  size_t i;
+
+  jsw_cspin ( thr );
+  raise_height ( skip, h );
+
+  /* Linking level 0 puts the item in the list */
+  for ( ;; ) {
+    if ( search ( skip, item, preds, succs ) ) {
+      if ( node != NULL ) {
+        skip->rel ( node->item );
+        free ( node );
+      }
+
+      jsw_csunpin ( thr );
+      return 0;
+    }
+
+    if ( node == NULL ) {
+      node = new_node ( skip, item, h );
+
+      if ( node == NULL ) {
+        jsw_csunpin ( thr );
+        return 0;
+      }
+    }
+
+    for ( i = 0; i < h; i++ ) {
+      atomic_store_explicit ( &node->next[i], (uintptr_t)succs[i],
+        memory_order_relaxed );
+    }
+
+    expect = (uintptr_t)succs[0];
+
+    if ( atomic_compare_exchange_strong ( &preds[0]->next[0],
+      &expect, (uintptr_t)node ) )
+    {
+      break;
+    }
+  }
+
+  atomic_fetch_add ( &skip->size, 1 );
+
+  /* Upper levels are only shortcuts, stop if the node is erased */
+  for ( i = 1; i < h; i++ ) {
+    for ( ;; ) {
+      expect = (uintptr_t)succs[i];
+
+      if ( atomic_compare_exchange_strong ( &preds[i]->next[i],
+        &expect, (uintptr_t)node ) )
+      {
+        break;
+      }
+
+      search ( skip, item, preds, succs );
+      expect = atomic_load ( &node->next[i] );
+
+      if ( MARKED ( expect )
+        || !atomic_compare_exchange_strong ( &node->next[i],
+          &expect, (uintptr_t)succs[i] ) )
+      {
+        goto done;
+      }
+    }
+
+    /*
+      An erase that finished its cleanup before this level
+      was linked can't see it, so unlink the node here
+    */
+    if ( MARKED ( atomic_load ( &node->next[i] ) ) ) {
+      search ( skip, item, preds, succs );
+      break;
+    }
+  }
+
+done:
+  jsw_csunpin ( thr );
+
+  return 1;
+}
+
+int jsw_cserase ( jsw_csthread_t *thr, void *item )
+{
+  jsw_cskip_t *skip = thr->skip;
+  jsw_csnode_t *preds[HEIGHT_LIMIT];
+  jsw_csnode_t *succs[HEIGHT_LIMIT];
+  jsw_csnode_t *node;
+  uintptr_t link;
+  size_t i;
+
+  jsw_cspin ( thr );
+
+  if ( !search ( skip, item, preds, succs ) ) {
+    jsw_csunpin ( thr );
+    return 0;
+  }
+
+  node = succs[0];
+
+  for ( i = node->height - 1; i > 0; i-- ) {
+    link = atomic_load ( &node->next[i] );
+
+    while ( !MARKED ( link )
+      && !atomic_compare_exchange_weak ( &node->next[i], &link, link | MARK ) )
+      ;
+  }
+
+  /* Whoever marks level 0 owns the node */
+  link = atomic_load ( &node->next[0] );
+
+  for ( ;; ) {
+    if ( MARKED ( link ) ) {
+      jsw_csunpin ( thr );
+      return 0;
+    }
+
+    if ( atomic_compare_exchange_weak ( &node->next[0], &link, link | MARK ) )
+      break;
+  }
+
+  atomic_fetch_sub ( &skip->size, 1 );
+
+  /* Unlink every level before the node can be retired */
+  search ( skip, item, preds, succs );
+  retire ( thr, node );
+
+  jsw_csunpin ( thr );
+
+  return 1;
+}
+
+size_t jsw_cssize ( jsw_cskip_t *skip )
+{
+  return atomic_load ( &skip->size );
+}
+
+void jsw_csreset ( jsw_csthread_t *thr )
+{
+  thr->curl = next_live ( thr->skip->head );
+}
+
+void *jsw_csitem ( jsw_csthread_t *thr )
+{
+  return thr->curl != NULL ? thr->curl->item : NULL;
+}
+
+int jsw_csnext ( jsw_csthread_t *thr )
+{
+  if ( thr->curl != NULL )
+    thr->curl = next_live ( thr->curl );
+
+  return thr->curl != NULL;
+}
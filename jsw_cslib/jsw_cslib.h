@@ -0,0 +1,149 @@
+#ifndef JSW_CSLIB_H
+#define JSW_CSLIB_H
+
+/*
+  Lock-free concurrent skip list library
+
+    > Created (agent): October 14, 2026
+
+  The classic skip list from jsw_slib with C11 atomic
+  links. Insertion is a CAS at each level, erasure marks
+  the links of a node before unlinking it, and erased
+  nodes are only released once every thread has moved
+  past the epoch they were retired in.
+
+  Each thread attaches to the list once and passes its
+  own handle to every call. The handle holds the thread's
+  epoch, its retired nodes, its level generator and its
+  traversal cursor, so nothing but the links is shared.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+#ifdef __cplusplus
+#include <cstddef>
+
+using std::size_t;
+
+extern "C" {
+#else
+#include <stddef.h>
+#endif
+
+typedef struct jsw_cskip jsw_cskip_t;
+typedef struct jsw_csthread jsw_csthread_t;
+
+/* Application specific key comparison function */
+typedef int   (*cmp_f) ( const void *a, const void *b );
+
+/* Application specific item copying function */
+typedef void *(*dup_f) ( const void *item );
+
+/* Application specific item deletion function */
+typedef void  (*rel_f) ( void *item );
+
+/*
+  Create a new concurrent skip list with a max height of max
+
+  Returns: An empty skip list, or NULL on failure
+*/
+jsw_cskip_t    *jsw_csnew ( size_t max, cmp_f cmp, dup_f dup, rel_f rel );
+
+/*
+  Release all memory used by the skip list. No thread
+  may still be using it, but threads need not detach
+*/
+void            jsw_csdelete ( jsw_cskip_t *skip );
+
+/*
+  Register the calling thread with the skip list. The
+  handle belongs to that thread until jsw_csdetach
+
+  Returns: A thread handle, or NULL on failure
+*/
+jsw_csthread_t *jsw_csattach ( jsw_cskip_t *skip );
+
+/* Give up a thread handle so another thread can reuse it */
+void            jsw_csdetach ( jsw_csthread_t *thr );
+
+/*
+  Seed the thread's private level generator. Every
+  handle starts with its own seed, so this is only
+  needed for reproducible layouts
+*/
+void            jsw_csseed ( jsw_csthread_t *thr, unsigned long seed );
+
+/*
+  Enter a critical section. Items returned by the list
+  stay valid until the matching jsw_csunpin, even if
+  another thread erases them. Pins nest, and every call
+  below pins itself, so this is only needed to hold on
+  to an item or to traverse
+*/
+void            jsw_cspin ( jsw_csthread_t *thr );
+
+/* Leave a critical section entered by jsw_cspin */
+void            jsw_csunpin ( jsw_csthread_t *thr );
+
+/*
+  Find an item with the selected key. Never writes
+  to shared memory
+
+  Returns: The item, or NULL if not found
+*/
+void           *jsw_csfind ( jsw_csthread_t *thr, void *item );
+
+/*
+  Insert an item with the selected key
+
+  Returns: non-zero for success, zero for failure
+*/
+int             jsw_csinsert ( jsw_csthread_t *thr, void *item );
+
+/*
+  Remove an item with the selected key
+
+  Returns: non-zero for success, zero for failure
+*/
+int             jsw_cserase ( jsw_csthread_t *thr, void *item );
+
+/*
+  Current number of items at height 0. Only exact
+  while no other thread is inserting or erasing
+*/
+size_t          jsw_cssize ( jsw_cskip_t *skip );
+
+/*
+  Reset the thread's cursor to the beginning. The
+  cursor functions must be called while pinned
+*/
+void            jsw_csreset ( jsw_csthread_t *thr );
+
+/*
+  Get the item under the thread's cursor
+
+  Returns the item, or NULL if end-of-list
+*/
+void           *jsw_csitem ( jsw_csthread_t *thr );
+
+/*
+  Move the thread's cursor forward by one key,
+  skipping items that have been erased
+
+  Returns 0 if end-of-list, 1 otherwise
+*/
+int             jsw_csnext ( jsw_csthread_t *thr );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,513 @@
+/*
+  Hash table library using open addressing
+
+    > Created (agent): October 14, 2026
+*/
+#include "jsw_flat.h"
+
+#ifdef __cplusplus
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+using std::malloc;
+using std::free;
+using std::memset;
+#else
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#if defined ( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+#define GROUP   16   /* Control bytes examined per probe */
+#define EMPTY   0x80 /* Slot has never been used */
+#define DELETED 0xfe /* Slot held an erased entry */
+
+/*
+  The whole hash picks the home group, so tables of any
+  size use all of its bits, and full slots keep the top 7
+  bits in their control byte. The tag then rarely depends
+  on the same bits as the group it is compared in
+*/
+#define H1(h) ( (size_t)( h ) )
+#define H2(h) \
+  ( (unsigned char)( ( (h) >> ( CHAR_BIT * sizeof ( unsigned ) - 7 ) ) & 0x7f ) )
+
+typedef struct jsw_slot {
+  void     *key;  /* Key used for searching */
+  void     *item; /* Actual content of a slot */
+  unsigned  hash; /* Full hash of the key */
+} jsw_slot_t;
+
+struct jsw_flat {
+  unsigned char *ctrl;     /* Control bytes, first group mirrored at the end */
+  jsw_slot_t    *slots;    /* Inline entries */
+  size_t         size;     /* Current item count */
+  size_t         capacity; /* Current table size (a power of two) */
+  size_t         deleted;  /* Tombstones left by erasure */
+  size_t         limit;    /* Full plus deleted slots allowed before growth */
+  size_t         curri;    /* Current index for traversal */
+  hash_f         hash;     /* User defined key hash function */
+  cmp_f          cmp;      /* User defined key comparison function */
+  keydup_f       keydup;   /* User defined key copy function */
+  itemdup_f      itemdup;  /* User defined item copy function */
+  keyrel_f       keyrel;   /* User defined key delete function */
+  itemrel_f      itemrel;  /* User defined item delete function */
+};
+
+/* Index of the lowest set bit in a non-zero group mask */
+static unsigned first_bit ( unsigned m )
+{
+#if defined ( __GNUC__ )
+  return (unsigned)__builtin_ctz ( m );
+#else
+  unsigned i = 0;
+
+  while ( ( m & 1 ) == 0 ) {
+    m >>= 1;
+    ++i;
+  }
+
+  return i;
+#endif
+}
+
+/* Bit i is set when control byte i of the group equals c */
+static unsigned match ( const unsigned char *g, unsigned char c )
+{
+#if defined ( __SSE2__ )
+  __m128i v = _mm_loadu_si128 ( (const __m128i *)g );
+
+  return (unsigned)_mm_movemask_epi8 (
+    _mm_cmpeq_epi8 ( v, _mm_set1_epi8 ( (char)c ) ) );
+#else
+  unsigned m = 0;
+  int i;
+
+  for ( i = 0; i < GROUP; i++ ) {
+    if ( g[i] == c )
+      m |= 1U << i;
+  }
+
+  return m;
+#endif
+}
+
+/* Bit i is set when slot i of the group is empty or deleted */
+static unsigned match_free ( const unsigned char *g )
+{
+#if defined ( __SSE2__ )
+  /* Only EMPTY and DELETED have the high bit set */
+  return (unsigned)_mm_movemask_epi8 (
+    _mm_loadu_si128 ( (const __m128i *)g ) );
+#else
+  unsigned m = 0;
+  int i;
+
+  for ( i = 0; i < GROUP; i++ ) {
+    if ( g[i] & 0x80 )
+      m |= 1U << i;
+  }
+
+  return m;
+#endif
+}
+
+/* Set a control byte, keeping the mirrored copy in sync */
+static void set_ctrl ( jsw_flat_t *ftab, size_t i, unsigned char c )
+{
+  ftab->ctrl[i] = c;
+
+  if ( i < GROUP )
+    ftab->ctrl[ftab->capacity + i] = c;
+}
+
+/*
+  Find the slot holding key
+
+  Returns: The slot index, or capacity if not found
+*/
+static size_t lookup ( jsw_flat_t *ftab, const void *key, unsigned h )
+{
+  size_t mask = ftab->capacity - 1;
+  size_t pos = H1 ( h ) & mask;
+  size_t stride = 0;
+
+  /* Triangular probing visits every group once */
+  for ( ; ; ) {
+    const unsigned char *g = ftab->ctrl + pos;
+    unsigned m = match ( g, H2 ( h ) );
+
+    while ( m != 0 ) {
+      size_t i = ( pos + first_bit ( m ) ) & mask;
+
+      if ( ftab->slots[i].hash == h
+        && ftab->cmp ( key, ftab->slots[i].key ) == 0 )
+      {
+        return i;
+      }
+
+      m &= m - 1;
+    }
+
+    /* An empty slot ends every probe sequence through here */
+    if ( match ( g, EMPTY ) != 0 )
+      return ftab->capacity;
+
+    stride += GROUP;
+    pos = ( pos + stride ) & mask;
+  }
+}
+
+/* Find the first empty or deleted slot for a hash */
+static size_t find_free ( jsw_flat_t *ftab, unsigned h )
+{
+  size_t mask = ftab->capacity - 1;
+  size_t pos = H1 ( h ) & mask;
+  size_t stride = 0;
+  unsigned m;
+
+  while ( ( m = match_free ( ftab->ctrl + pos ) ) == 0 ) {
+    stride += GROUP;
+    pos = ( pos + stride ) & mask;
+  }
+
+  return ( pos + first_bit ( m ) ) & mask;
+}
+
+/* Smallest table size that holds n items without growing */
+static size_t capacity_for ( size_t n )
+{
+  size_t cap = GROUP;
+
+  while ( cap - cap / 8 < n ) {
+    if ( cap > (size_t)-1 / 4 )
+      return 0;
+
+    cap *= 2;
+  }
+
+  return cap;
+}
+
+/*
+  Move every entry into fresh arrays with cap slots. The
+  stored hashes are reused, so the user hash isn't called
+
+  Returns: non-zero for success, zero for failure
+*/
+static int rehash ( jsw_flat_t *ftab, size_t cap )
+{
+  unsigned char *old_ctrl = ftab->ctrl;
+  jsw_slot_t *old_slots = ftab->slots;
+  size_t old_cap = ftab->capacity;
+  unsigned char *new_ctrl;
+  jsw_slot_t *new_slots;
+  size_t i;
+
+  new_ctrl = (unsigned char *)malloc ( cap + GROUP );
+  new_slots = (jsw_slot_t *)malloc ( cap * sizeof *new_slots );
+
+  if ( new_ctrl == NULL || new_slots == NULL ) {
+    free ( new_ctrl );
+    free ( new_slots );
+    return 0;
+  }
+
+  memset ( new_ctrl, EMPTY, cap + GROUP );
+
+  ftab->ctrl = new_ctrl;
+  ftab->slots = new_slots;
+  ftab->capacity = cap;
+  ftab->deleted = 0;
+  ftab->limit = cap - cap / 8;
+
+  /* At this point, all allocations are done, so nothing can fail */
+  if ( old_ctrl != NULL ) {
+    for ( i = 0; i < old_cap; i++ ) {
+      if ( old_ctrl[i] & 0x80 )
+        continue;
+
+      {
+        size_t j = find_free ( ftab, old_slots[i].hash );
+
+        set_ctrl ( ftab, j, H2 ( old_slots[i].hash ) );
+        ftab->slots[j] = old_slots[i];
+      }
+    }
+  }
+
+  free ( old_ctrl );
+  free ( old_slots );
+
+  /* Invalidate traversal information */
+  ftab->curri = ftab->capacity;
+
+  return 1;
+}
+
+/*
+  Create a new hash table that can hold at least size
+  items without growing, and user defined functions for
+  handling keys and items.
+
+  Returns: An empty hash table, or NULL on failure.
+*/
+jsw_flat_t *jsw_fnew ( size_t size, hash_f hash, cmp_f cmp,
+  keydup_f keydup, itemdup_f itemdup,
+  keyrel_f keyrel, itemrel_f itemrel )
+{
+  jsw_flat_t *ftab = (jsw_flat_t *)malloc ( sizeof *ftab );
+  size_t cap = capacity_for ( size );
+
+  if ( ftab == NULL )
+    return NULL;
+
+  ftab->ctrl = NULL;
+  ftab->slots = NULL;
+  ftab->size = 0;
+  ftab->capacity = 0;
+
+  if ( cap == 0 || !rehash ( ftab, cap ) ) {
+    free ( ftab );
+    return NULL;
+  }
+
+  ftab->hash = hash;
+  ftab->cmp = cmp;
+  ftab->keydup = keydup;
+  ftab->itemdup = itemdup;
+  ftab->keyrel = keyrel;
+  ftab->itemrel = itemrel;
+
+  return ftab;
+}
+
+/* Release all memory used by the hash table */
+void jsw_fdelete ( jsw_flat_t *ftab )
+{
+  size_t i;
+
+  for ( i = 0; i < ftab->capacity; i++ ) {
+    if ( ftab->ctrl[i] & 0x80 )
+      continue;
+
+    ftab->keyrel ( ftab->slots[i].key );
+    ftab->itemrel ( ftab->slots[i].item );
+  }
+
+  free ( ftab->ctrl );
+  free ( ftab->slots );
+  free ( ftab );
+}
+
+/*
+  Find an item with the selected key
+
+  Returns: The item, or NULL if not found
+*/
+void *jsw_ffind ( jsw_flat_t *ftab, void *key )
+{
+  size_t i = lookup ( ftab, key, ftab->hash ( key ) );
+
+  return i == ftab->capacity ? NULL : ftab->slots[i].item;
+}
+
+/*
+  Insert an item with the selected key
+
+  Returns: non-zero for success, zero for failure
+*/
+int jsw_finsert ( jsw_flat_t *ftab, void *key, void *item )
+{
+  unsigned h = ftab->hash ( key );
+  size_t i;
+
+  /* Disallow duplicate keys */
+  if ( lookup ( ftab, key, h ) != ftab->capacity )
+    return 0;
+
+  i = find_free ( ftab, h );
+
+  /* Recycling a tombstone doesn't use up any room */
+  if ( ftab->ctrl[i] == EMPTY
+    && ftab->size + ftab->deleted >= ftab->limit )
+  {
+    /* Mostly tombstones? Clean up without growing */
+    size_t cap = ftab->capacity;
+
+    if ( ftab->size >= ftab->limit / 2 )
+      cap *= 2;
+
+    if ( !rehash ( ftab, cap ) )
+      return 0;
+
+    i = find_free ( ftab, h );
+  }
+
+  if ( ftab->ctrl[i] == DELETED )
+    --ftab->deleted;
+
+  ftab->slots[i].key = ftab->keydup ( key );
+  ftab->slots[i].item = ftab->itemdup ( item );
+  ftab->slots[i].hash = h;
+  set_ctrl ( ftab, i, H2 ( h ) );
+
+  ++ftab->size;
+
+  return 1;
+}
+
+/*
+  Remove an item with the selected key
+
+  Returns: non-zero for success, zero for failure
+*/
+int jsw_ferase ( jsw_flat_t *ftab, void *key )
+{
+  size_t i = lookup ( ftab, key, ftab->hash ( key ) );
+
+  if ( i == ftab->capacity )
+    return 0;
+
+  ftab->keyrel ( ftab->slots[i].key );
+  ftab->itemrel ( ftab->slots[i].item );
+
+  /* Leave a tombstone so later probes keep going */
+  set_ctrl ( ftab, i, DELETED );
+
+  ++ftab->deleted;
+  --ftab->size;
+
+  return 1;
+}
+
+/*
+  Rehash so that at least new_size items fit without growing
+
+  Returns: non-zero for success, zero for failure
+*/
+int jsw_fresize ( jsw_flat_t *ftab, size_t new_size )
+{
+  size_t cap;
+
+  /* Never shrink below the current contents */
+  if ( new_size < ftab->size )
+    return 0;
+
+  cap = capacity_for ( new_size );
+
+  if ( cap == 0 )
+    return 0;
+
+  return rehash ( ftab, cap );
+}
+
+/* Reset the traversal markers to the beginning */
+void jsw_freset ( jsw_flat_t *ftab )
+{
+  size_t i;
+
+  /* Find the first full slot */
+  for ( i = 0; i < ftab->capacity; i++ ) {
+    if ( !( ftab->ctrl[i] & 0x80 ) )
+      break;
+  }
+
+  ftab->curri = i;
+}
+
+/* Traverse forward by one key */
+int jsw_fnext ( jsw_flat_t *ftab )
+{
+  if ( ftab->curri < ftab->capacity ) {
+    while ( ++ftab->curri < ftab->capacity ) {
+      if ( !( ftab->ctrl[ftab->curri] & 0x80 ) )
+        return 1;
+    }
+  }
+
+  return 0;
+}
+
+/* Get the current key */
+const void *jsw_fkey ( jsw_flat_t *ftab )
+{
+  /* Erasing the current item leaves a tombstone behind */
+  if ( ftab->curri >= ftab->capacity || ( ftab->ctrl[ftab->curri] & 0x80 ) )
+    return NULL;
+
+  return ftab->slots[ftab->curri].key;
+}
+
+/* Get the current item */
+void *jsw_fitem ( jsw_flat_t *ftab )
+{
+  if ( ftab->curri >= ftab->capacity || ( ftab->ctrl[ftab->curri] & 0x80 ) )
+    return NULL;
+
+  return ftab->slots[ftab->curri].item;
+}
+
+/* Current number of items in the table */
+size_t jsw_fsize ( jsw_flat_t *ftab )
+{
+  return ftab->size;
+}
+
+/* Total allowable number of items without resizing */
+size_t jsw_fcapacity ( jsw_flat_t *ftab )
+{
+  return ftab->limit - ftab->deleted;
+}
+
+/* Get statistics for the hash table */
+jsw_fstat_t *jsw_fstat ( jsw_flat_t *ftab )
+{
+  jsw_fstat_t *stat;
+  size_t mask = ftab->capacity - 1;
+  double sum = 0;
+  size_t i;
+
+  /* No stats for an empty table */
+  if ( ftab->size == 0 )
+    return NULL;
+
+  stat = (jsw_fstat_t *)malloc ( sizeof *stat );
+
+  if ( stat == NULL )
+    return NULL;
+
+  stat->lprobe = 0;
+
+  for ( i = 0; i < ftab->capacity; i++ ) {
+    size_t pos, stride = 0, groups = 1;
+
+    if ( ftab->ctrl[i] & 0x80 )
+      continue;
+
+    /* Replay the probe sequence until it reaches slot i */
+    pos = H1 ( ftab->slots[i].hash ) & mask;
+
+    while ( ( ( i - pos ) & mask ) >= GROUP ) {
+      stride += GROUP;
+      pos = ( pos + stride ) & mask;
+      ++groups;
+    }
+
+    sum += groups;
+
+    if ( groups > stat->lprobe )
+      stat->lprobe = groups;
+  }
+
+  stat->load = (double)ftab->size / ftab->capacity;
+  stat->aprobe = sum / ftab->size;
+  stat->deleted = ftab->deleted;
+
+  return stat;
+}
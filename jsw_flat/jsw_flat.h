@@ -0,0 +1,132 @@
+#ifndef JSW_FLAT_H
+#define JSW_FLAT_H
+
+/*
+  Hash table library using open addressing
+
+    > Created (agent): October 14, 2026
+
+  The interface follows jsw_hlib, but entries live inline
+  in one contiguous slot array. A parallel array of control
+  bytes (SwissTable style) holds 7 bits of each key's hash,
+  so most probes only touch one or two cache lines and no
+  memory is allocated per entry.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+#ifdef __cplusplus
+#include <cstddef>
+
+using std::size_t;
+
+extern "C" {
+#else
+#include <stddef.h>
+#endif
+
+typedef struct jsw_flat jsw_flat_t;
+
+/* Application specific hash function */
+typedef unsigned (*hash_f) ( const void *key );
+
+/* Application specific key comparison function */
+typedef int      (*cmp_f) ( const void *a, const void *b );
+
+/* Application specific key copying function */
+typedef void    *(*keydup_f) ( const void *key );
+
+/* Application specific data copying function */
+typedef void    *(*itemdup_f) ( const void *item );
+
+/* Application specific key deletion function */
+typedef void     (*keyrel_f) ( void *key );
+
+/* Application specific data deletion function */
+typedef void     (*itemrel_f) ( void *item );
+
+typedef struct jsw_fstat {
+  double load;            /* Table load factor: (used slots)/(table size) */
+  double aprobe;          /* Average probe length in groups */
+  size_t lprobe;          /* Longest probe length in groups */
+  size_t deleted;         /* Slots holding erased entries */
+} jsw_fstat_t;
+
+/*
+  Create a new hash table that can hold at least size
+  items without growing, and user defined functions for
+  handling keys and items.
+
+  Returns: An empty hash table, or NULL on failure.
+*/
+jsw_flat_t  *jsw_fnew ( size_t size, hash_f hash, cmp_f cmp,
+                       keydup_f keydup, itemdup_f itemdup,
+                       keyrel_f keyrel, itemrel_f itemrel );
+
+/* Release all memory used by the hash table */
+void         jsw_fdelete ( jsw_flat_t *ftab );
+
+/*
+  Find an item with the selected key
+
+  Returns: The item, or NULL if not found
+*/
+void        *jsw_ffind ( jsw_flat_t *ftab, void *key );
+
+/*
+  Insert an item with the selected key. The table
+  grows automatically, which invalidates traversal
+
+  Returns: non-zero for success, zero for failure
+*/
+int          jsw_finsert ( jsw_flat_t *ftab, void *key, void *item );
+
+/*
+  Remove an item with the selected key. Entries
+  never move on erasure, so traversal stays valid
+
+  Returns: non-zero for success, zero for failure
+*/
+int          jsw_ferase ( jsw_flat_t *ftab, void *key );
+
+/*
+  Rehash so that at least new_size items fit without growing
+
+  Returns: non-zero for success, zero for failure
+*/
+int          jsw_fresize ( jsw_flat_t *ftab, size_t new_size );
+
+/* Reset the traversal markers to the beginning */
+void         jsw_freset ( jsw_flat_t *ftab );
+
+/* Traverse forward by one key */
+int          jsw_fnext ( jsw_flat_t *ftab );
+
+/* Get the current key */
+const void  *jsw_fkey ( jsw_flat_t *ftab );
+
+/* Get the current item */
+void        *jsw_fitem ( jsw_flat_t *ftab );
+
+/* Current number of items in the table */
+size_t       jsw_fsize ( jsw_flat_t *ftab );
+
+/* Total allowable number of items without resizing */
+size_t       jsw_fcapacity ( jsw_flat_t *ftab );
+
+/* Get statistics for the hash table */
+jsw_fstat_t *jsw_fstat ( jsw_flat_t *ftab );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,261 @@
+/*
+  Frozen search arrays
+
+    > Created (agent): October 14, 2026
+
+  Slot k has its children at 2k and 2k + 1, so a search is
+  k = 2k + (item < key) until k runs off the end. The path
+  taken is then the bits of k, and shifting off the
+  trailing ones (the right turns since the last left turn)
+  and one more bit gives the slot where the search last
+  went left, which is the first item not less than the key.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+#include "jsw_frozen.h"
+
+#ifdef __cplusplus
+#include <cstdlib>
+
+using std::malloc;
+using std::free;
+#else
+#include <stdlib.h>
+#endif
+
+/* Searches interleaved by the batch lookup */
+#ifndef FIND_GROUP
+#define FIND_GROUP 8
+#endif
+
+/*
+  Levels a single search prefetches ahead. The 2^AHEAD
+  descendants of a slot are consecutive, so four levels
+  are 16 pointers, two cache lines
+*/
+#ifndef AHEAD
+#define AHEAD 4
+#endif
+
+/* Software prefetch hint, nothing where the compiler has none */
+#if defined ( __GNUC__ )
+#define PREFETCH(p) __builtin_prefetch ( (p) )
+#else
+#define PREFETCH(p) ( (void)0 )
+#endif
+
+struct jsw_frozen {
+  void  **items; /* Slots 1 to size in Eytzinger order, slot 0 unused */
+  size_t  size;  /* Number of items */
+  cmp_f   cmp;   /* Compare two items */
+  rel_f   rel;   /* Destroy an item (user-defined) */
+};
+
+/*
+  Undo the right turns at the end of a search path, and
+  the left turn before them
+*/
+static size_t ascend ( size_t k )
+{
+#if defined ( __GNUC__ )
+  return k >> ( __builtin_ctzll ( ~(unsigned long long)k ) + 1 );
+#else
+  while ( k & 1 )
+    k >>= 1;
+
+  return k >> 1;
+#endif
+}
+
+/* Slot k and up, or slot 0 once that is past the end */
+#define SLOT(fz,k) ( (fz)->items + ( (k) <= (fz)->size ? (k) : 0 ) )
+
+/* Fill the subtree at slot k in order, from items[*i] on */
+static void fill ( jsw_frozen_t *fz, dup_f dup, void **items, size_t *i,
+                   size_t k )
+{
+  if ( k <= fz->size ) {
+    fill ( fz, dup, items, i, 2 * k );
+    fz->items[k] = dup ( items[( *i )++] );
+    fill ( fz, dup, items, i, 2 * k + 1 );
+  }
+}
+
+jsw_frozen_t *jsw_fznew ( cmp_f cmp, dup_f dup, rel_f rel,
+                          void **items, size_t n )
+{
+  jsw_frozen_t *fz;
+  size_t i;
+
+  for ( i = 1; i < n; i++ ) {
+    if ( cmp ( items[i - 1], items[i] ) >= 0 )
+      return NULL;
+  }
+
+  fz = (jsw_frozen_t *)malloc ( sizeof *fz );
+
+  if ( fz == NULL )
+    return NULL;
+
+  fz->items = (void **)malloc ( ( n + 1 ) * sizeof *fz->items );
+
+  if ( fz->items == NULL ) {
+    free ( fz );
+    return NULL;
+  }
+
+  fz->size = n;
+  fz->cmp = cmp;
+  fz->rel = rel;
+  fz->items[0] = NULL;
+
+  i = 0;
+  fill ( fz, dup, items, &i, 1 );
+
+  return fz;
+}
+
+void jsw_fzdelete ( jsw_frozen_t *fz )
+{
+  size_t i;
+
+  for ( i = 1; i <= fz->size; i++ )
+    fz->rel ( fz->items[i] );
+
+  free ( fz->items );
+  free ( fz );
+}
+
+/* Descend for the first item not less than data, or greater with strict */
+static size_t descend ( jsw_frozen_t *fz, void *data, int strict )
+{
+  size_t k = 1;
+
+  while ( k <= fz->size ) {
+    PREFETCH ( SLOT ( fz, k << AHEAD ) );
+    k = 2 * k + ( fz->cmp ( fz->items[k], data ) < strict );
+  }
+
+  return ascend ( k );
+}
+
+void *jsw_fzfind ( jsw_frozen_t *fz, void *data )
+{
+  size_t k = descend ( fz, data, 0 );
+
+  if ( k != 0 && fz->cmp ( fz->items[k], data ) == 0 )
+    return fz->items[k];
+
+  return NULL;
+}
+
+/*
+  Batch lookup. Each step moves every search in a group
+  down one level, then prefetches the slots of its
+  grandchildren and the item it compares next, whose
+  slot was prefetched two steps before
+*/
+size_t jsw_fzfind_many ( jsw_frozen_t *fz, void **data, size_t n,
+                         void **out )
+{
+  size_t k[FIND_GROUP];
+  size_t found = 0;
+  size_t i, j, m, live;
+
+  for ( i = 0; i < n; i += m ) {
+    m = n - i < FIND_GROUP ? n - i : FIND_GROUP;
+
+    for ( j = 0; j < m; j++ )
+      k[j] = 1;
+
+    for ( live = fz->size > 0 ? m : 0; live > 0; ) {
+      for ( j = 0; j < m; j++ ) {
+        if ( k[j] > fz->size )
+          continue;
+
+        k[j] = 2 * k[j] + ( fz->cmp ( fz->items[k[j]], data[i + j] ) < 0 );
+
+        if ( k[j] > fz->size ) {
+          --live;
+          continue;
+        }
+
+        PREFETCH ( SLOT ( fz, 4 * k[j] ) );
+        PREFETCH ( fz->items[k[j]] );
+      }
+    }
+
+    for ( j = 0; j < m; j++ ) {
+      size_t pos = ascend ( k[j] );
+
+      out[i + j] = NULL;
+
+      if ( pos != 0 && fz->cmp ( fz->items[pos], data[i + j] ) == 0 ) {
+        out[i + j] = fz->items[pos];
+        ++found;
+      }
+    }
+  }
+
+  return found;
+}
+
+size_t jsw_fzsize ( jsw_frozen_t *fz )
+{
+  return fz->size;
+}
+
+size_t jsw_fzfirst ( jsw_frozen_t *fz )
+{
+  size_t k = 1;
+
+  if ( fz->size == 0 )
+    return 0;
+
+  while ( 2 * k <= fz->size )
+    k *= 2;
+
+  return k;
+}
+
+/* The leftmost slot of the right subtree, or the nearest left turn up */
+size_t jsw_fznext ( jsw_frozen_t *fz, size_t pos )
+{
+  if ( pos == 0 )
+    return 0;
+
+  if ( 2 * pos + 1 <= fz->size ) {
+    pos = 2 * pos + 1;
+
+    while ( 2 * pos <= fz->size )
+      pos *= 2;
+
+    return pos;
+  }
+
+  return ascend ( pos );
+}
+
+size_t jsw_fzlower ( jsw_frozen_t *fz, void *data )
+{
+  return descend ( fz, data, 0 );
+}
+
+size_t jsw_fzupper ( jsw_frozen_t *fz, void *data )
+{
+  return descend ( fz, data, 1 );
+}
+
+void *jsw_fzitem ( jsw_frozen_t *fz, size_t pos )
+{
+  return pos != 0 && pos <= fz->size ? fz->items[pos] : NULL;
+}
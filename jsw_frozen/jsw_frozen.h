@@ -0,0 +1,103 @@
+#ifndef JSW_FROZEN_H
+#define JSW_FROZEN_H
+
+/*
+  Frozen search arrays
+
+    > Created (agent): October 14, 2026
+
+  An immutable copy of an ordered container, for data that
+  is built once and then only searched. The items are laid
+  out in Eytzinger order (the breadth first order of a
+  perfectly balanced tree) in one array, so the first levels
+  of every search share a few cache lines, the children of a
+  slot sit next to each other and can be prefetched, and the
+  descent needs no branch on the comparison.
+
+  Fill an array from a tree traversal and freeze it:
+
+    for ( it = jsw_rbtfirst ( trav, tree ); it != NULL;
+          it = jsw_rbtnext ( trav ) )
+      items[n++] = it;
+
+    fz = jsw_fznew ( cmp, dup, rel, items, n );
+
+  Positions are 1 based, with 0 meaning no item.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+#ifdef __cplusplus
+#include <cstddef>
+
+using std::size_t;
+
+extern "C" {
+#else
+#include <stddef.h>
+#endif
+
+typedef struct jsw_frozen jsw_frozen_t;
+
+/* User-defined item handling, as in the tree libraries */
+typedef int   (*cmp_f) ( const void *p1, const void *p2 );
+typedef void *(*dup_f) ( void *p );
+typedef void  (*rel_f) ( void *p );
+
+/*
+  Freeze n items given in strictly increasing order. Each
+  is copied with dup and released with rel on delete
+
+  Returns: The frozen array, or NULL if the items are out
+  of order or memory runs out
+*/
+jsw_frozen_t *jsw_fznew ( cmp_f cmp, dup_f dup, rel_f rel,
+                          void **items, size_t n );
+
+/* Release the array and every item in it */
+void          jsw_fzdelete ( jsw_frozen_t *fz );
+
+/*
+  Find an item matching data
+
+  Returns: The item, or NULL if not found
+*/
+void         *jsw_fzfind ( jsw_frozen_t *fz, void *data );
+
+/*
+  Find n items at once, out[i] getting the match for
+  data[i] or NULL. Searches run interleaved, so their
+  cache misses overlap
+
+  Returns: The number of items found
+*/
+size_t        jsw_fzfind_many ( jsw_frozen_t *fz, void **data, size_t n,
+                                void **out );
+
+/* Number of items in the array */
+size_t        jsw_fzsize ( jsw_frozen_t *fz );
+
+/* Position of the smallest item, and of the next one in order */
+size_t        jsw_fzfirst ( jsw_frozen_t *fz );
+size_t        jsw_fznext ( jsw_frozen_t *fz, size_t pos );
+
+/* Position of the first item not less than, or greater than, data */
+size_t        jsw_fzlower ( jsw_frozen_t *fz, void *data );
+size_t        jsw_fzupper ( jsw_frozen_t *fz, void *data );
+
+/* Item at a position, or NULL for position 0 */
+void         *jsw_fzitem ( jsw_frozen_t *fz, size_t pos );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -9,345 +9,1595 @@
       Fixed jsw_resize, which freed the old table
       without returning the new one, and also fixed
       it so that it doesn't copy all the keys and items
+    > Modified (agent): October 14, 2026
+      Cached each key's hash, kept lookups from writing
+      to the table, stopped erasure from resetting
+      traversal, and added load factor growth, a power
+      of two mode, allocator hooks, batch, hashed and
+      bulk calls, inline keys, JSW_STATS counters and
+      clear
 */
 #include "jsw_hlib.h"
 
 #ifdef __cplusplus
 #include <cstdlib>
+#include <cstring>
 
 using std::malloc;
 using std::calloc;
 using std::free;
+using std::memcmp;
+using std::memcpy;
 #else
 #include <stdlib.h>
+#include <string.h>
 #endif
 
+/* Keys hashed together by the batch lookup */
+#ifndef FIND_GROUP
+#define FIND_GROUP 8
+#endif
+
+/* Most levels a bulk load or forked resize splits, 2^8 jobs */
+#ifndef FORK_LIMIT
+#define FORK_LIMIT 8
+#endif
+
+/* Software prefetch hint, nothing where the compiler has none */
+#if defined ( __GNUC__ )
+#define PREFETCH(p) __builtin_prefetch ( (p) )
+#else
+#define PREFETCH(p) ( (void)0 )
+#endif
+
+/*
+  Hot path counters, kept only with JSW_STATS. Without it
+  these do nothing and the table has no stats field. TALLY
+  counts into any jsw_stats_t, so forked jobs can keep
+  their own and add them to the table's afterwards
+*/
+#ifdef JSW_STATS
+#define TALLY(s,f) ( (void)++(s)->f )
+#define TALLY_PROBE(s,n) do {             \
+  (s)->probes += (n);                     \
+  if ( (n) > (s)->maxprobe )              \
+    (s)->maxprobe = (n);                  \
+} while (0)
+#define STATS(h) ( &(h)->stats )
+#else
+#define TALLY(s,f) ( (void)0 )
+#define TALLY_PROBE(s,n) ( (void)(n) )
+#define STATS(h) ( (jsw_stats_t *)NULL )
+#endif
+
+#define STAT(h,f) TALLY ( STATS ( h ), f )
+#define STAT_PROBE(h,n) TALLY_PROBE ( STATS ( h ), n )
+
+/* All zero, for new tables and for builds without JSW_STATS */
+static const jsw_stats_t no_stats = { 0 };
+
 typedef struct jsw_node {
   void            *key;  /* Key used for searching */
   void            *item; /* Actual content of a node */
+  unsigned         hash; /* Full hash of the key */
   struct jsw_node *next; /* Next link in the chain */
 } jsw_node_t;
 
+/*
+  Nodes of a table with inline keys carry a length prefix,
+  followed by the key bytes themselves when they fit
+*/
+typedef struct jsw_keyed {
+  jsw_node_t node; /* Ordinary node, key points at the bytes */
+  size_t     len;  /* Key length, as keylen measures it */
+} jsw_keyed_t;
+
+#define KEYLEN(p) ( ( (jsw_keyed_t *)(p) )->len )
+
 typedef struct jsw_head {
   jsw_node_t *first;     /* First link in the chain */
   size_t      size;      /* Length of the chain */
 } jsw_head_t;
 
+struct jsw_htrav {
+  jsw_hash_t *htab; /* Paired hash table */
+  size_t      i;    /* Current chain index */
+  jsw_node_t *it;   /* Current node */
+};
+
 struct jsw_hash {
   jsw_head_t **table;    /* Dynamic chained hash table */
   size_t       size;     /* Current item count */
   size_t       capacity; /* Current table size */
   size_t       curri;    /* Current index for traversal */
   jsw_node_t  *currl;    /* Current link for traversal */
+  jsw_head_t **old;      /* Table being drained by an incremental resize */
+  size_t       oldcap;   /* Size of the old table */
+  size_t       migrate;  /* Next old bucket to move */
+  double       maxload;  /* Load factor that triggers growth (0 = never) */
+  size_t       step;     /* Buckets moved per operation (0 = all at once) */
+  unsigned     flags;    /* Creation flags (JSW_HPOW2) */
   hash_f       hash;     /* User defined key hash function */
   cmp_f        cmp;      /* User defined key comparison function */
   keydup_f     keydup;   /* User defined key copy function */
   itemdup_f    itemdup;  /* User defined item copy function */
   keyrel_f     keyrel;   /* User defined key delete function */
   itemrel_f    itemrel;  /* User defined item delete function */
+  keylen_f     keylen;   /* Measures keys stored inline (NULL = never) */
+  size_t       maxinline; /* Longest key stored inline */
+  jsw_alloc_t  mem;      /* Node and chain head allocator */
+#ifdef JSW_STATS
+  jsw_stats_t  stats;    /* Hot path counters */
+#endif
 };
 
-static jsw_node_t *new_node ( void *key, void *item, jsw_node_t *next )
+/* Default node allocator hooks */
+static void *std_alloc ( void *ctx, size_t size )
+{
+  (void)ctx;
+  return malloc ( size );
+}
+
+static void std_release ( void *ctx, void *p, size_t size )
+{
+  (void)ctx;
+  (void)size;
+  free ( p );
+}
+
+/* Stands in for a NULL keyrel or itemrel */
+static void no_rel ( void *p )
+{
+  (void)p;
+}
+
+/* Nodes and chain heads go back to the table's allocator */
+#define RELEASE(htab,p) ( STAT ( htab, releases ), \
+  (htab)->mem.release ( (htab)->mem.ctx, (p), sizeof *(p) ) )
+
+/* Inline keys are as long as their nodes, other keys were copied */
+static int inline_key ( jsw_hash_t *htab, jsw_node_t *node )
+{
+  return htab->keylen != NULL && KEYLEN ( node ) <= htab->maxinline;
+}
+
+static size_t node_size ( jsw_hash_t *htab, jsw_node_t *node )
+{
+  if ( htab->keylen == NULL )
+    return sizeof *node;
+
+  return sizeof ( jsw_keyed_t ) +
+    ( inline_key ( htab, node ) ? KEYLEN ( node ) : 0 );
+}
+
+#define RELEASE_NODE(htab,p) ( STAT ( htab, releases ), \
+  (htab)->mem.release ( (htab)->mem.ctx, (p), node_size ( (htab), (p) ) ) )
+
+/* Release a node's key, unless it lives in the node */
+static void release_key ( jsw_hash_t *htab, jsw_node_t *node )
+{
+  if ( !inline_key ( htab, node ) )
+    htab->keyrel ( node->key );
+}
+
+/*
+  Make a node holding copies of key and item. A key short
+  enough for the inline limit is copied into the node itself,
+  so only one allocation is made for it. Forked jobs call
+  this directly, and count the allocation themselves
+*/
+static jsw_node_t *make_node ( jsw_hash_t *htab, void *key, void *item,
+  unsigned hash )
 {
-  jsw_node_t *node = (jsw_node_t *)malloc ( sizeof *node );
+  jsw_node_t *node;
+  size_t len = 0;
+  size_t size = sizeof *node;
+
+  if ( htab->keylen != NULL ) {
+    len = htab->keylen ( key );
+    size = sizeof ( jsw_keyed_t ) + ( len <= htab->maxinline ? len : 0 );
+  }
+
+  node = (jsw_node_t *)htab->mem.alloc ( htab->mem.ctx, size );
 
   if ( node == NULL )
     return NULL;
 
-  node->key = key;
-  node->item = item;
-  node->next = next;
+  if ( htab->keylen != NULL )
+    KEYLEN ( node ) = len;
+
+  if ( htab->keylen != NULL && len <= htab->maxinline )
+    node->key = memcpy ( (jsw_keyed_t *)node + 1, key, len );
+  else
+    node->key = htab->keydup ( key );
+
+  node->item = htab->itemdup ( item );
+  node->hash = hash;
+  node->next = NULL;
+
+  return node;
+}
+
+static jsw_node_t *new_node ( jsw_hash_t *htab, void *key, void *item,
+  unsigned hash )
+{
+  jsw_node_t *node = make_node ( htab, key, item, hash );
+
+  if ( node != NULL )
+    STAT ( htab, allocs );
+
+  return node;
+}
+
+static jsw_head_t *make_chain ( jsw_hash_t *htab )
+{
+  jsw_head_t *chain = (jsw_head_t *)htab->mem.alloc (
+    htab->mem.ctx, sizeof *chain );
+
+  if ( chain == NULL )
+    return NULL;
+
+  chain->first = NULL;
+  chain->size = 0;
+
+  return chain;
+}
+
+static jsw_head_t *new_chain ( jsw_hash_t *htab )
+{
+  jsw_head_t *chain = make_chain ( htab );
+
+  if ( chain != NULL )
+    STAT ( htab, allocs );
+
+  return chain;
+}
+
+/*
+  Hash a key for this table. Power of two tables index with
+  a mask, so the user hash gets a final avalanche (the mixer
+  from MurmurHash3) to spread weak hashes across the low bits.
+  The mix is a bijection, so equal stored hashes still mean
+  equal user hashes
+*/
+static unsigned mix_hash ( jsw_hash_t *htab, unsigned h )
+{
+  if ( htab->flags & JSW_HPOW2 ) {
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+  }
+
+  return h;
+}
+
+static unsigned hash_key ( jsw_hash_t *htab, const void *key )
+{
+  return mix_hash ( htab, htab->hash ( key ) );
+}
+
+/* Map a hash to one of n buckets */
+static size_t bucket ( jsw_hash_t *htab, unsigned h, size_t n )
+{
+  if ( htab->flags & JSW_HPOW2 )
+    return h & ( n - 1 );
+
+  return h % n;
+}
+
+/* Round a requested size to what the table can use */
+static size_t table_size ( jsw_hash_t *htab, size_t size )
+{
+  size_t n = 1;
+
+  if ( !( htab->flags & JSW_HPOW2 ) )
+    return size;
+
+  while ( n < size ) {
+    if ( n > (size_t)-1 / 2 )
+      return 0;
+
+    n *= 2;
+  }
+
+  return n;
+}
+
+/*
+  Find the chain that holds, or would hold, a key with
+  the given hash. While an incremental resize is running,
+  buckets of the old table that have not been moved yet
+  are still authoritative for their keys
+*/
+static jsw_head_t **chain_for ( jsw_hash_t *htab, unsigned h )
+{
+  if ( htab->old != NULL ) {
+    size_t i = bucket ( htab, h, htab->oldcap );
+
+    if ( i >= htab->migrate )
+      return &htab->old[i];
+  }
+
+  return &htab->table[bucket ( htab, h, htab->capacity )];
+}
+
+/*
+  Search a chain for key, matching with eq if it isn't
+  NULL or the table's cmp if it is. Comparing the stored
+  hashes first skips the user comparison for nearly every
+  node that can't match. Tables with inline keys match
+  lengths and bytes instead of calling cmp. The search is
+  counted in stats
+*/
+static jsw_node_t *scan_chain ( jsw_hash_t *htab, jsw_head_t *chain,
+  const void *key, unsigned h, keyeq_f eq, jsw_stats_t *stats )
+{
+  jsw_node_t *it;
+  unsigned long n = 0;
+  size_t len = 0;
+
+  (void)stats;
+
+  /* Empty chains have no head */
+  if ( chain == NULL )
+    return NULL;
+
+  if ( eq == NULL && htab->keylen != NULL )
+    len = htab->keylen ( key );
+
+  for ( it = chain->first; it != NULL; it = it->next ) {
+    ++n;
+
+    if ( it->hash == h ) {
+      TALLY ( stats, cmps );
+
+      if ( eq != NULL ) {
+        if ( eq ( key, it->key ) )
+          break;
+      }
+      else if ( htab->keylen != NULL ) {
+        if ( KEYLEN ( it ) == len && memcmp ( key, it->key, len ) == 0 )
+          break;
+      }
+      else if ( htab->cmp ( key, it->key ) == 0 )
+        break;
+    }
+  }
+
+  TALLY_PROBE ( stats, n );
+
+  return it;
+}
+
+static jsw_node_t *chain_find ( jsw_hash_t *htab, jsw_head_t *chain,
+  const void *key, unsigned h, keyeq_f eq )
+{
+  return scan_chain ( htab, chain, key, h, eq, STATS ( htab ) );
+}
+
+/* Number of chains visible to traversal, including the old table */
+static size_t chain_count ( jsw_hash_t *htab )
+{
+  return htab->capacity + ( htab->old != NULL ? htab->oldcap : 0 );
+}
+
+/* Chain at a traversal index (the old table follows the new one) */
+static jsw_head_t *chain_at ( jsw_hash_t *htab, size_t i )
+{
+  if ( i < htab->capacity )
+    return htab->table[i];
+
+  return htab->old[i - htab->capacity];
+}
+
+/*
+  Unlink a node from its chain and release it, along with
+  the chain head if that empties it. Traversal markers on
+  the node move to the next item first
+*/
+static void remove_node ( jsw_hash_t *htab, jsw_head_t **chain,
+  jsw_node_t *node )
+{
+  jsw_node_t **it = &( *chain )->first;
+
+  if ( htab->currl == node )
+    jsw_hnext ( htab );
+
+  while ( *it != node )
+    it = &( *it )->next;
+
+  *it = node->next;
+
+  /* Release the node's memory */
+  release_key ( htab, node );
+  htab->itemrel ( node->item );
+  RELEASE_NODE ( htab, node );
+
+  /* Remove the chain if it's empty */
+  if ( ( *chain )->first == NULL ) {
+    RELEASE ( htab, *chain );
+    *chain = NULL;
+  }
+  else
+    --( *chain )->size;
+
+  --htab->size;
+}
+
+/*
+  Move up to n buckets from the old table into the new one.
+  Every head a bucket needs is allocated before any of its
+  nodes move, so a failure leaves the table consistent
+
+  Returns: non-zero for success, zero for failure
+*/
+static int migrate ( jsw_hash_t *htab, size_t n )
+{
+  jsw_node_t *it, *next;
+
+  for ( ; n > 0 && htab->migrate < htab->oldcap; n-- ) {
+    jsw_head_t *chain = htab->old[htab->migrate];
+
+    if ( chain != NULL ) {
+      for ( it = chain->first; it != NULL; it = it->next ) {
+        size_t h = bucket ( htab, it->hash, htab->capacity );
+
+        if ( htab->table[h] == NULL ) {
+          htab->table[h] = new_chain ( htab );
+
+          if ( htab->table[h] == NULL ) {
+            /* Heads allocated for this bucket are still empty */
+            for ( next = chain->first; next != it; next = next->next ) {
+              h = bucket ( htab, next->hash, htab->capacity );
+
+              if ( htab->table[h] != NULL
+                && htab->table[h]->first == NULL )
+              {
+                RELEASE ( htab, htab->table[h] );
+                htab->table[h] = NULL;
+              }
+            }
+
+            return 0;
+          }
+        }
+      }
+
+      for ( it = chain->first; it != NULL; it = next ) {
+        size_t h = bucket ( htab, it->hash, htab->capacity );
+
+        /* Remember old next before we overwrite it */
+        next = it->next;
+
+        /* Insert at the front of the new chain */
+        it->next = htab->table[h]->first;
+        htab->table[h]->first = it;
+
+        ++htab->table[h]->size;
+      }
+
+      RELEASE ( htab, chain );
+      htab->old[htab->migrate] = NULL;
+    }
+
+    ++htab->migrate;
+  }
+
+  if ( htab->old != NULL && htab->migrate == htab->oldcap ) {
+    free ( htab->old );
+    htab->old = NULL;
+    htab->oldcap = 0;
+    htab->migrate = 0;
+
+    /* Traversal markers can't point past the new table */
+    if ( htab->curri >= htab->capacity ) {
+      htab->curri = htab->capacity;
+      htab->currl = NULL;
+    }
+  }
+
+  return 1;
+}
+
+/*
+  Start growing once the load factor limit has been passed.
+  Failure isn't fatal; the table just stays at its current size
+*/
+static void grow ( jsw_hash_t *htab )
+{
+  size_t new_size = table_size ( htab, htab->capacity * 2 + 1 );
+  jsw_head_t **new_table;
+
+  if ( htab->step == 0 ) {
+    jsw_hresize ( htab, new_size );
+    return;
+  }
+
+  if ( new_size == 0 )
+    return;
+
+  new_table = (jsw_head_t **)calloc ( new_size, sizeof *new_table );
+
+  if ( new_table == NULL )
+    return;
+
+  /* The current table becomes the old one and drains as we go */
+  htab->old = htab->table;
+  htab->oldcap = htab->capacity;
+  htab->migrate = 0;
+  htab->table = new_table;
+  htab->capacity = new_size;
+
+  /* Keep traversal markers pointing at the same chain */
+  htab->curri += new_size;
+  STAT ( htab, resizes );
+}
+
+/*
+  Create a new hash table with a capacity of size, and
+  user defined functions for handling keys and items.
+
+  Returns: An empty hash table, or NULL on failure.
+*/
+jsw_hash_t  *jsw_hnew ( size_t size, hash_f hash, cmp_f cmp,
+  keydup_f keydup, itemdup_f itemdup,
+  keyrel_f keyrel, itemrel_f itemrel )
+{
+  return jsw_hnew_flags ( size, 0, hash, cmp,
+    keydup, itemdup, keyrel, itemrel );
+}
+
+/*
+  Create a new hash table like jsw_hnew, with creation
+  flags. JSW_HPOW2 rounds the capacity (now and after every
+  resize) up to a power of two and indexes with a mask
+
+  Returns: An empty hash table, or NULL on failure.
+*/
+jsw_hash_t  *jsw_hnew_flags ( size_t size, unsigned flags,
+  hash_f hash, cmp_f cmp, keydup_f keydup, itemdup_f itemdup,
+  keyrel_f keyrel, itemrel_f itemrel )
+{
+  return jsw_hnew_alloc ( size, flags, hash, cmp,
+    keydup, itemdup, keyrel, itemrel, NULL );
+}
+
+/*
+  Create a new hash table like jsw_hnew_flags, whose nodes
+  and chain heads come from a user defined allocator, or
+  malloc if alloc is NULL. The bucket array always uses malloc
+
+  Returns: An empty hash table, or NULL on failure.
+*/
+jsw_hash_t  *jsw_hnew_alloc ( size_t size, unsigned flags,
+  hash_f hash, cmp_f cmp, keydup_f keydup, itemdup_f itemdup,
+  keyrel_f keyrel, itemrel_f itemrel, const jsw_alloc_t *alloc )
+{
+  jsw_hash_t *htab = (jsw_hash_t *)malloc ( sizeof *htab );
+  size_t i;
+
+  if ( htab == NULL )
+    return NULL;
+
+  htab->flags = flags;
+  size = table_size ( htab, size );
+
+  if ( size == 0 ) {
+    free ( htab );
+    return NULL;
+  }
+
+  htab->table = (jsw_head_t **)malloc ( size * sizeof *htab->table );
+
+  if ( htab->table == NULL ) {
+    free ( htab );
+    return NULL;
+  }
+
+  /* Empty chains have no head */
+  for ( i = 0; i < size; i++ )
+    htab->table[i] = NULL;
+
+  htab->size = 0;
+  htab->capacity = size;
+  htab->curri = 0;
+  htab->currl = NULL;
+  htab->old = NULL;
+  htab->oldcap = 0;
+  htab->migrate = 0;
+  htab->maxload = 0;
+  htab->step = 0;
+  htab->hash = hash;
+  htab->cmp = cmp;
+  htab->keydup = keydup;
+  htab->itemdup = itemdup;
+  htab->keyrel = keyrel != NULL ? keyrel : no_rel;
+  htab->itemrel = itemrel != NULL ? itemrel : no_rel;
+  htab->keylen = NULL;
+  htab->maxinline = 0;
+#ifdef JSW_STATS
+  htab->stats = no_stats;
+#endif
+
+  if ( alloc != NULL )
+    htab->mem = *alloc;
+  else {
+    htab->mem.alloc = std_alloc;
+    htab->mem.release = std_release;
+    htab->mem.purge = NULL;
+    htab->mem.ctx = NULL;
+  }
+
+  return htab;
+}
+
+/*
+  Release every chain in one bucket array, leaving the
+  array itself. Chains are only walked when a key or item
+  needs releasing or nodes have no purge hook to go back with
+*/
+static void release_chains ( jsw_hash_t *htab, jsw_head_t **table, size_t n )
+{
+  size_t i;
+
+  if ( htab->keyrel == no_rel && htab->itemrel == no_rel
+    && htab->mem.purge != NULL )
+  {
+    return;
+  }
+
+  /* Release each chain individually */
+  for ( i = 0; i < n; i++ ) {
+    jsw_node_t *save, *it;
+
+    if ( table[i] == NULL )
+      continue;
+
+    it = table[i]->first;
+
+    for ( ; it != NULL; it = save ) {
+      save = it->next;
+      release_key ( htab, it );
+      htab->itemrel ( it->item );
+
+      /* A purge hook releases every node at the end */
+      if ( htab->mem.purge == NULL )
+        RELEASE_NODE ( htab, it );
+    }
+
+    if ( htab->mem.purge == NULL )
+      RELEASE ( htab, table[i] );
+  }
+}
+
+/* Release all memory used by the hash table */
+void jsw_hdelete ( jsw_hash_t *htab )
+{
+  release_chains ( htab, htab->table, htab->capacity );
+  free ( htab->table );
+
+  /* An unfinished resize leaves nodes behind */
+  if ( htab->old != NULL ) {
+    release_chains ( htab, htab->old, htab->oldcap );
+    free ( htab->old );
+  }
+
+  if ( htab->mem.purge != NULL )
+    htab->mem.purge ( htab->mem.ctx );
+
+  /* Release the hash table */
+  free ( htab );
+}
+
+/*
+  Remove every item, keeping the bucket array (but not the
+  old one of an unfinished resize) for reuse
+*/
+void jsw_hclear ( jsw_hash_t *htab )
+{
+  size_t i;
+
+  release_chains ( htab, htab->table, htab->capacity );
+
+  if ( htab->old != NULL ) {
+    release_chains ( htab, htab->old, htab->oldcap );
+    free ( htab->old );
+    htab->old = NULL;
+    htab->oldcap = 0;
+    htab->migrate = 0;
+  }
+
+  if ( htab->mem.purge != NULL )
+    htab->mem.purge ( htab->mem.ctx );
+
+  for ( i = 0; i < htab->capacity; i++ )
+    htab->table[i] = NULL;
+
+  htab->size = 0;
+  htab->curri = 0;
+  htab->currl = NULL;
+}
+
+/*
+  Find an item with the selected key. Only insertions
+  and erasures move buckets during a resize, so this
+  never modifies the table
+
+  Returns: The item, or NULL if not found
+*/
+void *jsw_hfind ( jsw_hash_t *htab, void *key )
+{
+  unsigned h = hash_key ( htab, key );
+  jsw_node_t *it = chain_find ( htab, *chain_for ( htab, h ), key, h, NULL );
+
+  return it == NULL ? NULL : it->item;
+}
+
+/*
+  Find an item by a hash the caller already has, matching
+  probe against stored keys with eq (or cmp if eq is NULL),
+  so the probe can be any type eq understands. The hash must
+  be what the table's hash function gives the stored key
+
+  Returns: The item, or NULL if not found
+*/
+void *jsw_hfind_hashed ( jsw_hash_t *htab, unsigned hash, const void *probe,
+  keyeq_f eq )
+{
+  unsigned h = mix_hash ( htab, hash );
+  jsw_node_t *it = chain_find ( htab, *chain_for ( htab, h ), probe, h, eq );
+
+  return it == NULL ? NULL : it->item;
+}
+
+/*
+  Find items for n keys at once, storing each item (or
+  NULL) in out. Every key in a group is hashed and its
+  bucket prefetched, then the chain heads and their first
+  nodes, before any chain is searched, so the misses overlap
+
+  Returns: The number of keys found
+*/
+size_t jsw_hfind_many ( jsw_hash_t *htab, void **keys, size_t n, void **out )
+{
+  jsw_head_t **slot[FIND_GROUP];
+  unsigned h[FIND_GROUP];
+  size_t found = 0;
+  size_t i, j, m;
+
+  for ( i = 0; i < n; i += m ) {
+    m = n - i < FIND_GROUP ? n - i : FIND_GROUP;
+
+    for ( j = 0; j < m; j++ ) {
+      h[j] = hash_key ( htab, keys[i + j] );
+      slot[j] = chain_for ( htab, h[j] );
+      PREFETCH ( slot[j] );
+    }
+
+    for ( j = 0; j < m; j++ ) {
+      if ( *slot[j] != NULL )
+        PREFETCH ( *slot[j] );
+    }
+
+    for ( j = 0; j < m; j++ ) {
+      if ( *slot[j] != NULL )
+        PREFETCH ( ( *slot[j] )->first );
+    }
+
+    for ( j = 0; j < m; j++ ) {
+      jsw_node_t *it = chain_find ( htab, *slot[j], keys[i + j], h[j],
+        NULL );
+
+      out[i + j] = it == NULL ? NULL : it->item;
+      found += it != NULL;
+    }
+  }
+
+  return found;
+}
+
+/* Insert an item with the selected key and its table hash */
+static int insert_hashed ( jsw_hash_t *htab, unsigned h, void *key,
+  void *item )
+{
+  jsw_head_t **chain;
+  jsw_node_t *new_item;
+
+  /* Do a little of any pending resize */
+  if ( htab->old != NULL )
+    migrate ( htab, htab->step );
+
+  chain = chain_for ( htab, h );
+
+  /* Disallow duplicate keys */
+  if ( chain_find ( htab, *chain, key, h, NULL ) != NULL )
+    return 0;
+
+  /* Attempt to create a new item */
+  new_item = new_node ( htab, key, item, h );
+
+  if ( new_item == NULL )
+    return 0;
+
+  /* Create a chain if the bucket is empty */
+  if ( *chain == NULL ) {
+    *chain = new_chain ( htab );
+
+    if ( *chain == NULL ) {
+      release_key ( htab, new_item );
+      htab->itemrel ( new_item->item );
+      RELEASE_NODE ( htab, new_item );
+      return 0;
+    }
+  }
+
+  /* Insert at the front of the chain */
+  new_item->next = ( *chain )->first;
+  ( *chain )->first = new_item;
+
+  ++( *chain )->size;
+  ++htab->size;
+
+  /* Start growing if the table is getting too full */
+  if ( htab->maxload > 0 && htab->old == NULL
+    && htab->size > htab->maxload * htab->capacity )
+  {
+    grow ( htab );
+  }
+
+  return 1;
+}
+
+/*
+  Insert an item with the selected key
+
+  Returns: non-zero for success, zero for failure
+*/
+int jsw_hinsert ( jsw_hash_t *htab, void *key, void *item )
+{
+  return insert_hashed ( htab, hash_key ( htab, key ), key, item );
+}
+
+/*
+  Insert an item with the selected key, using a hash the
+  caller already has instead of hashing the key. The hash
+  must be what the table's hash function gives the key
+
+  Returns: non-zero for success, zero for failure
+*/
+int jsw_hinsert_hashed ( jsw_hash_t *htab, unsigned hash, void *key,
+  void *item )
+{
+  return insert_hashed ( htab, mix_hash ( htab, hash ), key, item );
+}
+
+/* Remove an item matching key by its table hash, and eq or cmp */
+static int erase_hashed ( jsw_hash_t *htab, unsigned h, const void *key,
+  keyeq_f eq )
+{
+  jsw_head_t **chain;
+  jsw_node_t *it;
+
+  /* Do a little of any pending resize */
+  if ( htab->old != NULL )
+    migrate ( htab, htab->step );
+
+  chain = chain_for ( htab, h );
+  it = chain_find ( htab, *chain, key, h, eq );
+
+  if ( it == NULL )
+    return 0;
+
+  remove_node ( htab, chain, it );
+
+  return 1;
+}
+
+/*
+  Remove an item with the selected key
+
+  Returns: non-zero for success, zero for failure
+*/
+int jsw_herase ( jsw_hash_t *htab, void *key )
+{
+  return erase_hashed ( htab, hash_key ( htab, key ), key, NULL );
+}
+
+/*
+  Remove an item by a hash the caller already has, matching
+  probe with eq (or cmp if eq is NULL) like jsw_hfind_hashed
+
+  Returns: non-zero for success, zero for failure
+*/
+int jsw_herase_hashed ( jsw_hash_t *htab, unsigned hash, const void *probe,
+  keyeq_f eq )
+{
+  return erase_hashed ( htab, mix_hash ( htab, hash ), probe, eq );
+}
+
+/*
+  Remove the item at the traversal markers and move them
+  to the next item. Buckets of a running resize stay put,
+  so a sweep can erase as it goes
+
+  Returns: non-zero for success, zero at end-of-table
+*/
+int jsw_herase_current ( jsw_hash_t *htab )
+{
+  if ( htab->currl == NULL )
+    return 0;
+
+  remove_node ( htab, chain_for ( htab, htab->currl->hash ), htab->currl );
+
+  return 1;
+}
+
+/*
+  Grow or shrink the table, this is a slow operation
+
+  Returns: non-zero for success, zero for failure
+*/
+int jsw_hresize ( jsw_hash_t *htab, size_t new_size )
+{
+  jsw_head_t **new_table;
+  jsw_node_t *it, *next;
+  size_t i;
+
+  /* Finish any incremental resize first */
+  if ( htab->old != NULL && !migrate ( htab, htab->oldcap ) )
+    return 0;
+
+  new_size = table_size ( htab, new_size );
+
+  if ( new_size == 0 )
+    return 0;
+
+  new_table = (jsw_head_t **) calloc ( new_size, sizeof (*new_table) );
+  if ( new_table == NULL )
+    return 0;
+
+  /* Go through the old table once, just to allocate the new heads */
+  for ( i = 0; i < htab->capacity; i++ ) {
+    if ( htab->table[i] == NULL )
+      continue;
+
+    for ( it = htab->table[i]->first; it != NULL; it = it->next ) {
+      size_t h = bucket ( htab, it->hash, new_size );
+
+      /* Create a chain if the bucket is empty */
+      if ( new_table[h] == NULL ) {
+        new_table[h] = new_chain ( htab );
+
+        /* If failure, free everything that has already been allocated */
+        if ( new_table[h] == NULL ) {
+          size_t j;
+
+          for ( j = 0; j < new_size; j++ ) {
+            if ( new_table[j] != NULL )
+              RELEASE ( htab, new_table[j] );
+          }
+
+          free ( new_table );
+          return 0;
+        }
+      }
+    }
+  }
+
+  /* At this point, all allocations are done, so nothing can fail */
+  for ( i = 0; i < htab->capacity; i++ ) {
+    if ( htab->table[i] == NULL )
+      continue;
+
+    for ( it = htab->table[i]->first; it != NULL; it = next ) {
+      size_t h = bucket ( htab, it->hash, new_size );
+
+      /* Remember old next before we overwrite it */
+      next = it->next;
+
+      /* Insert at the front of the new chain */
+      it->next = new_table[h]->first;
+      new_table[h]->first = it;
+
+      ++new_table[h]->size;
+    }
+
+    /* Free old head */
+    RELEASE ( htab, htab->table[i] );
+  }
+
+  /* Install the new table in the existing htab */
+  free ( htab->table );
+  htab->table = new_table;
+  htab->capacity = new_size;
+
+  /* Invalidate traversal information */
+  htab->curri = 0;
+  htab->currl = NULL;
+  STAT ( htab, resizes );
+
+  return 1;
+}
+
+/*
+  Work shared by the jobs of a bulk load or a forked resize.
+  Every job owns a slice of the input or a range of buckets
+  that no other job touches, so none of them takes a lock
+*/
+typedef struct jsw_hbulk {
+  jsw_hash_t   *htab;     /* Table being loaded or resized */
+  size_t        jobs;     /* Number of jobs, a power of two */
+  size_t        width;    /* Buckets in each range of the table */
+  void        **keys;     /* Keys to load */
+  void        **items;    /* Items to load */
+  size_t        n;        /* Number of keys */
+  unsigned     *hashes;   /* Table hash of each key */
+  size_t       *order;    /* Key indices, grouped by bucket range */
+  size_t       *pos;      /* Next order slot, by slice and range */
+  jsw_head_t  **table;    /* Bucket array the resize fills */
+  size_t        size;     /* Capacity of that array */
+  size_t        newwidth; /* Buckets in each of its ranges */
+  jsw_node_t  **first;    /* Moved nodes, by old range and new range */
+  jsw_node_t  **last;     /* Tails of those lists */
+} jsw_hbulk_t;
+
+typedef struct jsw_hjob {
+  jsw_hbulk_t  *bulk;                     /* Shared work */
+  size_t        id;                       /* Slice or range this job owns */
+  void        (*run) ( struct jsw_hjob * ); /* Step to run */
+  size_t        done;                     /* Items inserted */
+  int           failed;                   /* Non-zero if an allocation failed */
+  jsw_stats_t   stats;                    /* Counted here, added up after */
+} jsw_hjob_t;
+
+/* A run of jobs, halved by every fork */
+typedef struct jsw_hspan {
+  const jsw_fork_t *fork;  /* User fork hook */
+  int               depth; /* Levels left to fork */
+  jsw_hjob_t       *jobs;  /* First job of the span */
+  size_t            n;     /* Number of jobs */
+} jsw_hspan_t;
+
+static void run_span ( void *arg )
+{
+  jsw_hspan_t *span = (jsw_hspan_t *)arg;
+  size_t i;
+
+  if ( span->n > 1 && span->depth > 0 ) {
+    jsw_hspan_t sub[2];
+
+    sub[0] = sub[1] = *span;
+    sub[0].depth = sub[1].depth = span->depth - 1;
+    sub[0].n = span->n / 2;
+    sub[1].jobs += sub[0].n;
+    sub[1].n -= sub[0].n;
+
+    span->fork->fork ( span->fork->ctx, run_span, &sub[0], &sub[1] );
+  }
+  else {
+    for ( i = 0; i < span->n; i++ )
+      span->jobs[i].run ( &span->jobs[i] );
+  }
+}
+
+/* Run one step of every job, forking as deep as the hook allows */
+static void run_jobs ( const jsw_fork_t *fork, jsw_hjob_t *jobs, size_t n,
+  void (*run) ( jsw_hjob_t * ) )
+{
+  jsw_hspan_t span;
+  size_t i;
+
+  for ( i = 0; i < n; i++ )
+    jobs[i].run = run;
+
+  span.fork = fork;
+  span.depth = fork != NULL ? fork->depth : 0;
+  span.jobs = jobs;
+  span.n = n;
+
+  run_span ( &span );
+}
+
+/*
+  Set up jobs for work split over ranges of up to buckets
+  buckets, one job per leaf of the fork
+
+  Returns: The jobs, or NULL on failure
+*/
+static jsw_hjob_t *bulk_init ( jsw_hbulk_t *bulk, jsw_hash_t *htab,
+  const jsw_fork_t *fork, size_t buckets )
+{
+  jsw_hjob_t *jobs;
+  int depth = fork != NULL ? fork->depth : 0;
+  size_t i;
+
+  if ( depth > FORK_LIMIT )
+    depth = FORK_LIMIT;
+
+  bulk->htab = htab;
+  bulk->jobs = 1;
+
+  while ( depth-- > 0 && bulk->jobs * 2 <= buckets )
+    bulk->jobs *= 2;
+
+  bulk->width = ( htab->capacity + bulk->jobs - 1 ) / bulk->jobs;
+  bulk->hashes = NULL;
+  bulk->order = NULL;
+  bulk->pos = NULL;
+  bulk->table = NULL;
+  bulk->first = NULL;
+  bulk->last = NULL;
+
+  jobs = (jsw_hjob_t *)malloc ( bulk->jobs * sizeof *jobs );
+
+  if ( jobs == NULL )
+    return NULL;
+
+  for ( i = 0; i < bulk->jobs; i++ ) {
+    jobs[i].bulk = bulk;
+    jobs[i].id = i;
+    jobs[i].done = 0;
+    jobs[i].failed = 0;
+    jobs[i].stats = no_stats;
+  }
+
+  return jobs;
+}
+
+/* Add up what the jobs did, and free them */
+static void bulk_finish ( jsw_hbulk_t *bulk, jsw_hjob_t *jobs )
+{
+#ifdef JSW_STATS
+  jsw_stats_t *stats = &bulk->htab->stats;
+  size_t i;
+
+  for ( i = 0; i < bulk->jobs; i++ ) {
+    stats->cmps += jobs[i].stats.cmps;
+    stats->probes += jobs[i].stats.probes;
+    stats->allocs += jobs[i].stats.allocs;
+    stats->releases += jobs[i].stats.releases;
+
+    if ( jobs[i].stats.maxprobe > stats->maxprobe )
+      stats->maxprobe = jobs[i].stats.maxprobe;
+  }
+#endif
+
+  free ( bulk->hashes );
+  free ( bulk->order );
+  free ( bulk->pos );
+  free ( bulk->first );
+  free ( bulk->last );
+  free ( jobs );
+}
+
+/* Split each chain of the job's old range by new bucket range */
+static void resize_split ( jsw_hjob_t *job )
+{
+  jsw_hbulk_t *bulk = job->bulk;
+  jsw_hash_t *htab = bulk->htab;
+  size_t lo = job->id * bulk->width;
+  size_t hi = lo + bulk->width < htab->capacity
+    ? lo + bulk->width : htab->capacity;
+  jsw_node_t **first = bulk->first + job->id * bulk->jobs;
+  jsw_node_t **last = bulk->last + job->id * bulk->jobs;
+  jsw_node_t *it, *next;
+  size_t i;
+
+  for ( i = lo; i < hi; i++ ) {
+    if ( htab->table[i] == NULL )
+      continue;
+
+    for ( it = htab->table[i]->first; it != NULL; it = next ) {
+      size_t r = bucket ( htab, it->hash, bulk->size ) / bulk->newwidth;
+
+      next = it->next;
+      it->next = NULL;
+
+      if ( last[r] != NULL )
+        last[r]->next = it;
+      else
+        first[r] = it;
 
-  return node;
+      last[r] = it;
+    }
+
+    /* The empty head stays in case the resize has to be undone */
+    htab->table[i]->first = NULL;
+    htab->table[i]->size = 0;
+  }
 }
 
-static jsw_head_t *new_chain ( void )
+/* Make the chain heads the job's new range will need */
+static void resize_heads ( jsw_hjob_t *job )
 {
-  jsw_head_t *chain = (jsw_head_t *)malloc ( sizeof *chain );
+  jsw_hbulk_t *bulk = job->bulk;
+  jsw_hash_t *htab = bulk->htab;
+  jsw_node_t *it;
+  size_t s;
 
-  if ( chain == NULL )
-    return NULL;
+  for ( s = 0; s < bulk->jobs; s++ ) {
+    it = bulk->first[s * bulk->jobs + job->id];
 
-  chain->first = NULL;
-  chain->size = 0;
+    for ( ; it != NULL; it = it->next ) {
+      size_t h = bucket ( htab, it->hash, bulk->size );
 
-  return chain;
-}
+      if ( bulk->table[h] == NULL ) {
+        bulk->table[h] = make_chain ( htab );
 
-/*
-  Create a new hash table with a capacity of size, and
-  user defined functions for handling keys and items.
+        if ( bulk->table[h] == NULL ) {
+          job->failed = 1;
+          return;
+        }
 
-  Returns: An empty hash table, or NULL on failure.
-*/
-jsw_hash_t  *jsw_hnew ( size_t size, hash_f hash, cmp_f cmp,
-  keydup_f keydup, itemdup_f itemdup,
-  keyrel_f keyrel, itemrel_f itemrel )
+        TALLY ( &job->stats, allocs );
+      }
+    }
+  }
+}
+
+/* Move the nodes headed for the job's new range into their chains */
+static void resize_link ( jsw_hjob_t *job )
 {
-  jsw_hash_t *htab = (jsw_hash_t *)malloc ( sizeof *htab );
-  size_t i;
+  jsw_hbulk_t *bulk = job->bulk;
+  jsw_node_t *it, *next;
+  size_t s;
 
-  if ( htab == NULL )
-    return NULL;
+  for ( s = 0; s < bulk->jobs; s++ ) {
+    it = bulk->first[s * bulk->jobs + job->id];
 
-  htab->table = (jsw_head_t **)malloc ( size * sizeof *htab->table );
+    for ( ; it != NULL; it = next ) {
+      jsw_head_t *chain = bulk->table[bucket ( bulk->htab, it->hash,
+        bulk->size )];
 
-  if ( htab->table == NULL ) {
-    free ( htab );
-    return NULL;
+      next = it->next;
+      it->next = chain->first;
+      chain->first = it;
+      ++chain->size;
+    }
   }
-
-  /* Empty chains have no head */
-  for ( i = 0; i < size; i++ )
-    htab->table[i] = NULL;
-
-  htab->size = 0;
-  htab->capacity = size;
-  htab->curri = 0;
-  htab->currl = NULL;
-  htab->hash = hash;
-  htab->cmp = cmp;
-  htab->keydup = keydup;
-  htab->itemdup = itemdup;
-  htab->keyrel = keyrel;
-  htab->itemrel = itemrel;
-
-  return htab;
 }
 
-/* Release all memory used by the hash table */
-void jsw_hdelete ( jsw_hash_t *htab )
+/* Release the old heads of the job's old range */
+static void resize_release ( jsw_hjob_t *job )
 {
+  jsw_hbulk_t *bulk = job->bulk;
+  jsw_hash_t *htab = bulk->htab;
+  size_t lo = job->id * bulk->width;
+  size_t hi = lo + bulk->width < htab->capacity
+    ? lo + bulk->width : htab->capacity;
   size_t i;
 
-  /* Release each chain individually */
-  for ( i = 0; i < htab->capacity; i++ ) {
-    jsw_node_t *save, *it;
-
-    if ( htab->table[i] == NULL )
-      continue;
-
-    it = htab->table[i]->first;
-
-    for ( ; it != NULL; it = save ) {
-      save = it->next;
-      htab->keyrel ( it->key );
-      htab->itemrel ( it->item );
-      free ( it );
+  for ( i = lo; i < hi; i++ ) {
+    if ( htab->table[i] != NULL ) {
+      htab->mem.release ( htab->mem.ctx, htab->table[i],
+        sizeof *htab->table[i] );
+      TALLY ( &job->stats, releases );
     }
-
-    free ( htab->table[i] );
   }
-
-  /* Release the hash table */
-  free ( htab->table );
-  free ( htab );
 }
 
 /*
-  Find an item with the selected key
-
-  Returns: The item, or NULL if not found
+  Put every split node back into its old chain after a
+  failed allocation. Chains may come back in another order,
+  so the traversal markers start over
 */
-void *jsw_hfind ( jsw_hash_t *htab, void *key )
+static void resize_undo ( jsw_hbulk_t *bulk )
 {
-  unsigned h = htab->hash ( key ) % htab->capacity;
+  jsw_hash_t *htab = bulk->htab;
+  jsw_node_t *it, *next;
+  size_t i;
+
+  for ( i = 0; i < bulk->size; i++ ) {
+    if ( bulk->table[i] != NULL )
+      RELEASE ( htab, bulk->table[i] );
+  }
 
-  /* Search the chain only if it exists */
-  if ( htab->table[h] != NULL ) {
-    jsw_node_t *it = htab->table[h]->first;
+  for ( i = 0; i < bulk->jobs * bulk->jobs; i++ ) {
+    for ( it = bulk->first[i]; it != NULL; it = next ) {
+      jsw_head_t *chain = htab->table[bucket ( htab, it->hash,
+        htab->capacity )];
 
-    for ( ; it != NULL; it = it->next ) {
-      if ( htab->cmp ( key, it->key ) == 0 )
-        return it->item;
+      next = it->next;
+      it->next = chain->first;
+      chain->first = it;
+      ++chain->size;
     }
   }
 
-  return NULL;
+  htab->curri = 0;
+  htab->currl = NULL;
 }
 
 /*
-  Insert an item with the selected key
+  Resize like jsw_hresize, but split the old table into
+  bucket ranges for jobs run through the fork hook. Nodes
+  are first split by old range into lists for each new
+  range, then each new range makes all of its heads before
+  any node is linked, so a failure can still be undone
 
   Returns: non-zero for success, zero for failure
 */
-int jsw_hinsert ( jsw_hash_t *htab, void *key, void *item )
+int jsw_hresize_fork ( jsw_hash_t *htab, size_t new_size,
+  const jsw_fork_t *fork )
 {
-  unsigned h = htab->hash ( key ) % htab->capacity;
-  void *dupkey, *dupitem;
-  jsw_node_t *new_item;
+  jsw_hbulk_t bulk;
+  jsw_hjob_t *jobs;
+  size_t i;
+  int failed = 0;
 
-  /* Disallow duplicate keys */
-  if ( jsw_hfind ( htab, key ) != NULL )
+  if ( fork == NULL || fork->depth <= 0 )
+    return jsw_hresize ( htab, new_size );
+
+  /* Finish any incremental resize first */
+  if ( htab->old != NULL && !migrate ( htab, htab->oldcap ) )
     return 0;
 
-  /* Attempt to create a new item */
-  dupkey = htab->keydup ( key );
-  dupitem = htab->itemdup ( item );
+  new_size = table_size ( htab, new_size );
+
+  if ( new_size == 0 )
+    return 0;
 
-  new_item = new_node ( dupkey, dupitem, NULL );
+  jobs = bulk_init ( &bulk, htab, fork,
+    htab->capacity < new_size ? htab->capacity : new_size );
 
-  if ( new_item == NULL )
+  if ( jobs == NULL )
     return 0;
 
-  /* Create a chain if the bucket is empty */
-  if ( htab->table[h] == NULL ) {
-    htab->table[h] = new_chain();
+  bulk.size = new_size;
+  bulk.newwidth = ( new_size + bulk.jobs - 1 ) / bulk.jobs;
+  bulk.table = (jsw_head_t **)calloc ( new_size, sizeof *bulk.table );
+  bulk.first = (jsw_node_t **)calloc ( bulk.jobs * bulk.jobs,
+    sizeof *bulk.first );
+  bulk.last = (jsw_node_t **)calloc ( bulk.jobs * bulk.jobs,
+    sizeof *bulk.last );
+
+  if ( bulk.table == NULL || bulk.first == NULL || bulk.last == NULL ) {
+    free ( bulk.table );
+    bulk_finish ( &bulk, jobs );
+    return 0;
+  }
 
-    if ( htab->table[h] == NULL ) {
-      htab->keyrel ( new_item->key );
-      htab->itemrel ( new_item->item );
-      free ( new_item );
-      return 0;
-    }
+  run_jobs ( fork, jobs, bulk.jobs, resize_split );
+  run_jobs ( fork, jobs, bulk.jobs, resize_heads );
+
+  for ( i = 0; i < bulk.jobs; i++ )
+    failed |= jobs[i].failed;
+
+  if ( failed ) {
+    resize_undo ( &bulk );
+    free ( bulk.table );
+    bulk_finish ( &bulk, jobs );
+    return 0;
   }
 
-  /* Insert at the front of the chain */
-  new_item->next = htab->table[h]->first;
-  htab->table[h]->first = new_item;
+  /* At this point, all allocations are done, so nothing can fail */
+  run_jobs ( fork, jobs, bulk.jobs, resize_link );
+  run_jobs ( fork, jobs, bulk.jobs, resize_release );
 
-  ++htab->table[h]->size;
-  ++htab->size;
+  /* Install the new table in the existing htab */
+  free ( htab->table );
+  htab->table = bulk.table;
+  htab->capacity = new_size;
+
+  /* Invalidate traversal information */
+  htab->curri = 0;
+  htab->currl = NULL;
+  STAT ( htab, resizes );
+  bulk_finish ( &bulk, jobs );
 
   return 1;
 }
 
-/*
-  Remove an item with the selected key
+/* Keys of one input slice */
+static void bulk_slice ( jsw_hbulk_t *bulk, size_t id, size_t *lo,
+  size_t *hi )
+{
+  size_t per = ( bulk->n + bulk->jobs - 1 ) / bulk->jobs;
 
-  Returns: non-zero for success, zero for failure
-*/
-int jsw_herase ( jsw_hash_t *htab, void *key )
+  *lo = id * per < bulk->n ? id * per : bulk->n;
+  *hi = *lo + per < bulk->n ? *lo + per : bulk->n;
+}
+
+/* Hash the job's slice and count its keys in each bucket range */
+static void bulk_hash ( jsw_hjob_t *job )
 {
-  unsigned h = htab->hash ( key ) % htab->capacity;
-  jsw_node_t *save, *it;
+  jsw_hbulk_t *bulk = job->bulk;
+  jsw_hash_t *htab = bulk->htab;
+  size_t *count = bulk->pos + job->id * bulk->jobs;
+  size_t i, lo, hi;
 
-  if ( htab->table[h] == NULL )
-    return 0;
+  bulk_slice ( bulk, job->id, &lo, &hi );
 
-  it = htab->table[h]->first;
+  for ( i = lo; i < hi; i++ ) {
+    unsigned h = hash_key ( htab, bulk->keys[i] );
 
-  /* Remove the first node in the chain? */
-  if ( htab->cmp ( key, it->key ) == 0 ) {
-    htab->table[h]->first = it->next;
+    bulk->hashes[i] = h;
+    ++count[bucket ( htab, h, htab->capacity ) / bulk->width];
+  }
+}
 
-    /* Release the node's memory */
-    htab->keyrel ( it->key );
-    htab->itemrel ( it->item );
-    free ( it );
+/* Place the job's slice in order, keeping the input order */
+static void bulk_sort ( jsw_hjob_t *job )
+{
+  jsw_hbulk_t *bulk = job->bulk;
+  jsw_hash_t *htab = bulk->htab;
+  size_t *pos = bulk->pos + job->id * bulk->jobs;
+  size_t i, lo, hi;
 
-    /* Remove the chain if it's empty */
-    if ( htab->table[h]->first == NULL ) {
-      free ( htab->table[h] );
-      htab->table[h] = NULL;
-    }
-    else
-      --htab->table[h]->size;
+  bulk_slice ( bulk, job->id, &lo, &hi );
+
+  for ( i = lo; i < hi; i++ ) {
+    size_t r = bucket ( htab, bulk->hashes[i], htab->capacity ) / bulk->width;
+
+    bulk->order[pos[r]++] = i;
   }
-  else {
-    /* Search for the node */
-    while ( it->next != NULL ) {
-      if ( htab->cmp ( key, it->next->key ) == 0 )
-        break;
+}
 
-      it = it->next;
+/* Insert every key of the job's bucket range, in input order */
+static void bulk_insert ( jsw_hjob_t *job )
+{
+  jsw_hbulk_t *bulk = job->bulk;
+  jsw_hash_t *htab = bulk->htab;
+  size_t *end = bulk->pos + ( bulk->jobs - 1 ) * bulk->jobs;
+  size_t j = job->id > 0 ? end[job->id - 1] : 0;
+
+  for ( ; j < end[job->id]; j++ ) {
+    size_t i = bulk->order[j];
+    unsigned h = bulk->hashes[i];
+    jsw_head_t **chain = &htab->table[bucket ( htab, h, htab->capacity )];
+    jsw_node_t *node;
+
+    /* Disallow duplicate keys, including earlier ones in the input */
+    if ( scan_chain ( htab, *chain, bulk->keys[i], h, NULL,
+      &job->stats ) != NULL )
+    {
+      continue;
     }
 
-    /* Not found? */
-    if ( it->next == NULL )
-      return 0;
+    node = make_node ( htab, bulk->keys[i], bulk->items[i], h );
 
-    save = it->next;
-    it->next = it->next->next;
+    if ( node == NULL ) {
+      job->failed = 1;
+      continue;
+    }
 
-    /* Release the node's memory */
-    htab->keyrel ( save->key );
-    htab->itemrel ( save->item );
-    free ( save );
+    TALLY ( &job->stats, allocs );
 
-    --htab->table[h]->size;
-  }
+    /* Create a chain if the bucket is empty */
+    if ( *chain == NULL ) {
+      *chain = make_chain ( htab );
+
+      if ( *chain == NULL ) {
+        release_key ( htab, node );
+        htab->itemrel ( node->item );
+        htab->mem.release ( htab->mem.ctx, node, node_size ( htab, node ) );
+        TALLY ( &job->stats, releases );
+        job->failed = 1;
+        continue;
+      }
 
-  /* Erasure invalidates traversal markers */
-  jsw_hreset ( htab );
+      TALLY ( &job->stats, allocs );
+    }
 
-  --htab->size;
+    /* Insert at the front of the chain */
+    node->next = ( *chain )->first;
+    ( *chain )->first = node;
 
-  return 1;
+    ++( *chain )->size;
+    ++job->done;
+  }
 }
 
 /*
-  Grow or shrink the table, this is a slow operation
+  Insert n keys and items. Keys are hashed by slices of the
+  input, grouped by bucket range with a counting sort, and
+  then every range is loaded by its own job
 
-  Returns: non-zero for success, zero for failure
+  Returns: The number of items inserted
 */
-int jsw_hresize ( jsw_hash_t *htab, size_t new_size )
+size_t jsw_hbulk_insert ( jsw_hash_t *htab, void **keys, void **items,
+  size_t n, const jsw_fork_t *fork )
 {
-  jsw_head_t **new_table;
-  jsw_node_t *it, *next;
-  size_t i;
+  jsw_hbulk_t bulk;
+  jsw_hjob_t *jobs;
+  size_t i, r, total = 0;
 
-  new_table = (jsw_head_t **) calloc ( new_size, sizeof (*new_table) );
-  if ( new_table == NULL )
+  if ( n == 0 )
     return 0;
 
-  /* Go through the old table once, just to allocate the new heads */
-  for ( i = 0; i < htab->capacity; i++ ) {
-    if ( htab->table[i] == NULL )
-      continue;
+  /* Jobs only know the new table, so finish any incremental resize */
+  if ( htab->old != NULL && !migrate ( htab, htab->oldcap ) )
+    return 0;
 
-    for ( it = htab->table[i]->first; it != NULL; it = it->next ) {
-      unsigned h = htab->hash ( it->key ) % new_size;
+  /* Grow once up front; failure just leaves the table fuller */
+  if ( htab->maxload > 0
+    && htab->size + n > htab->maxload * htab->capacity )
+  {
+    jsw_hresize_fork ( htab,
+      (size_t)( ( htab->size + n ) / htab->maxload ) + 1, fork );
+  }
 
-      /* Create a chain if the bucket is empty */
-      if ( new_table[h] == NULL ) {
-        new_table[h] = new_chain();
+  jobs = bulk_init ( &bulk, htab, fork, htab->capacity );
 
-        /* If failure, free everything that has already been allocated */
-        if ( new_table[h] == NULL ) {
-          size_t j;
+  if ( jobs == NULL )
+    return 0;
 
-          for ( j = 0; j < new_size; j++ ) {
-            free ( new_table[j] );
-          }
+  bulk.keys = keys;
+  bulk.items = items;
+  bulk.n = n;
+  bulk.hashes = (unsigned *)malloc ( n * sizeof *bulk.hashes );
+  bulk.order = (size_t *)malloc ( n * sizeof *bulk.order );
+  bulk.pos = (size_t *)calloc ( bulk.jobs * bulk.jobs, sizeof *bulk.pos );
 
-          free ( new_table );
-          return 0;
-        }
-      }
+  if ( bulk.hashes == NULL || bulk.order == NULL || bulk.pos == NULL ) {
+    bulk_finish ( &bulk, jobs );
+    return 0;
+  }
+
+  run_jobs ( fork, jobs, bulk.jobs, bulk_hash );
+
+  /* Ranges follow each other in order, each split by slice */
+  for ( r = 0; r < bulk.jobs; r++ ) {
+    for ( i = 0; i < bulk.jobs; i++ ) {
+      size_t count = bulk.pos[i * bulk.jobs + r];
+
+      bulk.pos[i * bulk.jobs + r] = total;
+      total += count;
     }
   }
 
-  /* At this point, all allocations are done, so nothing can fail */
-  for ( i = 0; i < htab->capacity; i++ ) {
-    if ( htab->table[i] == NULL )
-      continue;
+  run_jobs ( fork, jobs, bulk.jobs, bulk_sort );
+  run_jobs ( fork, jobs, bulk.jobs, bulk_insert );
 
-    for ( it = htab->table[i]->first; it != NULL; it = next ) {
-      unsigned h = htab->hash ( it->key ) % new_size;
+  for ( i = 0, total = 0; i < bulk.jobs; i++ )
+    total += jobs[i].done;
 
-      /* Remember old next before we overwrite it */
-      next = it->next;
+  htab->size += total;
+  bulk_finish ( &bulk, jobs );
 
-      /* Insert at the front of the new chain */
-      it->next = new_table[h]->first;
-      new_table[h]->first = it;
+  return total;
+}
 
-      ++new_table[h]->size;
-    }
+/*
+  Grow automatically once size/capacity passes load. With a
+  non-zero step the growth is incremental: each insert and
+  erase moves up to step buckets into the bigger table
+  instead of rehashing everything in one call. A load of zero
+  turns automatic growth off
 
-    /* Free old head */
-    free ( htab->table[i] );
-  }
+  Returns: non-zero for success, zero for failure
+*/
+int jsw_hgrowth ( jsw_hash_t *htab, double load, size_t step )
+{
+  if ( load < 0 )
+    return 0;
 
-  /* Install the new table in the existing htab */
-  free ( htab->table );
-  htab->table = new_table;
-  htab->capacity = new_size;
+  htab->maxload = load;
+  htab->step = step;
 
-  /* Invalidate traversal information */
-  htab->curri = 0;
-  htab->currl = NULL;
+  /* Switching to stop-the-world finishes what's pending */
+  if ( step == 0 && htab->old != NULL )
+    return migrate ( htab, htab->oldcap );
+
+  return 1;
+}
+
+/*
+  Store keys of up to max bytes, as keylen measures them,
+  inside their nodes. Only an empty table can switch, since
+  nodes already stored have no length prefix
+
+  Returns: non-zero for success, zero for failure
+*/
+int jsw_hinline ( jsw_hash_t *htab, keylen_f keylen, size_t max )
+{
+  if ( htab->size != 0 || htab->old != NULL )
+    return 0;
+
+  htab->keylen = keylen;
+  htab->maxinline = keylen != NULL ? max : 0;
 
   return 1;
 }
@@ -355,22 +1605,23 @@ int jsw_hresize ( jsw_hash_t *htab, size_t new_size )
 /* Reset the traversal markers to the beginning */
 void jsw_hreset ( jsw_hash_t *htab )
 {
+  size_t n = chain_count ( htab );
   size_t i;
 
   htab->curri = 0;
   htab->currl = NULL;
 
   /* Find the first non-empty bucket */
-  for ( i = 0; i < htab->capacity; i++ ) {
-    if ( htab->table[i] != NULL )
+  for ( i = 0; i < n; i++ ) {
+    if ( chain_at ( htab, i ) != NULL )
       break;
   }
 
   htab->curri = i;
 
   /* Set the link marker if the table was not empty */
-  if ( i != htab->capacity )
-    htab->currl = htab->table[i]->first;
+  if ( i != n )
+    htab->currl = chain_at ( htab, i )->first;
 }
 
 /* Traverse forward by one key */
@@ -381,23 +1632,91 @@ int jsw_hnext ( jsw_hash_t *htab )
 
     /* At the end of the chain? */
     if ( htab->currl == NULL ) {
+      size_t n = chain_count ( htab );
+
       /* Find the next chain */
-      while ( ++htab->curri < htab->capacity ) {
-        if ( htab->table[htab->curri] != NULL )
+      while ( ++htab->curri < n ) {
+        if ( chain_at ( htab, htab->curri ) != NULL )
           break;
       }
 
       /* No more chains? */
-      if ( htab->curri == htab->capacity )
+      if ( htab->curri >= n )
         return 0;
 
-      htab->currl = htab->table[htab->curri]->first;
+      htab->currl = chain_at ( htab, htab->curri )->first;
     }
   }
 
   return 1;
 }
 
+/*
+  First non-empty chain at or after traversal index i
+
+  Returns: The first node of that chain, or NULL if none
+*/
+static jsw_node_t *first_from ( jsw_hash_t *htab, size_t *i )
+{
+  size_t n = chain_count ( htab );
+
+  for ( ; *i < n; ++*i ) {
+    if ( chain_at ( htab, *i ) != NULL )
+      return chain_at ( htab, *i )->first;
+  }
+
+  return NULL;
+}
+
+/* Create a new traversal object */
+jsw_htrav_t *jsw_htnew ( void )
+{
+  return (jsw_htrav_t *)malloc ( sizeof ( jsw_htrav_t ) );
+}
+
+/* Release a traversal object */
+void jsw_htdelete ( jsw_htrav_t *trav )
+{
+  free ( trav );
+}
+
+/* Start a traversal at the first item in the table */
+void *jsw_htfirst ( jsw_htrav_t *trav, jsw_hash_t *htab )
+{
+  trav->htab = htab;
+  trav->i = 0;
+  trav->it = first_from ( htab, &trav->i );
+
+  return jsw_htitem ( trav );
+}
+
+/* Traverse forward by one key */
+void *jsw_htnext ( jsw_htrav_t *trav )
+{
+  if ( trav->it != NULL ) {
+    trav->it = trav->it->next;
+
+    if ( trav->it == NULL ) {
+      ++trav->i;
+      trav->it = first_from ( trav->htab, &trav->i );
+    }
+  }
+
+  return jsw_htitem ( trav );
+}
+
+/* Get the key at the traversal object */
+const void *jsw_htkey ( jsw_htrav_t *trav )
+{
+  return trav->it != NULL ? trav->it->key : NULL;
+}
+
+/* Get the item at the traversal object */
+void *jsw_htitem ( jsw_htrav_t *trav )
+{
+  return trav->it != NULL ? trav->it->item : NULL;
+}
+
 /* Get the current key */
 const void *jsw_hkey ( jsw_hash_t *htab )
 {
@@ -422,11 +1741,25 @@ size_t jsw_hcapacity ( jsw_hash_t *htab )
   return htab->capacity;
 }
 
+/* Copy out the hot path counters, non-zero if built with JSW_STATS */
+int jsw_hstats ( jsw_hash_t *htab, jsw_stats_t *stats )
+{
+#ifdef JSW_STATS
+  *stats = htab->stats;
+  return 1;
+#else
+  (void)htab;
+  *stats = no_stats;
+  return 0;
+#endif
+}
+
 /* Get statistics for the hash table */
 jsw_hstat_t *jsw_hstat ( jsw_hash_t *htab )
 {
   jsw_hstat_t *stat;
   double sum = 0, used = 0;
+  size_t n = chain_count ( htab );
   size_t i;
 
   /* No stats for an empty table */
@@ -441,21 +1774,23 @@ jsw_hstat_t *jsw_hstat ( jsw_hash_t *htab )
   stat->lchain = 0;
   stat->schain = (size_t)-1;
 
-  for ( i = 0; i < htab->capacity; i++ ) {
-    if ( htab->table[i] != NULL ) {
-      sum += htab->table[i]->size;
+  for ( i = 0; i < n; i++ ) {
+    jsw_head_t *chain = chain_at ( htab, i );
+
+    if ( chain != NULL ) {
+      sum += chain->size;
 
       ++used; /* Non-empty buckets */
 
-      if ( htab->table[i]->size > stat->lchain )
-        stat->lchain = htab->table[i]->size;
+      if ( chain->size > stat->lchain )
+        stat->lchain = chain->size;
 
-      if ( htab->table[i]->size < stat->schain )
-        stat->schain = htab->table[i]->size;
+      if ( chain->size < stat->schain )
+        stat->schain = chain->size;
     }
   }
 
-  stat->load = used / htab->capacity;
+  stat->load = used / n;
   stat->achain = sum / used;
 
   return stat;
@@ -6,6 +6,10 @@
 
     > Created (Julienne Walker): August 7, 2005
     > Modified (Julienne Walker): August 11, 2005
+    > Modified (agent): October 14, 2026
+      Added load factor growth, a power of two mode,
+      allocator hooks, batch, hashed and bulk calls,
+      inline keys, JSW_STATS counters and clear
 
   This code is in the public domain. Anyone may
   use it or change it in any way that they see
@@ -28,7 +32,11 @@ extern "C" {
 #include <stddef.h>
 #endif
 
+#include "jsw_alloc.h"
+#include "jsw_common.h"
+
 typedef struct jsw_hash jsw_hash_t;
+typedef struct jsw_htrav jsw_htrav_t;
 
 /* Application specific hash function */
 typedef unsigned (*hash_f) ( const void *key );
@@ -48,6 +56,15 @@ typedef void     (*keyrel_f) ( void *key );
 /* Application specific data deletion function */
 typedef void     (*itemrel_f) ( void *item );
 
+/*
+  Application specific probe matching function, non-zero if
+  probe (of any type) matches the stored key
+*/
+typedef int      (*keyeq_f) ( const void *probe, const void *key );
+
+/* Application specific key length function, in bytes */
+typedef size_t   (*keylen_f) ( const void *key );
+
 typedef struct jsw_hstat {
   double load;            /* Table load factor: (M chains)/(table size) */
   double achain;          /* Average chain length */
@@ -55,9 +72,13 @@ typedef struct jsw_hstat {
   size_t schain;          /* Shortest non-empty chain */
 } jsw_hstat_t;
 
+/* Creation flags for jsw_hnew_flags */
+#define JSW_HPOW2 0x1U /* Power of two capacity, mask instead of modulo */
+
 /*
   Create a new hash table with a capacity of size, and
   user defined functions for handling keys and items.
+  A NULL keyrel or itemrel leaves keys or items alone.
 
   Returns: An empty hash table, or NULL on failure.
 */
@@ -65,16 +86,75 @@ jsw_hash_t  *jsw_hnew ( size_t size, hash_f hash, cmp_f cmp,
                        keydup_f keydup, itemdup_f itemdup,
                        keyrel_f keyrel, itemrel_f itemrel );
 
+/*
+  Create a new hash table like jsw_hnew, with creation
+  flags. JSW_HPOW2 rounds the capacity (now and after every
+  resize) up to a power of two and picks buckets with a mask
+  after mixing the user hash, so weak hashes still spread well
+
+  Returns: An empty hash table, or NULL on failure.
+*/
+jsw_hash_t  *jsw_hnew_flags ( size_t size, unsigned flags,
+                             hash_f hash, cmp_f cmp,
+                             keydup_f keydup, itemdup_f itemdup,
+                             keyrel_f keyrel, itemrel_f itemrel );
+
+/*
+  Create a new hash table like jsw_hnew_flags, whose nodes
+  and chain heads come from a user defined allocator, or
+  malloc if alloc is NULL
+
+  Returns: An empty hash table, or NULL on failure.
+*/
+jsw_hash_t  *jsw_hnew_alloc ( size_t size, unsigned flags,
+                             hash_f hash, cmp_f cmp,
+                             keydup_f keydup, itemdup_f itemdup,
+                             keyrel_f keyrel, itemrel_f itemrel,
+                             const jsw_alloc_t *alloc );
+
 /* Release all memory used by the hash table */
 void         jsw_hdelete ( jsw_hash_t *htab );
 
 /*
-  Find an item with the selected key
+  Remove every item, keeping the table and its capacity for
+  reuse. With a purge hook and NULL keyrel and itemrel no
+  chain is visited, only the bucket array is zeroed
+*/
+void         jsw_hclear ( jsw_hash_t *htab );
+
+/*
+  Find an item with the selected key. Unless built with
+  JSW_STATS, doesn't modify the table, so any number of
+  threads can find at once
 
   Returns: The item, or NULL if not found
 */
 void        *jsw_hfind ( jsw_hash_t *htab, void *key );
 
+/*
+  Find items for n keys at once, storing each item or
+  NULL in out. Hashes and prefetches a group of buckets
+  before searching them. Doesn't modify the table unless
+  built with JSW_STATS
+
+  Returns: The number of keys found
+*/
+size_t       jsw_hfind_many ( jsw_hash_t *htab, void **keys, size_t n,
+                              void **out );
+
+/*
+  Find an item by a hash the caller already has, which has
+  to be what the hash function gives the stored key. probe
+  is matched against stored keys with eq, so it can be any
+  type eq understands (a pointer and length, say), or like
+  a plain key when eq is NULL: with cmp, or by keylen and
+  bytes on a table set up with jsw_hinline
+
+  Returns: The item, or NULL if not found
+*/
+void        *jsw_hfind_hashed ( jsw_hash_t *htab, unsigned hash,
+                                const void *probe, keyeq_f eq );
+
 /*
   Insert an item with the selected key
 
@@ -83,19 +163,104 @@ void        *jsw_hfind ( jsw_hash_t *htab, void *key );
 int          jsw_hinsert ( jsw_hash_t *htab, void *key, void *item );
 
 /*
-  Remove an item with the selected key
+  Insert an item with the selected key, and a hash the caller
+  already has instead of calling the hash function. The key
+  is still a whole one, as keydup copies it into the table
+
+  Returns: non-zero for success, zero for failure
+*/
+int          jsw_hinsert_hashed ( jsw_hash_t *htab, unsigned hash,
+                                  void *key, void *item );
+
+/*
+  Insert n keys and items, skipping any key already in the
+  table or earlier in keys, as n calls to jsw_hinsert would.
+  A table with automatic growth is resized once up front.
+  With a fork hook the keys are hashed and loaded by jobs
+  that each own a range of buckets, so hash, cmp, keydup,
+  itemdup, keylen and the allocator hooks are called from
+  several threads at once and must allow it (a jsw_pool
+  doesn't). Nothing else may use the table meanwhile
+
+  Returns: The number of items inserted
+*/
+size_t       jsw_hbulk_insert ( jsw_hash_t *htab, void **keys, void **items,
+                                size_t n, const jsw_fork_t *fork );
+
+/*
+  Remove an item with the selected key. Traversal markers
+  on the item move to the next one, and markers elsewhere
+  stay valid unless a resize is running
 
   Returns: non-zero for success, zero for failure
 */
 int          jsw_herase ( jsw_hash_t *htab, void *key );
 
 /*
-  Grow or shrink the table, this is a slow operation
-  
+  Remove an item by a hash the caller already has, matching
+  probe with eq, or like a plain key if eq is NULL, as in
+  jsw_hfind_hashed
+
+  Returns: non-zero for success, zero for failure
+*/
+int          jsw_herase_hashed ( jsw_hash_t *htab, unsigned hash,
+                                 const void *probe, keyeq_f eq );
+
+/*
+  Remove the item at the traversal markers and move them
+  to the next item, so a sweep can erase as it goes. This
+  never moves buckets of a running resize
+
+  Returns: non-zero for success, zero at end-of-table
+*/
+int          jsw_herase_current ( jsw_hash_t *htab );
+
+/*
+  Grow or shrink the table, this is a slow operation.
+  Power of two tables round new_size up to a power of two
+
   Returns: non-zero for success, zero for failure
 */
 int          jsw_hresize ( jsw_hash_t *htab, size_t new_size );
 
+/*
+  Resize like jsw_hresize, with jobs that each move one range
+  of buckets through the fork hook. The allocator hooks are
+  called from several threads, as in jsw_hbulk_insert. A
+  NULL fork or a depth of zero is just jsw_hresize
+
+  Returns: non-zero for success, zero for failure
+*/
+int          jsw_hresize_fork ( jsw_hash_t *htab, size_t new_size,
+                                const jsw_fork_t *fork );
+
+/*
+  Grow automatically once size/capacity passes load. With a
+  non-zero step the growth is incremental: each insert and
+  erase moves up to step buckets into the bigger table,
+  so no single call pays for a full rehash. A load of zero
+  turns automatic growth off (the default)
+
+  Inserting may invalidate the traversal markers when growth
+  is enabled
+
+  Returns: non-zero for success, zero for failure
+*/
+int          jsw_hgrowth ( jsw_hash_t *htab, double load, size_t step );
+
+/*
+  Store keys of up to max bytes, as keylen measures them,
+  inside their nodes instead of copying them with keydup,
+  so inserting one makes a single allocation. Longer keys
+  still go through keydup and keyrel. Keys then match when
+  their lengths and bytes are equal, without calling cmp,
+  so a string's length should count its terminator. A NULL
+  keylen turns this off. Only an empty table can switch
+
+  Returns: non-zero for success, zero for failure
+*/
+int          jsw_hinline ( jsw_hash_t *htab, keylen_f keylen, size_t max );
+
 /* Reset the traversal markers to the beginning */
 void         jsw_hreset ( jsw_hash_t *htab );
 
@@ -108,6 +273,23 @@ const void  *jsw_hkey ( jsw_hash_t *htab );
 /* Get the current item */
 void        *jsw_hitem ( jsw_hash_t *htab );
 
+/*
+  Traversal objects keep their position outside of the
+  table, so readers can share it. jsw_htfirst and
+  jsw_htnext return the item, or NULL at the end.
+  Inserting or erasing invalidates them
+*/
+jsw_htrav_t *jsw_htnew ( void );
+void         jsw_htdelete ( jsw_htrav_t *trav );
+void        *jsw_htfirst ( jsw_htrav_t *trav, jsw_hash_t *htab );
+void        *jsw_htnext ( jsw_htrav_t *trav );
+
+/* Get the key at a traversal object, or NULL at the end */
+const void  *jsw_htkey ( jsw_htrav_t *trav );
+
+/* Get the item at a traversal object, or NULL at the end */
+void        *jsw_htitem ( jsw_htrav_t *trav );
+
 /* Current number of items in the table */
 size_t       jsw_hsize ( jsw_hash_t *htab );
 
@@ -117,6 +299,15 @@ size_t       jsw_hcapacity ( jsw_hash_t *htab );
 /* Get statistics for the hash table */
 jsw_hstat_t *jsw_hstat ( jsw_hash_t *htab );
 
+/*
+  Copy the hot path counters into stats, or zeros in a
+  build without JSW_STATS. Unlike jsw_hstat these count
+  what the table has done since it was created
+
+  Returns: non-zero if the counters are compiled in
+*/
+int          jsw_hstats ( jsw_hash_t *htab, jsw_stats_t *stats );
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,501 @@
+#ifndef JSW_HLIB_HPP
+#define JSW_HLIB_HPP
+
+/*
+  Hash table template for C++
+
+    > Created (agent): October 14, 2026
+
+  A header-only counterpart of jsw_hlib for C++11 and later.
+  It uses the same separate chaining, with each node caching
+  its key's full hash. Keys and values are stored by value in
+  the nodes. Hash and equality are template parameters, so
+  they inline instead of going through function pointers.
+  The table is always a power of two and mixes the user hash
+  as JSW_HPOW2 does, because std::hash is often the identity.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace jsw {
+
+/* Map of unique keys to values, like std::unordered_map */
+template <class K, class V, class Hash = std::hash<K>,
+          class Eq = std::equal_to<K>,
+          class Alloc = std::allocator<std::pair<const K, V> > >
+class hash_map {
+public:
+  typedef K                     key_type;
+  typedef V                     mapped_type;
+  typedef std::pair<const K, V> value_type;
+  typedef Hash                  hasher;
+  typedef Eq                    key_equal;
+  typedef Alloc                 allocator_type;
+  typedef std::size_t           size_type;
+
+private:
+  struct node {
+    node       *next;  /* Next link in the chain */
+    std::size_t hash;  /* Mixed hash of the key */
+    value_type  value; /* Key and mapped value */
+
+    template <class... Args>
+    explicit node ( Args&&... args ): value ( std::forward<Args> ( args )... ) {}
+  };
+
+  typedef typename std::allocator_traits<Alloc>::template
+    rebind_alloc<node> node_alloc;
+  typedef std::allocator_traits<node_alloc> node_traits;
+  typedef typename std::allocator_traits<Alloc>::template
+    rebind_alloc<node *> table_alloc;
+  typedef std::allocator_traits<table_alloc> table_traits;
+
+  /* Forward iterator over the buckets, const or not */
+  template <bool Const>
+  class basic_iterator {
+    typedef typename std::conditional<Const, const hash_map, hash_map>::type
+      map_type;
+
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef typename hash_map::value_type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef typename std::conditional<Const, const value_type,
+      value_type>::type &reference;
+    typedef typename std::conditional<Const, const value_type,
+      value_type>::type *pointer;
+
+    basic_iterator (): it_ ( NULL ), map_ ( NULL ) {}
+
+    /* Mutable iterators convert to const ones */
+    template <bool C, class = typename std::enable_if<Const && !C>::type>
+    basic_iterator ( const basic_iterator<C> &rhs )
+      : it_ ( rhs.it_ ), map_ ( rhs.map_ ) {}
+
+    reference operator* () const { return it_->value; }
+    pointer operator-> () const { return &it_->value; }
+
+    basic_iterator &operator++ ()
+    {
+      it_ = map_->next_node ( it_ );
+      return *this;
+    }
+
+    basic_iterator operator++ ( int )
+    {
+      basic_iterator save = *this;
+      ++*this;
+      return save;
+    }
+
+    template <bool C>
+    bool operator== ( const basic_iterator<C> &rhs ) const
+    {
+      return it_ == rhs.it_;
+    }
+
+    template <bool C>
+    bool operator!= ( const basic_iterator<C> &rhs ) const
+    {
+      return it_ != rhs.it_;
+    }
+
+  private:
+    friend class hash_map;
+
+    basic_iterator ( node *it, map_type *map ): it_ ( it ), map_ ( map ) {}
+
+    node     *it_;  /* Current node, NULL for end() */
+    map_type *map_; /* Paired table */
+  };
+
+public:
+  typedef basic_iterator<false> iterator;
+  typedef basic_iterator<true>  const_iterator;
+
+  explicit hash_map ( size_type size = 0, const Hash &hash = Hash(),
+                      const Eq &eq = Eq(), const Alloc &alloc = Alloc() )
+    : table_ ( NULL ), capacity_ ( 0 ), size_ ( 0 ), maxload_ ( 1.0f ),
+      hash_ ( hash ), eq_ ( eq ), nodes_ ( alloc ), tables_ ( alloc )
+  {
+    if ( size > 0 )
+      reserve ( size );
+  }
+
+  hash_map ( hash_map &&rhs )
+    : table_ ( rhs.table_ ), capacity_ ( rhs.capacity_ ),
+      size_ ( rhs.size_ ), maxload_ ( rhs.maxload_ ),
+      hash_ ( std::move ( rhs.hash_ ) ), eq_ ( std::move ( rhs.eq_ ) ),
+      nodes_ ( std::move ( rhs.nodes_ ) ), tables_ ( std::move ( rhs.tables_ ) )
+  {
+    rhs.table_ = NULL;
+    rhs.capacity_ = rhs.size_ = 0;
+  }
+
+  hash_map &operator= ( hash_map &&rhs )
+  {
+    if ( this != &rhs ) {
+      release();
+      table_ = rhs.table_;
+      capacity_ = rhs.capacity_;
+      size_ = rhs.size_;
+      maxload_ = rhs.maxload_;
+      hash_ = std::move ( rhs.hash_ );
+      eq_ = std::move ( rhs.eq_ );
+      nodes_ = std::move ( rhs.nodes_ );
+      tables_ = std::move ( rhs.tables_ );
+      rhs.table_ = NULL;
+      rhs.capacity_ = rhs.size_ = 0;
+    }
+
+    return *this;
+  }
+
+  hash_map ( const hash_map & ) = delete;
+  hash_map &operator= ( const hash_map & ) = delete;
+
+  ~hash_map () { release(); }
+
+  iterator begin () { return iterator ( first_node ( 0 ), this ); }
+  iterator end () { return iterator ( NULL, this ); }
+  const_iterator begin () const { return const_iterator ( first_node ( 0 ), this ); }
+  const_iterator end () const { return const_iterator ( NULL, this ); }
+  const_iterator cbegin () const { return begin(); }
+  const_iterator cend () const { return end(); }
+
+  size_type size () const { return size_; }
+  bool empty () const { return size_ == 0; }
+  size_type bucket_count () const { return capacity_; }
+
+  float load_factor () const
+  {
+    return capacity_ == 0 ? 0.0f : (float)size_ / capacity_;
+  }
+
+  float max_load_factor () const { return maxload_; }
+
+  /* The table grows when an insert pushes it past load */
+  void max_load_factor ( float load )
+  {
+    maxload_ = load > 0 ? load : 1.0f;
+    reserve ( size_ );
+  }
+
+  /* Remove every entry, keeping the buckets */
+  void clear ()
+  {
+    size_type i;
+
+    for ( i = 0; i < capacity_; i++ ) {
+      node *it = table_[i];
+
+      while ( it != NULL ) {
+        node *save = it->next;
+        destroy ( it );
+        it = save;
+      }
+
+      table_[i] = NULL;
+    }
+
+    size_ = 0;
+  }
+
+  iterator find ( const K &key )
+  {
+    return iterator ( lookup ( key, mix ( hash_ ( key ) ) ), this );
+  }
+
+  const_iterator find ( const K &key ) const
+  {
+    return const_iterator ( lookup ( key, mix ( hash_ ( key ) ) ), this );
+  }
+
+  size_type count ( const K &key ) const
+  {
+    return find ( key ) != end();
+  }
+
+  /* Value for key, inserting a default one if it's missing */
+  V &operator[] ( const K &key )
+  {
+    return try_emplace ( key ).first->second;
+  }
+
+  V &operator[] ( K &&key )
+  {
+    return try_emplace ( std::move ( key ) ).first->second;
+  }
+
+  /* Insert unless the key exists; the value is built only if needed */
+  template <class Key, class... Args>
+  std::pair<iterator, bool> try_emplace ( Key &&key, Args&&... args )
+  {
+    std::size_t h = mix ( hash_ ( key ) );
+    node *it = lookup ( key, h );
+
+    if ( it != NULL )
+      return std::make_pair ( iterator ( it, this ), false );
+
+    it = create ( std::piecewise_construct,
+      std::forward_as_tuple ( std::forward<Key> ( key ) ),
+      std::forward_as_tuple ( std::forward<Args> ( args )... ) );
+    link ( it, h );
+
+    return std::make_pair ( iterator ( it, this ), true );
+  }
+
+  std::pair<iterator, bool> insert ( const value_type &value )
+  {
+    return try_emplace ( value.first, value.second );
+  }
+
+  std::pair<iterator, bool> insert ( value_type &&value )
+  {
+    return try_emplace ( std::move ( const_cast<K &> ( value.first ) ),
+      std::move ( value.second ) );
+  }
+
+  /* Build the entry in place first, then insert it */
+  template <class... Args>
+  std::pair<iterator, bool> emplace ( Args&&... args )
+  {
+    node *n = create ( std::forward<Args> ( args )... );
+    std::size_t h = mix ( hash_ ( n->value.first ) );
+    node *it = lookup ( n->value.first, h );
+
+    if ( it != NULL ) {
+      destroy ( n );
+      return std::make_pair ( iterator ( it, this ), false );
+    }
+
+    link ( n, h );
+
+    return std::make_pair ( iterator ( n, this ), true );
+  }
+
+  /* Remove the key if present, returning how many were removed */
+  size_type erase ( const K &key )
+  {
+    std::size_t h;
+    node **it;
+
+    if ( capacity_ == 0 )
+      return 0;
+
+    h = mix ( hash_ ( key ) );
+
+    for ( it = &table_[h & ( capacity_ - 1 )]; *it != NULL; it = &( *it )->next ) {
+      if ( ( *it )->hash == h && eq_ ( ( *it )->value.first, key ) ) {
+        node *save = *it;
+
+        *it = save->next;
+        destroy ( save );
+        --size_;
+
+        return 1;
+      }
+    }
+
+    return 0;
+  }
+
+  /* Remove one entry, returning the position after it */
+  iterator erase ( const_iterator pos )
+  {
+    node *next = next_node ( pos.it_ );
+
+    erase ( pos.it_->value.first );
+
+    return iterator ( next, this );
+  }
+
+  /* Make room for at least n entries without growing */
+  void reserve ( size_type n )
+  {
+    rehash ( (size_type)( n / maxload_ ) + 1 );
+  }
+
+  /* Use at least n buckets (rounded up to a power of two) */
+  void rehash ( size_type n )
+  {
+    size_type new_size = 1, i;
+    node **new_table;
+
+    if ( n < (size_type)( size_ / maxload_ ) + 1 )
+      n = (size_type)( size_ / maxload_ ) + 1;
+
+    while ( new_size < n )
+      new_size <<= 1;
+
+    if ( new_size == capacity_ )
+      return;
+
+    new_table = table_traits::allocate ( tables_, new_size );
+
+    for ( i = 0; i < new_size; i++ )
+      new_table[i] = NULL;
+
+    /* Cached hashes mean no user hash calls here */
+    for ( i = 0; i < capacity_; i++ ) {
+      node *it = table_[i];
+
+      while ( it != NULL ) {
+        node *next = it->next;
+        node **chain = &new_table[it->hash & ( new_size - 1 )];
+
+        it->next = *chain;
+        *chain = it;
+        it = next;
+      }
+    }
+
+    if ( table_ != NULL )
+      table_traits::deallocate ( tables_, table_, capacity_ );
+
+    table_ = new_table;
+    capacity_ = new_size;
+  }
+
+private:
+  /* Final avalanche for the user hash (MurmurHash3 fmix) */
+  static std::size_t mix ( std::size_t h )
+  {
+    if ( sizeof h > 4 ) {
+      h ^= h >> 33;
+      h *= (std::size_t)0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      h *= (std::size_t)0xc4ceb9fe1a85ec53ULL;
+      h ^= h >> 33;
+    }
+    else {
+      h ^= h >> 16;
+      h *= 0x85ebca6bU;
+      h ^= h >> 13;
+      h *= 0xc2b2ae35U;
+      h ^= h >> 16;
+    }
+
+    return h;
+  }
+
+  template <class Key>
+  node *lookup ( const Key &key, std::size_t h ) const
+  {
+    node *it;
+
+    if ( capacity_ == 0 )
+      return NULL;
+
+    for ( it = table_[h & ( capacity_ - 1 )]; it != NULL; it = it->next ) {
+      if ( it->hash == h && eq_ ( it->value.first, key ) )
+        break;
+    }
+
+    return it;
+  }
+
+  /* Add a new node at the front of its chain, growing first if needed */
+  void link ( node *n, std::size_t h )
+  {
+    node **chain;
+
+    n->hash = h;
+
+    if ( capacity_ == 0 || size_ + 1 > maxload_ * capacity_ ) {
+      try {
+        rehash ( capacity_ == 0 ? 8 : capacity_ * 2 );
+      }
+      catch ( ... ) {
+        destroy ( n );
+        throw;
+      }
+    }
+
+    chain = &table_[h & ( capacity_ - 1 )];
+    n->next = *chain;
+    *chain = n;
+    ++size_;
+  }
+
+  /* First node at or after bucket i */
+  node *first_node ( size_type i ) const
+  {
+    for ( ; i < capacity_; i++ ) {
+      if ( table_[i] != NULL )
+        return table_[i];
+    }
+
+    return NULL;
+  }
+
+  node *next_node ( node *it ) const
+  {
+    if ( it->next != NULL )
+      return it->next;
+
+    return first_node ( ( it->hash & ( capacity_ - 1 ) ) + 1 );
+  }
+
+  template <class... Args>
+  node *create ( Args&&... args )
+  {
+    node *n = node_traits::allocate ( nodes_, 1 );
+
+    try {
+      node_traits::construct ( nodes_, n, std::forward<Args> ( args )... );
+    }
+    catch ( ... ) {
+      node_traits::deallocate ( nodes_, n, 1 );
+      throw;
+    }
+
+    return n;
+  }
+
+  void destroy ( node *n )
+  {
+    node_traits::destroy ( nodes_, n );
+    node_traits::deallocate ( nodes_, n, 1 );
+  }
+
+  void release ()
+  {
+    clear();
+
+    if ( table_ != NULL )
+      table_traits::deallocate ( tables_, table_, capacity_ );
+
+    table_ = NULL;
+    capacity_ = 0;
+  }
+
+  node      **table_;    /* Chained hash table */
+  size_type   capacity_; /* Number of buckets, a power of two */
+  size_type   size_;     /* Current entry count */
+  float       maxload_;  /* Load factor that triggers growth */
+  Hash        hash_;     /* Key hash function */
+  Eq          eq_;       /* Key equality */
+  node_alloc  nodes_;    /* Node allocator */
+  table_alloc tables_;   /* Bucket array allocator */
+};
+
+}
+
+#endif
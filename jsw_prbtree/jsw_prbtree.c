@@ -0,0 +1,803 @@
+/*
+  Persistent red black tree library
+
+    > Created (agent): October 14, 2026
+
+  Insertion and erasure are the bottom-up algorithms from
+  the red black tree tutorial, where every node is made
+  private to the writer's version before it is changed.
+  A node stamped with the writer's version is private and
+  changed in place. Any other node may be in a published
+  version, so it is copied and the original retired. The
+  stamp moves on with every publish, so a batch of updates
+  between publishes copies each node at most once.
+
+  Retired memory waits in a queue in retirement order.
+  Publishing tags everything retired since the last publish
+  with the current epoch and then advances it. A view pins
+  by storing the epoch it saw before it loads the version,
+  so a view pinned at a later epoch can only have loaded a
+  later version, and a tag is released once every pinned
+  view has a later epoch. A view that stored its pin after
+  the writer looked at it loads a version published before
+  the look, which the memory being released is not part of.
+
+  Nodes copied or made by an update come from spares the
+  update reserves before it changes anything, along with
+  room in the queue, so a failed allocation leaves both
+  versions as they were.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+#include "jsw_prbtree.h"
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef HEIGHT_LIMIT
+#define HEIGHT_LIMIT 64 /* Tallest allowable tree */
+#endif
+
+/* Nodes and queue entries reserved for an update of depth d */
+#define RESERVE(d) ( 2 * (d) + 10 )
+
+/* Kinds of retired memory */
+enum { RETIRE_NODE, RETIRE_ITEM, RETIRE_VERSION };
+
+typedef struct jsw_prbnode {
+  int                 red;     /* Color (1=red, 0=black) */
+  unsigned long long  stamp;   /* Writer's version that made this node */
+  void               *item;    /* User-defined content */
+  struct jsw_prbnode *link[2]; /* Left (0) and right (1) links */
+} jsw_prbnode_t;
+
+/* A published version, swapped in whole */
+typedef struct jsw_prbver {
+  jsw_prbnode_t *root; /* Top of the version's tree */
+  size_t         size; /* Number of items in it */
+} jsw_prbver_t;
+
+/* Memory waiting for the views that might read it */
+typedef struct jsw_prblimbo {
+  void               *p;     /* Node, item or version */
+  int                 kind;  /* RETIRE_NODE, RETIRE_ITEM or RETIRE_VERSION */
+  unsigned long long  epoch; /* Epoch it was published out of */
+} jsw_prblimbo_t;
+
+struct jsw_prbview {
+  jsw_prbtree_t           *tree;               /* Tree this view reads */
+  struct jsw_prbview      *link;               /* Next view, fixed once published */
+  atomic_int               busy;               /* Non-zero while a thread owns it */
+  atomic_ullong            state;              /* Pinned epoch << 1, low bit if pinned */
+  unsigned                 nest;               /* Depth of nested pins */
+  jsw_prbver_t            *ver;                /* Version seen while pinned */
+  jsw_prbnode_t           *it;                 /* Current node of the traversal */
+  jsw_prbnode_t           *path[HEIGHT_LIMIT]; /* Traversal path */
+  size_t                   top;                /* Top of stack */
+};
+
+struct jsw_prbtree {
+  jsw_prbnode_t            *root;    /* Top of the writer's version */
+  size_t                    size;    /* Number of items in the writer's version */
+  unsigned long long        stamp;   /* Stamp of nodes private to the writer */
+  _Atomic(jsw_prbver_t *)   current; /* Published version */
+  atomic_ullong             epoch;   /* Advanced by every publish */
+  _Atomic(jsw_prbview_t *)  views;   /* Every view ever attached */
+  jsw_prblimbo_t           *limbo;   /* Retired memory, oldest first */
+  size_t                    head;    /* First entry not yet released */
+  size_t                    pending; /* First entry not yet tagged */
+  size_t                    count;   /* Entries in use */
+  size_t                    cap;     /* Entries allocated */
+  jsw_prbnode_t            *spare;   /* Reserved nodes, linked by link[0] */
+  size_t                    spares;  /* Number of reserved nodes */
+  cmp_f                     cmp;     /* User defined item compare function */
+  dup_f                     dup;     /* User defined item copy function */
+  rel_f                     rel;     /* User defined delete function */
+};
+
+static int is_red ( jsw_prbnode_t *node )
+{
+  return node != NULL && node->red == 1;
+}
+
+/*
+  Make sure the next update can take n nodes and retire
+  n entries without allocating anything
+
+  Returns: non-zero for success, zero for failure
+*/
+static int reserve ( jsw_prbtree_t *tree, size_t n )
+{
+  while ( tree->spares < n ) {
+    jsw_prbnode_t *node = (jsw_prbnode_t *)malloc ( sizeof *node );
+
+    if ( node == NULL )
+      return 0;
+
+    node->link[0] = tree->spare;
+    tree->spare = node;
+    ++tree->spares;
+  }
+
+  /* Move released entries out of the way before growing */
+  if ( tree->cap - tree->count < n && tree->head > 0 ) {
+    memmove ( tree->limbo, tree->limbo + tree->head,
+      ( tree->count - tree->head ) * sizeof *tree->limbo );
+    tree->pending -= tree->head;
+    tree->count -= tree->head;
+    tree->head = 0;
+  }
+
+  if ( tree->cap - tree->count < n ) {
+    size_t cap = tree->cap * 2 > tree->count + n
+      ? tree->cap * 2 : tree->count + n;
+    jsw_prblimbo_t *limbo = (jsw_prblimbo_t *)realloc ( tree->limbo,
+      cap * sizeof *limbo );
+
+    if ( limbo == NULL )
+      return 0;
+
+    tree->limbo = limbo;
+    tree->cap = cap;
+  }
+
+  return 1;
+}
+
+/* Take a reserved node, stamped as private to the writer */
+static jsw_prbnode_t *take ( jsw_prbtree_t *tree )
+{
+  jsw_prbnode_t *node = tree->spare;
+
+  tree->spare = node->link[0];
+  --tree->spares;
+  node->stamp = tree->stamp;
+
+  return node;
+}
+
+/* Queue memory a published version may still use, in reserved room */
+static void retire ( jsw_prbtree_t *tree, void *p, int kind )
+{
+  jsw_prblimbo_t *entry = &tree->limbo[tree->count++];
+
+  entry->p = p;
+  entry->kind = kind;
+  entry->epoch = 0;
+}
+
+static void release_entry ( jsw_prbtree_t *tree, jsw_prblimbo_t *entry )
+{
+  if ( entry->kind == RETIRE_ITEM )
+    tree->rel ( entry->p );
+  else
+    free ( entry->p );
+}
+
+/*
+  Make node private to the writer's version, copying it
+  if readers might see it
+
+  Returns: The private node, which replaces node in its parent
+*/
+static jsw_prbnode_t *own ( jsw_prbtree_t *tree, jsw_prbnode_t *node )
+{
+  jsw_prbnode_t *copy;
+
+  if ( node == NULL || node->stamp == tree->stamp )
+    return node;
+
+  copy = take ( tree );
+  copy->red = node->red;
+  copy->item = node->item;
+  copy->link[0] = node->link[0];
+  copy->link[1] = node->link[1];
+  retire ( tree, node, RETIRE_NODE );
+
+  return copy;
+}
+
+/* Drop a node that has left the writer's version */
+static void discard ( jsw_prbtree_t *tree, jsw_prbnode_t *node )
+{
+  if ( node->stamp == tree->stamp ) {
+    node->link[0] = tree->spare;
+    tree->spare = node;
+    ++tree->spares;
+  }
+  else
+    retire ( tree, node, RETIRE_NODE );
+}
+
+/* Both nodes must already be private to the writer */
+static jsw_prbnode_t *single ( jsw_prbnode_t *root, int dir )
+{
+  jsw_prbnode_t *save = root->link[!dir];
+
+  root->link[!dir] = save->link[dir];
+  save->link[dir] = root;
+
+  root->red = 1;
+  save->red = 0;
+
+  return save;
+}
+
+/* All three nodes must already be private to the writer */
+static jsw_prbnode_t *pdouble ( jsw_prbnode_t *root, int dir )
+{
+  root->link[!dir] = single ( root->link[!dir], !dir );
+
+  return single ( root, dir );
+}
+
+/*
+  Insert node below root, fixing red violations on the
+  way back up. The subtree returned is always private
+
+  Returns: The new root of the subtree
+*/
+static jsw_prbnode_t *insert_r ( jsw_prbtree_t *tree, jsw_prbnode_t *root,
+  jsw_prbnode_t *node )
+{
+  jsw_prbnode_t *child;
+  int dir;
+
+  if ( root == NULL )
+    return node;
+
+  root = own ( tree, root );
+  dir = tree->cmp ( root->item, node->item ) < 0;
+  root->link[dir] = insert_r ( tree, root->link[dir], node );
+  child = root->link[dir];
+
+  /* Only the path can have a red node with a red child */
+  if ( is_red ( child )
+    && ( is_red ( child->link[0] ) || is_red ( child->link[1] ) ) )
+  {
+    if ( is_red ( root->link[!dir] ) ) {
+      /* Color flip */
+      root->link[!dir] = own ( tree, root->link[!dir] );
+      root->red = 1;
+      root->link[0]->red = 0;
+      root->link[1]->red = 0;
+    }
+    else if ( is_red ( child->link[dir] ) )
+      root = single ( root, !dir );
+    else
+      root = pdouble ( root, !dir );
+  }
+
+  return root;
+}
+
+/*
+  Restore the black height of root after its dir subtree
+  lost one, copying the sibling side it changes
+
+  Returns: The new root of the subtree
+*/
+static jsw_prbnode_t *remove_balance ( jsw_prbtree_t *tree,
+  jsw_prbnode_t *root, int dir, int *done )
+{
+  jsw_prbnode_t *p = root;
+  jsw_prbnode_t *s = own ( tree, root->link[!dir] );
+
+  root->link[!dir] = s;
+
+  /* A red sibling becomes the parent, leaving a black one */
+  if ( is_red ( s ) ) {
+    root = single ( root, dir );
+    s = own ( tree, p->link[!dir] );
+    p->link[!dir] = s;
+  }
+
+  if ( s != NULL ) {
+    if ( !is_red ( s->link[0] ) && !is_red ( s->link[1] ) ) {
+      if ( is_red ( p ) )
+        *done = 1;
+
+      p->red = 0;
+      s->red = 1;
+    }
+    else {
+      int save = p->red;
+      int new_root = ( root == p );
+
+      if ( is_red ( s->link[!dir] ) ) {
+        s->link[!dir] = own ( tree, s->link[!dir] );
+        p = single ( p, dir );
+      }
+      else {
+        s->link[dir] = own ( tree, s->link[dir] );
+        p = pdouble ( p, dir );
+      }
+
+      p->red = save;
+      p->link[0]->red = 0;
+      p->link[1]->red = 0;
+
+      if ( new_root )
+        root = p;
+      else
+        root->link[dir] = p;
+
+      *done = 1;
+    }
+  }
+
+  return root;
+}
+
+/*
+  Remove the node matching item below root. A node with
+  two children takes its predecessor's item, and the
+  predecessor is removed instead
+
+  Returns: The new root of the subtree
+*/
+static jsw_prbnode_t *remove_r ( jsw_prbtree_t *tree, jsw_prbnode_t *root,
+  const void *item, int *done )
+{
+  int cmp = tree->cmp ( root->item, item );
+  int dir;
+
+  if ( cmp == 0 ) {
+    if ( root->link[0] == NULL || root->link[1] == NULL ) {
+      jsw_prbnode_t *save = root->link[root->link[0] == NULL];
+
+      if ( is_red ( root ) )
+        *done = 1;
+      else if ( is_red ( save ) ) {
+        save = own ( tree, save );
+        save->red = 0;
+        *done = 1;
+      }
+
+      discard ( tree, root );
+
+      return save;
+    }
+    else {
+      jsw_prbnode_t *heir = root->link[0];
+
+      while ( heir->link[1] != NULL )
+        heir = heir->link[1];
+
+      root = own ( tree, root );
+      root->item = heir->item;
+      item = heir->item;
+      dir = 0;
+    }
+  }
+  else {
+    root = own ( tree, root );
+    dir = cmp < 0;
+  }
+
+  root->link[dir] = remove_r ( tree, root->link[dir], item, done );
+
+  if ( !*done )
+    root = remove_balance ( tree, root, dir, done );
+
+  return root;
+}
+
+/* The writer's root is black, copied first if it has to change */
+static void blacken_root ( jsw_prbtree_t *tree )
+{
+  if ( is_red ( tree->root ) ) {
+    tree->root = own ( tree, tree->root );
+    tree->root->red = 0;
+  }
+}
+
+/* Release everything no pinned view is still behind */
+static void reclaim ( jsw_prbtree_t *tree )
+{
+  unsigned long long oldest = ~0ULL;
+  jsw_prbview_t *it = atomic_load ( &tree->views );
+
+  for ( ; it != NULL; it = it->link ) {
+    unsigned long long s = atomic_load ( &it->state );
+
+    if ( ( s & 1 ) != 0 && ( s >> 1 ) < oldest )
+      oldest = s >> 1;
+  }
+
+  while ( tree->head < tree->pending
+    && tree->limbo[tree->head].epoch < oldest )
+  {
+    release_entry ( tree, &tree->limbo[tree->head++] );
+  }
+}
+
+/* Release every node of a subtree along with its item */
+static void release_tree ( jsw_prbtree_t *tree, jsw_prbnode_t *node )
+{
+  jsw_prbnode_t *save;
+
+  /* Rotate away the left links, like jsw_rbdelete */
+  while ( node != NULL ) {
+    if ( node->link[0] == NULL ) {
+      save = node->link[1];
+      tree->rel ( node->item );
+      free ( node );
+    }
+    else {
+      save = node->link[0];
+      node->link[0] = save->link[1];
+      save->link[1] = node;
+    }
+
+    node = save;
+  }
+}
+
+jsw_prbtree_t *jsw_prbnew ( cmp_f cmp, dup_f dup, rel_f rel )
+{
+  jsw_prbtree_t *tree = (jsw_prbtree_t *)malloc ( sizeof *tree );
+  jsw_prbver_t *ver;
+
+  if ( tree == NULL )
+    return NULL;
+
+  ver = (jsw_prbver_t *)malloc ( sizeof *ver );
+
+  if ( ver == NULL ) {
+    free ( tree );
+    return NULL;
+  }
+
+  ver->root = NULL;
+  ver->size = 0;
+
+  tree->root = NULL;
+  tree->size = 0;
+  tree->stamp = 1;
+  atomic_init ( &tree->current, ver );
+  atomic_init ( &tree->epoch, 0ULL );
+  atomic_init ( &tree->views, (jsw_prbview_t *)NULL );
+  tree->limbo = NULL;
+  tree->head = 0;
+  tree->pending = 0;
+  tree->count = 0;
+  tree->cap = 0;
+  tree->spare = NULL;
+  tree->spares = 0;
+  tree->cmp = cmp;
+  tree->dup = dup;
+  tree->rel = rel;
+
+  return tree;
+}
+
+void jsw_prbdelete ( jsw_prbtree_t *tree )
+{
+  jsw_prbview_t *view = atomic_load ( &tree->views );
+  jsw_prbview_t *next;
+  jsw_prbnode_t *save;
+  size_t i;
+
+  /*
+    Nodes of the published version that the writer has
+    since replaced are all queued with the rest
+  */
+  release_tree ( tree, tree->root );
+
+  for ( i = tree->head; i < tree->count; i++ )
+    release_entry ( tree, &tree->limbo[i] );
+
+  free ( tree->limbo );
+  free ( atomic_load ( &tree->current ) );
+
+  while ( tree->spare != NULL ) {
+    save = tree->spare->link[0];
+    free ( tree->spare );
+    tree->spare = save;
+  }
+
+  while ( view != NULL ) {
+    next = view->link;
+    free ( view );
+    view = next;
+  }
+
+  free ( tree );
+}
+
+int jsw_prbinsert ( jsw_prbtree_t *tree, void *item )
+{
+  jsw_prbnode_t *it = tree->root;
+  jsw_prbnode_t *node;
+  size_t depth = 0;
+
+  /* Reject duplicates before copying anything */
+  while ( it != NULL ) {
+    int cmp = tree->cmp ( it->item, item );
+
+    if ( cmp == 0 )
+      return 0;
+
+    it = it->link[cmp < 0];
+    ++depth;
+  }
+
+  if ( !reserve ( tree, RESERVE ( depth ) ) )
+    return 0;
+
+  node = take ( tree );
+  node->item = tree->dup ( item );
+
+  if ( node->item == NULL ) {
+    discard ( tree, node );
+    return 0;
+  }
+
+  node->red = 1;
+  node->link[0] = node->link[1] = NULL;
+
+  tree->root = insert_r ( tree, tree->root, node );
+  blacken_root ( tree );
+  ++tree->size;
+
+  return 1;
+}
+
+int jsw_prberase ( jsw_prbtree_t *tree, void *item )
+{
+  jsw_prbnode_t *it = tree->root;
+  void *victim = NULL;
+  size_t depth = 0;
+  int done = 0;
+
+  while ( it != NULL ) {
+    int cmp = tree->cmp ( it->item, item );
+
+    ++depth;
+
+    if ( cmp == 0 ) {
+      victim = it->item;
+      break;
+    }
+
+    it = it->link[cmp < 0];
+  }
+
+  /* A node with two children is replaced by its predecessor */
+  if ( victim != NULL ) {
+    for ( it = it->link[0]; it != NULL; it = it->link[1] )
+      ++depth;
+  }
+
+  if ( victim == NULL || !reserve ( tree, RESERVE ( depth ) ) )
+    return 0;
+
+  tree->root = remove_r ( tree, tree->root, item, &done );
+  blacken_root ( tree );
+  retire ( tree, victim, RETIRE_ITEM );
+  --tree->size;
+
+  return 1;
+}
+
+int jsw_prbpublish ( jsw_prbtree_t *tree )
+{
+  jsw_prbver_t *ver = (jsw_prbver_t *)malloc ( sizeof *ver );
+  unsigned long long e;
+  size_t i;
+
+  if ( ver == NULL || !reserve ( tree, 1 ) ) {
+    free ( ver );
+    return 0;
+  }
+
+  ver->root = tree->root;
+  ver->size = tree->size;
+  retire ( tree, atomic_exchange ( &tree->current, ver ), RETIRE_VERSION );
+
+  /* Everything retired since the last publish left with this one */
+  e = atomic_load ( &tree->epoch );
+
+  for ( i = tree->pending; i < tree->count; i++ )
+    tree->limbo[i].epoch = e;
+
+  tree->pending = tree->count;
+  atomic_store ( &tree->epoch, e + 1 );
+
+  /* Published nodes can't be changed in place any more */
+  ++tree->stamp;
+  reclaim ( tree );
+
+  return 1;
+}
+
+size_t jsw_prbsize ( jsw_prbtree_t *tree )
+{
+  return tree->size;
+}
+
+jsw_prbview_t *jsw_prbattach ( jsw_prbtree_t *tree )
+{
+  jsw_prbview_t *view = atomic_load ( &tree->views );
+  int idle;
+
+  /* Reuse a detached view */
+  for ( ; view != NULL; view = view->link ) {
+    idle = 0;
+
+    if ( atomic_load ( &view->busy ) == 0
+      && atomic_compare_exchange_strong ( &view->busy, &idle, 1 ) )
+    {
+      return view;
+    }
+  }
+
+  view = (jsw_prbview_t *)malloc ( sizeof *view );
+
+  if ( view == NULL )
+    return NULL;
+
+  view->tree = tree;
+  atomic_init ( &view->busy, 1 );
+  atomic_init ( &view->state, 0ULL );
+  view->nest = 0;
+  view->ver = NULL;
+  view->it = NULL;
+  view->top = 0;
+
+  view->link = atomic_load ( &tree->views );
+
+  while ( !atomic_compare_exchange_weak ( &tree->views, &view->link, view ) )
+    ;
+
+  return view;
+}
+
+void jsw_prbdetach ( jsw_prbview_t *view )
+{
+  view->nest = 0;
+  view->ver = NULL;
+  view->it = NULL;
+  atomic_store ( &view->state, 0ULL );
+  atomic_store ( &view->busy, 0 );
+}
+
+void jsw_prbpin ( jsw_prbview_t *view )
+{
+  unsigned long long e;
+
+  if ( view->nest++ != 0 )
+    return;
+
+  /* A stale epoch only holds back more memory than it needs to */
+  e = atomic_load ( &view->tree->epoch );
+  atomic_store ( &view->state, e << 1 | 1 );
+  view->ver = atomic_load ( &view->tree->current );
+}
+
+void jsw_prbunpin ( jsw_prbview_t *view )
+{
+  if ( --view->nest == 0 ) {
+    view->ver = NULL;
+    view->it = NULL;
+    atomic_store_explicit ( &view->state, 0ULL, memory_order_release );
+  }
+}
+
+void *jsw_prbfind ( jsw_prbview_t *view, void *item )
+{
+  jsw_prbtree_t *tree = view->tree;
+  jsw_prbnode_t *it;
+  void *found = NULL;
+
+  jsw_prbpin ( view );
+
+  for ( it = view->ver->root; it != NULL; ) {
+    int cmp = tree->cmp ( it->item, item );
+
+    if ( cmp == 0 ) {
+      found = it->item;
+      break;
+    }
+
+    it = it->link[cmp < 0];
+  }
+
+  jsw_prbunpin ( view );
+
+  return found;
+}
+
+size_t jsw_prbvsize ( jsw_prbview_t *view )
+{
+  size_t size;
+
+  jsw_prbpin ( view );
+  size = view->ver->size;
+  jsw_prbunpin ( view );
+
+  return size;
+}
+
+/* Start a traversal at the edge of the version in direction dir */
+static void *start ( jsw_prbview_t *view, int dir )
+{
+  view->it = view->ver->root;
+  view->top = 0;
+
+  /* Save the path for later traversal */
+  if ( view->it != NULL ) {
+    while ( view->it->link[dir] != NULL ) {
+      view->path[view->top++] = view->it;
+      view->it = view->it->link[dir];
+    }
+  }
+
+  return view->it == NULL ? NULL : view->it->item;
+}
+
+/* Step the traversal one item in direction dir */
+static void *move ( jsw_prbview_t *view, int dir )
+{
+  if ( view->it == NULL )
+    return NULL;
+
+  if ( view->it->link[dir] != NULL ) {
+    /* Continue down this branch */
+    view->path[view->top++] = view->it;
+    view->it = view->it->link[dir];
+
+    while ( view->it->link[!dir] != NULL ) {
+      view->path[view->top++] = view->it;
+      view->it = view->it->link[!dir];
+    }
+  }
+  else {
+    /* Move to the next branch */
+    jsw_prbnode_t *last;
+
+    do {
+      if ( view->top == 0 ) {
+        view->it = NULL;
+        break;
+      }
+
+      last = view->it;
+      view->it = view->path[--view->top];
+    } while ( last == view->it->link[dir] );
+  }
+
+  return view->it == NULL ? NULL : view->it->item;
+}
+
+void *jsw_prbfirst ( jsw_prbview_t *view )
+{
+  return start ( view, 0 );
+}
+
+void *jsw_prblast ( jsw_prbview_t *view )
+{
+  return start ( view, 1 );
+}
+
+void *jsw_prbnext ( jsw_prbview_t *view )
+{
+  return move ( view, 1 );
+}
+
+void *jsw_prbprev ( jsw_prbview_t *view )
+{
+  return move ( view, 0 );
+}
@@ -0,0 +1,158 @@
+#ifndef JSW_PRBTREE_H
+#define JSW_PRBTREE_H
+
+/*
+  Persistent red black tree library
+
+    > Created (agent): October 14, 2026
+
+  A red black tree for one writer and any number of
+  readers. The writer never changes a node that readers
+  can see: insert and erase copy the nodes on the path
+  they change, so the rest of the tree is shared with
+  the version readers have. jsw_prbpublish makes the
+  writer's version the current one with an atomic swap
+  of a single pointer.
+
+  Readers attach a view and pin it, which picks up the
+  current version. Everything read through the view
+  comes from that version until it is unpinned, however
+  many versions are published meanwhile. Pinning is one
+  atomic load and one store, so readers never wait for
+  the writer or for each other. Copied nodes, erased
+  items and old versions are released by the writer,
+  once no pinned view can still be reading them.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+#ifdef __cplusplus
+#include <cstddef>
+
+using std::size_t;
+
+extern "C" {
+#else
+#include <stddef.h>
+#endif
+
+typedef struct jsw_prbtree jsw_prbtree_t;
+typedef struct jsw_prbview jsw_prbview_t;
+
+/* Application specific key comparison function */
+typedef int   (*cmp_f) ( const void *a, const void *b );
+
+/* Application specific item copying function */
+typedef void *(*dup_f) ( const void *item );
+
+/* Application specific item deletion function */
+typedef void  (*rel_f) ( void *item );
+
+/*
+  Create a new persistent tree, with an empty version
+  already published
+
+  Returns: An empty tree, or NULL on failure
+*/
+jsw_prbtree_t *jsw_prbnew ( cmp_f cmp, dup_f dup, rel_f rel );
+
+/*
+  Release all memory used by the tree. No view may still
+  be in use, but views need not be detached
+*/
+void           jsw_prbdelete ( jsw_prbtree_t *tree );
+
+/*
+  Insert an item with the selected key into the writer's
+  version. Only one thread may call the writer functions
+  (insert, erase, publish and size) at a time
+
+  Returns: non-zero for success, zero for failure
+*/
+int            jsw_prbinsert ( jsw_prbtree_t *tree, void *item );
+
+/*
+  Remove an item with the selected key from the writer's
+  version. The item is released once no view can see it
+
+  Returns: non-zero for success, zero for failure
+*/
+int            jsw_prberase ( jsw_prbtree_t *tree, void *item );
+
+/*
+  Make the writer's version the current one. Views pinned
+  from now on see it, and memory that only older versions
+  used is released as the views holding them unpin
+
+  Returns: non-zero for success, zero for failure
+*/
+int            jsw_prbpublish ( jsw_prbtree_t *tree );
+
+/* Number of items in the writer's version */
+size_t         jsw_prbsize ( jsw_prbtree_t *tree );
+
+/*
+  Make a view for the calling thread. The view belongs
+  to that thread until jsw_prbdetach
+
+  Returns: A view, or NULL on failure
+*/
+jsw_prbview_t *jsw_prbattach ( jsw_prbtree_t *tree );
+
+/* Give up a view so another thread can reuse it */
+void           jsw_prbdetach ( jsw_prbview_t *view );
+
+/*
+  Pin the current version to the view. Items found and
+  traversed stay valid until the matching jsw_prbunpin.
+  Pins nest, only the outermost picks up a new version,
+  and every call below pins itself, so this is only
+  needed to see several calls from one version
+*/
+void           jsw_prbpin ( jsw_prbview_t *view );
+
+/* Leave a pin entered by jsw_prbpin */
+void           jsw_prbunpin ( jsw_prbview_t *view );
+
+/*
+  Find an item with the selected key in the view's
+  version. Never writes to shared memory
+
+  Returns: The item, or NULL if not found
+*/
+void          *jsw_prbfind ( jsw_prbview_t *view, void *item );
+
+/* Number of items in the view's version */
+size_t         jsw_prbvsize ( jsw_prbview_t *view );
+
+/*
+  Traverse the view's version from the smallest or the
+  largest item. The traversal functions must be called
+  while pinned
+
+  Returns: The item, or NULL if the version is empty
+*/
+void          *jsw_prbfirst ( jsw_prbview_t *view );
+void          *jsw_prblast ( jsw_prbview_t *view );
+
+/*
+  Move the view's traversal to the next or previous item
+
+  Returns: The item, or NULL past the end
+*/
+void          *jsw_prbnext ( jsw_prbview_t *view );
+void          *jsw_prbprev ( jsw_prbview_t *view );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -2,54 +2,113 @@
 #include <time.h>
 #include "jsw_rand.h"
 
-#define N 624
+#if defined ( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+#define N JSW_RAND_N
 #define M 397
 #define A 0x9908b0dfUL
 #define U 0x80000000UL
 #define L 0x7fffffffUL
 
-/* Internal state */
-static unsigned long x[N];
-static int next;
+/* Internal state for the global functions */
+static jsw_rand_state_t global;
 
 /* Initialize internal state */
 void jsw_seed ( unsigned long s )
 {
-  int i;
-
-  x[0] = s & 0xffffffffUL;
-
-  for ( i = 1; i < N; i++ ) {
-    x[i] = ( 1812433253UL 
-      * ( x[i - 1] ^ ( x[i - 1] >> 30 ) ) + i );
-    x[i] &= 0xffffffffUL;
-  }
+  jsw_rand_seed ( &global, (uint32_t)s );
 }
 
 /* Mersenne Twister */
 unsigned long jsw_rand ( void )
 {
-  unsigned long y, a;
+  return jsw_rand_next ( &global );
+}
+
+void jsw_rand_fill ( uint32_t *buf, size_t n )
+{
+  jsw_rand_fill_r ( &global, buf, n );
+}
+
+void jsw_rand_seed ( jsw_rand_state_t *rs, uint32_t s )
+{
+  uint32_t *x = rs->x;
   int i;
 
-  /* Refill x if exhausted */
-  if ( next == N ) {
-    next = 0;
+  x[0] = s;
 
-    for ( i = 0; i < N - 1; i++ ) {
-      y = ( x[i] & U ) | x[i + 1] & L;
-      a = ( y & 0x1UL ) ? A : 0x0UL;
-      x[i] = x[( i + M ) % N] ^ ( y >> 1 ) ^ a;
-    }
+  for ( i = 1; i < N; i++ )
+    x[i] = 1812433253UL * ( x[i - 1] ^ ( x[i - 1] >> 30 ) ) + i;
 
-    y = ( x[N - 1] & U ) | x[0] & L;
-    a = ( y & 0x1UL ) ? A : 0x0UL;
-    x[N - 1] = x[M - 1] ^ ( y >> 1 ) ^ a;
-  }
+  /* The first draw regenerates the block */
+  rs->next = N;
+}
+
+/* One step of the recurrence for x[i], with x[i + 1] and x[i + M] given */
+#define twist(x,i,i1,im) do {                          \
+  uint32_t y = ( (x)[i] & U ) | ( (x)[i1] & L );       \
+  (x)[i] = (x)[im] ^ ( y >> 1 ) ^ ( ( 0U - ( y & 1 ) ) & A ); \
+} while (0)
+
+#if defined ( __SSE2__ )
+/* Four steps of the recurrence, starting at x[i] */
+static void twist4 ( uint32_t *x, int i, int im )
+{
+  const __m128i upper = _mm_set1_epi32 ( (int)U );
+  const __m128i lower = _mm_set1_epi32 ( (int)L );
+  const __m128i one = _mm_set1_epi32 ( 1 );
+  const __m128i a = _mm_set1_epi32 ( (int)A );
+  __m128i y, mag;
+
+  y = _mm_or_si128 (
+    _mm_and_si128 ( _mm_loadu_si128 ( (const __m128i *)( x + i ) ), upper ),
+    _mm_and_si128 ( _mm_loadu_si128 ( (const __m128i *)( x + i + 1 ) ), lower ) );
+  mag = _mm_and_si128 (
+    _mm_sub_epi32 ( _mm_setzero_si128(), _mm_and_si128 ( y, one ) ), a );
+  y = _mm_xor_si128 ( _mm_srli_epi32 ( y, 1 ), mag );
+  y = _mm_xor_si128 ( y, _mm_loadu_si128 ( (const __m128i *)( x + im ) ) );
+
+  _mm_storeu_si128 ( (__m128i *)( x + i ), y );
+}
+#endif
+
+/*
+  Regenerate the whole block. The loop is split where
+  x[i + M] wraps around, so there's no modulo. Lanes of
+  a vector only read words that are either all still old
+  (x[i + 1]) or all already new (x[i + M - N], 227 back)
+*/
+static void refill ( jsw_rand_state_t *rs )
+{
+  uint32_t *x = rs->x;
+  int i = 0;
+
+#if defined ( __SSE2__ )
+  for ( ; i + 4 <= N - M; i += 4 )
+    twist4 ( x, i, i + M );
+#endif
+
+  for ( ; i < N - M; i++ )
+    twist ( x, i, i + 1, i + M );
+
+#if defined ( __SSE2__ )
+  for ( ; i + 4 <= N - 1; i += 4 )
+    twist4 ( x, i, i + M - N );
+#endif
 
-  y = x[next++];
+  for ( ; i < N - 1; i++ )
+    twist ( x, i, i + 1, i + M - N );
 
-  /* Improve distribution */
+  twist ( x, N - 1, 0, M - 1 );
+
+  rs->next = 0;
+}
+
+/* Improve distribution */
+static uint32_t temper ( uint32_t y )
+{
   y ^= (y >> 11);
   y ^= (y << 7) & 0x9d2c5680UL;
   y ^= (y << 15) & 0xefc60000UL;
@@ -58,6 +117,60 @@ unsigned long jsw_rand ( void )
   return y;
 }
 
+uint32_t jsw_rand_next ( jsw_rand_state_t *rs )
+{
+  /* Refill x if exhausted */
+  if ( rs->next >= N )
+    refill ( rs );
+
+  return temper ( rs->x[rs->next++] );
+}
+
+void jsw_rand_fill_r ( jsw_rand_state_t *rs, uint32_t *buf, size_t n )
+{
+  while ( n > 0 ) {
+    const uint32_t *x;
+    size_t i, k;
+
+    if ( rs->next >= N )
+      refill ( rs );
+
+    /* Temper as much of the current block as fits */
+    k = (size_t)( N - rs->next );
+
+    if ( k > n )
+      k = n;
+
+    x = rs->x + rs->next;
+    i = 0;
+
+#if defined ( __SSE2__ )
+    {
+      const __m128i b = _mm_set1_epi32 ( (int)0x9d2c5680UL );
+      const __m128i c = _mm_set1_epi32 ( (int)0xefc60000UL );
+
+      for ( ; i + 4 <= k; i += 4 ) {
+        __m128i y = _mm_loadu_si128 ( (const __m128i *)( x + i ) );
+
+        y = _mm_xor_si128 ( y, _mm_srli_epi32 ( y, 11 ) );
+        y = _mm_xor_si128 ( y, _mm_and_si128 ( _mm_slli_epi32 ( y, 7 ), b ) );
+        y = _mm_xor_si128 ( y, _mm_and_si128 ( _mm_slli_epi32 ( y, 15 ), c ) );
+        y = _mm_xor_si128 ( y, _mm_srli_epi32 ( y, 18 ) );
+
+        _mm_storeu_si128 ( (__m128i *)( buf + i ), y );
+      }
+    }
+#endif
+
+    for ( ; i < k; i++ )
+      buf[i] = temper ( x[i] );
+
+    rs->next += (int)k;
+    buf += k;
+    n -= k;
+  }
+}
+
 /* Portable time seed */
 unsigned jsw_time_seed()
 {
@@ -70,4 +183,4 @@ unsigned jsw_time_seed()
     seed = seed * ( UCHAR_MAX + 2U ) + p[i];
 
   return seed;
-}
\ No newline at end of file
+}
@@ -1,13 +1,49 @@
 #ifndef JSW_RAND_H
 #define JSW_RAND_H
 
+#ifdef __cplusplus
+#include <cstddef>
+#include <stdint.h>
+
+using std::size_t;
+
+extern "C" {
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+#define JSW_RAND_N 624
+
+/* Independent Mersenne Twister, one per thread */
+typedef struct jsw_rand_state {
+  uint32_t x[JSW_RAND_N]; /* Internal state */
+  int      next;          /* Next word to temper */
+} jsw_rand_state_t;
+
 /* Seed the RNG. Must be called first */
 void          jsw_seed ( unsigned long s );
 
 /* Return a 32-bit random number */
 unsigned long jsw_rand ( void );
 
+/* Fill buf with n random numbers from the global RNG */
+void          jsw_rand_fill ( uint32_t *buf, size_t n );
+
+/* Seed a state object. Must be called before using it */
+void          jsw_rand_seed ( jsw_rand_state_t *rs, uint32_t s );
+
+/* Return a 32-bit random number from a state object */
+uint32_t      jsw_rand_next ( jsw_rand_state_t *rs );
+
+/* Fill buf with n random numbers from a state object */
+void          jsw_rand_fill_r ( jsw_rand_state_t *rs, uint32_t *buf, size_t n );
+
 /* Seed with current system time */
 unsigned      jsw_time_seed();
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
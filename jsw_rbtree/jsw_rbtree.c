@@ -3,6 +3,12 @@
 
     > Created (Julienne Walker): August 23, 2003
     > Modified (Julienne Walker): March 14, 2008
+    > Modified (agent): October 14, 2026
+      Compared once per level, and added allocator
+      hooks, intrusive nodes, building from sorted
+      input, bounds and range visits, rank and select,
+      batch lookups, JSW_STATS counters, clear and set
+      operations
 */
 #include "jsw_rbtree.h"
 
@@ -20,11 +26,48 @@ using std::size_t;
 #define HEIGHT_LIMIT 64 /* Tallest allowable tree */
 #endif
 
-typedef struct jsw_rbnode {
-  int                red;     /* Color (1=red, 0=black) */
-  void              *data;    /* User-defined content */
-  struct jsw_rbnode *link[2]; /* Left (0) and right (1) links */
-} jsw_rbnode_t;
+/* Searches interleaved by the batch lookup */
+#ifndef FIND_GROUP
+#define FIND_GROUP 8
+#endif
+
+/* Software prefetch hint, nothing where the compiler has none */
+#if defined ( __GNUC__ )
+#define PREFETCH(p) __builtin_prefetch ( (p) )
+#else
+#define PREFETCH(p) ( (void)0 )
+#endif
+
+/*
+  Subtree sizes for rank and select, kept only with JSW_RANK.
+  Without it these do nothing and the node has no count field
+*/
+#ifdef JSW_RANK
+#define COUNT(n)       ( (n) == NULL ? 0 : (n)->count )
+#define ADD_COUNT(n,d) ( (n)->count += (size_t)(d) )
+#define SET_COUNT(n,c) ( (n)->count = (c) )
+#define RECOUNT(n) \
+  ( (n)->count = 1 + COUNT ( (n)->link[0] ) + COUNT ( (n)->link[1] ) )
+#else
+#define RECOUNT(n)     ( (void)0 )
+#define ADD_COUNT(n,d) ( (void)0 )
+#define SET_COUNT(n,c) ( (void)0 )
+#endif
+
+/*
+  Hot path counters, kept only with JSW_STATS. Without it
+  these do nothing and the tree has no stats field
+*/
+#ifdef JSW_STATS
+#define STAT_ADD(t,f,n) ( (void)( (t)->stats.f += (unsigned long)(n) ) )
+#else
+#define STAT_ADD(t,f,n) ( (void)0 )
+#endif
+#define STAT(t,f) STAT_ADD ( t, f, 1 )
+#define CMP(t,a,b) ( STAT ( t, cmps ), (t)->cmp ( (a), (b) ) )
+
+/* All zero, for new trees and for builds without JSW_STATS */
+static const jsw_stats_t no_stats = { 0 };
 
 struct jsw_rbtree {
   jsw_rbnode_t *root; /* Top of the tree */
@@ -32,6 +75,12 @@ struct jsw_rbtree {
   dup_f         dup;  /* Clone an item (user-defined) */
   rel_f         rel;  /* Destroy an item (user-defined) */
   size_t        size; /* Number of items (user-defined) */
+  jsw_alloc_t   mem;  /* Node allocator */
+  int           intrusive; /* Nodes are embedded in the items */
+  size_t        offset;    /* Offset of the node in each item */
+#ifdef JSW_STATS
+  jsw_stats_t   stats;     /* Hot path counters */
+#endif
 };
 
 struct jsw_rbtrav {
@@ -71,6 +120,10 @@ static jsw_rbnode_t *jsw_single ( jsw_rbnode_t *root, int dir )
   root->link[!dir] = save->link[dir];
   save->link[dir] = root;
 
+  /* The subtree keeps its size, only root's changes */
+  SET_COUNT ( save, root->count );
+  RECOUNT ( root );
+
   root->red = 1;
   save->red = 0;
 
@@ -94,10 +147,48 @@ static jsw_rbnode_t *jsw_double ( jsw_rbnode_t *root, int dir )
   return jsw_single ( root, dir );
 }
 
+/**
+  <summary>
+  Default node allocator hooks, using malloc and free
+  <summary>
+  <remarks>For jsw_rbtree.c internal use only</remarks>
+*/
+static void *std_alloc ( void *ctx, size_t size )
+{
+  (void)ctx;
+  return malloc ( size );
+}
+
+static void std_release ( void *ctx, void *p, size_t size )
+{
+  (void)ctx;
+  (void)size;
+  free ( p );
+}
+
+/**
+  <summary>
+  Release hooks for intrusive trees, which never own memory
+  <summary>
+  <remarks>For jsw_rbtree.c internal use only</remarks>
+*/
+static void no_release ( void *ctx, void *p, size_t size )
+{
+  (void)ctx;
+  (void)p;
+  (void)size;
+}
+
+static void no_rel ( void *p )
+{
+  (void)p;
+}
+
 /**
   <summary>
   Creates an initializes a new red black node with a copy of
-  the data. This function does not insert the new node into a tree
+  the data. This function does not insert the new node into a tree.
+  Intrusive trees use the node embedded in the data instead
   <summary>
   <param name="tree">The red black tree this node is being created for</param>
   <param name="data">The data value that will be stored in this node</param>
@@ -105,19 +196,30 @@ static jsw_rbnode_t *jsw_double ( jsw_rbnode_t *root, int dir )
   <remarks>
   For jsw_rbtree.c internal use only. The data for this node must
   be freed using the same tree's rel function. The returned pointer
-  must be freed using C's free function
+  must be freed using the same tree's release hook
   </remarks>
 */
 static jsw_rbnode_t *new_node ( jsw_rbtree_t *tree, void *data )
 {
-  jsw_rbnode_t *rn = (jsw_rbnode_t *)malloc ( sizeof *rn );
+  jsw_rbnode_t *rn;
 
-  if ( rn == NULL )
-    return NULL;
+  if ( tree->intrusive ) {
+    rn = (jsw_rbnode_t *)( (char *)data + tree->offset );
+    rn->data = data;
+  }
+  else {
+    rn = (jsw_rbnode_t *)tree->mem.alloc ( tree->mem.ctx, sizeof *rn );
+
+    if ( rn == NULL )
+      return NULL;
+
+    STAT ( tree, allocs );
+    rn->data = tree->dup ( data );
+  }
 
   rn->red = 1;
-  rn->data = tree->dup ( data );
   rn->link[0] = rn->link[1] = NULL;
+  SET_COUNT ( rn, 1 );
 
   return rn;
 }
@@ -129,13 +231,37 @@ static jsw_rbnode_t *new_node ( jsw_rbtree_t *tree, void *data )
   <summary>
   <param name="cmp">User-defined data comparison function</param>
   <param name="dup">User-defined data copy function</param>
-  <param name="rel">User-defined data release function</param>
+  <param name="rel">
+  User-defined data release function, or NULL when the items
+  are owned elsewhere and must not be released
+  </param>
   <returns>A pointer to the new tree</returns>
   <remarks>
   The returned pointer must be released with jsw_rbdelete
   </remarks>
 */
 jsw_rbtree_t *jsw_rbnew ( cmp_f cmp, dup_f dup, rel_f rel )
+{
+  return jsw_rbnew_alloc ( cmp, dup, rel, NULL );
+}
+
+/**
+  <summary>
+  Creates and initializes an empty red black tree whose
+  nodes come from a user-defined allocator
+  <summary>
+  <param name="cmp">User-defined data comparison function</param>
+  <param name="dup">User-defined data copy function</param>
+  <param name="rel">User-defined data release function</param>
+  <param name="alloc">Node allocator hooks, or NULL for malloc</param>
+  <returns>A pointer to the new tree</returns>
+  <remarks>
+  The hooks are copied. The returned pointer must be
+  released with jsw_rbdelete
+  </remarks>
+*/
+jsw_rbtree_t *jsw_rbnew_alloc ( cmp_f cmp, dup_f dup, rel_f rel,
+                                const jsw_alloc_t *alloc )
 {
   jsw_rbtree_t *rt = (jsw_rbtree_t *)malloc ( sizeof *rt );
 
@@ -145,25 +271,80 @@ jsw_rbtree_t *jsw_rbnew ( cmp_f cmp, dup_f dup, rel_f rel )
   rt->root = NULL;
   rt->cmp = cmp;
   rt->dup = dup;
-  rt->rel = rel;
+  rt->rel = rel != NULL ? rel : no_rel;
   rt->size = 0;
+  rt->intrusive = 0;
+  rt->offset = 0;
+#ifdef JSW_STATS
+  rt->stats = no_stats;
+#endif
+
+  if ( alloc != NULL )
+    rt->mem = *alloc;
+  else {
+    rt->mem.alloc = std_alloc;
+    rt->mem.release = std_release;
+    rt->mem.purge = NULL;
+    rt->mem.ctx = NULL;
+  }
 
   return rt;
 }
 
 /**
   <summary>
-  Releases a valid red black tree
+  Creates and initializes an empty intrusive red black tree.
+  Each item embeds a jsw_rbnode_t at the given offset, which
+  the tree links directly, so nothing is copied or allocated
   <summary>
-  <param name="tree">The tree to release</param>
+  <param name="cmp">User-defined comparison of two items</param>
+  <param name="rel">
+  Called with an item when it leaves the tree, or NULL
+  </param>
+  <param name="offset">Offset of the embedded node in an item</param>
+  <returns>A pointer to the new tree</returns>
   <remarks>
-  The tree must have been created using jsw_rbnew
+  Insert, find and erase take and return items as usual.
+  An item must stay put (and out of other trees using the
+  same node) while it is linked. The returned pointer must
+  be released with jsw_rbdelete
   </remarks>
 */
-void jsw_rbdelete ( jsw_rbtree_t *tree )
+jsw_rbtree_t *jsw_rbnew_intrusive ( cmp_f cmp, rel_f rel, size_t offset )
+{
+  jsw_rbtree_t *rt = jsw_rbnew ( cmp, NULL, rel );
+
+  if ( rt == NULL )
+    return NULL;
+
+  rt->intrusive = 1;
+  rt->offset = offset;
+  rt->mem.release = no_release;
+
+  return rt;
+}
+
+/**
+  <summary>
+  Releases every node of a tree, leaving the root dangling
+  <summary>
+  <param name="tree">The tree to empty</param>
+  <remarks>
+  For jsw_rbtree.c internal use only. Nodes are only visited
+  when something has to happen to each one: an item to
+  release, or a node to give back without a purge hook. An
+  arena-backed tree of externally owned items (or an
+  intrusive one) is emptied without touching its nodes
+  </remarks>
+*/
+static void release_nodes ( jsw_rbtree_t *tree )
 {
   jsw_rbnode_t *it = tree->root;
   jsw_rbnode_t *save;
+  int each = tree->mem.purge == NULL && !tree->intrusive;
+
+  if ( tree->rel == no_rel && !each )
+    it = NULL;
 
   /*
     Rotate away the left links so that
@@ -175,7 +356,9 @@ void jsw_rbdelete ( jsw_rbtree_t *tree )
       /* No left links, just kill the node and move on */
       save = it->link[1];
       tree->rel ( it->data );
-      free ( it );
+
+      if ( each )
+        tree->mem.release ( tree->mem.ctx, it, sizeof *it );
     }
     else {
       /* Rotate away the left link and check again */
@@ -187,9 +370,45 @@ void jsw_rbdelete ( jsw_rbtree_t *tree )
     it = save;
   }
 
+  if ( tree->mem.purge != NULL )
+    tree->mem.purge ( tree->mem.ctx );
+}
+
+/**
+  <summary>
+  Releases a valid red black tree
+  <summary>
+  <param name="tree">The tree to release</param>
+  <remarks>
+  The tree must have been created using jsw_rbnew. With a
+  purge hook, nodes are released all at once by the allocator
+  </remarks>
+*/
+void jsw_rbdelete ( jsw_rbtree_t *tree )
+{
+  release_nodes ( tree );
   free ( tree );
 }
 
+/**
+  <summary>
+  Removes every item from a red black tree, keeping the
+  tree itself for reuse
+  <summary>
+  <param name="tree">The tree to empty</param>
+  <remarks>
+  Costs O(1) when the tree has a purge hook and its items
+  are owned elsewhere (rel was NULL). Traversers of the
+  tree are invalidated
+  </remarks>
+*/
+void jsw_rbclear ( jsw_rbtree_t *tree )
+{
+  release_nodes ( tree );
+  tree->root = NULL;
+  tree->size = 0;
+}
+
 /**
   <summary>
   Search for a copy of the specified
@@ -207,7 +426,7 @@ void *jsw_rbfind ( jsw_rbtree_t *tree, void *data )
   jsw_rbnode_t *it = tree->root;
 
   while ( it != NULL ) {
-    int cmp = tree->cmp ( it->data, data );
+    int cmp = CMP ( tree, it->data, data );
 
     if ( cmp == 0 )
       break;
@@ -222,6 +441,98 @@ void *jsw_rbfind ( jsw_rbtree_t *tree, void *data )
   return it == NULL ? NULL : it->data;
 }
 
+/**
+  <summary>
+  Search for several data values at once
+  <summary>
+  <param name="tree">The tree to search</param>
+  <param name="data">The data values to search for</param>
+  <param name="n">The number of data values</param>
+  <param name="out">
+  Receives the stored data value for each search,
+  or a null pointer if it could not be found
+  </param>
+  <returns>The number of data values found</returns>
+  <remarks>
+  Searches run in groups, one level at a time. Each step
+  prefetches the next node of every search in the group,
+  so their cache misses overlap instead of following one
+  after another
+  </remarks>
+*/
+size_t jsw_rbfind_many ( jsw_rbtree_t *tree, void **data, size_t n,
+                         void **out )
+{
+  jsw_rbnode_t *it[FIND_GROUP];
+  size_t found = 0;
+  size_t i, j, m, live;
+
+  for ( i = 0; i < n; i += m ) {
+    m = n - i < FIND_GROUP ? n - i : FIND_GROUP;
+    live = 0;
+
+    for ( j = 0; j < m; j++ ) {
+      out[i + j] = NULL;
+      it[j] = tree->root;
+      live += it[j] != NULL;
+    }
+
+    while ( live > 0 ) {
+      for ( j = 0; j < m; j++ ) {
+        int cmp;
+
+        if ( it[j] == NULL )
+          continue;
+
+        cmp = CMP ( tree, it[j]->data, data[i + j] );
+
+        if ( cmp == 0 ) {
+          out[i + j] = it[j]->data;
+          it[j] = NULL;
+          ++found;
+        }
+        else
+          it[j] = it[j]->link[cmp < 0];
+
+        if ( it[j] != NULL )
+          PREFETCH ( it[j] );
+        else
+          --live;
+      }
+    }
+  }
+
+  return found;
+}
+
+#ifdef JSW_RANK
+/**
+  <summary>
+  Takes back a count adjustment made along the search path for
+  data, down to the matching node or the bottom of the tree
+  <summary>
+  <param name="tree">The tree to fix</param>
+  <param name="data">The data value that was searched for</param>
+  <param name="d">The adjustment to add (the opposite of the original)</param>
+  <remarks>For jsw_rbtree.c internal use only</remarks>
+*/
+static void uncount ( jsw_rbtree_t *tree, void *data, size_t d )
+{
+  jsw_rbnode_t *it = tree->root;
+
+  while ( it != NULL ) {
+    int cmp = CMP ( tree, it->data, data );
+
+    it->count += d;
+
+    if ( cmp == 0 )
+      break;
+
+    it = it->link[cmp < 0];
+  }
+}
+#endif
+
 /**
   <summary>
   Insert a copy of the user-specified
@@ -233,6 +544,11 @@ void *jsw_rbfind ( jsw_rbtree_t *tree, void *data )
   1 if the value was inserted successfully,
   0 if the insertion failed for any reason
   </returns>
+  <remarks>
+  With JSW_RANK, every node on the way down counts the new
+  node early, so rotations can keep the counts exact. A
+  duplicate or failed allocation takes the counts back
+  </remarks>
 */
 int jsw_rbinsert ( jsw_rbtree_t *tree, void *data )
 {
@@ -250,12 +566,13 @@ int jsw_rbinsert ( jsw_rbtree_t *tree, void *data )
     jsw_rbnode_t head = {0}; /* False tree root */
     jsw_rbnode_t *g, *t;     /* Grandparent & parent */
     jsw_rbnode_t *p, *q;     /* Iterator & parent */
-    int dir = 0, last = 0;
+    int dir = 0, last = 0, cmp, added = 0;
 
     /* Set up our helpers */
     t = &head;
     g = p = NULL;
     q = t->link[1] = tree->root;
+    ADD_COUNT ( q, 1 );
 
     /* Search down the tree for a place to insert */
     for ( ; ; ) {
@@ -264,7 +581,9 @@ int jsw_rbinsert ( jsw_rbtree_t *tree, void *data )
         p->link[dir] = q = new_node ( tree, data );
 
         if ( q == NULL )
-          return 0;
+          break;
+
+        added = 1;
       }
       else if ( is_red ( q->link[0] ) && is_red ( q->link[1] ) ) {
         /* Simple red violation: color flip */
@@ -277,21 +596,27 @@ int jsw_rbinsert ( jsw_rbtree_t *tree, void *data )
         /* Hard red violation: rotations necessary */
         int dir2 = t->link[1] == g;
 
-        if ( q == p->link[last] )
+        if ( q == p->link[last] ) {
           t->link[dir2] = jsw_single ( g, !last );
-        else
+          STAT ( tree, rotations );
+        }
+        else {
           t->link[dir2] = jsw_double ( g, !last );
+          STAT_ADD ( tree, rotations, 2 );
+        }
       }
 
       /*
         Stop working if we inserted a node. This
         check also disallows duplicates in the tree
       */
-      if ( tree->cmp ( q->data, data ) == 0 )
+      cmp = CMP ( tree, q->data, data );
+
+      if ( cmp == 0 )
         break;
 
       last = dir;
-      dir = tree->cmp ( q->data, data ) < 0;
+      dir = cmp < 0;
 
       /* Move the helpers down */
       if ( g != NULL )
@@ -299,10 +624,22 @@ int jsw_rbinsert ( jsw_rbtree_t *tree, void *data )
 
       g = p, p = q;
       q = q->link[dir];
+
+      if ( q != NULL )
+        ADD_COUNT ( q, 1 );
     }
 
     /* Update the root (it may be different) */
     tree->root = head.link[1];
+
+    /* A duplicate was found or the allocation failed */
+    if ( !added ) {
+#ifdef JSW_RANK
+      uncount ( tree, data, (size_t)-1 );
+#endif
+      tree->root->red = 0;
+      return 0;
+    }
   }
 
   /* Make the root black for simplified logic */
@@ -334,6 +671,7 @@ int jsw_rberase ( jsw_rbtree_t *tree, void *data )
     jsw_rbnode_t head = {0}; /* False tree root */
     jsw_rbnode_t *q, *p, *g; /* Helpers */
     jsw_rbnode_t *f = NULL;  /* Found item */
+    jsw_rbnode_t *fp = NULL; /* Parent of the found item */
     int dir = 1;
 
     /* Set up our helpers */
@@ -351,19 +689,41 @@ int jsw_rberase ( jsw_rbtree_t *tree, void *data )
       /* Move the helpers down */
       g = p, p = q;
       q = q->link[dir];
-      dir = tree->cmp ( q->data, data ) < 0;
+      ADD_COUNT ( q, -1 );
 
       /*
         Save the node with matching data and keep
-        going; we'll do removal tasks at the end
+        going; we'll do removal tasks at the end.
+        Below it, everything on the path is smaller
       */
-      if ( tree->cmp ( q->data, data ) == 0 )
-        f = q;
+      if ( f != NULL )
+        dir = 1;
+      else {
+        int cmp = CMP ( tree, q->data, data );
+
+        dir = cmp < 0;
+
+        if ( cmp == 0 ) {
+          f = q;
+          fp = p;
+        }
+      }
 
-      /* Push the red node down with rotations and color flips */
+      /*
+        Push the red node down with rotations and color flips,
+        keeping track of the found node's parent as it moves
+      */
       if ( !is_red ( q ) && !is_red ( q->link[dir] ) ) {
-        if ( is_red ( q->link[!dir] ) )
+        if ( is_red ( q->link[!dir] ) ) {
           p = p->link[last] = jsw_single ( q, dir );
+          STAT ( tree, rotations );
+
+          /* q is still on the path, so it loses the node too */
+          ADD_COUNT ( q, -1 );
+
+          if ( q == f )
+            fp = p;
+        }
         else if ( !is_red ( q->link[!dir] ) ) {
           jsw_rbnode_t *s = p->link[!last];
 
@@ -377,10 +737,17 @@ int jsw_rberase ( jsw_rbtree_t *tree, void *data )
             else {
               int dir2 = g->link[1] == p;
 
-              if ( is_red ( s->link[last] ) )
+              if ( is_red ( s->link[last] ) ) {
                 g->link[dir2] = jsw_double ( p, last );
-              else if ( is_red ( s->link[!last] ) )
+                STAT_ADD ( tree, rotations, 2 );
+              }
+              else if ( is_red ( s->link[!last] ) ) {
                 g->link[dir2] = jsw_single ( p, last );
+                STAT ( tree, rotations );
+              }
+
+              if ( p == f )
+                fp = g->link[dir2];
 
               /* Ensure correct coloring */
               q->red = g->link[dir2]->red = 1;
@@ -392,13 +759,26 @@ int jsw_rberase ( jsw_rbtree_t *tree, void *data )
       }
     }
 
-    /* Replace and remove the saved node */
+    /*
+      Unlink q, then move it into the saved node's place.
+      Relinking instead of swapping data keeps intrusive
+      nodes attached to their own items
+    */
     if ( f != NULL ) {
-      tree->rel ( f->data );
-      f->data = q->data;
       p->link[p->link[1] == q] =
         q->link[q->link[0] == NULL];
-      free ( q );
+
+      if ( q != f ) {
+        SET_COUNT ( q, f->count );
+        q->red = f->red;
+        q->link[0] = f->link[0];
+        q->link[1] = f->link[1];
+        fp->link[fp->link[1] == f] = q;
+      }
+
+      tree->rel ( f->data );
+      tree->mem.release ( tree->mem.ctx, f, sizeof *f );
+      STAT_ADD ( tree, releases, !tree->intrusive );
     }
 
     /* Update the root (it may be different) */
@@ -408,10 +788,40 @@ int jsw_rberase ( jsw_rbtree_t *tree, void *data )
     if ( tree->root != NULL )
       tree->root->red = 0;
 
+    /* The tree was still rebalanced, but nothing was removed */
+    if ( f == NULL ) {
+#ifdef JSW_RANK
+      uncount ( tree, data, 1 );
+#endif
+      return 0;
+    }
+
     --tree->size;
+
+    return 1;
   }
 
+  return 0;
+}
+
+/**
+  <summary>
+  Reads the hot path counters of a red black tree
+  <summary>
+  <param name="tree">The tree to read counters from</param>
+  <param name="stats">Receives the counters, all zero without JSW_STATS</param>
+  <returns>1 if the counters are compiled in, 0 otherwise</returns>
+*/
+int jsw_rbstats ( jsw_rbtree_t *tree, jsw_stats_t *stats )
+{
+#ifdef JSW_STATS
+  *stats = tree->stats;
   return 1;
+#else
+  (void)tree;
+  *stats = no_stats;
+  return 0;
+#endif
 }
 
 /**
@@ -426,60 +836,987 @@ size_t jsw_rbsize ( jsw_rbtree_t *tree )
   return tree->size;
 }
 
+#ifdef JSW_RANK
 /**
   <summary>
-  Create a new traversal object
+  Finds the k-th smallest item in a red black tree
   <summary>
-  <returns>A pointer to the new object</returns>
-  <remarks>
-  The traversal object is not initialized until
-  jsw_rbtfirst or jsw_rbtlast are called.
-  The pointer must be released with jsw_rbtdelete
-  </remarks>
+  <param name="tree">The tree to search</param>
+  <param name="k">The zero-based position of the item</param>
+  <returns>
+  A pointer to the data value at position k,
+  or a null pointer if k isn't less than the size
+  </returns>
 */
-jsw_rbtrav_t *jsw_rbtnew ( void )
+void *jsw_rbselect ( jsw_rbtree_t *tree, size_t k )
 {
-  return (jsw_rbtrav_t*)malloc ( sizeof ( jsw_rbtrav_t ) );
+  jsw_rbnode_t *it = tree->root;
+
+  while ( it != NULL ) {
+    size_t left = COUNT ( it->link[0] );
+
+    if ( k == left )
+      return it->data;
+
+    if ( k < left )
+      it = it->link[0];
+    else {
+      k -= left + 1;
+      it = it->link[1];
+    }
+  }
+
+  return NULL;
 }
 
 /**
   <summary>
-  Release a traversal object
+  Counts the items in a red black tree that
+  are smaller than the user-specified data
   <summary>
-  <param name="trav">The object to release</param>
-  <remarks>
-  The object must have been created with jsw_rbtnew
-  </remarks>
+  <param name="tree">The tree to search</param>
+  <param name="data">The data value to search for</param>
+  <returns>
+  The number of smaller items, which is the position of
+  data if it's in the tree and the position it would
+  take otherwise
+  </returns>
 */
-void jsw_rbtdelete ( jsw_rbtrav_t *trav )
+size_t jsw_rbrank ( jsw_rbtree_t *tree, void *data )
 {
-  free ( trav );
+  jsw_rbnode_t *it = tree->root;
+  size_t rank = 0;
+
+  while ( it != NULL ) {
+    int cmp = CMP ( tree, it->data, data );
+
+    if ( cmp == 0 )
+      return rank + COUNT ( it->link[0] );
+
+    if ( cmp < 0 ) {
+      rank += COUNT ( it->link[0] ) + 1;
+      it = it->link[1];
+    }
+    else
+      it = it->link[0];
+  }
+
+  return rank;
 }
+#endif
 
 /**
   <summary>
-  Initialize a traversal object. The user-specified
-  direction determines whether to begin traversal at the
-  smallest or largest valued node
+  Releases a subtree built by build_tree. Recursion is
+  safe because built subtrees are perfectly balanced
   <summary>
-  <param name="trav">The traversal object to initialize</param>
-  <param name="tree">The tree that the object will be attached to</param>
-  <param name="dir">
-  The direction to traverse (0 = ascending, 1 = descending)
-  </param>
-  <returns>A pointer to the smallest or largest data value</returns>
+  <param name="tree">The tree the nodes belong to</param>
+  <param name="root">The subtree to release</param>
   <remarks>For jsw_rbtree.c internal use only</remarks>
 */
-static void *start ( jsw_rbtrav_t *trav, jsw_rbtree_t *tree, int dir )
+static void release_tree ( jsw_rbtree_t *tree, jsw_rbnode_t *root )
 {
-  trav->tree = tree;
-  trav->it = tree->root;
-  trav->top = 0;
+  if ( root != NULL ) {
+    release_tree ( tree, root->link[0] );
+    release_tree ( tree, root->link[1] );
+    tree->rel ( root->data );
+    tree->mem.release ( tree->mem.ctx, root, sizeof *root );
+  }
+}
 
-  /* Save the path for later traversal */
-  if ( trav->it != NULL ) {
-    while ( trav->it->link[dir] != NULL ) {
-      trav->path[trav->top++] = trav->it;
+/**
+  <summary>
+  Builds a perfectly balanced subtree from a sorted array
+  <summary>
+  <param name="tree">The tree the nodes are being built for</param>
+  <param name="items">Sorted data values for the subtree</param>
+  <param name="n">The number of values, at least 1</param>
+  <param name="depth">The depth of the subtree's root</param>
+  <param name="red">The depth at which nodes are red</param>
+  <returns>The subtree, or NULL if an allocation failed</returns>
+  <remarks>
+  For jsw_rbtree.c internal use only. Splitting at the lower
+  middle leaves every missing leaf on the deepest level, so
+  coloring just that level red keeps all black heights equal
+  </remarks>
+*/
+static jsw_rbnode_t *build_tree ( jsw_rbtree_t *tree, void **items,
+                                  size_t n, size_t depth, size_t red )
+{
+  size_t mid = ( n - 1 ) / 2;
+  jsw_rbnode_t *rn = new_node ( tree, items[mid] );
+
+  if ( rn == NULL )
+    return NULL;
+
+  rn->red = depth == red;
+
+  if ( mid > 0 ) {
+    rn->link[0] = build_tree ( tree, items, mid, depth + 1, red );
+
+    if ( rn->link[0] == NULL ) {
+      release_tree ( tree, rn );
+      return NULL;
+    }
+  }
+
+  if ( n - mid > 1 ) {
+    rn->link[1] = build_tree ( tree, items + mid + 1, n - mid - 1,
+      depth + 1, red );
+
+    if ( rn->link[1] == NULL ) {
+      release_tree ( tree, rn );
+      return NULL;
+    }
+  }
+
+  RECOUNT ( rn );
+
+  return rn;
+}
+
+/**
+  <summary>
+  Fills an empty red black tree with copies of sorted data in
+  linear time, without comparisons or rebalancing
+  <summary>
+  <param name="tree">The empty tree to fill</param>
+  <param name="items">Data values in strictly increasing order</param>
+  <param name="n">The number of data values</param>
+  <returns>
+  1 if the tree was built successfully, 0 if the tree
+  wasn't empty, the data was out of order, or an allocation
+  failed. The tree is unchanged on failure
+  </returns>
+  <remarks>
+  Nodes are allocated in preorder, so a pool allocator
+  lays each subtree out contiguously
+  </remarks>
+*/
+int jsw_rbbuild ( jsw_rbtree_t *tree, void **items, size_t n )
+{
+  size_t i, red = 0;
+
+  if ( tree->root != NULL )
+    return 0;
+
+  for ( i = 1; i < n; i++ ) {
+    if ( CMP ( tree, items[i - 1], items[i] ) >= 0 )
+      return 0;
+  }
+
+  if ( n == 0 )
+    return 1;
+
+  /* floor(log2(n + 1)) is one past the last full level */
+  for ( i = n + 1; i > 1; i >>= 1 )
+    ++red;
+
+  tree->root = build_tree ( tree, items, n, 0, red );
+
+  if ( tree->root == NULL )
+    return 0;
+
+  tree->size = n;
+
+  return 1;
+}
+
+/*
+  Set operations, built on join: joining two trees around a
+  key costs O(|bh(l) - bh(r)|), so splitting costs O(log n)
+  and union, intersection and difference of trees of sizes
+  m <= n cost O(m log(n/m + 1)). Black heights (black nodes
+  from a subtree's root down to a leaf, counting the root)
+  are tracked on the way down instead of stored
+*/
+
+/* Set operation kinds */
+#define SET_UNION      0
+#define SET_INTERSECT  1
+#define SET_DIFFERENCE 2
+
+/**
+  <summary>
+  State for one subproblem of a set operation
+  <summary>
+  <remarks>
+  For jsw_rbtree.c internal use only. Each task of a parallel
+  run has its own, so tasks share nothing but the comparison
+  function and the fork hook. Nodes leaving either tree are
+  collected rather than released, because the allocator
+  might not be thread safe
+  </remarks>
+*/
+typedef struct jsw_rbset {
+  cmp_f             cmp;       /* Compare two items */
+  const jsw_fork_t *fork;      /* Fork-join hook, or NULL */
+  int               depth;     /* Levels left to fork */
+  int               kind;      /* SET_UNION, SET_INTERSECT or SET_DIFFERENCE */
+  jsw_rbnode_t     *in[2];     /* Subtrees of the first and second trees */
+  int               inbh[2];   /* Their black heights */
+  jsw_rbnode_t     *out;       /* The result */
+  int               outbh;     /* Its black height */
+  size_t            matches;   /* Items found in both subtrees */
+  jsw_rbnode_t     *drop[2];   /* Nodes leaving each tree, linked by link[0] */
+  jsw_rbnode_t     *last[2];   /* Tails of the drop lists */
+  unsigned long     cmps;      /* Comparisons made */
+  unsigned long     rotations; /* Rotations made */
+} jsw_rbset_t;
+
+/**
+  <summary>
+  Prepares set operation state with nothing done yet
+  <summary>
+  <param name="set">The state to prepare</param>
+  <param name="cmp">The comparison function to split with</param>
+  <param name="fork">The fork-join hook, or NULL</param>
+  <param name="kind">The set operation to run</param>
+  <remarks>For jsw_rbtree.c internal use only</remarks>
+*/
+static void set_init ( jsw_rbset_t *set, cmp_f cmp,
+                       const jsw_fork_t *fork, int kind )
+{
+  set->cmp = cmp;
+  set->fork = fork;
+  set->depth = fork != NULL ? fork->depth : 0;
+  set->kind = kind;
+  set->in[0] = set->in[1] = NULL;
+  set->inbh[0] = set->inbh[1] = 0;
+  set->out = NULL;
+  set->outbh = 0;
+  set->matches = 0;
+  set->drop[0] = set->drop[1] = NULL;
+  set->last[0] = set->last[1] = NULL;
+  set->cmps = 0;
+  set->rotations = 0;
+}
+
+/**
+  <summary>
+  Counts the black nodes on the leftmost path of a subtree
+  <summary>
+  <param name="root">The subtree to measure</param>
+  <returns>The black height of the subtree</returns>
+  <remarks>For jsw_rbtree.c internal use only</remarks>
+*/
+static int black_height ( jsw_rbnode_t *root )
+{
+  int bh = 0;
+
+  for ( ; root != NULL; root = root->link[0] )
+    bh += !root->red;
+
+  return bh;
+}
+
+/**
+  <summary>
+  Joins a key and a shorter subtree onto one side of a
+  taller subtree, walking down that side until the black
+  heights match
+  <summary>
+  <param name="set">The set operation doing the join</param>
+  <param name="root">The taller subtree</param>
+  <param name="bh">The black height of root</param>
+  <param name="key">The node to join with</param>
+  <param name="s">The shorter subtree, with a black root</param>
+  <param name="sbh">The black height of s</param>
+  <param name="dir">The side s goes on (0 = left, 1 = right)</param>
+  <returns>The joined subtree, with root's black height</returns>
+  <remarks>
+  For jsw_rbtree.c internal use only. A red node may come
+  back with a red child on the dir side, which its black
+  parent fixes by rotation. Below a black root, the result
+  is a valid red black tree
+  </remarks>
+*/
+static jsw_rbnode_t *join_side ( jsw_rbset_t *set, jsw_rbnode_t *root,
+                                 int bh, jsw_rbnode_t *key,
+                                 jsw_rbnode_t *s, int sbh, int dir )
+{
+  jsw_rbnode_t *save;
+
+  if ( !is_red ( root ) && bh == sbh ) {
+    key->link[!dir] = root;
+    key->link[dir] = s;
+    key->red = 1;
+    RECOUNT ( key );
+
+    return key;
+  }
+
+  root->link[dir] = join_side ( set, root->link[dir], bh - !root->red,
+    key, s, sbh, dir );
+  save = root->link[dir];
+
+  if ( !root->red && is_red ( save ) && is_red ( save->link[dir] ) ) {
+    /* Two reds in a row: blacken the lower one and rotate */
+    save->link[dir]->red = 0;
+    root->link[dir] = save->link[!dir];
+    save->link[!dir] = root;
+    RECOUNT ( root );
+    RECOUNT ( save );
+    ++set->rotations;
+
+    return save;
+  }
+
+  RECOUNT ( root );
+
+  return root;
+}
+
+/**
+  <summary>
+  Joins two subtrees around a key that sorts between them
+  <summary>
+  <param name="set">The set operation doing the join</param>
+  <param name="l">The subtree of smaller items</param>
+  <param name="lbh">The black height of l</param>
+  <param name="key">The node to join with</param>
+  <param name="r">The subtree of larger items</param>
+  <param name="rbh">The black height of r</param>
+  <param name="bh">Receives the black height of the result</param>
+  <returns>The joined subtree, whose root may be red</returns>
+  <remarks>
+  For jsw_rbtree.c internal use only. Blackening both
+  roots first keeps the key from landing next to a red one
+  </remarks>
+*/
+static jsw_rbnode_t *join ( jsw_rbset_t *set, jsw_rbnode_t *l, int lbh,
+                            jsw_rbnode_t *key, jsw_rbnode_t *r, int rbh,
+                            int *bh )
+{
+  if ( is_red ( l ) ) {
+    l->red = 0;
+    ++lbh;
+  }
+
+  if ( is_red ( r ) ) {
+    r->red = 0;
+    ++rbh;
+  }
+
+  if ( lbh > rbh ) {
+    *bh = lbh;
+    return join_side ( set, l, lbh, key, r, rbh, 1 );
+  }
+
+  if ( rbh > lbh ) {
+    *bh = rbh;
+    return join_side ( set, r, rbh, key, l, lbh, 0 );
+  }
+
+  key->link[0] = l;
+  key->link[1] = r;
+  key->red = 1;
+  RECOUNT ( key );
+  *bh = lbh;
+
+  return key;
+}
+
+/**
+  <summary>
+  Removes the last node of a subtree
+  <summary>
+  <param name="set">The set operation doing the removal</param>
+  <param name="root">The subtree, which must not be empty</param>
+  <param name="bh">The black height of root</param>
+  <param name="last">Receives the removed node</param>
+  <param name="restbh">Receives the black height of the rest</param>
+  <returns>The rest of the subtree</returns>
+  <remarks>For jsw_rbtree.c internal use only</remarks>
+*/
+static jsw_rbnode_t *split_last ( jsw_rbset_t *set, jsw_rbnode_t *root,
+                                  int bh, jsw_rbnode_t **last,
+                                  int *restbh )
+{
+  jsw_rbnode_t *rest;
+  int cbh = bh - !root->red;
+
+  if ( root->link[1] == NULL ) {
+    *last = root;
+    *restbh = cbh;
+
+    return root->link[0];
+  }
+
+  rest = split_last ( set, root->link[1], cbh, last, restbh );
+
+  return join ( set, root->link[0], cbh, root, rest, *restbh, restbh );
+}
+
+/**
+  <summary>
+  Joins two subtrees, every item of l sorting before r
+  <summary>
+  <param name="set">The set operation doing the join</param>
+  <param name="l">The subtree of smaller items</param>
+  <param name="lbh">The black height of l</param>
+  <param name="r">The subtree of larger items</param>
+  <param name="rbh">The black height of r</param>
+  <param name="bh">Receives the black height of the result</param>
+  <returns>The joined subtree</returns>
+  <remarks>For jsw_rbtree.c internal use only</remarks>
+*/
+static jsw_rbnode_t *join2 ( jsw_rbset_t *set, jsw_rbnode_t *l, int lbh,
+                             jsw_rbnode_t *r, int rbh, int *bh )
+{
+  jsw_rbnode_t *key;
+
+  if ( l == NULL ) {
+    *bh = rbh;
+    return r;
+  }
+
+  l = split_last ( set, l, lbh, &key, &lbh );
+
+  return join ( set, l, lbh, key, r, rbh, bh );
+}
+
+/**
+  <summary>
+  Splits a subtree around a key
+  <summary>
+  <param name="set">The set operation doing the split</param>
+  <param name="root">The subtree to split</param>
+  <param name="bh">The black height of root</param>
+  <param name="data">The key to split around</param>
+  <param name="l">Receives the items less than data</param>
+  <param name="lbh">Receives the black height of l</param>
+  <param name="r">Receives the items greater than data</param>
+  <param name="rbh">Receives the black height of r</param>
+  <returns>The node matching data, or NULL if there is none</returns>
+  <remarks>For jsw_rbtree.c internal use only</remarks>
+*/
+static jsw_rbnode_t *split ( jsw_rbset_t *set, jsw_rbnode_t *root, int bh,
+                             void *data, jsw_rbnode_t **l, int *lbh,
+                             jsw_rbnode_t **r, int *rbh )
+{
+  jsw_rbnode_t *found, *sub;
+  int cmp, cbh, subbh;
+
+  if ( root == NULL ) {
+    *l = *r = NULL;
+    *lbh = *rbh = 0;
+
+    return NULL;
+  }
+
+  cbh = bh - !root->red;
+  ++set->cmps;
+  cmp = set->cmp ( root->data, data );
+
+  if ( cmp == 0 ) {
+    *l = root->link[0];
+    *r = root->link[1];
+    *lbh = *rbh = cbh;
+
+    return root;
+  }
+
+  if ( cmp < 0 ) {
+    found = split ( set, root->link[1], cbh, data, &sub, &subbh, r, rbh );
+    *l = join ( set, root->link[0], cbh, root, sub, subbh, lbh );
+  }
+  else {
+    found = split ( set, root->link[0], cbh, data, l, lbh, &sub, &subbh );
+    *r = join ( set, sub, subbh, root, root->link[1], cbh, rbh );
+  }
+
+  return found;
+}
+
+/**
+  <summary>
+  Adds a node to the drop list of one tree
+  <summary>
+  <param name="set">The set operation dropping the node</param>
+  <param name="side">The tree the node came from (0 or 1)</param>
+  <param name="node">The node to drop</param>
+  <remarks>For jsw_rbtree.c internal use only</remarks>
+*/
+static void drop ( jsw_rbset_t *set, int side, jsw_rbnode_t *node )
+{
+  node->link[0] = NULL;
+
+  if ( set->drop[side] == NULL )
+    set->drop[side] = node;
+  else
+    set->last[side]->link[0] = node;
+
+  set->last[side] = node;
+}
+
+/**
+  <summary>
+  Adds every node of a subtree to the drop list of one tree
+  <summary>
+  <param name="set">The set operation dropping the nodes</param>
+  <param name="side">The tree the nodes came from (0 or 1)</param>
+  <param name="root">The subtree to drop</param>
+  <remarks>For jsw_rbtree.c internal use only</remarks>
+*/
+static void drop_tree ( jsw_rbset_t *set, int side, jsw_rbnode_t *root )
+{
+  if ( root != NULL ) {
+    jsw_rbnode_t *r = root->link[1];
+
+    drop_tree ( set, side, root->link[0] );
+    drop ( set, side, root );
+    drop_tree ( set, side, r );
+  }
+}
+
+/**
+  <summary>
+  Runs one subproblem of a set operation
+  <summary>
+  <param name="arg">The jsw_rbset_t to run</param>
+  <remarks>
+  For jsw_rbtree.c internal use only. The root of one input
+  splits the other, and the two halves run as tasks of their
+  own (in parallel while forking levels are left) before
+  being joined back around that root, or without it
+  </remarks>
+*/
+static void set_task ( void *arg )
+{
+  jsw_rbset_t *set = (jsw_rbset_t *)arg;
+  jsw_rbset_t sub[2];
+  jsw_rbnode_t *key, *found, *half[2];
+  int halfbh[2];
+  int pivot, keybh, i;
+
+  if ( set->in[0] == NULL || set->in[1] == NULL ) {
+    /* What is left of an input stays or goes whole */
+    for ( i = 0; i < 2; i++ ) {
+      if ( set->in[i] == NULL )
+        continue;
+
+      if ( set->kind == SET_UNION
+        || ( set->kind == SET_DIFFERENCE && i == 0 ) )
+      {
+        set->out = set->in[i];
+        set->outbh = set->inbh[i];
+      }
+      else
+        drop_tree ( set, i, set->in[i] );
+    }
+
+    return;
+  }
+
+  /* A difference keeps what the second tree's keys don't split off */
+  pivot = set->kind == SET_DIFFERENCE;
+  key = set->in[pivot];
+  keybh = set->inbh[pivot] - !key->red;
+  found = split ( set, set->in[!pivot], set->inbh[!pivot], key->data,
+    &half[0], &halfbh[0], &half[1], &halfbh[1] );
+
+  for ( i = 0; i < 2; i++ ) {
+    set_init ( &sub[i], set->cmp, set->fork, set->kind );
+    sub[i].depth = set->depth - 1;
+    sub[i].in[pivot] = key->link[i];
+    sub[i].inbh[pivot] = keybh;
+    sub[i].in[!pivot] = half[i];
+    sub[i].inbh[!pivot] = halfbh[i];
+  }
+
+  if ( set->depth > 0 )
+    set->fork->fork ( set->fork->ctx, set_task, &sub[0], &sub[1] );
+  else {
+    set_task ( &sub[0] );
+    set_task ( &sub[1] );
+  }
+
+  /* Take over what the halves did */
+  for ( i = 0; i < 2; i++ ) {
+    int side;
+
+    for ( side = 0; side < 2; side++ ) {
+      if ( sub[i].drop[side] == NULL )
+        continue;
+
+      if ( set->drop[side] == NULL )
+        set->drop[side] = sub[i].drop[side];
+      else
+        set->last[side]->link[0] = sub[i].drop[side];
+
+      set->last[side] = sub[i].last[side];
+    }
+
+    set->matches += sub[i].matches;
+    set->cmps += sub[i].cmps;
+    set->rotations += sub[i].rotations;
+  }
+
+  if ( found != NULL ) {
+    ++set->matches;
+    drop ( set, !pivot, found );
+  }
+
+  if ( set->kind == SET_UNION
+    || ( set->kind == SET_INTERSECT && found != NULL ) )
+  {
+    set->out = join ( set, sub[0].out, sub[0].outbh, key,
+      sub[1].out, sub[1].outbh, &set->outbh );
+  }
+  else {
+    drop ( set, pivot, key );
+    set->out = join2 ( set, sub[0].out, sub[0].outbh,
+      sub[1].out, sub[1].outbh, &set->outbh );
+  }
+}
+
+/**
+  <summary>
+  Checks that nodes can move between two trees
+  <summary>
+  <param name="a">The first tree</param>
+  <param name="b">The second tree</param>
+  <returns>1 if the trees are distinct and share node handling</returns>
+  <remarks>
+  For jsw_rbtree.c internal use only. A purge hook is never
+  shared: deleting either tree would purge the allocator
+  under the nodes the other one holds
+  </remarks>
+*/
+static int compatible ( jsw_rbtree_t *a, jsw_rbtree_t *b )
+{
+  return a != b && a->intrusive == b->intrusive && a->offset == b->offset
+    && a->mem.alloc == b->mem.alloc && a->mem.release == b->mem.release
+    && a->mem.purge == NULL && b->mem.purge == NULL
+    && a->mem.ctx == b->mem.ctx;
+}
+
+/**
+  <summary>
+  Releases the nodes on a drop list, and their items
+  <summary>
+  <param name="tree">The tree the nodes came from</param>
+  <param name="it">The first node on the list</param>
+  <remarks>For jsw_rbtree.c internal use only</remarks>
+*/
+static void release_list ( jsw_rbtree_t *tree, jsw_rbnode_t *it )
+{
+  while ( it != NULL ) {
+    /* The item may hold the node */
+    jsw_rbnode_t *save = it->link[0];
+
+    tree->rel ( it->data );
+    tree->mem.release ( tree->mem.ctx, it, sizeof *it );
+    STAT_ADD ( tree, releases, !tree->intrusive );
+    it = save;
+  }
+}
+
+/**
+  <summary>
+  Counts the nodes of a subtree
+  <summary>
+  <param name="root">The subtree to count</param>
+  <returns>The number of nodes in root</returns>
+  <remarks>
+  For jsw_rbtree.c internal use only. Linear unless JSW_RANK
+  keeps the counts
+  </remarks>
+*/
+static size_t count_nodes ( jsw_rbnode_t *root )
+{
+#ifdef JSW_RANK
+  return COUNT ( root );
+#else
+  if ( root == NULL )
+    return 0;
+
+  return 1 + count_nodes ( root->link[0] ) + count_nodes ( root->link[1] );
+#endif
+}
+
+/**
+  <summary>
+  Runs a set operation on two trees, leaving the result in
+  the first and the second empty
+  <summary>
+  <param name="a">The first tree, which receives the result</param>
+  <param name="b">The second tree</param>
+  <param name="fork">The fork-join hook, or NULL</param>
+  <param name="kind">The set operation to run</param>
+  <returns>1 on success, 0 if the trees are incompatible</returns>
+  <remarks>For jsw_rbtree.c internal use only</remarks>
+*/
+static int set_op ( jsw_rbtree_t *a, jsw_rbtree_t *b,
+                    const jsw_fork_t *fork, int kind )
+{
+  jsw_rbset_t set;
+
+  if ( !compatible ( a, b ) )
+    return 0;
+
+  set_init ( &set, a->cmp, fork, kind );
+  set.in[0] = a->root;
+  set.inbh[0] = black_height ( a->root );
+  set.in[1] = b->root;
+  set.inbh[1] = black_height ( b->root );
+
+  set_task ( &set );
+
+  a->root = set.out;
+
+  if ( a->root != NULL )
+    a->root->red = 0;
+
+  if ( kind == SET_UNION )
+    a->size += b->size - set.matches;
+  else if ( kind == SET_INTERSECT )
+    a->size = set.matches;
+  else
+    a->size -= set.matches;
+
+  b->root = NULL;
+  b->size = 0;
+
+  STAT_ADD ( a, cmps, set.cmps );
+  STAT_ADD ( a, rotations, set.rotations );
+  release_list ( a, set.drop[0] );
+  release_list ( b, set.drop[1] );
+
+  return 1;
+}
+
+/**
+  <summary>
+  Moves every item of one tree into another, when all of
+  them sort after the items already there
+  <summary>
+  <param name="a">The tree to join onto</param>
+  <param name="b">The tree of larger items, left empty</param>
+  <returns>
+  1 on success, 0 if the trees are incompatible or the
+  items overlap. Neither tree changes on failure
+  </returns>
+  <remarks>
+  Costs O(log n). The trees are compatible when they were
+  created the same way (both intrusive with the same offset,
+  or both with the same allocator and no purge hook).
+  Traversers of either tree are invalidated
+  </remarks>
+*/
+int jsw_rbjoin ( jsw_rbtree_t *a, jsw_rbtree_t *b )
+{
+  jsw_rbnode_t *hi, *lo;
+  jsw_rbset_t set;
+  int bh;
+
+  if ( !compatible ( a, b ) )
+    return 0;
+
+  if ( a->root != NULL && b->root != NULL ) {
+    for ( hi = a->root; hi->link[1] != NULL; hi = hi->link[1] )
+      ;
+
+    for ( lo = b->root; lo->link[0] != NULL; lo = lo->link[0] )
+      ;
+
+    if ( CMP ( a, hi->data, lo->data ) >= 0 )
+      return 0;
+  }
+
+  set_init ( &set, a->cmp, NULL, SET_UNION );
+  a->root = join2 ( &set, a->root, black_height ( a->root ),
+    b->root, black_height ( b->root ), &bh );
+
+  if ( a->root != NULL )
+    a->root->red = 0;
+
+  a->size += b->size;
+  b->root = NULL;
+  b->size = 0;
+  STAT_ADD ( a, rotations, set.rotations );
+
+  return 1;
+}
+
+/**
+  <summary>
+  Moves the items of a tree from a key upward into another
+  <summary>
+  <param name="tree">The tree to split, which keeps smaller items</param>
+  <param name="data">The key to split at</param>
+  <param name="right">
+  An empty tree that receives the items not less than data
+  </param>
+  <returns>
+  1 on success, 0 if right isn't empty or the trees are
+  incompatible. Neither tree changes on failure
+  </returns>
+  <remarks>
+  Costs O(log n) with JSW_RANK. Without it the items that
+  move are also counted, to keep both sizes. Traversers of
+  either tree are invalidated
+  </remarks>
+*/
+int jsw_rbsplit ( jsw_rbtree_t *tree, void *data, jsw_rbtree_t *right )
+{
+  jsw_rbnode_t *found, *l, *r;
+  jsw_rbset_t set;
+  int lbh, rbh;
+  size_t n;
+
+  if ( right->root != NULL || !compatible ( tree, right ) )
+    return 0;
+
+  set_init ( &set, tree->cmp, NULL, SET_UNION );
+  found = split ( &set, tree->root, black_height ( tree->root ), data,
+    &l, &lbh, &r, &rbh );
+
+  /* A matching item goes right, in front of the others */
+  if ( found != NULL )
+    r = join ( &set, NULL, 0, found, r, rbh, &rbh );
+
+  tree->root = l;
+  right->root = r;
+
+  if ( l != NULL )
+    l->red = 0;
+
+  if ( r != NULL )
+    r->red = 0;
+
+  n = count_nodes ( r );
+  tree->size -= n;
+  right->size = n;
+  STAT_ADD ( tree, cmps, set.cmps );
+  STAT_ADD ( tree, rotations, set.rotations );
+
+  return 1;
+}
+
+/**
+  <summary>
+  Merges every item of one tree into another
+  <summary>
+  <param name="a">The tree that receives the union</param>
+  <param name="b">The other tree, left empty</param>
+  <param name="fork">A fork-join hook, or NULL to run serially</param>
+  <returns>
+  1 on success, 0 if the trees are incompatible (see
+  jsw_rbjoin). Neither tree changes on failure
+  </returns>
+  <remarks>
+  Costs O(m log(n/m + 1)) for trees of sizes m and n, m <= n.
+  An item in both trees keeps a's copy, b's is released.
+  With a fork hook cmp has to be thread safe, though items
+  and nodes are only released once the tasks are done
+  </remarks>
+*/
+int jsw_rbunion ( jsw_rbtree_t *a, jsw_rbtree_t *b,
+                  const jsw_fork_t *fork )
+{
+  return set_op ( a, b, fork, SET_UNION );
+}
+
+/**
+  <summary>
+  Removes the items of a tree that aren't in another
+  <summary>
+  <param name="a">The tree that receives the intersection</param>
+  <param name="b">The other tree, left empty</param>
+  <param name="fork">A fork-join hook, or NULL to run serially</param>
+  <returns>
+  1 on success, 0 if the trees are incompatible (see
+  jsw_rbjoin). Neither tree changes on failure
+  </returns>
+  <remarks>
+  Costs O(m log(n/m + 1)) like jsw_rbunion. An item in both
+  trees keeps a's copy, and everything else is released
+  </remarks>
+*/
+int jsw_rbintersect ( jsw_rbtree_t *a, jsw_rbtree_t *b,
+                      const jsw_fork_t *fork )
+{
+  return set_op ( a, b, fork, SET_INTERSECT );
+}
+
+/**
+  <summary>
+  Removes the items of a tree that are in another
+  <summary>
+  <param name="a">The tree that receives the difference</param>
+  <param name="b">The items to remove, left empty</param>
+  <param name="fork">A fork-join hook, or NULL to run serially</param>
+  <returns>
+  1 on success, 0 if the trees are incompatible (see
+  jsw_rbjoin). Neither tree changes on failure
+  </returns>
+  <remarks>
+  Costs O(m log(n/m + 1)) like jsw_rbunion. Every item of b
+  is released, along with the items of a that it matched
+  </remarks>
+*/
+int jsw_rbdifference ( jsw_rbtree_t *a, jsw_rbtree_t *b,
+                       const jsw_fork_t *fork )
+{
+  return set_op ( a, b, fork, SET_DIFFERENCE );
+}
+
+/**
+  <summary>
+  Create a new traversal object
+  <summary>
+  <returns>A pointer to the new object</returns>
+  <remarks>
+  The traversal object is not initialized until
+  jsw_rbtfirst or jsw_rbtlast are called.
+  The pointer must be released with jsw_rbtdelete
+  </remarks>
+*/
+jsw_rbtrav_t *jsw_rbtnew ( void )
+{
+  return (jsw_rbtrav_t*)malloc ( sizeof ( jsw_rbtrav_t ) );
+}
+
+/**
+  <summary>
+  Release a traversal object
+  <summary>
+  <param name="trav">The object to release</param>
+  <remarks>
+  The object must have been created with jsw_rbtnew
+  </remarks>
+*/
+void jsw_rbtdelete ( jsw_rbtrav_t *trav )
+{
+  free ( trav );
+}
+
+/**
+  <summary>
+  Initialize a traversal object. The user-specified
+  direction determines whether to begin traversal at the
+  smallest or largest valued node
+  <summary>
+  <param name="trav">The traversal object to initialize</param>
+  <param name="tree">The tree that the object will be attached to</param>
+  <param name="dir">
+  The direction to traverse (0 = ascending, 1 = descending)
+  </param>
+  <returns>A pointer to the smallest or largest data value</returns>
+  <remarks>For jsw_rbtree.c internal use only</remarks>
+*/
+static void *start ( jsw_rbtrav_t *trav, jsw_rbtree_t *tree, int dir )
+{
+  trav->tree = tree;
+  trav->it = tree->root;
+  trav->top = 0;
+
+  /* Save the path for later traversal */
+  if ( trav->it != NULL ) {
+    while ( trav->it->link[dir] != NULL ) {
+      trav->path[trav->top++] = trav->it;
       trav->it = trav->it->link[dir];
     }
   }
@@ -578,4 +1915,116 @@ void *jsw_rbtnext ( jsw_rbtrav_t *trav )
 void *jsw_rbtprev ( jsw_rbtrav_t *trav )
 {
   return move ( trav, 0 ); /* Toward smaller items */
-}
\ No newline at end of file
+}
+
+/**
+  <summary>
+  Initialize a traversal object to the first item that isn't
+  less than data, or that is greater than data for an upper bound
+  <summary>
+  <param name="trav">The traversal object to initialize</param>
+  <param name="tree">The tree that the object will be attached to</param>
+  <param name="data">The data value to search for</param>
+  <param name="upper">1 to skip an equal item, 0 to stop on it</param>
+  <returns>A pointer to the data value found, or NULL if none</returns>
+  <remarks>
+  For jsw_rbtree.c internal use only. The path to the best
+  candidate so far is kept, so later moves work as usual
+  </remarks>
+*/
+static void *bound ( jsw_rbtrav_t *trav, jsw_rbtree_t *tree, void *data,
+                     int upper )
+{
+  jsw_rbnode_t *it = tree->root;
+  size_t top = 0;
+
+  trav->tree = tree;
+  trav->it = NULL;
+  trav->top = 0;
+
+  while ( it != NULL ) {
+    int cmp = CMP ( tree, it->data, data );
+
+    if ( cmp > 0 || ( cmp == 0 && !upper ) ) {
+      /* A candidate, but a better one could be to the left */
+      trav->it = it;
+      trav->top = top;
+
+      if ( cmp == 0 )
+        break;
+
+      trav->path[top++] = it;
+      it = it->link[0];
+    }
+    else {
+      trav->path[top++] = it;
+      it = it->link[1];
+    }
+  }
+
+  return trav->it == NULL ? NULL : trav->it->data;
+}
+
+/**
+  <summary>
+  Initialize a traversal object to the smallest item
+  that isn't less than the specified data
+  <summary>
+  <param name="trav">The traversal object to initialize</param>
+  <param name="tree">The tree that the object will be attached to</param>
+  <param name="data">The data value to search for</param>
+  <returns>A pointer to the data value found, or NULL if none</returns>
+*/
+void *jsw_rbtlower ( jsw_rbtrav_t *trav, jsw_rbtree_t *tree, void *data )
+{
+  return bound ( trav, tree, data, 0 );
+}
+
+/**
+  <summary>
+  Initialize a traversal object to the smallest item
+  that is greater than the specified data
+  <summary>
+  <param name="trav">The traversal object to initialize</param>
+  <param name="tree">The tree that the object will be attached to</param>
+  <param name="data">The data value to search for</param>
+  <returns>A pointer to the data value found, or NULL if none</returns>
+*/
+void *jsw_rbtupper ( jsw_rbtrav_t *trav, jsw_rbtree_t *tree, void *data )
+{
+  return bound ( trav, tree, data, 1 );
+}
+
+/**
+  <summary>
+  Visit the items from lo to hi, inclusive, in ascending order
+  <summary>
+  <param name="tree">The tree to search</param>
+  <param name="lo">The smallest data value to visit</param>
+  <param name="hi">The largest data value to visit</param>
+  <param name="visit">Called with each item and arg</param>
+  <param name="arg">User-defined argument for visit</param>
+  <returns>The number of items passed to visit</returns>
+  <remarks>
+  The walk stops at the first item past hi, or as soon as
+  visit returns 0. The tree must not change during the walk
+  </remarks>
+*/
+size_t jsw_rbrange ( jsw_rbtree_t *tree, void *lo, void *hi,
+                     visit_f visit, void *arg )
+{
+  jsw_rbtrav_t trav;
+  void *it = bound ( &trav, tree, lo, 0 );
+  size_t n = 0;
+
+  while ( it != NULL && CMP ( tree, it, hi ) <= 0 ) {
+    ++n;
+
+    if ( !visit ( it, arg ) )
+      break;
+
+    it = move ( &trav, 1 );
+  }
+
+  return n;
+}
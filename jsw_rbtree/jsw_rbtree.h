@@ -6,6 +6,11 @@
 
     > Created (Julienne Walker): August 23, 2003
     > Modified (Julienne Walker): March 14, 2008
+    > Modified (agent): October 14, 2026
+      Added allocator hooks, intrusive nodes, building
+      from sorted input, bounds and range visits, rank
+      and select, batch lookups, JSW_STATS counters,
+      clear and set operations
 
   This code is in the public domain. Anyone may
   use it or change it in any way that they see
@@ -28,22 +33,70 @@ extern "C" {
 #include <stddef.h>
 #endif
 
+#include "jsw_alloc.h"
+#include "jsw_common.h"
+
 /* Opaque types */
 typedef struct jsw_rbtree jsw_rbtree_t;
 typedef struct jsw_rbtrav jsw_rbtrav_t;
 
+/* Tree node, embed one in each item for intrusive trees */
+typedef struct jsw_rbnode {
+  int                red;     /* Color (1=red, 0=black) */
+  void              *data;    /* User-defined content */
+  struct jsw_rbnode *link[2]; /* Left (0) and right (1) links */
+#ifdef JSW_RANK
+  size_t             count;   /* Nodes in this subtree */
+#endif
+} jsw_rbnode_t;
+
 /* User-defined item handling */
 typedef int   (*cmp_f) ( const void *p1, const void *p2 );
 typedef void *(*dup_f) ( void *p );
 typedef void  (*rel_f) ( void *p );
 
+/* Called for each item in a range, returns 0 to stop */
+typedef int   (*visit_f) ( void *p, void *arg );
+
 /* Red Black tree functions */
 jsw_rbtree_t *jsw_rbnew ( cmp_f cmp, dup_f dup, rel_f rel );
+jsw_rbtree_t *jsw_rbnew_alloc ( cmp_f cmp, dup_f dup, rel_f rel,
+                                const jsw_alloc_t *alloc );
+jsw_rbtree_t *jsw_rbnew_intrusive ( cmp_f cmp, rel_f rel, size_t offset );
 void          jsw_rbdelete ( jsw_rbtree_t *tree );
+void          jsw_rbclear ( jsw_rbtree_t *tree );
 void         *jsw_rbfind ( jsw_rbtree_t *tree, void *data );
+size_t        jsw_rbfind_many ( jsw_rbtree_t *tree, void **data, size_t n,
+                                void **out );
 int           jsw_rbinsert ( jsw_rbtree_t *tree, void *data );
 int           jsw_rberase ( jsw_rbtree_t *tree, void *data );
 size_t        jsw_rbsize ( jsw_rbtree_t *tree );
+int           jsw_rbstats ( jsw_rbtree_t *tree, jsw_stats_t *stats );
+int           jsw_rbbuild ( jsw_rbtree_t *tree, void **items, size_t n );
+size_t        jsw_rbrange ( jsw_rbtree_t *tree, void *lo, void *hi,
+                            visit_f visit, void *arg );
+
+/*
+  Set operations, which move nodes between compatible trees:
+  both intrusive with the same offset, or both on the same
+  allocator without a purge hook, since either tree would
+  purge it when deleted
+*/
+int           jsw_rbjoin ( jsw_rbtree_t *a, jsw_rbtree_t *b );
+int           jsw_rbsplit ( jsw_rbtree_t *tree, void *data,
+                            jsw_rbtree_t *right );
+int           jsw_rbunion ( jsw_rbtree_t *a, jsw_rbtree_t *b,
+                            const jsw_fork_t *fork );
+int           jsw_rbintersect ( jsw_rbtree_t *a, jsw_rbtree_t *b,
+                                const jsw_fork_t *fork );
+int           jsw_rbdifference ( jsw_rbtree_t *a, jsw_rbtree_t *b,
+                                 const jsw_fork_t *fork );
+
+#ifdef JSW_RANK
+/* Order statistics, when every file is built with JSW_RANK */
+void         *jsw_rbselect ( jsw_rbtree_t *tree, size_t k );
+size_t        jsw_rbrank ( jsw_rbtree_t *tree, void *data );
+#endif
 
 /* Traversal functions */
 jsw_rbtrav_t *jsw_rbtnew ( void );
@@ -52,6 +105,10 @@ void         *jsw_rbtfirst ( jsw_rbtrav_t *trav, jsw_rbtree_t *tree );
 void         *jsw_rbtlast ( jsw_rbtrav_t *trav, jsw_rbtree_t *tree );
 void         *jsw_rbtnext ( jsw_rbtrav_t *trav );
 void         *jsw_rbtprev ( jsw_rbtrav_t *trav );
+void         *jsw_rbtlower ( jsw_rbtrav_t *trav, jsw_rbtree_t *tree,
+                             void *data );
+void         *jsw_rbtupper ( jsw_rbtrav_t *trav, jsw_rbtree_t *tree,
+                             void *data );
 
 #ifdef __cplusplus
 }
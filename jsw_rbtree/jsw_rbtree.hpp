@@ -0,0 +1,541 @@
+#ifndef JSW_RBTREE_HPP
+#define JSW_RBTREE_HPP
+
+/*
+  Red Black balanced tree template for C++
+
+    > Created (agent): October 14, 2026
+
+  A header-only counterpart of jsw_rbtree for C++11 and later.
+  Keys are stored by value in the nodes and the comparator is
+  a template parameter, so integer compares inline instead of
+  going through a cmp_f pointer. Keys are moved in when given
+  as rvalues. Nodes keep a parent link so the iterators can be
+  plain STL bidirectional iterators, and balance is restored
+  with the classic bottom-up fix-ups.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace jsw {
+
+/* Ordered set of unique keys, like std::set */
+template <class K, class Compare = std::less<K>,
+          class Alloc = std::allocator<K> >
+class rbtree {
+  struct node {
+    node *link[2]; /* Left (0) and right (1) links */
+    node *parent;  /* NULL at the root */
+    bool  red;     /* Color */
+    K     key;     /* User-defined content */
+
+    template <class... Args>
+    explicit node ( Args&&... args ): key ( std::forward<Args> ( args )... ) {}
+  };
+
+  typedef typename std::allocator_traits<Alloc>::template
+    rebind_alloc<node> node_alloc;
+  typedef std::allocator_traits<node_alloc> node_traits;
+
+public:
+  typedef K           key_type;
+  typedef K           value_type;
+  typedef Compare     key_compare;
+  typedef Alloc       allocator_type;
+  typedef std::size_t size_type;
+
+  /* Keys can't change in place, so every iterator is const */
+  class const_iterator {
+  public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef K                               value_type;
+    typedef std::ptrdiff_t                  difference_type;
+    typedef const K                        *pointer;
+    typedef const K                        &reference;
+
+    const_iterator (): it_ ( NULL ), tree_ ( NULL ) {}
+
+    reference operator* () const { return it_->key; }
+    pointer operator-> () const { return &it_->key; }
+
+    const_iterator &operator++ ()
+    {
+      it_ = step ( it_, 1 );
+      return *this;
+    }
+
+    const_iterator operator++ ( int )
+    {
+      const_iterator save = *this;
+      ++*this;
+      return save;
+    }
+
+    /* Stepping back from end() lands on the last key */
+    const_iterator &operator-- ()
+    {
+      it_ = it_ != NULL ? step ( it_, 0 ) : tree_->extreme ( 1 );
+      return *this;
+    }
+
+    const_iterator operator-- ( int )
+    {
+      const_iterator save = *this;
+      --*this;
+      return save;
+    }
+
+    bool operator== ( const const_iterator &rhs ) const
+    {
+      return it_ == rhs.it_;
+    }
+
+    bool operator!= ( const const_iterator &rhs ) const
+    {
+      return it_ != rhs.it_;
+    }
+
+  private:
+    friend class rbtree;
+
+    const_iterator ( node *it, const rbtree *tree )
+      : it_ ( it ), tree_ ( tree ) {}
+
+    node         *it_;   /* Current node, NULL for end() */
+    const rbtree *tree_; /* Paired tree */
+  };
+
+  typedef const_iterator                        iterator;
+  typedef std::reverse_iterator<const_iterator> reverse_iterator;
+  typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  explicit rbtree ( const Compare &cmp = Compare(),
+                    const Alloc &alloc = Alloc() )
+    : root_ ( NULL ), size_ ( 0 ), cmp_ ( cmp ), alloc_ ( alloc ) {}
+
+  rbtree ( rbtree &&rhs )
+    : root_ ( rhs.root_ ), size_ ( rhs.size_ ),
+      cmp_ ( std::move ( rhs.cmp_ ) ), alloc_ ( std::move ( rhs.alloc_ ) )
+  {
+    rhs.root_ = NULL;
+    rhs.size_ = 0;
+  }
+
+  rbtree &operator= ( rbtree &&rhs )
+  {
+    if ( this != &rhs ) {
+      clear();
+      std::swap ( root_, rhs.root_ );
+      std::swap ( size_, rhs.size_ );
+      cmp_ = std::move ( rhs.cmp_ );
+      alloc_ = std::move ( rhs.alloc_ );
+    }
+
+    return *this;
+  }
+
+  rbtree ( const rbtree & ) = delete;
+  rbtree &operator= ( const rbtree & ) = delete;
+
+  ~rbtree () { clear(); }
+
+  const_iterator begin () const { return const_iterator ( extreme ( 0 ), this ); }
+  const_iterator end () const { return const_iterator ( NULL, this ); }
+  const_iterator cbegin () const { return begin(); }
+  const_iterator cend () const { return end(); }
+  const_reverse_iterator rbegin () const { return const_reverse_iterator ( end() ); }
+  const_reverse_iterator rend () const { return const_reverse_iterator ( begin() ); }
+
+  size_type size () const { return size_; }
+  bool empty () const { return size_ == 0; }
+
+  /* Release every node */
+  void clear ()
+  {
+    node *it = root_;
+
+    /* Rotate away the left links, as in jsw_rbdelete */
+    while ( it != NULL ) {
+      node *save;
+
+      if ( it->link[0] == NULL ) {
+        save = it->link[1];
+        destroy ( it );
+      }
+      else {
+        save = it->link[0];
+        it->link[0] = save->link[1];
+        save->link[1] = it;
+      }
+
+      it = save;
+    }
+
+    root_ = NULL;
+    size_ = 0;
+  }
+
+  template <class Key>
+  const_iterator find ( const Key &key ) const
+  {
+    node *it = root_;
+
+    while ( it != NULL ) {
+      if ( cmp_ ( key, it->key ) )
+        it = it->link[0];
+      else if ( cmp_ ( it->key, key ) )
+        it = it->link[1];
+      else
+        break;
+    }
+
+    return const_iterator ( it, this );
+  }
+
+  template <class Key>
+  size_type count ( const Key &key ) const
+  {
+    return find ( key ) != end();
+  }
+
+  /* First key that isn't less than key */
+  template <class Key>
+  const_iterator lower_bound ( const Key &key ) const
+  {
+    node *it = root_, *best = NULL;
+
+    while ( it != NULL ) {
+      if ( cmp_ ( it->key, key ) )
+        it = it->link[1];
+      else {
+        best = it;
+        it = it->link[0];
+      }
+    }
+
+    return const_iterator ( best, this );
+  }
+
+  /* Insert a key unless an equal one is already there */
+  std::pair<const_iterator, bool> insert ( const K &key )
+  {
+    return insert_unique ( key );
+  }
+
+  std::pair<const_iterator, bool> insert ( K &&key )
+  {
+    return insert_unique ( std::move ( key ) );
+  }
+
+  /* Build the key in place first, then insert it */
+  template <class... Args>
+  std::pair<const_iterator, bool> emplace ( Args&&... args )
+  {
+    node *n = create ( std::forward<Args> ( args )... );
+    node *p;
+    int dir;
+
+    if ( !locate ( n->key, p, dir ) ) {
+      destroy ( n );
+      return std::make_pair ( const_iterator ( p, this ), false );
+    }
+
+    attach ( n, p, dir );
+
+    return std::make_pair ( const_iterator ( n, this ), true );
+  }
+
+  /* Remove the key if present, returning how many were removed */
+  template <class Key>
+  size_type erase ( const Key &key )
+  {
+    const_iterator it = find ( key );
+
+    if ( it == end() )
+      return 0;
+
+    erase ( it );
+
+    return 1;
+  }
+
+  /* Remove one key, returning the position after it */
+  const_iterator erase ( const_iterator pos )
+  {
+    node *next = step ( pos.it_, 1 );
+
+    remove ( pos.it_ );
+
+    return const_iterator ( next, this );
+  }
+
+private:
+  static bool is_red ( const node *n ) { return n != NULL && n->red; }
+
+  /* In-order neighbor of n in direction dir, NULL past the end */
+  static node *step ( node *n, int dir )
+  {
+    if ( n->link[dir] != NULL ) {
+      n = n->link[dir];
+
+      while ( n->link[!dir] != NULL )
+        n = n->link[!dir];
+
+      return n;
+    }
+
+    while ( n->parent != NULL && n->parent->link[dir] == n )
+      n = n->parent;
+
+    return n->parent;
+  }
+
+  /* Smallest (0) or largest (1) node */
+  node *extreme ( int dir ) const
+  {
+    node *it = root_;
+
+    if ( it != NULL ) {
+      while ( it->link[dir] != NULL )
+        it = it->link[dir];
+    }
+
+    return it;
+  }
+
+  template <class... Args>
+  node *create ( Args&&... args )
+  {
+    node *n = node_traits::allocate ( alloc_, 1 );
+
+    try {
+      node_traits::construct ( alloc_, n, std::forward<Args> ( args )... );
+    }
+    catch ( ... ) {
+      node_traits::deallocate ( alloc_, n, 1 );
+      throw;
+    }
+
+    return n;
+  }
+
+  void destroy ( node *n )
+  {
+    node_traits::destroy ( alloc_, n );
+    node_traits::deallocate ( alloc_, n, 1 );
+  }
+
+  /*
+    Find where key belongs. Returns false with p set to the
+    equal node, or true with p and dir set to the free link
+  */
+  bool locate ( const K &key, node *&p, int &dir )
+  {
+    node *q = root_;
+
+    p = NULL;
+    dir = 0;
+
+    while ( q != NULL ) {
+      if ( cmp_ ( key, q->key ) )
+        dir = 0;
+      else if ( cmp_ ( q->key, key ) )
+        dir = 1;
+      else {
+        p = q;
+        return false;
+      }
+
+      p = q;
+      q = q->link[dir];
+    }
+
+    return true;
+  }
+
+  template <class Arg>
+  std::pair<const_iterator, bool> insert_unique ( Arg &&key )
+  {
+    node *p, *n;
+    int dir;
+
+    /* Search before allocating, so duplicates cost nothing */
+    if ( !locate ( key, p, dir ) )
+      return std::make_pair ( const_iterator ( p, this ), false );
+
+    n = create ( std::forward<Arg> ( key ) );
+    attach ( n, p, dir );
+
+    return std::make_pair ( const_iterator ( n, this ), true );
+  }
+
+  /* Point whatever linked to u at v instead */
+  void replace ( node *u, node *v )
+  {
+    if ( u->parent == NULL )
+      root_ = v;
+    else
+      u->parent->link[u->parent->link[1] == u] = v;
+
+    if ( v != NULL )
+      v->parent = u->parent;
+  }
+
+  /* Move x down in direction dir, raising its other child */
+  void rotate ( node *x, int dir )
+  {
+    node *y = x->link[!dir];
+
+    x->link[!dir] = y->link[dir];
+
+    if ( y->link[dir] != NULL )
+      y->link[dir]->parent = x;
+
+    replace ( x, y );
+    y->link[dir] = x;
+    x->parent = y;
+  }
+
+  /* Link a new red node below p and restore the red rule */
+  void attach ( node *n, node *p, int dir )
+  {
+    n->link[0] = n->link[1] = NULL;
+    n->parent = p;
+    n->red = true;
+
+    if ( p == NULL )
+      root_ = n;
+    else
+      p->link[dir] = n;
+
+    while ( is_red ( p = n->parent ) ) {
+      node *g = p->parent; /* A red node is never the root */
+      int d = g->link[1] == p;
+      node *u = g->link[!d];
+
+      if ( is_red ( u ) ) {
+        /* Color flip and move up */
+        p->red = u->red = false;
+        g->red = true;
+        n = g;
+      }
+      else {
+        /* Straighten an inner child, then rotate at g */
+        if ( n == p->link[!d] ) {
+          rotate ( p, d );
+          p = n;
+        }
+
+        p->red = false;
+        g->red = true;
+        rotate ( g, !d );
+        break;
+      }
+    }
+
+    root_->red = false;
+    ++size_;
+  }
+
+  /* Unlink and release z, then restore the black rule */
+  void remove ( node *z )
+  {
+    node *y = z, *x, *xp;
+    bool lost_black = !z->red;
+
+    if ( z->link[0] == NULL || z->link[1] == NULL ) {
+      x = z->link[z->link[0] == NULL];
+      xp = z->parent;
+      replace ( z, x );
+    }
+    else {
+      /* The successor takes z's place and color */
+      y = z->link[1];
+
+      while ( y->link[0] != NULL )
+        y = y->link[0];
+
+      lost_black = !y->red;
+      x = y->link[1];
+
+      if ( y->parent == z )
+        xp = y;
+      else {
+        xp = y->parent;
+        replace ( y, x );
+        y->link[1] = z->link[1];
+        y->link[1]->parent = y;
+      }
+
+      replace ( z, y );
+      y->link[0] = z->link[0];
+      y->link[0]->parent = y;
+      y->red = z->red;
+    }
+
+    destroy ( z );
+    --size_;
+
+    if ( !lost_black )
+      return;
+
+    /* x is short one black; xp is its parent (x may be NULL) */
+    while ( x != root_ && !is_red ( x ) ) {
+      int d = xp->link[1] == x;
+      node *w = xp->link[!d];
+
+      if ( w->red ) {
+        w->red = false;
+        xp->red = true;
+        rotate ( xp, d );
+        w = xp->link[!d];
+      }
+
+      if ( !is_red ( w->link[0] ) && !is_red ( w->link[1] ) ) {
+        w->red = true;
+        x = xp;
+        xp = x->parent;
+      }
+      else {
+        if ( !is_red ( w->link[!d] ) ) {
+          w->link[d]->red = false;
+          w->red = true;
+          rotate ( w, !d );
+          w = xp->link[!d];
+        }
+
+        w->red = xp->red;
+        xp->red = false;
+        w->link[!d]->red = false;
+        rotate ( xp, d );
+        x = root_;
+      }
+    }
+
+    if ( x != NULL )
+      x->red = false;
+  }
+
+  node      *root_; /* Top of the tree */
+  size_type  size_; /* Number of keys */
+  Compare    cmp_;  /* Strict weak ordering */
+  node_alloc alloc_;
+};
+
+}
+
+#endif
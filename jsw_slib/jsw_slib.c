@@ -3,28 +3,70 @@
 
     > Created (Julienne Walker): April 11, 2004
     > Updated (Julienne Walker): August 19, 2005
+    > Modified (agent): October 14, 2026
+      Allocated links with their node, gave each list
+      its own level generator, kept lookups from writing
+      to the list, and added allocator hooks, bounds and
+      range visits, batch lookups, JSW_STATS counters
+      and clear
 */
 #include "jsw_rand.h"
 #include "jsw_slib.h"
 
 #ifdef __cplusplus
-#include <climits>
+#include <cstddef>
 #include <cstdlib>
 
 using std::malloc;
 using std::free;
 using std::size_t;
 #else
-#include <limits.h>
+#include <stddef.h>
 #include <stdlib.h>
 #endif
 
+/* Searches interleaved by the batch lookup */
+#ifndef FIND_GROUP
+#define FIND_GROUP 8
+#endif
+
+/* Software prefetch hint, nothing where the compiler has none */
+#if defined ( __GNUC__ )
+#define PREFETCH(p) __builtin_prefetch ( (p) )
+#else
+#define PREFETCH(p) ( (void)0 )
+#endif
+
+/*
+  Hot path counters, kept only with JSW_STATS. Without it
+  these do nothing and the list has no stats field
+*/
+#ifdef JSW_STATS
+#define STAT_ADD(s,f,n) ( (void)( (s)->stats.f += (unsigned long)(n) ) )
+#else
+#define STAT_ADD(s,f,n) ( (void)0 )
+#endif
+#define STAT(s,f) STAT_ADD ( s, f, 1 )
+#define CMP(s,a,b) ( STAT ( s, cmps ), (s)->cmp ( (a), (b) ) )
+
+/* All zero, for new lists and for builds without JSW_STATS */
+static const jsw_stats_t no_stats = { 0 };
+
 typedef struct jsw_node {
-  void             *item;   /* Data item with combined key */
-  size_t            height; /* Column height of this node */
-  struct jsw_node **next;   /* Dynamic array of next links */
+  void             *item;    /* Data item with combined key */
+  size_t            height;  /* Column height of this node */
+  struct jsw_node  *next[1]; /* Next links, allocated with the node */
 } jsw_node_t;
 
+/* Bytes needed for a node with a column of height links */
+#define NODE_SIZE(height) \
+  ( offsetof ( jsw_node_t, next ) + (height) * sizeof ( jsw_node_t * ) )
+
+struct jsw_strav {
+  jsw_skip_t *skip; /* Paired skip list */
+  jsw_node_t *it;   /* Current node */
+};
+
 struct jsw_skip {
   jsw_node_t  *head; /* Full height header node */
   jsw_node_t **fix;  /* Update array */
@@ -35,59 +77,85 @@ struct jsw_skip {
   cmp_f        cmp;  /* User defined item compare function */
   dup_f        dup;  /* User defined item copy function */
   rel_f        rel;  /* User defined delete function */
+  jsw_alloc_t  mem;  /* Node allocator */
+  unsigned long rng; /* Private xorshift state for levels (never 0) */
+#ifdef JSW_STATS
+  jsw_stats_t  stats; /* Hot path counters */
+#endif
 };
 
-/*
-  Weighted random level with probability 1/2.
-  (For better distribution, modify with 1/3)
-
-  Implements a tuned bit stream algorithm.
-*/
-static size_t rlevel ( size_t max )
+/* Next 32-bit value from the skip list's own xorshift generator */
+static unsigned long xorshift ( jsw_skip_t *skip )
 {
-  static size_t bits = 0;
-  static size_t reset = 0;
-  size_t h, found = 0;
+  unsigned long x = skip->rng;
 
-  for ( h = 0; !found; h++ ) {
-    if ( reset == 0 ) {
-      bits = jsw_rand();
-      reset = sizeof ( size_t ) * CHAR_BIT - 1;
-    }
+  x ^= ( x << 13 ) & 0xffffffffUL;
+  x ^= x >> 17;
+  x ^= ( x << 5 ) & 0xffffffffUL;
 
-    /*
-      For 1/3 change to:
+  return skip->rng = x;
+}
 
-      found = bits % 3;
-      bits = bits / 3;
-    */
-    found = bits & 1;
-    bits = bits >> 1;
-    --reset;
+/* Number of trailing zero bits in a non-zero 32-bit value */
+static size_t ctz32 ( unsigned long x )
+{
+#if defined ( __GNUC__ )
+  return (size_t)__builtin_ctzl ( x );
+#else
+  size_t n = 0;
+
+  while ( ( x & 1 ) == 0 ) {
+    x >>= 1;
+    ++n;
   }
 
-  if ( h >= max )
-    h = max - 1;
+  return n;
+#endif
+}
+
+/*
+  Weighted random level with probability 1/2. Each
+  trailing zero bit of a random word is one more level
+*/
+static size_t rlevel ( jsw_skip_t *skip )
+{
+  size_t h = ctz32 ( xorshift ( skip ) ) + 1;
+
+  if ( h >= skip->maxh )
+    h = skip->maxh - 1;
 
   return h;
 }
 
+/* Default node allocator hooks */
+static void *std_alloc ( void *ctx, size_t size )
+{
+  (void)ctx;
+  return malloc ( size );
+}
+
+static void std_release ( void *ctx, void *p, size_t size )
+{
+  (void)ctx;
+  (void)size;
+  free ( p );
+}
+
+static void no_rel ( void *item )
+{
+  (void)item;
+}
+
 /* This function does not make a copy of the item */
-static jsw_node_t *new_node ( void *item, size_t height )
+static jsw_node_t *new_node ( jsw_skip_t *skip, void *item, size_t height )
 {
-  jsw_node_t *node = (jsw_node_t *)malloc ( sizeof *node );
+  jsw_node_t *node = (jsw_node_t *)skip->mem.alloc (
+    skip->mem.ctx, NODE_SIZE ( height ) );
   size_t i;
 
   if ( node == NULL )
     return NULL;
 
-  node->next = (jsw_node_t **)malloc ( height * sizeof *node->next );
-
-  if ( node->next == NULL ) {
-    free ( node );
-    return NULL;
-  }
-
   node->item = item;
   node->height = height;
 
@@ -98,27 +166,36 @@ static jsw_node_t *new_node ( void *item, size_t height )
 }
 
 /* This function does not release an item's memory */
-static void delete_node ( jsw_node_t *node )
+static void delete_node ( jsw_skip_t *skip, jsw_node_t *node )
 {
-  free ( node->next );
-  free ( node );
+  skip->mem.release ( skip->mem.ctx, node, NODE_SIZE ( node->height ) );
 }
 
-/* Find an existing item, or the position before where it would be */
-static jsw_node_t *locate ( jsw_skip_t *skip, void *item )
+/*
+  Find the position before where an item is or would be.
+  The node before it at each level goes into fix, unless
+  fix is NULL, so searches that only read leave the skip
+  list untouched
+*/
+static jsw_node_t *locate ( jsw_skip_t *skip, void *item, jsw_node_t **fix )
 {
   jsw_node_t *p = skip->head;
   size_t i;
 
   for ( i = skip->curh; i < (size_t)-1; i-- ) {
+    /* One step per link followed, and one to drop a level */
+    STAT ( skip, probes );
+
     while ( p->next[i] != NULL ) {
-      if ( skip->cmp ( item, p->next[i]->item ) <= 0 )
+      if ( CMP ( skip, item, p->next[i]->item ) <= 0 )
         break;
 
       p = p->next[i];
+      STAT ( skip, probes );
     }
 
-    skip->fix[i] = p;
+    if ( fix != NULL )
+      fix[i] = p;
   }
 
   return p;
@@ -126,13 +203,30 @@ static jsw_node_t *locate ( jsw_skip_t *skip, void *item )
 
 /* Allocate and initialize a new skip list */
 jsw_skip_t *jsw_snew ( size_t max, cmp_f cmp, dup_f dup, rel_f rel )
+{
+  return jsw_snew_alloc ( max, cmp, dup, rel, NULL );
+}
+
+jsw_skip_t *jsw_snew_alloc ( size_t max, cmp_f cmp, dup_f dup, rel_f rel,
+                             const jsw_alloc_t *alloc )
 {
   jsw_skip_t *skip = (jsw_skip_t *)malloc ( sizeof *skip );
+  size_t i;
 
   if ( skip == NULL )
     return NULL;
 
-  skip->head = new_node ( NULL, ++max );
+  if ( alloc != NULL )
+    skip->mem = *alloc;
+  else {
+    skip->mem.alloc = std_alloc;
+    skip->mem.release = std_release;
+    skip->mem.purge = NULL;
+    skip->mem.ctx = NULL;
+  }
+
+  /* The header outlives a purge, so it never comes from mem */
+  skip->head = (jsw_node_t *)malloc ( NODE_SIZE ( ++max ) );
 
   if ( skip->head == NULL ) {
     free ( skip );
@@ -142,73 +236,187 @@ jsw_skip_t *jsw_snew ( size_t max, cmp_f cmp, dup_f dup, rel_f rel )
   skip->fix = (jsw_node_t **)malloc ( max * sizeof *skip->fix );
 
   if ( skip->fix == NULL ) {
-    delete_node ( skip->head );
+    free ( skip->head );
     free ( skip );
     return NULL;
   }
 
+  skip->head->item = NULL;
+  skip->head->height = max;
+
+  for ( i = 0; i < max; i++ )
+    skip->head->next[i] = NULL;
+
   skip->curl = NULL;
+#ifdef JSW_STATS
+  skip->stats = no_stats;
+#endif
   skip->maxh = max;
   skip->curh = 0;
   skip->size = 0;
   skip->cmp = cmp;
   skip->dup = dup;
-  skip->rel = rel;
+  skip->rel = rel != NULL ? rel : no_rel;
 
-  jsw_seed ( jsw_time_seed() );
+  /* Lists made in the same second still get different levels */
+  jsw_sseed ( skip, jsw_time_seed() ^ (unsigned long)(size_t)skip );
 
   return skip;
 }
 
-void jsw_sdelete ( jsw_skip_t *skip )
+void jsw_sseed ( jsw_skip_t *skip, unsigned long seed )
+{
+  /* Spread the seed over all 32 bits (lowbias32) */
+  seed &= 0xffffffffUL;
+  seed ^= seed >> 16;
+  seed = ( seed * 0x7feb352dUL ) & 0xffffffffUL;
+  seed ^= seed >> 15;
+  seed = ( seed * 0x846ca68bUL ) & 0xffffffffUL;
+  seed ^= seed >> 16;
+
+  /* Zero is the one state xorshift can't leave */
+  skip->rng = seed != 0 ? seed : 0x9e3779b9UL;
+}
+
+/*
+  Release every node but the header. Nodes are only visited
+  when an item needs releasing or a node has no purge hook
+  to go back with
+*/
+static void release_nodes ( jsw_skip_t *skip )
 {
   jsw_node_t *it = skip->head->next[0];
   jsw_node_t *save;
 
+  if ( skip->rel == no_rel && skip->mem.purge != NULL )
+    it = NULL;
+
   while ( it != NULL ) {
     save = it->next[0];
     skip->rel ( it->item );
-    delete_node ( it );
+
+    /* A purge hook releases every node at the end */
+    if ( skip->mem.purge == NULL )
+      delete_node ( skip, it );
+
     it = save;
   }
 
-  delete_node ( skip->head );
+  if ( skip->mem.purge != NULL )
+    skip->mem.purge ( skip->mem.ctx );
+}
+
+void jsw_sdelete ( jsw_skip_t *skip )
+{
+  release_nodes ( skip );
+  free ( skip->head );
   free ( skip->fix );
   free ( skip );
 }
 
+void jsw_sclear ( jsw_skip_t *skip )
+{
+  size_t i;
+
+  release_nodes ( skip );
+
+  for ( i = 0; i < skip->maxh; i++ )
+    skip->head->next[i] = NULL;
+
+  skip->curl = NULL;
+  skip->curh = 0;
+  skip->size = 0;
+}
+
 void *jsw_sfind ( jsw_skip_t *skip, void *item )
 {
-  jsw_node_t *p = locate ( skip, item )->next[0];
+  jsw_node_t *p = locate ( skip, item, NULL )->next[0];
 
-  if ( p != NULL && skip->cmp ( item, p->item ) == 0 )
+  if ( p != NULL && CMP ( skip, item, p->item ) == 0 )
     return p->item;
 
   return NULL;
 }
 
+/*
+  Batch lookup. Each search in a group keeps its own node
+  and level, and every step moves each search one link
+  and prefetches the node it will compare next
+*/
+size_t jsw_sfind_many ( jsw_skip_t *skip, void **items, size_t n,
+                        void **out )
+{
+  jsw_node_t *p[FIND_GROUP];
+  size_t lvl[FIND_GROUP];
+  size_t found = 0;
+  size_t i, j, m, live;
+
+  for ( i = 0; i < n; i += m ) {
+    m = n - i < FIND_GROUP ? n - i : FIND_GROUP;
+
+    for ( j = 0; j < m; j++ ) {
+      p[j] = skip->head;
+      lvl[j] = skip->curh;
+      out[i + j] = NULL;
+    }
+
+    for ( live = m; live > 0; ) {
+      for ( j = 0; j < m; j++ ) {
+        jsw_node_t *next;
+
+        if ( p[j] == NULL )
+          continue;
+
+        STAT ( skip, probes );
+        next = p[j]->next[lvl[j]];
+
+        /* Same moves as locate, one per step */
+        if ( next != NULL && CMP ( skip, items[i + j], next->item ) > 0 ) {
+          p[j] = next;
+          PREFETCH ( next->next[lvl[j]] );
+        }
+        else if ( lvl[j]-- == 0 ) {
+          if ( next != NULL && CMP ( skip, items[i + j], next->item ) == 0 ) {
+            out[i + j] = next->item;
+            ++found;
+          }
+
+          p[j] = NULL;
+          --live;
+        }
+        else
+          PREFETCH ( p[j]->next[lvl[j]] );
+      }
+    }
+  }
+
+  return found;
+}
+
 int jsw_sinsert ( jsw_skip_t *skip, void *item )
 {
-  void *p = locate ( skip, item )->item;
+  jsw_node_t *p = locate ( skip, item, skip->fix )->next[0];
 
-  if ( p != NULL && skip->cmp ( item, p ) == 0 )
+  if ( p != NULL && CMP ( skip, item, p->item ) == 0 )
     return 0;
   else {
     /* Try to allocate before making changes */
-    size_t h = rlevel ( skip->maxh );
+    size_t h = rlevel ( skip );
     void *dup = skip->dup ( item );
     jsw_node_t *it;
 
     if ( dup == NULL )
       return 0;
 
-    it = new_node ( dup, h );
+    it = new_node ( skip, dup, h );
 
     if ( it == NULL ) {
       skip->rel ( dup );
       return 0;
     }
 
+    STAT ( skip, allocs );
+
     /* Raise height if necessary */
     if ( h > skip->curh ) {
       h = ++skip->curh;
@@ -229,9 +437,9 @@ int jsw_sinsert ( jsw_skip_t *skip, void *item )
 
 int jsw_serase ( jsw_skip_t *skip, void *item )
 {
-  jsw_node_t *p = locate ( skip, item )->next[0];
+  jsw_node_t *p = locate ( skip, item, skip->fix )->next[0];
 
-  if ( p == NULL || skip->cmp ( item, p->item ) != 0 )
+  if ( p == NULL || CMP ( skip, item, p->item ) != 0 )
     return 0;
   else {
     size_t i;
@@ -245,7 +453,8 @@ int jsw_serase ( jsw_skip_t *skip, void *item )
     }
 
     skip->rel ( p->item );
-    delete_node ( p );
+    delete_node ( skip, p );
+    STAT ( skip, releases );
 
     /* Lower height if necessary */
     while ( skip->curh > 0 ) {
@@ -269,6 +478,19 @@ size_t jsw_ssize ( jsw_skip_t *skip )
   return skip->size;
 }
 
+/* Copy out the hot path counters, non-zero if built with JSW_STATS */
+int jsw_sstats ( jsw_skip_t *skip, jsw_stats_t *stats )
+{
+#ifdef JSW_STATS
+  *stats = skip->stats;
+  return 1;
+#else
+  (void)skip;
+  *stats = no_stats;
+  return 0;
+#endif
+}
+
 void jsw_sreset ( jsw_skip_t *skip )
 {
   skip->curl = skip->head->next[0];
@@ -283,3 +505,111 @@ int jsw_snext ( jsw_skip_t *skip )
 {
   return ( skip->curl = skip->curl->next[0] ) != NULL;
 }
+
+void *jsw_slower ( jsw_skip_t *skip, void *item )
+{
+  skip->curl = locate ( skip, item, NULL )->next[0];
+
+  return jsw_sitem ( skip );
+}
+
+/* First node greater than item, skipping at most one equal node */
+static jsw_node_t *upper ( jsw_skip_t *skip, void *item )
+{
+  jsw_node_t *p = locate ( skip, item, NULL )->next[0];
+
+  if ( p != NULL && CMP ( skip, item, p->item ) == 0 )
+    p = p->next[0];
+
+  return p;
+}
+
+void *jsw_supper ( jsw_skip_t *skip, void *item )
+{
+  skip->curl = upper ( skip, item );
+
+  return jsw_sitem ( skip );
+}
+
+size_t jsw_srange ( jsw_skip_t *skip, void *lo, void *hi,
+                    visit_f visit, void *arg )
+{
+  jsw_node_t *p = locate ( skip, lo, NULL )->next[0];
+  size_t n = 0;
+
+  while ( p != NULL && CMP ( skip, p->item, hi ) <= 0 ) {
+    ++n;
+
+    if ( !visit ( p->item, arg ) )
+      break;
+
+    p = p->next[0];
+  }
+
+  return n;
+}
+
+jsw_strav_t *jsw_stnew ( void )
+{
+  return (jsw_strav_t *)malloc ( sizeof ( jsw_strav_t ) );
+}
+
+void jsw_stdelete ( jsw_strav_t *trav )
+{
+  free ( trav );
+}
+
+/* Item at the traverser, or NULL at the end */
+static void *trav_item ( jsw_strav_t *trav )
+{
+  return trav->it == NULL ? NULL : trav->it->item;
+}
+
+void *jsw_stfirst ( jsw_strav_t *trav, jsw_skip_t *skip )
+{
+  trav->skip = skip;
+  trav->it = skip->head->next[0];
+
+  return trav_item ( trav );
+}
+
+void *jsw_stlast ( jsw_strav_t *trav, jsw_skip_t *skip )
+{
+  jsw_node_t *p = skip->head;
+  size_t i;
+
+  /* Run to the end of each level, then drop down */
+  for ( i = skip->curh; i < (size_t)-1; i-- ) {
+    while ( p->next[i] != NULL )
+      p = p->next[i];
+  }
+
+  trav->skip = skip;
+  trav->it = p != skip->head ? p : NULL;
+
+  return trav_item ( trav );
+}
+
+void *jsw_stnext ( jsw_strav_t *trav )
+{
+  if ( trav->it != NULL )
+    trav->it = trav->it->next[0];
+
+  return trav_item ( trav );
+}
+
+void *jsw_stlower ( jsw_strav_t *trav, jsw_skip_t *skip, void *item )
+{
+  trav->skip = skip;
+  trav->it = locate ( skip, item, NULL )->next[0];
+
+  return trav_item ( trav );
+}
+
+void *jsw_stupper ( jsw_strav_t *trav, jsw_skip_t *skip, void *item )
+{
+  trav->skip = skip;
+  trav->it = upper ( skip, item );
+
+  return trav_item ( trav );
+}
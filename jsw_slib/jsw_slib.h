@@ -6,6 +6,10 @@
 
     > Created (Julienne Walker): April 11, 2004
     > Updated (Julienne Walker): August 19, 2005
+    > Modified (agent): October 14, 2026
+      Gave each list its own level generator, and added
+      allocator hooks, bounds and range visits, batch
+      lookups, JSW_STATS counters and clear
 
   This code is in the public domain. Anyone may
   use it or change it in any way that they see
@@ -28,7 +32,11 @@ extern "C" {
 #include <stddef.h>
 #endif
 
+#include "jsw_alloc.h"
+#include "jsw_common.h"
+
 typedef struct jsw_skip jsw_skip_t;
+typedef struct jsw_strav jsw_strav_t;
 
 /* Application specific key comparison function */
 typedef int   (*cmp_f) ( const void *a, const void *b );
@@ -36,9 +44,15 @@ typedef int   (*cmp_f) ( const void *a, const void *b );
 /* Application specific item copying function */
 typedef void *(*dup_f) ( const void *item );
 
-/* Application specific item deletion function */
+/*
+  Application specific item deletion function. A NULL rel
+  leaves items alone, for lists of items owned elsewhere
+*/
 typedef void  (*rel_f) ( void *item );
 
+/* Application specific range visitor, returns 0 to stop */
+typedef int   (*visit_f) ( void *item, void *arg );
+
 /*
   Create a new skip list with a max height of max
 
@@ -46,16 +60,51 @@ typedef void  (*rel_f) ( void *item );
 */
 jsw_skip_t *jsw_snew ( size_t max, cmp_f cmp, dup_f dup, rel_f rel );
 
+/*
+  Create a new skip list whose nodes come from a user
+  defined allocator, or malloc if alloc is NULL
+
+  Returns: An empty skip list, or NULL on failure
+*/
+jsw_skip_t *jsw_snew_alloc ( size_t max, cmp_f cmp, dup_f dup, rel_f rel,
+                             const jsw_alloc_t *alloc );
+
+/*
+  Seed the skip list's private level generator. Every
+  skip list starts with its own seed, so this is only
+  needed for reproducible layouts
+*/
+void        jsw_sseed ( jsw_skip_t *skip, unsigned long seed );
+
 /* Release all memory used by the skip list */
 void        jsw_sdelete ( jsw_skip_t *skip );
 
 /*
-  Find an item with the selected key
+  Remove every item, keeping the skip list for reuse. With
+  a purge hook and a NULL rel no node is visited
+*/
+void        jsw_sclear ( jsw_skip_t *skip );
+
+/*
+  Find an item with the selected key. Unless built with
+  JSW_STATS, doesn't modify the skip list, so any number
+  of threads can find at once
 
   Returns: The item, or NULL if not found
 */
 void       *jsw_sfind ( jsw_skip_t *skip, void *item );
 
+/*
+  Find n items at once, storing each stored item or NULL
+  in out. Interleaves the searches and prefetches their
+  next nodes, so cache misses overlap. Doesn't modify
+  the skip list unless built with JSW_STATS
+
+  Returns: The number of items found
+*/
+size_t      jsw_sfind_many ( jsw_skip_t *skip, void **items, size_t n,
+                             void **out );
+
 /*
   Insert an item with the selected key
 
@@ -73,6 +122,14 @@ int         jsw_serase ( jsw_skip_t *skip, void *item );
 /* Current number of items at height 0 */
 size_t      jsw_ssize ( jsw_skip_t *skip );
 
+/*
+  Copy the hot path counters into stats, or zeros in a
+  build without JSW_STATS
+
+  Returns: non-zero if the counters are compiled in
+*/
+int         jsw_sstats ( jsw_skip_t *skip, jsw_stats_t *stats );
+
 /* Reset the traversal markers to the beginning */
 void        jsw_sreset ( jsw_skip_t *skip );
 
@@ -90,6 +147,52 @@ void       *jsw_sitem ( jsw_skip_t *skip );
 */
 int         jsw_snext ( jsw_skip_t *skip );
 
+/*
+  Move the traversal marker to the first item
+  that isn't less than the selected key
+
+  Returns the item, or NULL if end-of-list
+*/
+void       *jsw_slower ( jsw_skip_t *skip, void *item );
+
+/*
+  Move the traversal marker to the first item
+  that is greater than the selected key
+
+  Returns the item, or NULL if end-of-list
+*/
+void       *jsw_supper ( jsw_skip_t *skip, void *item );
+
+/*
+  Visit items from lo to hi inclusive in ascending order,
+  stopping early if visit returns 0. The traversal marker
+  is left alone
+
+  Returns the number of items passed to visit
+*/
+size_t      jsw_srange ( jsw_skip_t *skip, void *lo, void *hi,
+                         visit_f visit, void *arg );
+
+/*
+  Traversal objects keep their position outside of the
+  skip list, so readers can share it. Each function
+  returns the item, or NULL if end-of-list. Inserting or
+  erasing invalidates them
+*/
+jsw_strav_t *jsw_stnew ( void );
+void         jsw_stdelete ( jsw_strav_t *trav );
+void        *jsw_stfirst ( jsw_strav_t *trav, jsw_skip_t *skip );
+void        *jsw_stlast ( jsw_strav_t *trav, jsw_skip_t *skip );
+void        *jsw_stnext ( jsw_strav_t *trav );
+
+/* Position a traversal object like jsw_slower */
+void        *jsw_stlower ( jsw_strav_t *trav, jsw_skip_t *skip,
+                           void *item );
+
+/* Position a traversal object like jsw_supper */
+void        *jsw_stupper ( jsw_strav_t *trav, jsw_skip_t *skip,
+                           void *item );
+
 #ifdef __cplusplus
 }
 #endif
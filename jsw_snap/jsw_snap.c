@@ -0,0 +1,389 @@
+/*
+  Memory mapped snapshots of ordered containers
+
+    > Created (agent): October 14, 2026
+
+  File layout, all integers in the writer's byte order:
+
+    header   magic, version, byte order mark, record count,
+             index offset, file length
+    records  a 64-bit length, then the bytes, padded so the
+             next record starts 8 byte aligned
+    index    the offset of each record's length, in order
+
+  The index makes the file a sorted array, which the reader
+  binary searches in place. Offsets are checked as they are
+  used rather than all at open, so opening never reads more
+  than the header. A record's length is checked against the
+  end of the records before the record is used, and passed
+  on to cmp, which is left to judge the bytes themselves.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+#include "jsw_snap.h"
+
+#ifdef __cplusplus
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using std::FILE;
+using std::fclose;
+using std::fflush;
+using std::fopen;
+using std::fseek;
+using std::fwrite;
+using std::remove;
+using std::rename;
+using std::malloc;
+using std::realloc;
+using std::free;
+using std::memcmp;
+using std::memcpy;
+using std::memset;
+using std::strlen;
+#else
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#include <stdint.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SNAP_VERSION 1
+#define SNAP_ORDER   0x01020304UL /* Reads differently in the other byte order */
+#define SNAP_ALIGN   8
+
+/* Round n up to the record alignment */
+#define ALIGN_UP(n) \
+  ( ( (n) + SNAP_ALIGN - 1 ) & ~(uint64_t)( SNAP_ALIGN - 1 ) )
+
+static const char snap_magic[8] = "jswsnap";
+
+typedef struct jsw_snaphead {
+  char     magic[8]; /* "jswsnap" */
+  uint32_t version;  /* SNAP_VERSION */
+  uint32_t order;    /* SNAP_ORDER */
+  uint64_t count;    /* Number of records */
+  uint64_t index;    /* Offset of the record index */
+  uint64_t length;   /* Size of the whole file */
+} jsw_snaphead_t;
+
+struct jsw_snapw {
+  FILE     *out;    /* Temporary file being written */
+  char     *path;   /* Final name of the snapshot */
+  char     *tmp;    /* Name of the temporary file */
+  uint64_t *offs;   /* Offset of every record so far */
+  size_t    count;  /* Number of records so far */
+  size_t    cap;    /* Room in offs */
+  uint64_t  pos;    /* Bytes written so far */
+  int       failed; /* A write failed, so close throws the file away */
+};
+
+struct jsw_snap {
+  const unsigned char *base;   /* Start of the mapping */
+  size_t               length; /* Size of the mapping */
+  const uint64_t      *index;  /* Record offsets, in order */
+  uint64_t             end;    /* Offset of the index, where records stop */
+  size_t               count;  /* Number of records */
+  reccmp_f             cmp;    /* User defined key comparison function */
+};
+
+/* Write n bytes, remembering any failure for close */
+static void put ( jsw_snapw_t *w, const void *p, size_t n )
+{
+  if ( !w->failed && n > 0 && fwrite ( p, 1, n, w->out ) != n )
+    w->failed = 1;
+
+  w->pos += n;
+}
+
+jsw_snapw_t *jsw_snapwopen ( const char *path )
+{
+  jsw_snapw_t *w = (jsw_snapw_t *)malloc ( sizeof *w );
+  jsw_snaphead_t head;
+  size_t n = strlen ( path );
+
+  if ( w == NULL )
+    return NULL;
+
+  w->path = (char *)malloc ( n + 1 );
+  w->tmp = (char *)malloc ( n + 5 );
+
+  if ( w->path == NULL || w->tmp == NULL ) {
+    free ( w->path );
+    free ( w->tmp );
+    free ( w );
+    return NULL;
+  }
+
+  memcpy ( w->path, path, n + 1 );
+  memcpy ( w->tmp, path, n );
+  memcpy ( w->tmp + n, ".tmp", 5 );
+
+  w->out = fopen ( w->tmp, "wb" );
+
+  if ( w->out == NULL ) {
+    free ( w->path );
+    free ( w->tmp );
+    free ( w );
+    return NULL;
+  }
+
+  w->offs = NULL;
+  w->count = w->cap = 0;
+  w->pos = 0;
+  w->failed = 0;
+
+  /* Filled in by close, once the index is written */
+  memset ( &head, 0, sizeof head );
+  put ( w, &head, sizeof head );
+
+  return w;
+}
+
+int jsw_snapwadd ( jsw_snapw_t *w, const void *rec, size_t len )
+{
+  static const unsigned char pad[SNAP_ALIGN] = { 0 };
+  uint64_t n = len;
+
+  if ( w->failed )
+    return 0;
+
+  if ( w->count == w->cap ) {
+    size_t cap = w->cap != 0 ? w->cap * 2 : 1024;
+    uint64_t *save = (uint64_t *)realloc ( w->offs, cap * sizeof *save );
+
+    /* A snapshot missing this record must not be published */
+    if ( save == NULL ) {
+      w->failed = 1;
+      return 0;
+    }
+
+    w->offs = save;
+    w->cap = cap;
+  }
+
+  w->offs[w->count++] = w->pos;
+
+  put ( w, &n, sizeof n );
+  put ( w, rec, len );
+  put ( w, pad, (size_t)( ALIGN_UP ( w->pos ) - w->pos ) );
+
+  return !w->failed;
+}
+
+int jsw_snapwclose ( jsw_snapw_t *w )
+{
+  jsw_snaphead_t head;
+  int ok;
+
+  memcpy ( head.magic, snap_magic, sizeof head.magic );
+  head.version = SNAP_VERSION;
+  head.order = SNAP_ORDER;
+  head.count = w->count;
+  head.index = w->pos;
+  head.length = w->pos + w->count * sizeof *w->offs;
+
+  put ( w, w->offs, w->count * sizeof *w->offs );
+
+  if ( !w->failed && fseek ( w->out, 0, SEEK_SET ) != 0 )
+    w->failed = 1;
+
+  put ( w, &head, sizeof head );
+
+  /* The data has to be on disk before the name points at it */
+  ok = !w->failed
+    && fflush ( w->out ) == 0
+    && fsync ( fileno ( w->out ) ) == 0;
+  ok = fclose ( w->out ) == 0 && ok;
+  ok = ok && rename ( w->tmp, w->path ) == 0;
+
+  if ( !ok )
+    remove ( w->tmp );
+
+  free ( w->offs );
+  free ( w->path );
+  free ( w->tmp );
+  free ( w );
+
+  return ok;
+}
+
+jsw_snap_t *jsw_snapopen ( const char *path, reccmp_f cmp )
+{
+  jsw_snap_t *snap;
+  const jsw_snaphead_t *head;
+  struct stat st;
+  void *base;
+  int fd = open ( path, O_RDONLY );
+
+  if ( fd < 0 )
+    return NULL;
+
+  if ( fstat ( fd, &st ) != 0
+    || (uint64_t)st.st_size < sizeof *head
+    || (uint64_t)st.st_size != (uint64_t)(size_t)st.st_size )
+  {
+    close ( fd );
+    return NULL;
+  }
+
+  base = mmap ( NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+  close ( fd );
+
+  if ( base == MAP_FAILED )
+    return NULL;
+
+  /* Everything the index depends on has to add up */
+  head = (const jsw_snaphead_t *)base;
+
+  if ( memcmp ( head->magic, snap_magic, sizeof head->magic ) != 0
+    || head->version != SNAP_VERSION
+    || head->order != SNAP_ORDER
+    || head->length != (uint64_t)st.st_size
+    || head->index < sizeof *head
+    || head->index % SNAP_ALIGN != 0
+    || head->index > head->length
+    || head->count != ( head->length - head->index ) / sizeof ( uint64_t )
+    || ( head->length - head->index ) % sizeof ( uint64_t ) != 0 )
+  {
+    munmap ( base, (size_t)st.st_size );
+    return NULL;
+  }
+
+  snap = (jsw_snap_t *)malloc ( sizeof *snap );
+
+  if ( snap == NULL ) {
+    munmap ( base, (size_t)st.st_size );
+    return NULL;
+  }
+
+  snap->base = (const unsigned char *)base;
+  snap->length = (size_t)st.st_size;
+  snap->index = (const uint64_t *)( snap->base + head->index );
+  snap->end = head->index;
+  snap->count = (size_t)head->count;
+  snap->cmp = cmp;
+
+  return snap;
+}
+
+void jsw_snapclose ( jsw_snap_t *snap )
+{
+  munmap ( (void *)snap->base, snap->length );
+  free ( snap );
+}
+
+size_t jsw_snapsize ( jsw_snap_t *snap )
+{
+  return snap->count;
+}
+
+/* Record at position i, or NULL if its offsets lead outside the records */
+static const void *record ( jsw_snap_t *snap, size_t i, uint64_t *len )
+{
+  uint64_t off = snap->index[i];
+  uint64_t n;
+
+  if ( off < sizeof ( jsw_snaphead_t )
+    || off % SNAP_ALIGN != 0
+    || off > snap->end - sizeof n )
+  {
+    return NULL;
+  }
+
+  memcpy ( &n, snap->base + off, sizeof n );
+
+  if ( n > snap->end - off - sizeof n )
+    return NULL;
+
+  *len = n;
+
+  return snap->base + off + sizeof n;
+}
+
+const void *jsw_snapitem ( jsw_snap_t *snap, size_t i, size_t *len )
+{
+  const void *rec;
+  uint64_t n;
+
+  if ( i >= snap->count )
+    return NULL;
+
+  rec = record ( snap, i, &n );
+
+  if ( rec != NULL && len != NULL )
+    *len = (size_t)n;
+
+  return rec;
+}
+
+/*
+  First position whose record compares at least as big
+  as key, or with strict set, bigger. A damaged record
+  ends the search at the end of the snapshot
+*/
+static size_t search ( jsw_snap_t *snap, const void *key, int strict )
+{
+  size_t lo = 0, hi = snap->count;
+  uint64_t n;
+
+  while ( lo < hi ) {
+    size_t mid = lo + ( hi - lo ) / 2;
+    const void *rec = record ( snap, mid, &n );
+    int cmp;
+
+    if ( rec == NULL )
+      return snap->count;
+
+    cmp = snap->cmp ( key, rec, (size_t)n );
+
+    if ( cmp > 0 || ( strict && cmp == 0 ) )
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return lo;
+}
+
+const void *jsw_snapfind ( jsw_snap_t *snap, const void *key )
+{
+  size_t i = search ( snap, key, 0 );
+  uint64_t n;
+  const void *rec;
+
+  if ( i == snap->count )
+    return NULL;
+
+  rec = record ( snap, i, &n );
+
+  if ( rec != NULL && snap->cmp ( key, rec, (size_t)n ) == 0 )
+    return rec;
+
+  return NULL;
+}
+
+size_t jsw_snaplower ( jsw_snap_t *snap, const void *key )
+{
+  return search ( snap, key, 0 );
+}
+
+size_t jsw_snapupper ( jsw_snap_t *snap, const void *key )
+{
+  return search ( snap, key, 1 );
+}
@@ -0,0 +1,122 @@
+#ifndef JSW_SNAP_H
+#define JSW_SNAP_H
+
+/*
+  Memory mapped snapshots of ordered containers
+
+    > Created (agent): October 14, 2026
+
+  A snapshot is a file of records in sorted order, followed
+  by an index of their offsets from the start of the file.
+  Nothing in it is a pointer, so it can be mapped anywhere,
+  and every process that opens the same file shares its
+  pages through the page cache.
+
+  A writer takes the records of any ordered container, one
+  traversal from first to last. A reader maps the file read
+  only and answers lookups and in-order walks straight from
+  the mapping, so opening it costs a few system calls no
+  matter how many records it holds.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+#ifdef __cplusplus
+#include <cstddef>
+
+using std::size_t;
+
+extern "C" {
+#else
+#include <stddef.h>
+#endif
+
+typedef struct jsw_snap jsw_snap_t;
+typedef struct jsw_snapw jsw_snapw_t;
+
+/*
+  User defined key comparison function. rec is a record
+  in the mapping, so a record must hold its key without
+  pointers, and len is its length as stored. A damaged
+  file can hold any bytes, so the function must not read
+  past len, nor rely on a terminator inside it
+*/
+typedef int (*reccmp_f) ( const void *key, const void *rec, size_t len );
+
+/*
+  Start writing a snapshot to path. The records go to a
+  temporary file beside it, which replaces path only once
+  jsw_snapwclose succeeds, so readers of an older snapshot
+  at path never see a partial one
+
+  Returns: A new writer, or NULL on failure
+*/
+jsw_snapw_t *jsw_snapwopen ( const char *path );
+
+/*
+  Append a record of len bytes. Records must arrive in
+  ascending order with no duplicates, as a traversal of
+  an ordered container gives them. Each is stored 8 byte
+  aligned, so structures can be read in place. Once an add
+  fails, every later add and jsw_snapwclose fail as well
+
+  Returns: non-zero for success, zero for failure
+*/
+int          jsw_snapwadd ( jsw_snapw_t *w, const void *rec, size_t len );
+
+/*
+  Write the index and put the snapshot in place. The
+  writer is released either way, and on failure the
+  temporary file is removed
+
+  Returns: non-zero for success, zero for failure
+*/
+int          jsw_snapwclose ( jsw_snapw_t *w );
+
+/*
+  Map a snapshot for reading, checking its header
+
+  Returns: The snapshot, or NULL on failure
+*/
+jsw_snap_t  *jsw_snapopen ( const char *path, reccmp_f cmp );
+
+/* Unmap a snapshot, invalidating every record pointer */
+void         jsw_snapclose ( jsw_snap_t *snap );
+
+/* Number of records in the snapshot */
+size_t       jsw_snapsize ( jsw_snap_t *snap );
+
+/*
+  Find the record matching key
+
+  Returns: The record in the mapping, or NULL if not found
+*/
+const void  *jsw_snapfind ( jsw_snap_t *snap, const void *key );
+
+/*
+  Get the record at position i, in order from 0. len
+  receives its length unless it is NULL
+
+  Returns: The record, or NULL if i is past the end
+*/
+const void  *jsw_snapitem ( jsw_snap_t *snap, size_t i, size_t *len );
+
+/* Position of the first record not less than key (size if none) */
+size_t       jsw_snaplower ( jsw_snap_t *snap, const void *key );
+
+/* Position of the first record greater than key (size if none) */
+size_t       jsw_snapupper ( jsw_snap_t *snap, const void *key );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
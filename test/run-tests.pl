@@ -3,6 +3,9 @@
 # Test for jsw-lib containers
 #
 #   > Created (Patrick Pelletier): April 17, 2022
+#   > Modified (agent): October 14, 2026
+#     Builds and runs the tests of the added libraries
+#     and features
 #
 # This code is in the public domain. Anyone may
 # use it or change it in any way that they see
@@ -21,9 +24,10 @@ use FindBin;
 chdir ($FindBin::Bin) or die;
 
 my $cc = "gcc";
+my $cxx = "g++";
 my $valgrind = "valgrind";
 
-my @libs = qw(atree avltree rbtree slib hlib);
+my @libs = qw(atree avltree rbtree btree slib cslib hlib chlib flat prbtree);
 
 my $red = "\e[31m";
 my $off = "\e[0m";
@@ -46,22 +50,175 @@ sub mysystem {
 foreach my $lib (@libs) {
     my $libdir = "../jsw_$lib";
     my $testname = "test-$lib";
-    my @cmd = ($cc, "-Wall", "-g", "-o", $testname, "-I$libdir");
-    if ($lib eq "slib") {
+    my @cmd = ($cc, "-Wall", "-g", "-o", $testname, "-I$libdir",
+               "-I../jsw_alloc");
+    if ($lib eq "slib" || $lib eq "cslib") {
         push @cmd, "-I../jsw_rand";
         push @cmd, "../jsw_rand/jsw_rand.c";
     }
+    if ($lib eq "chlib") {
+        push @cmd, "-pthread", "-I../jsw_hlib";
+    }
     push @cmd, "$libdir/jsw_$lib.c";
+    push @cmd, "../jsw_alloc/jsw_alloc.c";
     push @cmd, "$testname.c";
     push @cmd, "test-main.c";
 
     mysystem (@cmd);
 }
 
+# The same container tests with nodes from a pool allocator
+foreach my $lib (qw(hlib slib)) {
+    my @cmd = ($cc, "-Wall", "-g", "-o", "test-$lib-pool", "-I../jsw_$lib",
+               "-I../jsw_alloc");
+    if ($lib eq "slib") {
+        push @cmd, "-I../jsw_rand", "../jsw_rand/jsw_rand.c";
+    }
+    mysystem (@cmd, "../jsw_$lib/jsw_$lib.c", "../jsw_alloc/jsw_alloc.c",
+              "test-$lib-pool.c", "test-main.c");
+}
+
+# Reference outputs of the random number generator, with and without SSE2
+foreach my $variant (["test-rand"], ["test-rand-scalar", "-U__SSE2__"]) {
+    my ($name, @defs) = @$variant;
+    mysystem ($cc, "-Wall", "-g", @defs, "-o", $name, "-I../jsw_rand",
+              "../jsw_rand/jsw_rand.c", "test-rand.c");
+}
+
+# Balanced trees with nodes embedded in the items
+foreach my $variant (["rbtree", "test-intrusive"],
+                     ["avltree", "test-intrusive-avltree",
+                      "-DINTRUSIVE_AVLTREE"],
+                     ["atree", "test-intrusive-atree", "-DINTRUSIVE_ATREE"]) {
+    my ($lib, $name, @defs) = @$variant;
+    mysystem ($cc, "-Wall", "-g", @defs, "-o", $name, "-I../jsw_$lib",
+              "-I../jsw_alloc", "../jsw_$lib/jsw_$lib.c",
+              "../jsw_alloc/jsw_alloc.c", "test-intrusive.c", "test-main.c");
+}
+
+# Comparator call counts for the balanced trees
+my @trees = qw(rbtree avltree atree);
+mysystem ($cc, "-Wall", "-g", "-o", "test-cmpcount",
+          (map { "-I../jsw_$_" } @trees), "-I../jsw_alloc",
+          (map { "../jsw_$_/jsw_$_.c" } @trees),
+          "../jsw_alloc/jsw_alloc.c", "test-cmpcount.c", "-lm");
+
+# Balanced trees built from sorted input, then updated
+mysystem ($cc, "-Wall", "-g", "-o", "test-build",
+          (map { "-I../jsw_$_" } @trees), "-I../jsw_alloc",
+          (map { "../jsw_$_/jsw_$_.c" } @trees),
+          "../jsw_alloc/jsw_alloc.c", "test-build.c");
+
+# Bounds and range visits for the ordered containers
+my @ordered = qw(rbtree avltree atree btree slib);
+mysystem ($cc, "-Wall", "-g", "-o", "test-range",
+          (map { "-I../jsw_$_" } @ordered), "-I../jsw_rand", "-I../jsw_alloc",
+          (map { "../jsw_$_/jsw_$_.c" } @ordered), "../jsw_rand/jsw_rand.c",
+          "../jsw_alloc/jsw_alloc.c", "test-range.c", "test-slib-ops.c");
+
+# Rank and select, with subtree sizes compiled in
+mysystem ($cc, "-Wall", "-g", "-DJSW_RANK", "-o", "test-rank",
+          "-I../jsw_rbtree", "-I../jsw_avltree", "-I../jsw_alloc",
+          "../jsw_rbtree/jsw_rbtree.c", "../jsw_avltree/jsw_avltree.c",
+          "../jsw_alloc/jsw_alloc.c", "test-rank.c");
+
+# Traversal objects for the skip list and hash table
+mysystem ($cc, "-Wall", "-g", "-o", "test-trav", "-I../jsw_slib",
+          "-I../jsw_hlib", "-I../jsw_rand", "-I../jsw_alloc",
+          "../jsw_slib/jsw_slib.c", "../jsw_hlib/jsw_hlib.c",
+          "../jsw_rand/jsw_rand.c", "../jsw_alloc/jsw_alloc.c", "test-trav.c");
+
+# Batch lookups, checked against single lookups
+my @batched = qw(rbtree hlib slib);
+mysystem ($cc, "-Wall", "-g", "-o", "test-find-many",
+          (map { "-I../jsw_$_" } @batched), "-I../jsw_rand", "-I../jsw_alloc",
+          (map { "../jsw_$_/jsw_$_.c" } @batched), "../jsw_rand/jsw_rand.c",
+          "../jsw_alloc/jsw_alloc.c", "test-find-many.c", "test-slib-ops.c");
+
+# Hot path counters, compiled in with JSW_STATS
+my @counted = qw(rbtree avltree atree hlib slib);
+mysystem ($cc, "-Wall", "-g", "-DJSW_STATS", "-o", "test-stats",
+          (map { "-I../jsw_$_" } @counted), "-I../jsw_rand", "-I../jsw_alloc",
+          (map { "../jsw_$_/jsw_$_.c" } @counted), "../jsw_rand/jsw_rand.c",
+          "../jsw_alloc/jsw_alloc.c", "test-stats.c", "test-slib-ops.c");
+
+# Snapshots of a red black tree, mapped back in
+mysystem ($cc, "-Wall", "-g", "-o", "test-snap", "-I../jsw_rbtree",
+          "-I../jsw_snap", "-I../jsw_alloc", "../jsw_rbtree/jsw_rbtree.c",
+          "../jsw_snap/jsw_snap.c", "../jsw_alloc/jsw_alloc.c", "test-snap.c");
+
+# Frozen search arrays, made from each balanced tree
+my @frozen = qw(rbtree avltree atree frozen);
+mysystem ($cc, "-Wall", "-g", "-o", "test-frozen",
+          (map { "-I../jsw_$_" } @frozen), "-I../jsw_alloc",
+          (map { "../jsw_$_/jsw_$_.c" } @frozen),
+          "../jsw_alloc/jsw_alloc.c", "test-frozen.c");
+
+# Clearing for reuse, with and without a purge hook
+my @cleared = qw(rbtree avltree atree hlib slib);
+mysystem ($cc, "-Wall", "-g", "-o", "test-clear",
+          (map { "-I../jsw_$_" } @cleared), "-I../jsw_rand", "-I../jsw_alloc",
+          (map { "../jsw_$_/jsw_$_.c" } @cleared), "../jsw_rand/jsw_rand.c",
+          "../jsw_alloc/jsw_alloc.c", "test-clear.c", "test-slib-ops.c");
+
+# Lookups by a precomputed hash and a probe of another type
+mysystem ($cc, "-Wall", "-g", "-o", "test-hashed", "-I../jsw_hlib",
+          "-I../jsw_alloc", "../jsw_hlib/jsw_hlib.c", "../jsw_alloc/jsw_alloc.c",
+          "test-hashed.c");
+
+# Short keys stored inside hash table nodes
+mysystem ($cc, "-Wall", "-g", "-o", "test-inline", "-I../jsw_hlib",
+          "-I../jsw_alloc", "../jsw_hlib/jsw_hlib.c", "../jsw_alloc/jsw_alloc.c",
+          "test-inline.c");
+
+# Bulk loads and resizes on the hash table, forked onto threads
+mysystem ($cc, "-Wall", "-g", "-pthread", "-o", "test-bulk", "-I../jsw_hlib",
+          "-I../jsw_alloc", "../jsw_hlib/jsw_hlib.c",
+          "../jsw_alloc/jsw_alloc.c", "test-bulk.c");
+
+# Set operations on both join-based trees, also with subtree counts
+foreach my $variant (["test-setops"], ["test-setops-rank", "-DJSW_RANK"]) {
+    my ($name, @defs) = @$variant;
+    mysystem ($cc, "-Wall", "-g", @defs, "-pthread", "-o", $name,
+              "-I../jsw_rbtree", "-I../jsw_avltree", "-I../jsw_alloc",
+              "../jsw_rbtree/jsw_rbtree.c", "../jsw_avltree/jsw_avltree.c",
+              "../jsw_alloc/jsw_alloc.c", "test-setops.c");
+}
+
+# Concurrent skip list, hammered from several threads
+mysystem ($cc, "-Wall", "-g", "-pthread", "-o", "test-cslib-mt",
+          "-I../jsw_cslib", "-I../jsw_rand", "../jsw_cslib/jsw_cslib.c",
+          "../jsw_rand/jsw_rand.c", "test-cslib-mt.c");
+
+# Persistent red black tree, read while one thread publishes
+mysystem ($cc, "-Wall", "-g", "-pthread", "-o", "test-prbtree-mt",
+          "-I../jsw_prbtree", "../jsw_prbtree/jsw_prbtree.c",
+          "test-prbtree-mt.c");
+
+# Concurrent hash table, resized while threads use it
+mysystem ($cc, "-Wall", "-g", "-pthread", "-o", "test-chlib-mt",
+          "-I../jsw_chlib", "-I../jsw_hlib", "-I../jsw_alloc",
+          "../jsw_chlib/jsw_chlib.c", "test-chlib-mt.c");
+
+# Header-only C++ templates, with test-main.c built as C++
+foreach my $lib (qw(rbtree hlib)) {
+    mysystem ($cxx, "-Wall", "-g", "-o", "test-$lib-cpp", "-I../jsw_$lib",
+              "test-$lib-cpp.cpp", "-x", "c++", "test-main.c");
+}
+
 my $seed = int (rand (4294967296));
 
-foreach my $lib (@libs) {
-    my $testname = "test-$lib";
+foreach my $testname ((map { "test-$_" } @libs),
+                      "test-hlib-pool", "test-slib-pool", "test-rand",
+                      "test-rand-scalar", "test-intrusive",
+                      "test-intrusive-avltree", "test-intrusive-atree",
+                      "test-cmpcount", "test-build", "test-range",
+                      "test-rank", "test-trav", "test-find-many",
+                      "test-stats", "test-snap", "test-frozen", "test-clear",
+                      "test-setops", "test-setops-rank", "test-hashed",
+                      "test-inline", "test-bulk", "test-cslib-mt",
+                      "test-chlib-mt", "test-prbtree-mt", "test-rbtree-cpp",
+                      "test-hlib-cpp") {
     my @cmd = ($valgrind, "-q", "--error-exitcode=99",
                "--exit-on-first-error=yes", "--leak-check=yes",
                "./$testname", $seed);
@@ -0,0 +1,61 @@
+/*
+  Test for jsw-lib B+trees
+
+    > Created (agent): October 14, 2026
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "jsw_btree.h"
+#include "test-containers.h"
+
+void *new_container (void)
+{
+    return jsw_bnew ((cmp_f) strcmp, (dup_f) strdup, (rel_f) free);
+}
+
+void delete_container (void *c)
+{
+    jsw_bdelete ((jsw_btree_t *) c);
+}
+
+bool insert_item (void *c, const char *item)
+{
+    return (0 != jsw_binsert ((jsw_btree_t *) c, (void *) item));
+}
+
+bool remove_item (void *c, const char *item)
+{
+    return (0 != jsw_berase ((jsw_btree_t *) c, (void *) item));
+}
+
+bool lookup_item (void *c, const char *item)
+{
+    return (NULL != jsw_bfind ((jsw_btree_t *) c, (void *) item));
+}
+
+bool resize_container (void *c)
+{
+    return true;
+}
+
+const char *test_name (void)
+{
+    return "test-btree";
+}
+
+void set_seed (unsigned seed)
+{
+}
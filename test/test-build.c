@@ -0,0 +1,554 @@
+/*
+  Building jsw-lib balanced trees from sorted input
+
+    > Created (agent): October 14, 2026
+
+  For every size from 0 up to a few hundred, and some
+  larger ones around powers of two, builds a red black,
+  AVL and AA tree from sorted items and checks the size,
+  the order and the shape: red black heights and colors,
+  AVL balance factors and AA levels. Building into a tree
+  that isn't empty, or from items out of order or with a
+  repeated key, has to fail and leave the tree alone. The
+  built tree then takes random inserts and erases, which
+  must keep it balanced. Items are intrusive, so the test
+  can find each tree's root and walk its nodes.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "jsw_rbtree.h"
+#include "jsw_avltree.h"
+#include "jsw_atree.h"
+
+#define N_SMALL 300
+#define N_MAX   4097
+#define N_ITEMS ( 2 * N_MAX + 2 )
+
+static const char green[] = "\033[32m";
+static const char off[]   = "\033[0m";
+
+/* The key comes first, so a pointer to one is a search key */
+typedef struct item {
+    int           key;
+    jsw_rbnode_t  rb;
+    jsw_avlnode_t avl;
+    jsw_anode_t   aa;
+} item_t;
+
+/* Key k is items[k]; builds take the even keys, inserts any up to 2n+1 */
+static item_t items[N_ITEMS];
+static void *sorted[N_MAX];
+static void *spare[N_MAX];
+static void *input[N_MAX];
+static char in[N_ITEMS];
+static char child[N_ITEMS];
+static item_t *order[N_ITEMS];
+
+static int item_cmp (const void *a, const void *b)
+{
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+
+    return (x > y) - (x < y);
+}
+
+typedef struct build_ops {
+    const char *name;
+    void       *(*create) (void);
+    int         (*build) (void *t, void **items, size_t n);
+    int         (*insert) (void *t, item_t *it);
+    int         (*erase) (void *t, item_t *it);
+    size_t      (*size) (void *t);
+    size_t      (*walk) (void *t, item_t **out);
+    int         (*shape) (item_t *root);
+    item_t     *(*left) (item_t *it);
+    item_t     *(*right) (item_t *it);
+    void        (*destroy) (void *t);
+} build_ops_t;
+
+/* The item in order that no other item has as a child */
+static item_t *find_root (const build_ops_t *ops, item_t **walk, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        child[walk[i] - items] = 0;
+    }
+
+    for (i = 0; i < n; i++) {
+        if (ops->left (walk[i]) != NULL) {
+            child[ops->left (walk[i]) - items] = 1;
+        }
+        if (ops->right (walk[i]) != NULL) {
+            child[ops->right (walk[i]) - items] = 1;
+        }
+    }
+
+    for (i = 0; i < n; i++) {
+        if (! child[walk[i] - items]) {
+            return walk[i];
+        }
+    }
+
+    return NULL;
+}
+
+static item_t *rb_item (jsw_rbnode_t *node)
+{
+    return node == NULL ? NULL : node->data;
+}
+
+static void *rb_create (void)
+{
+    return jsw_rbnew_intrusive (item_cmp, NULL, offsetof (item_t, rb));
+}
+
+static int rb_build (void *t, void **items, size_t n)
+{
+    return jsw_rbbuild (t, items, n);
+}
+
+static int rb_insert (void *t, item_t *it)
+{
+    return jsw_rbinsert (t, it);
+}
+
+static int rb_erase (void *t, item_t *it)
+{
+    return jsw_rberase (t, it);
+}
+
+static size_t rb_size (void *t)
+{
+    return jsw_rbsize (t);
+}
+
+static size_t rb_walk (void *t, item_t **out)
+{
+    jsw_rbtrav_t *trav = jsw_rbtnew ();
+    size_t n = 0;
+    item_t *it;
+
+    for (it = jsw_rbtfirst (trav, t); it != NULL; it = jsw_rbtnext (trav)) {
+        out[n++] = it;
+    }
+
+    jsw_rbtdelete (trav);
+
+    return n;
+}
+
+static item_t *rb_left (item_t *it)
+{
+    return rb_item (it->rb.link[0]);
+}
+
+static item_t *rb_right (item_t *it)
+{
+    return rb_item (it->rb.link[1]);
+}
+
+/* Black height, or -1 if the subtree isn't a red black tree */
+static int rb_height (jsw_rbnode_t *node)
+{
+    int l, r;
+
+    if (node == NULL) {
+        return 0;
+    }
+
+    if (node->red && ((node->link[0] != NULL && node->link[0]->red)
+                      || (node->link[1] != NULL && node->link[1]->red))) {
+        return -1;
+    }
+
+    l = rb_height (node->link[0]);
+    r = rb_height (node->link[1]);
+
+    if (l < 0 || l != r) {
+        return -1;
+    }
+
+    return l + ! node->red;
+}
+
+static int rb_shape (item_t *root)
+{
+    return ! root->rb.red && rb_height (&root->rb) >= 0;
+}
+
+static void rb_destroy (void *t)
+{
+    jsw_rbdelete (t);
+}
+
+static item_t *avl_item (jsw_avlnode_t *node)
+{
+    return node == NULL ? NULL : node->data;
+}
+
+static void *avl_create (void)
+{
+    return jsw_avlnew_intrusive (item_cmp, NULL, offsetof (item_t, avl));
+}
+
+static int avl_build (void *t, void **items, size_t n)
+{
+    return jsw_avlbuild (t, items, n);
+}
+
+static int avl_insert (void *t, item_t *it)
+{
+    return jsw_avlinsert (t, it);
+}
+
+static int avl_erase (void *t, item_t *it)
+{
+    return jsw_avlerase (t, it);
+}
+
+static size_t avl_size (void *t)
+{
+    return jsw_avlsize (t);
+}
+
+static size_t avl_walk (void *t, item_t **out)
+{
+    jsw_avltrav_t *trav = jsw_avltnew ();
+    size_t n = 0;
+    item_t *it;
+
+    for (it = jsw_avltfirst (trav, t); it != NULL; it = jsw_avltnext (trav)) {
+        out[n++] = it;
+    }
+
+    jsw_avltdelete (trav);
+
+    return n;
+}
+
+static item_t *avl_left (item_t *it)
+{
+    return avl_item (it->avl.link[0]);
+}
+
+static item_t *avl_right (item_t *it)
+{
+    return avl_item (it->avl.link[1]);
+}
+
+/* Height, or -1 if the subtree isn't an AVL tree */
+static int avl_height (jsw_avlnode_t *node)
+{
+    int l, r;
+
+    if (node == NULL) {
+        return 0;
+    }
+
+    l = avl_height (node->link[0]);
+    r = avl_height (node->link[1]);
+
+    if (l < 0 || r < 0 || node->balance != r - l
+        || node->balance < -1 || node->balance > 1) {
+        return -1;
+    }
+
+    return 1 + (l > r ? l : r);
+}
+
+static int avl_shape (item_t *root)
+{
+    return avl_height (&root->avl) >= 0;
+}
+
+static void avl_destroy (void *t)
+{
+    jsw_avldelete (t);
+}
+
+/* The end of tree sentinel is the only node at level 0 */
+static item_t *aa_item (jsw_anode_t *node)
+{
+    return node->level == 0 ? NULL : node->data;
+}
+
+static void *aa_create (void)
+{
+    return jsw_anew_intrusive (item_cmp, NULL, offsetof (item_t, aa));
+}
+
+static int aa_build (void *t, void **items, size_t n)
+{
+    return jsw_abuild (t, items, n);
+}
+
+static int aa_insert (void *t, item_t *it)
+{
+    return jsw_ainsert (t, it);
+}
+
+static int aa_erase (void *t, item_t *it)
+{
+    return jsw_aerase (t, it);
+}
+
+static size_t aa_size (void *t)
+{
+    return jsw_asize (t);
+}
+
+static size_t aa_walk (void *t, item_t **out)
+{
+    jsw_atrav_t *trav = jsw_atnew ();
+    size_t n = 0;
+    item_t *it;
+
+    for (it = jsw_atfirst (trav, t); it != NULL; it = jsw_atnext (trav)) {
+        out[n++] = it;
+    }
+
+    jsw_atdelete (trav);
+
+    return n;
+}
+
+static item_t *aa_left (item_t *it)
+{
+    return aa_item (it->aa.link[0]);
+}
+
+static item_t *aa_right (item_t *it)
+{
+    return aa_item (it->aa.link[1]);
+}
+
+/*
+  Leaves are at level 1, a left child is one level down,
+  a right child is at most one down and never has a right
+  child on the same level as its parent
+*/
+static int aa_level (jsw_anode_t *node)
+{
+    jsw_anode_t *l, *r;
+
+    if (node->level == 0) {
+        return 1;
+    }
+
+    l = node->link[0];
+    r = node->link[1];
+
+    if ((l->level == 0 && r->level == 0 && node->level != 1)
+        || l->level != node->level - 1
+        || (r->level != node->level && r->level != node->level - 1)
+        || (r->level != 0 && r->link[1]->level == node->level)) {
+        return 0;
+    }
+
+    return aa_level (l) && aa_level (r);
+}
+
+static int aa_shape (item_t *root)
+{
+    return aa_level (&root->aa);
+}
+
+static void aa_destroy (void *t)
+{
+    jsw_adelete (t);
+}
+
+static const build_ops_t rb_build_ops = {
+    "rbtree", rb_create, rb_build, rb_insert, rb_erase, rb_size, rb_walk,
+    rb_shape, rb_left, rb_right, rb_destroy
+};
+
+static const build_ops_t avl_build_ops = {
+    "avltree", avl_create, avl_build, avl_insert, avl_erase, avl_size,
+    avl_walk, avl_shape, avl_left, avl_right, avl_destroy
+};
+
+static const build_ops_t aa_build_ops = {
+    "atree", aa_create, aa_build, aa_insert, aa_erase, aa_size, aa_walk,
+    aa_shape, aa_left, aa_right, aa_destroy
+};
+
+/* The tree holds exactly the keys marked in, in order and balanced */
+static int check_tree (const build_ops_t *ops, void *t, size_t n,
+                       const char *what)
+{
+    size_t got = ops->walk (t, order);
+    size_t i = 0;
+    int k;
+
+    for (k = 0; k < N_ITEMS; k++) {
+        if (in[k] && (i == got || order[i++] != &items[k])) {
+            break;
+        }
+    }
+
+    if (k < N_ITEMS || got != i || ops->size (t) != got) {
+        fprintf (stderr, "test-build: %s %s of %lu has the wrong items\n",
+                 ops->name, what, (unsigned long) n);
+        return 0;
+    }
+
+    if (got > 0 && ! ops->shape (find_root (ops, order, got))) {
+        fprintf (stderr, "test-build: %s %s of %lu is out of balance\n",
+                 ops->name, what, (unsigned long) n);
+        return 0;
+    }
+
+    return 1;
+}
+
+/* Build rejections never change the tree they were given */
+static int check_rejects (const build_ops_t *ops, void *t, size_t n)
+{
+    void *empty = ops->create ();
+    void *save;
+    int ok = 1;
+
+    if (empty == NULL) {
+        return 0;
+    }
+
+    if (n > 0) {
+        ok &= ! ops->build (t, sorted, n) && ! ops->build (t, sorted, 1);
+    }
+
+    if (n > 1) {
+        memcpy (input, sorted, n * sizeof *input);
+        save = input[n / 2];
+        input[n / 2] = input[n / 2 - 1];
+        input[n / 2 - 1] = save;
+        ok &= ! ops->build (empty, input, n) && ops->size (empty) == 0;
+
+        input[n / 2 - 1] = input[n / 2];
+        ok &= ! ops->build (empty, input, n) && ops->size (empty) == 0;
+    }
+
+    /* Still empty, so a good build goes through, on nodes t isn't using */
+    ok &= ops->build (empty, spare, n) && ops->size (empty) == n;
+    ops->destroy (empty);
+
+    if (! ok) {
+        fprintf (stderr, "test-build: %s took bad input at %lu\n", ops->name,
+                 (unsigned long) n);
+    }
+
+    return ok && check_tree (ops, t, n, "rejected build");
+}
+
+static int check (const build_ops_t *ops, size_t n)
+{
+    void *t = ops->create ();
+    size_t i, steps = n / 2 + 16;
+
+    if (t == NULL) {
+        fprintf (stderr, "test-build: failed to make a %s\n", ops->name);
+        return 0;
+    }
+
+    memset (in, 0, sizeof in);
+
+    for (i = 0; i < n; i++) {
+        in[2 * i] = 1;
+    }
+
+    if (! ops->build (t, sorted, n)) {
+        fprintf (stderr, "test-build: %s build of %lu failed\n", ops->name,
+                 (unsigned long) n);
+        return 0;
+    }
+
+    if (! check_tree (ops, t, n, "build") || ! check_rejects (ops, t, n)) {
+        return 0;
+    }
+
+    /* Toggle random keys, even ones from the build and odd ones not */
+    for (i = 0; i < steps; i++) {
+        int k = rand() % (int) (2 * n + 2);
+        int ok = in[k] ? ops->erase (t, &items[k])
+                       : ops->insert (t, &items[k]);
+
+        in[k] = ! in[k];
+
+        if (! ok || ((i % 16 == 15 || i == steps - 1)
+                     && ! check_tree (ops, t, n, "update"))) {
+            fprintf (stderr, "test-build: %s update %lu of %lu went wrong\n",
+                     ops->name, (unsigned long) i, (unsigned long) n);
+            return 0;
+        }
+    }
+
+    ops->destroy (t);
+
+    return 1;
+}
+
+int main (int argc, char **argv)
+{
+    static const build_ops_t *trees[] = {
+        &rb_build_ops, &avl_build_ops, &aa_build_ops
+    };
+    static const size_t large[] = {
+        511, 512, 513, 1000, 1023, 1024, 1025, 4095, 4096, N_MAX
+    };
+    unsigned seed;
+    size_t n, j, t;
+    int k, ok = 1;
+
+    if (argc < 2) {
+        seed = (unsigned) time(NULL);
+    } else {
+        seed = (unsigned) strtoul(argv[1], NULL, 0);
+    }
+
+    printf ("test-build: seed = %u\n", seed);
+    srand (seed);
+
+    for (k = 0; k < N_ITEMS; k++) {
+        items[k].key = k;
+    }
+
+    for (k = 0; k < N_MAX; k++) {
+        sorted[k] = &items[2 * k];
+        spare[k] = &items[2 * k + 1];
+    }
+
+    for (t = 0; t < sizeof trees / sizeof trees[0]; t++) {
+        for (n = 0; n <= N_SMALL && ok; n++) {
+            ok &= check (trees[t], n);
+        }
+
+        for (j = 0; j < sizeof large / sizeof large[0] && ok; j++) {
+            ok &= check (trees[t], large[j]);
+        }
+    }
+
+    if (! ok) {
+        return 2;
+    }
+
+    printf ("test-build: %sPASS%s\n", green, off);
+
+    return 0;
+}
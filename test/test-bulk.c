@@ -0,0 +1,302 @@
+/*
+  Bulk loads and forked resizes of jsw-lib hash tables
+
+    > Created (agent): October 14, 2026
+
+  Loads a shuffled input with repeated keys into a table
+  that already holds some of them, through jsw_hbulk_insert
+  with and without a fork hook that runs halves on new
+  threads, and checks that the table ends up as calls to
+  jsw_hinsert in input order would leave it. Then resizes
+  it both ways with jsw_hresize_fork, and makes the heads
+  of a resize and the nodes of a load run out, which must
+  leave every key where it was. Nodes come from counting
+  hooks that are safe to call from several threads, so a
+  leak or a double release shows up in the count.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "jsw_hlib.h"
+
+#define N_KEYS  20000
+#define N_INPUT ( N_KEYS + N_KEYS / 4 )
+#define N_EXTRA 2000
+
+static const char green[] = "\033[32m";
+static const char off[]   = "\033[0m";
+
+static int keys[N_KEYS + N_EXTRA];
+static int values[N_INPUT + N_KEYS];
+
+/* Input for a load, and the item each key should end up with */
+static void *in_keys[N_INPUT];
+static void *in_items[N_INPUT];
+static void *want[N_KEYS];
+
+/* Blocks the hooks have out, and how many more they may give */
+static atomic_long live;
+static atomic_long budget;
+
+static unsigned int_hash (const void *key)
+{
+    return (unsigned) *(const int *) key;
+}
+
+static int int_cmp (const void *a, const void *b)
+{
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+
+    return (x > y) - (x < y);
+}
+
+static void *identity (const void *p)
+{
+    return (void *) p;
+}
+
+static void *count_alloc (void *ctx, size_t size)
+{
+    void *p;
+
+    if (atomic_fetch_sub (&budget, 1) <= 0) {
+        atomic_fetch_add (&budget, 1);
+        return NULL;
+    }
+
+    p = malloc (size);
+    if (p != NULL) {
+        atomic_fetch_add (&live, 1);
+    }
+
+    return p;
+}
+
+static void count_release (void *ctx, void *p, size_t size)
+{
+    atomic_fetch_sub (&live, 1);
+    atomic_fetch_add (&budget, 1);
+    free (p);
+}
+
+static const jsw_alloc_t counting = { count_alloc, count_release, NULL, NULL };
+
+/* Runs a in a new thread and b in this one */
+typedef struct job {
+    jsw_task_f  task;
+    void       *arg;
+} job_t;
+
+static void *run_job (void *arg)
+{
+    job_t *job = arg;
+
+    job->task (job->arg);
+
+    return NULL;
+}
+
+static void thread_fork (void *ctx, jsw_task_f task, void *a, void *b)
+{
+    job_t job = { task, a };
+    pthread_t thread;
+
+    if (pthread_create (&thread, NULL, run_job, &job) != 0) {
+        task (a);
+        task (b);
+        return;
+    }
+
+    task (b);
+    pthread_join (thread, NULL);
+}
+
+static const jsw_fork_t threads = { thread_fork, NULL, 3 };
+
+/* Every key has its expected item, and traversal sees each once */
+static int check_table (jsw_hash_t *htab, const char *what)
+{
+    size_t n = 0, present = 0;
+    int i;
+
+    for (i = 0; i < N_KEYS; i++) {
+        if (jsw_hfind (htab, &keys[i]) != want[i]) {
+            fprintf (stderr, "test-bulk: %s: key %d has the wrong item\n",
+                     what, i);
+            return 0;
+        }
+        present += want[i] != NULL;
+    }
+
+    for (jsw_hreset (htab); jsw_hitem (htab) != NULL; jsw_hnext (htab)) {
+        n++;
+    }
+
+    if (n != jsw_hsize (htab) || n < present) {
+        fprintf (stderr, "test-bulk: %s: traversed %lu of %lu items\n", what,
+                 (unsigned long) n, (unsigned long) jsw_hsize (htab));
+        return 0;
+    }
+
+    return 1;
+}
+
+static int check (unsigned flags, size_t step, const jsw_fork_t *fork)
+{
+    jsw_hash_t *htab = jsw_hnew_alloc (17, flags, int_hash, int_cmp, identity,
+                                       identity, NULL, NULL, &counting);
+    size_t expect = 0, got, before, cap;
+    int i, k;
+
+    if (htab == NULL || ! jsw_hgrowth (htab, 1.0, step)) {
+        fprintf (stderr, "test-bulk: failed to make a table\n");
+        return 0;
+    }
+
+    /* Every eighth key is in the table before the load */
+    for (i = 0; i < N_KEYS; i++) {
+        want[i] = NULL;
+    }
+
+    for (i = 0; i < N_KEYS; i += 8) {
+        want[i] = &values[N_INPUT + i];
+        if (! jsw_hinsert (htab, &keys[i], want[i])) {
+            fprintf (stderr, "test-bulk: failed to insert %d\n", i);
+            return 0;
+        }
+    }
+
+    /* The first time a key comes up in the input wins */
+    for (i = 0; i < N_INPUT; i++) {
+        k = i < N_KEYS ? i : rand () % N_KEYS;
+        in_keys[i] = &keys[k];
+        in_items[i] = &values[i];
+    }
+
+    for (i = N_INPUT - 1; i > 0; i--) {
+        int j = rand () % (i + 1);
+        void *t = in_keys[i];
+
+        in_keys[i] = in_keys[j];
+        in_keys[j] = t;
+    }
+
+    for (i = 0; i < N_INPUT; i++) {
+        k = (int) ((int *) in_keys[i] - keys);
+
+        if (want[k] == NULL) {
+            want[k] = in_items[i];
+            expect++;
+        }
+    }
+
+    before = jsw_hsize (htab);
+    got = jsw_hbulk_insert (htab, in_keys, in_items, N_INPUT, fork);
+
+    if (got != expect || jsw_hsize (htab) != before + expect
+        || jsw_hcapacity (htab) < jsw_hsize (htab)
+        || ! check_table (htab, "load")) {
+        fprintf (stderr, "test-bulk: loaded %lu of %lu\n",
+                 (unsigned long) got, (unsigned long) expect);
+        return 0;
+    }
+
+    if (! jsw_hresize_fork (htab, jsw_hcapacity (htab) * 3, fork)
+        || ! check_table (htab, "grow")
+        || ! jsw_hresize_fork (htab, jsw_hcapacity (htab) / 8, fork)
+        || ! check_table (htab, "shrink")) {
+        return 0;
+    }
+
+    /* Run out of chain heads partway through a resize */
+    cap = jsw_hcapacity (htab);
+    atomic_store (&budget, 100);
+
+    if (jsw_hresize_fork (htab, cap * 4, fork)
+        || jsw_hcapacity (htab) != cap || ! check_table (htab, "undo")) {
+        fprintf (stderr, "test-bulk: resize without memory went wrong\n");
+        return 0;
+    }
+
+    /* Run out of nodes partway through a load of new keys */
+    for (i = 0; i < N_EXTRA; i++) {
+        in_keys[i] = &keys[N_KEYS + i];
+    }
+
+    before = jsw_hsize (htab);
+    atomic_store (&budget, N_EXTRA / 2);
+    got = jsw_hbulk_insert (htab, in_keys, in_items, N_EXTRA, fork);
+    atomic_store (&budget, 1L << 30);
+
+    for (i = 0, expect = 0; i < N_EXTRA; i++) {
+        expect += jsw_hfind (htab, &keys[N_KEYS + i]) != NULL;
+    }
+
+    if (got == 0 || got == N_EXTRA || got != expect
+        || jsw_hsize (htab) != before + got
+        || ! check_table (htab, "partial load")) {
+        fprintf (stderr, "test-bulk: partial load kept %lu, found %lu\n",
+                 (unsigned long) got, (unsigned long) expect);
+        return 0;
+    }
+
+    jsw_hdelete (htab);
+
+    if (atomic_load (&live) != 0) {
+        fprintf (stderr, "test-bulk: %ld blocks left\n", atomic_load (&live));
+        return 0;
+    }
+
+    return 1;
+}
+
+int main (int argc, char **argv)
+{
+    unsigned seed;
+    int i, ok = 1;
+
+    if (argc < 2) {
+        seed = (unsigned) time(NULL);
+    } else {
+        seed = (unsigned) strtoul(argv[1], NULL, 0);
+    }
+
+    printf ("test-bulk: seed = %u\n", seed);
+    srand (seed);
+
+    for (i = 0; i < N_KEYS + N_EXTRA; i++) {
+        keys[i] = i;
+    }
+
+    atomic_store (&budget, 1L << 30);
+
+    ok &= check (0, 0, NULL);
+    ok &= check (0, 0, &threads);
+    ok &= check (JSW_HPOW2, 0, &threads);
+    ok &= check (0, 4, &threads);
+    ok &= check (JSW_HPOW2, 4, &threads);
+
+    if (! ok) {
+        return 2;
+    }
+
+    printf ("test-bulk: %sPASS%s\n", green, off);
+
+    return 0;
+}
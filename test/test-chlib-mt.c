@@ -0,0 +1,238 @@
+/*
+  Threaded test for the jsw-lib concurrent hash table
+
+    > Created (agent): October 14, 2026
+
+  Writer threads insert and erase keys from a small
+  shared range while reader threads find them and a
+  resizer keeps changing the table size underneath.
+  Keys and items are heap copies that hold the key, so
+  a reader handed a released or mismatched item shows
+  it straight away. Afterwards the net count each writer
+  kept for every key has to match the table.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "jsw_chlib.h"
+
+#define N_WRITERS 4
+#define N_READERS 3
+#define N_KEYS    512
+#define N_OPS     20000
+
+static const char green[] = "\033[32m";
+static const char off[]   = "\033[0m";
+
+typedef struct worker {
+    jsw_chash_t  *htab;
+    unsigned long rng;
+    long          net[N_KEYS];
+    int           errors;
+} worker_t;
+
+static int keys[N_KEYS];
+static atomic_int writing;
+
+static unsigned int_hash (const void *key)
+{
+    /* Weak on purpose, the table mixes it */
+    return (unsigned) *(const int *) key;
+}
+
+static int int_cmp (const void *a, const void *b)
+{
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+
+    return (x > y) - (x < y);
+}
+
+static void *int_dup (const void *item)
+{
+    int *copy = malloc (sizeof *copy);
+
+    if (copy != NULL) {
+        *copy = *(const int *) item;
+    }
+
+    return copy;
+}
+
+static unsigned long next_rand (worker_t *w)
+{
+    w->rng ^= w->rng << 13;
+    w->rng ^= w->rng >> 7;
+    w->rng ^= w->rng << 17;
+
+    return w->rng;
+}
+
+static void *writer (void *arg)
+{
+    worker_t *w = arg;
+    int i;
+
+    for (i = 0; i < N_OPS; i++) {
+        int k = (int) (next_rand (w) % N_KEYS);
+
+        if (next_rand (w) & 1) {
+            if (jsw_chinsert (w->htab, &keys[k], &keys[k])) {
+                w->net[k]++;
+            }
+        } else {
+            if (jsw_cherase (w->htab, &keys[k])) {
+                w->net[k]--;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static void *reader (void *arg)
+{
+    worker_t *w = arg;
+
+    while (atomic_load (&writing)) {
+        int k = (int) (next_rand (w) % N_KEYS);
+        int *found = jsw_chfind (w->htab, &keys[k]);
+
+        if (found != NULL) {
+            if (*found != k) {
+                w->errors++;
+            }
+            free (found);
+        }
+    }
+
+    return NULL;
+}
+
+static void *resizer (void *arg)
+{
+    worker_t *w = arg;
+
+    while (atomic_load (&writing)) {
+        jsw_hstat_t *stat;
+
+        if (! jsw_chresize (w->htab, 1 + next_rand (w) % 2048)) {
+            w->errors++;
+        }
+
+        stat = jsw_chstat (w->htab);
+        if (stat != NULL) {
+            if (stat->lchain < stat->schain) {
+                w->errors++;
+            }
+            free (stat);
+        }
+    }
+
+    return NULL;
+}
+
+int main (int argc, char **argv)
+{
+    static worker_t w[N_WRITERS + N_READERS + 1];
+    pthread_t tids[N_WRITERS + N_READERS + 1];
+    int n = N_WRITERS + N_READERS + 1;
+    jsw_chash_t *htab;
+    size_t present = 0;
+    unsigned seed;
+    int i, k;
+
+    if (argc < 2) {
+        seed = (unsigned) time(NULL);
+    } else {
+        seed = (unsigned) strtoul(argv[1], NULL, 0);
+    }
+
+    printf ("test-chlib-mt: seed = %u\n", seed);
+
+    for (i = 0; i < N_KEYS; i++) {
+        keys[i] = i;
+    }
+
+    htab = jsw_chnew (1, 4, int_hash, int_cmp, int_dup, int_dup, free, free);
+    if (htab == NULL || ! jsw_chgrowth (htab, 0.75)) {
+        fprintf (stderr, "test-chlib-mt: failed to allocate table\n");
+        return 1;
+    }
+
+    for (i = 0; i < n; i++) {
+        w[i].htab = htab;
+        w[i].rng = seed * 2654435761UL + (unsigned long) i * 40503UL + 1;
+    }
+
+    atomic_store (&writing, 1);
+    for (i = 0; i < n; i++) {
+        void *(*fn) (void *) = i < N_WRITERS ? writer
+                             : i < N_WRITERS + N_READERS ? reader : resizer;
+
+        if (pthread_create (&tids[i], NULL, fn, &w[i]) != 0) {
+            fprintf (stderr, "test-chlib-mt: pthread_create failed\n");
+            return 1;
+        }
+    }
+
+    for (i = 0; i < N_WRITERS; i++) {
+        pthread_join (tids[i], NULL);
+    }
+    atomic_store (&writing, 0);
+    for (i = N_WRITERS; i < n; i++) {
+        pthread_join (tids[i], NULL);
+    }
+
+    for (i = 0; i < n; i++) {
+        if (w[i].errors != 0) {
+            fprintf (stderr, "test-chlib-mt: thread %d saw %d errors\n",
+                     i, w[i].errors);
+            return 2;
+        }
+    }
+
+    for (k = 0; k < N_KEYS; k++) {
+        long net = 0;
+        int *found = jsw_chfind (htab, &keys[k]);
+
+        for (i = 0; i < N_WRITERS; i++) {
+            net += w[i].net[k];
+        }
+
+        if (net != (found != NULL)) {
+            fprintf (stderr, "test-chlib-mt: key %d has net count %ld "
+                     "but is %s\n", k, net, found ? "present" : "missing");
+            return 2;
+        }
+        present += (found != NULL);
+        free (found);
+    }
+
+    if (jsw_chsize (htab) != present) {
+        fprintf (stderr, "test-chlib-mt: size %lu, expected %lu\n",
+                 (unsigned long) jsw_chsize (htab), (unsigned long) present);
+        return 2;
+    }
+
+    jsw_chdelete (htab);
+
+    printf ("test-chlib-mt: %sPASS%s\n", green, off);
+
+    return 0;
+}
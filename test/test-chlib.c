@@ -0,0 +1,93 @@
+/*
+  Test for the jsw-lib concurrent hash table, from one thread
+
+    > Created (agent): October 14, 2026
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "jsw_chlib.h"
+#include "test-containers.h"
+
+static int somewhere;
+
+static unsigned hashfunc (const void *key)
+{
+    /* FNV-1a hash function for NUL-terminated strings */
+    const unsigned char *p = key;
+    unsigned h = 2166136261;
+    int i;
+
+    for (i = 0; p[i]; i++) {
+        h = (h ^ p[i]) * 16777619;
+    }
+
+    return h;
+}
+
+static void *identity (const void *item)
+{
+    return (void *) item;
+}
+
+void *new_container (void)
+{
+    jsw_chash_t *htab = jsw_chnew (16, 8, hashfunc, (cmp_f) strcmp,
+                                   (keydup_f) strdup, identity,
+                                   (keyrel_f) free, NULL);
+
+    /* Start small so that the test exercises growth */
+    if (htab != NULL && ! jsw_chgrowth (htab, 0.75)) {
+        jsw_chdelete (htab);
+        htab = NULL;
+    }
+
+    return htab;
+}
+
+void delete_container (void *c)
+{
+    jsw_chdelete ((jsw_chash_t *) c);
+}
+
+bool insert_item (void *c, const char *item)
+{
+    return (0 != jsw_chinsert ((jsw_chash_t *) c, (void *) item,
+                               (void *) &somewhere));
+}
+
+bool remove_item (void *c, const char *item)
+{
+    return (0 != jsw_cherase ((jsw_chash_t *) c, (void *) item));
+}
+
+bool lookup_item (void *c, const char *item)
+{
+    return (NULL != jsw_chfind ((jsw_chash_t *) c, (void *) item));
+}
+
+bool resize_container (void *c)
+{
+    return (0 != jsw_chresize ((jsw_chash_t *) c, 37619));
+}
+
+const char *test_name (void)
+{
+    return "test-chlib";
+}
+
+void set_seed (unsigned seed)
+{
+}
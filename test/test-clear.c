@@ -0,0 +1,448 @@
+/*
+  Clearing jsw-lib containers
+
+    > Created (agent): October 14, 2026
+
+  Each container is filled, cleared, checked to be empty,
+  filled again and deleted, three ways: with malloc and
+  items it owns, with a pool and items it owns, and with
+  a pool and items owned by the test (NULL rel). Its nodes
+  come through counting allocator hooks, so every node has
+  to go back one at a time without a purge hook, and none
+  may go back with one. Items are released exactly once
+  when the container owns them, and never otherwise.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "jsw_rbtree.h"
+#include "jsw_avltree.h"
+#include "jsw_atree.h"
+#include "jsw_hlib.h"
+#include "test-slib-ops.h"
+
+#define N_KEYS 2000
+
+typedef struct clear_ops {
+    const char  *name;
+    /* alloc may be NULL, owned means items are released by the test */
+    void        *(*create) (const jsw_alloc_t *alloc, int owned);
+    int          (*insert) (void *c, void *data);
+    void        *(*find) (void *c, void *data);
+    size_t       (*size) (void *c);
+    void         (*clear) (void *c);
+    void         (*destroy) (void *c);
+} clear_ops_t;
+
+static const char green[] = "\033[32m";
+static const char off[]   = "\033[0m";
+
+static int keys[N_KEYS];
+
+/* Every container releases items through this, so calls can be checked */
+static unsigned long rel_calls;
+
+/* What the counting hooks have seen */
+static unsigned long allocs, releases, purges;
+static jsw_alloc_t inner;
+
+static int int_cmp (const void *a, const void *b)
+{
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+
+    return (x > y) - (x < y);
+}
+
+static void counting_rel (void *item)
+{
+    ++rel_calls;
+}
+
+static void *count_alloc (void *ctx, size_t size)
+{
+    ++allocs;
+    return inner.alloc (inner.ctx, size);
+}
+
+static void count_release (void *ctx, void *p, size_t size)
+{
+    ++releases;
+    inner.release (inner.ctx, p, size);
+}
+
+static void count_purge (void *ctx)
+{
+    ++purges;
+    inner.purge (inner.ctx);
+}
+
+static void *std_alloc (void *ctx, size_t size)
+{
+    return malloc (size);
+}
+
+static void std_release (void *ctx, void *p, size_t size)
+{
+    free (p);
+}
+
+static unsigned int_hash (const void *key)
+{
+    return (unsigned) *(const int *) key;
+}
+
+static void *identity (void *item)
+{
+    return item;
+}
+
+static void *const_identity (const void *item)
+{
+    return (void *) item;
+}
+
+static void *rb_create (const jsw_alloc_t *alloc, int owned)
+{
+    return jsw_rbnew_alloc (int_cmp, identity,
+                            owned ? counting_rel : NULL, alloc);
+}
+
+static int rb_insert (void *c, void *data)
+{
+    return jsw_rbinsert (c, data);
+}
+
+static void *rb_find (void *c, void *data)
+{
+    return jsw_rbfind (c, data);
+}
+
+static size_t rb_size (void *c)
+{
+    return jsw_rbsize (c);
+}
+
+static void rb_clear (void *c)
+{
+    jsw_rbclear (c);
+}
+
+static void rb_destroy (void *c)
+{
+    jsw_rbdelete (c);
+}
+
+static void *avl_create (const jsw_alloc_t *alloc, int owned)
+{
+    return jsw_avlnew_alloc (int_cmp, identity,
+                             owned ? counting_rel : NULL, alloc);
+}
+
+static int avl_insert (void *c, void *data)
+{
+    return jsw_avlinsert (c, data);
+}
+
+static void *avl_find (void *c, void *data)
+{
+    return jsw_avlfind (c, data);
+}
+
+static size_t avl_size (void *c)
+{
+    return jsw_avlsize (c);
+}
+
+static void avl_clear (void *c)
+{
+    jsw_avlclear (c);
+}
+
+static void avl_destroy (void *c)
+{
+    jsw_avldelete (c);
+}
+
+static void *a_create (const jsw_alloc_t *alloc, int owned)
+{
+    return jsw_anew_alloc (int_cmp, identity,
+                           owned ? counting_rel : NULL, alloc);
+}
+
+static int a_insert (void *c, void *data)
+{
+    return jsw_ainsert (c, data);
+}
+
+static void *a_find (void *c, void *data)
+{
+    return jsw_afind (c, data);
+}
+
+static size_t a_size (void *c)
+{
+    return jsw_asize (c);
+}
+
+static void a_clear (void *c)
+{
+    jsw_aclear (c);
+}
+
+static void a_destroy (void *c)
+{
+    jsw_adelete (c);
+}
+
+/* Small and growing, so clearing also meets a resize in progress */
+static void *h_create (const jsw_alloc_t *alloc, int owned)
+{
+    jsw_hash_t *htab = jsw_hnew_alloc (7, 0, int_hash, int_cmp,
+                                       const_identity, const_identity,
+                                       NULL, owned ? counting_rel : NULL,
+                                       alloc);
+
+    if (htab != NULL && ! jsw_hgrowth (htab, 1.0, 1)) {
+        jsw_hdelete (htab);
+        htab = NULL;
+    }
+
+    return htab;
+}
+
+static int h_insert (void *c, void *data)
+{
+    return jsw_hinsert (c, data, data);
+}
+
+static void *h_find (void *c, void *data)
+{
+    return jsw_hfind (c, data);
+}
+
+static size_t h_size (void *c)
+{
+    return jsw_hsize (c);
+}
+
+static void h_clear (void *c)
+{
+    jsw_hclear (c);
+}
+
+static void h_destroy (void *c)
+{
+    jsw_hdelete (c);
+}
+
+static const clear_ops_t rb_clear_ops = {
+    "rbtree", rb_create, rb_insert, rb_find, rb_size, rb_clear, rb_destroy
+};
+
+static const clear_ops_t avl_clear_ops = {
+    "avltree", avl_create, avl_insert, avl_find, avl_size, avl_clear,
+    avl_destroy
+};
+
+static const clear_ops_t a_clear_ops = {
+    "atree", a_create, a_insert, a_find, a_size, a_clear, a_destroy
+};
+
+static const clear_ops_t hlib_clear_ops = {
+    "hlib", h_create, h_insert, h_find, h_size, h_clear, h_destroy
+};
+
+static void *s_create (const jsw_alloc_t *alloc, int owned)
+{
+    return slib_create (int_cmp, owned ? counting_rel : NULL, alloc);
+}
+
+static const clear_ops_t slib_clear_ops = {
+    "slib", s_create, slib_insert, slib_find, slib_size, slib_clear,
+    slib_destroy
+};
+
+static int fill (const clear_ops_t *ops, void *c, int n)
+{
+    int i;
+
+    for (i = 0; i < n; i++) {
+        if (! ops->insert (c, &keys[i])) {
+            fprintf (stderr, "test-clear: %s insert failed\n", ops->name);
+            return 0;
+        }
+    }
+
+    for (i = 0; i < N_KEYS; i++) {
+        if (ops->find (c, &keys[i]) != (i < n ? &keys[i] : NULL)) {
+            fprintf (stderr, "test-clear: %s wrong answer for %d\n",
+                     ops->name, keys[i]);
+            return 0;
+        }
+    }
+
+    if (ops->size (c) != (size_t) n) {
+        fprintf (stderr, "test-clear: %s has %lu items, not %d\n",
+                 ops->name, (unsigned long) ops->size (c), n);
+        return 0;
+    }
+
+    return 1;
+}
+
+static int check (const clear_ops_t *ops, jsw_pool_t *pool, int owned)
+{
+    const char *how = pool != NULL ? "pool" : "malloc";
+    unsigned long want = owned ? N_KEYS : 0;
+    unsigned long before;
+    jsw_alloc_t alloc;
+    void *c;
+
+    if (pool != NULL) {
+        jsw_poolhooks (pool, &inner);
+    } else {
+        inner.alloc = std_alloc;
+        inner.release = std_release;
+        inner.purge = NULL;
+        inner.ctx = NULL;
+    }
+
+    alloc.alloc = count_alloc;
+    alloc.release = count_release;
+    alloc.purge = pool != NULL ? count_purge : NULL;
+    alloc.ctx = NULL;
+
+    rel_calls = allocs = releases = purges = 0;
+
+    c = ops->create (&alloc, owned);
+    if (c == NULL) {
+        fprintf (stderr, "test-clear: failed to allocate %s\n", ops->name);
+        return 0;
+    }
+
+    if (! fill (ops, c, N_KEYS)) {
+        return 0;
+    }
+
+    /* A growing hash table gives some back while it moves buckets */
+    before = releases;
+    ops->clear (c);
+
+    if (rel_calls != want) {
+        fprintf (stderr, "test-clear: %s (%s) released %lu of %lu items\n",
+                 ops->name, how, rel_calls, want);
+        return 0;
+    }
+
+    /* Every node goes back one at a time, or all at once */
+    if (pool != NULL ? releases != before || purges != 1
+                     : releases != allocs) {
+        fprintf (stderr, "test-clear: %s (%s) released %lu of %lu nodes"
+                 " and purged %lu times\n", ops->name, how,
+                 releases - before, allocs, purges);
+        return 0;
+    }
+
+    /* Clearing an empty container changes nothing */
+    ops->clear (c);
+
+    if (! fill (ops, c, 0) || rel_calls != want) {
+        return 0;
+    }
+
+    if (! fill (ops, c, N_KEYS / 2)) {
+        return 0;
+    }
+
+    ops->destroy (c);
+    want += owned ? N_KEYS / 2 : 0;
+
+    if (rel_calls != want) {
+        fprintf (stderr, "test-clear: %s (%s) deleted %lu of %lu items\n",
+                 ops->name, how, rel_calls, want);
+        return 0;
+    }
+
+    if (pool == NULL && releases != allocs) {
+        fprintf (stderr, "test-clear: %s leaked %lu nodes\n",
+                 ops->name, allocs - releases);
+        return 0;
+    }
+
+    return 1;
+}
+
+static int check_all (const clear_ops_t *ops)
+{
+    jsw_pool_t *pool = jsw_poolnew (0);
+    int ok;
+
+    if (pool == NULL) {
+        fprintf (stderr, "test-clear: failed to allocate a pool\n");
+        return 0;
+    }
+
+    ok = check (ops, NULL, 1);
+    ok = ok && check (ops, pool, 1);
+    ok = ok && check (ops, pool, 0);
+
+    jsw_pooldelete (pool);
+
+    return ok;
+}
+
+int main (int argc, char **argv)
+{
+    unsigned seed;
+    int i, ok;
+
+    if (argc < 2) {
+        seed = (unsigned) time(NULL);
+    } else {
+        seed = (unsigned) strtoul(argv[1], NULL, 0);
+    }
+
+    printf ("test-clear: seed = %u\n", seed);
+    srand (seed);
+
+    for (i = 0; i < N_KEYS; i++) {
+        keys[i] = i;
+    }
+
+    /* Insert in random order, so the trees aren't all degenerate */
+    for (i = N_KEYS - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int save = keys[i];
+
+        keys[i] = keys[j];
+        keys[j] = save;
+    }
+
+    ok = check_all (&rb_clear_ops);
+    ok &= check_all (&avl_clear_ops);
+    ok &= check_all (&a_clear_ops);
+    ok &= check_all (&hlib_clear_ops);
+    ok &= check_all (&slib_clear_ops);
+
+    if (! ok) {
+        return 2;
+    }
+
+    printf ("test-clear: %sPASS%s\n", green, off);
+
+    return 0;
+}
@@ -0,0 +1,256 @@
+/*
+  Comparator call counts for jsw-lib balanced trees
+
+    > Created (agent): October 14, 2026
+
+  Inserts, finds and erases a shuffled set of string keys,
+  counting every call to the comparison function. Each tree
+  should compare once per level it walks, so the averages
+  are checked against just over log2(n).
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <math.h>
+#include <time.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "jsw_rbtree.h"
+#include "jsw_avltree.h"
+#include "jsw_atree.h"
+
+#define N_KEYS 4096
+
+static const char green[] = "\033[32m";
+static const char red[]   = "\033[31m";
+static const char off[]   = "\033[0m";
+
+static char keys[N_KEYS][12];
+static char *order[N_KEYS];
+static unsigned long ncmp;
+
+static int counting_cmp (const void *a, const void *b)
+{
+    ++ncmp;
+    return strcmp (a, b);
+}
+
+static void *identity (void *item)
+{
+    return item;
+}
+
+static void nop (void *item)
+{
+}
+
+typedef struct tree_ops {
+    const char *name;
+    void       *(*create) (void);
+    int         (*insert) (void *tree, void *data);
+    void       *(*find) (void *tree, void *data);
+    int         (*erase) (void *tree, void *data);
+    void        (*destroy) (void *tree);
+} tree_ops_t;
+
+static void *rb_create (void)
+{
+    return jsw_rbnew (counting_cmp, identity, nop);
+}
+
+static int rb_insert (void *tree, void *data)
+{
+    return jsw_rbinsert (tree, data);
+}
+
+static void *rb_find (void *tree, void *data)
+{
+    return jsw_rbfind (tree, data);
+}
+
+static int rb_erase (void *tree, void *data)
+{
+    return jsw_rberase (tree, data);
+}
+
+static void rb_destroy (void *tree)
+{
+    jsw_rbdelete (tree);
+}
+
+static void *avl_create (void)
+{
+    return jsw_avlnew (counting_cmp, identity, nop);
+}
+
+static int avl_insert (void *tree, void *data)
+{
+    return jsw_avlinsert (tree, data);
+}
+
+static void *avl_find (void *tree, void *data)
+{
+    return jsw_avlfind (tree, data);
+}
+
+static int avl_erase (void *tree, void *data)
+{
+    return jsw_avlerase (tree, data);
+}
+
+static void avl_destroy (void *tree)
+{
+    jsw_avldelete (tree);
+}
+
+static void *aa_create (void)
+{
+    return jsw_anew (counting_cmp, identity, nop);
+}
+
+static int aa_insert (void *tree, void *data)
+{
+    return jsw_ainsert (tree, data);
+}
+
+static void *aa_find (void *tree, void *data)
+{
+    return jsw_afind (tree, data);
+}
+
+static int aa_erase (void *tree, void *data)
+{
+    return jsw_aerase (tree, data);
+}
+
+static void aa_destroy (void *tree)
+{
+    jsw_adelete (tree);
+}
+
+static const tree_ops_t trees[] = {
+    { "rbtree", rb_create, rb_insert, rb_find, rb_erase, rb_destroy },
+    { "avltree", avl_create, avl_insert, avl_find, avl_erase, avl_destroy },
+    { "atree", aa_create, aa_insert, aa_find, aa_erase, aa_destroy },
+};
+
+static void shuffle (void)
+{
+    unsigned i;
+
+    for (i = N_KEYS - 1; i > 0; i--) {
+        unsigned j = ((unsigned) rand()) % (i + 1);
+        char *save = order[i];
+
+        order[i] = order[j];
+        order[j] = save;
+    }
+}
+
+static int check (const char *name, const char *op, double limit)
+{
+    double per_op = (double) ncmp / N_KEYS;
+    int ok = per_op <= limit;
+
+    printf ("test-cmpcount: %-8s %-6s %6.2f compares/op (limit %.2f)%s%s%s\n",
+            name, op, per_op, limit, ok ? "" : red,
+            ok ? "" : " too many", off);
+
+    return ok;
+}
+
+int main (int argc, char **argv)
+{
+    /*
+      Random balanced trees average about log2(n) levels, so
+      comparing twice per level on any path goes over this
+    */
+    double limit = log2 (N_KEYS) + 1.5;
+    unsigned seed, i, t;
+    int ok = 1;
+
+    if (argc < 2) {
+        seed = (unsigned) time(NULL);
+    } else {
+        seed = (unsigned) strtoul(argv[1], NULL, 0);
+    }
+
+    printf ("test-cmpcount: seed = %u\n", seed);
+    srand (seed);
+
+    for (i = 0; i < N_KEYS; i++) {
+        snprintf (keys[i], sizeof (keys[i]), "%u", i);
+        order[i] = keys[i];
+    }
+
+    for (t = 0; t < sizeof trees / sizeof trees[0]; t++) {
+        const tree_ops_t *ops = &trees[t];
+        void *tree = ops->create();
+
+        if (tree == NULL) {
+            fprintf (stderr, "test-cmpcount: failed to allocate %s\n",
+                     ops->name);
+            return 1;
+        }
+
+        shuffle();
+        ncmp = 0;
+        for (i = 0; i < N_KEYS; i++) {
+            if (! ops->insert (tree, order[i])) {
+                fprintf (stderr, "test-cmpcount: %s insert failed\n",
+                         ops->name);
+                return 2;
+            }
+        }
+        ok &= check (ops->name, "insert", limit);
+
+        shuffle();
+        ncmp = 0;
+        for (i = 0; i < N_KEYS; i++) {
+            if (ops->find (tree, order[i]) != order[i]) {
+                fprintf (stderr, "test-cmpcount: %s find failed\n",
+                         ops->name);
+                return 2;
+            }
+        }
+        ok &= check (ops->name, "find", limit);
+
+        shuffle();
+        ncmp = 0;
+        for (i = 0; i < N_KEYS; i++) {
+            if (! ops->erase (tree, order[i])) {
+                fprintf (stderr, "test-cmpcount: %s erase failed\n",
+                         ops->name);
+                return 2;
+            }
+        }
+        ok &= check (ops->name, "erase", limit);
+
+        if (ops->erase (tree, keys[0])) {
+            fprintf (stderr, "test-cmpcount: %s erased a missing key\n",
+                     ops->name);
+            return 2;
+        }
+
+        ops->destroy (tree);
+    }
+
+    if (! ok) {
+        return 3;
+    }
+
+    printf ("test-cmpcount: %sPASS%s\n", green, off);
+
+    return 0;
+}
@@ -0,0 +1,309 @@
+/*
+  Threaded test for the jsw-lib concurrent skip list
+
+    > Created (agent): October 14, 2026
+
+  Writer threads insert and erase keys from a small
+  shared range, so most calls race with another thread
+  on the same key, while reader threads look keys up and
+  walk the list. Each writer counts its own successful
+  inserts and erases, and afterwards the net count for
+  every key has to match what the list holds. Items are
+  heap copies, so a node released too early shows up
+  as a bad read under valgrind or a sanitizer.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "jsw_cslib.h"
+
+#define N_WRITERS 6
+#define N_READERS 2
+#define N_KEYS    256
+#define N_OPS     20000
+#define N_OWN     2000
+
+static const char green[] = "\033[32m";
+static const char off[]   = "\033[0m";
+
+typedef struct worker {
+    jsw_cskip_t  *skip;
+    unsigned long rng;
+    int           id;
+    long          net[N_KEYS];
+    int           errors;
+} worker_t;
+
+static int keys[N_KEYS + N_OWN * N_WRITERS];
+static atomic_int writing;
+
+static int int_cmp (const void *a, const void *b)
+{
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+
+    return (x > y) - (x < y);
+}
+
+static void *int_dup (const void *item)
+{
+    int *copy = malloc (sizeof *copy);
+
+    if (copy != NULL) {
+        *copy = *(const int *) item;
+    }
+
+    return copy;
+}
+
+static unsigned long next_rand (worker_t *w)
+{
+    w->rng ^= w->rng << 13;
+    w->rng ^= w->rng >> 7;
+    w->rng ^= w->rng << 17;
+
+    return w->rng;
+}
+
+static void *writer (void *arg)
+{
+    worker_t *w = arg;
+    jsw_csthread_t *thr = jsw_csattach (w->skip);
+    int i;
+
+    if (thr == NULL) {
+        w->errors++;
+        return NULL;
+    }
+
+    for (i = 0; i < N_OPS; i++) {
+        int k = (int) (next_rand (w) % N_KEYS);
+
+        if (next_rand (w) & 1) {
+            if (jsw_csinsert (thr, &keys[k])) {
+                w->net[k]++;
+            }
+        } else {
+            if (jsw_cserase (thr, &keys[k])) {
+                w->net[k]--;
+            }
+        }
+    }
+
+    jsw_csdetach (thr);
+
+    return NULL;
+}
+
+static void *reader (void *arg)
+{
+    worker_t *w = arg;
+    jsw_csthread_t *thr = jsw_csattach (w->skip);
+
+    if (thr == NULL) {
+        w->errors++;
+        return NULL;
+    }
+
+    while (atomic_load (&writing)) {
+        int k = (int) (next_rand (w) % N_KEYS);
+        int *found;
+        int last = -1;
+
+        /* A found item stays readable until the pin is dropped */
+        jsw_cspin (thr);
+        found = jsw_csfind (thr, &keys[k]);
+        if (found != NULL && *found != k) {
+            w->errors++;
+        }
+
+        for (jsw_csreset (thr); jsw_csitem (thr) != NULL; jsw_csnext (thr)) {
+            int key = *(int *) jsw_csitem (thr);
+
+            if (key <= last) {
+                w->errors++;
+            }
+            last = key;
+        }
+        jsw_csunpin (thr);
+    }
+
+    jsw_csdetach (thr);
+
+    return NULL;
+}
+
+/* Each writer inserts and then erases a range nobody else touches */
+static void *owner (void *arg)
+{
+    worker_t *w = arg;
+    jsw_csthread_t *thr = jsw_csattach (w->skip);
+    int base = N_KEYS + w->id * N_OWN;
+    int i;
+
+    if (thr == NULL) {
+        w->errors++;
+        return NULL;
+    }
+
+    for (i = 0; i < N_OWN; i++) {
+        if (! jsw_csinsert (thr, &keys[base + i])) {
+            w->errors++;
+        }
+    }
+
+    for (i = 0; i < N_OWN; i++) {
+        if (jsw_csfind (thr, &keys[base + i]) == NULL) {
+            w->errors++;
+        }
+    }
+
+    for (i = N_OWN - 1; i >= 0; i--) {
+        if (! jsw_cserase (thr, &keys[base + i])) {
+            w->errors++;
+        }
+    }
+
+    jsw_csdetach (thr);
+
+    return NULL;
+}
+
+static int run (pthread_t *tids, worker_t *w, int n, void *(*fn) (void *))
+{
+    int i;
+
+    for (i = 0; i < n; i++) {
+        if (pthread_create (&tids[i], NULL, fn, &w[i]) != 0) {
+            fprintf (stderr, "test-cslib-mt: pthread_create failed\n");
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+int main (int argc, char **argv)
+{
+    static worker_t w[N_WRITERS + N_READERS];
+    pthread_t tids[N_WRITERS + N_READERS];
+    jsw_cskip_t *skip;
+    jsw_csthread_t *thr;
+    size_t present = 0;
+    unsigned seed;
+    int i, k;
+
+    if (argc < 2) {
+        seed = (unsigned) time(NULL);
+    } else {
+        seed = (unsigned) strtoul(argv[1], NULL, 0);
+    }
+
+    printf ("test-cslib-mt: seed = %u\n", seed);
+
+    for (i = 0; i < (int) (sizeof keys / sizeof keys[0]); i++) {
+        keys[i] = i;
+    }
+
+    skip = jsw_csnew (16, int_cmp, int_dup, free);
+    if (skip == NULL) {
+        fprintf (stderr, "test-cslib-mt: failed to allocate list\n");
+        return 1;
+    }
+
+    for (i = 0; i < N_WRITERS + N_READERS; i++) {
+        w[i].skip = skip;
+        w[i].id = i;
+        w[i].rng = seed * 2654435761UL + (unsigned long) i * 40503UL + 1;
+    }
+
+    atomic_store (&writing, 1);
+    if (! run (tids, w, N_WRITERS, writer)
+        || ! run (tids + N_WRITERS, w + N_WRITERS, N_READERS, reader)) {
+        return 1;
+    }
+
+    for (i = 0; i < N_WRITERS; i++) {
+        pthread_join (tids[i], NULL);
+    }
+    atomic_store (&writing, 0);
+    for (i = N_WRITERS; i < N_WRITERS + N_READERS; i++) {
+        pthread_join (tids[i], NULL);
+    }
+
+    /* Every key went in and out some number of times */
+    thr = jsw_csattach (skip);
+    if (thr == NULL) {
+        fprintf (stderr, "test-cslib-mt: failed to attach\n");
+        return 1;
+    }
+
+    for (k = 0; k < N_KEYS; k++) {
+        long net = 0;
+        int *found = jsw_csfind (thr, &keys[k]);
+
+        for (i = 0; i < N_WRITERS; i++) {
+            net += w[i].net[k];
+        }
+
+        if (net != (found != NULL)) {
+            fprintf (stderr, "test-cslib-mt: key %d has net count %ld "
+                     "but is %s\n", k, net, found ? "present" : "missing");
+            return 2;
+        }
+        present += (found != NULL);
+    }
+
+    if (jsw_cssize (skip) != present) {
+        fprintf (stderr, "test-cslib-mt: size %lu, expected %lu\n",
+                 (unsigned long) jsw_cssize (skip), (unsigned long) present);
+        return 2;
+    }
+
+    jsw_csdetach (thr);
+
+    /* Disjoint ranges, where every call has to succeed */
+    if (! run (tids, w, N_WRITERS, owner)) {
+        return 1;
+    }
+
+    for (i = 0; i < N_WRITERS; i++) {
+        pthread_join (tids[i], NULL);
+    }
+
+    for (i = 0; i < N_WRITERS + N_READERS; i++) {
+        if (w[i].errors != 0) {
+            fprintf (stderr, "test-cslib-mt: thread %d saw %d errors\n",
+                     i, w[i].errors);
+            return 2;
+        }
+    }
+
+    if (jsw_cssize (skip) != present) {
+        fprintf (stderr, "test-cslib-mt: size %lu after owned ranges, "
+                 "expected %lu\n", (unsigned long) jsw_cssize (skip),
+                 (unsigned long) present);
+        return 2;
+    }
+
+    jsw_csdelete (skip);
+
+    printf ("test-cslib-mt: %sPASS%s\n", green, off);
+
+    return 0;
+}
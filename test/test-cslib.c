@@ -0,0 +1,81 @@
+/*
+  Test for the jsw-lib concurrent skip list, from one thread
+
+    > Created (agent): October 14, 2026
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "jsw_cslib.h"
+#include "test-containers.h"
+
+static jsw_csthread_t *thr;
+static unsigned level_seed;
+
+void *new_container (void)
+{
+    jsw_cskip_t *skip = jsw_csnew (12, (cmp_f) strcmp, (dup_f) strdup,
+                                   (rel_f) free);
+
+    if (skip == NULL) {
+        return NULL;
+    }
+
+    thr = jsw_csattach (skip);
+    if (thr == NULL) {
+        jsw_csdelete (skip);
+        return NULL;
+    }
+
+    jsw_csseed (thr, level_seed);
+
+    return skip;
+}
+
+void delete_container (void *c)
+{
+    jsw_csdetach (thr);
+    jsw_csdelete ((jsw_cskip_t *) c);
+}
+
+bool insert_item (void *c, const char *item)
+{
+    return (0 != jsw_csinsert (thr, (void *) item));
+}
+
+bool remove_item (void *c, const char *item)
+{
+    return (0 != jsw_cserase (thr, (void *) item));
+}
+
+bool lookup_item (void *c, const char *item)
+{
+    return (NULL != jsw_csfind (thr, (void *) item));
+}
+
+bool resize_container (void *c)
+{
+    return true;
+}
+
+const char *test_name (void)
+{
+    return "test-cslib";
+}
+
+void set_seed (unsigned seed)
+{
+    level_seed = seed;
+}
@@ -0,0 +1,250 @@
+/*
+  Batch lookups for jsw-lib containers
+
+    > Created (agent): October 14, 2026
+
+  Fills each container with the even numbers below
+  2 * N_KEYS in random order, then looks up random batches
+  of even and odd numbers with the batch entry point. Each
+  answer has to match a single lookup of the same key, and
+  the returned count has to match the number found. Batch
+  sizes run from zero up past several search groups.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "jsw_rbtree.h"
+#include "jsw_hlib.h"
+#include "test-slib-ops.h"
+
+#define N_KEYS  3000
+#define N_BATCH 100
+#define MAX_N   70
+
+static const char green[] = "\033[32m";
+static const char off[]   = "\033[0m";
+
+typedef struct find_ops {
+    const char *name;
+    void       *(*create) (void);
+    int         (*insert) (void *c, void *data);
+    void       *(*find) (void *c, void *data);
+    size_t      (*find_many) (void *c, void **data, size_t n, void **out);
+    void        (*destroy) (void *c);
+} find_ops_t;
+
+static int keys[2 * N_KEYS];
+
+static int int_cmp (const void *a, const void *b)
+{
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+
+    return (x > y) - (x < y);
+}
+
+static unsigned int_hash (const void *key)
+{
+    return (unsigned) *(const int *) key;
+}
+
+static void *identity (void *item)
+{
+    return item;
+}
+
+static void *const_identity (const void *item)
+{
+    return (void *) item;
+}
+
+static void nop (void *item)
+{
+}
+
+static void *rb_create (void)
+{
+    return jsw_rbnew (int_cmp, identity, nop);
+}
+
+static int rb_insert (void *c, void *data)
+{
+    return jsw_rbinsert (c, data);
+}
+
+static void *rb_find (void *c, void *data)
+{
+    return jsw_rbfind (c, data);
+}
+
+static size_t rb_find_many (void *c, void **data, size_t n, void **out)
+{
+    return jsw_rbfind_many (c, data, n, out);
+}
+
+static void rb_destroy (void *c)
+{
+    jsw_rbdelete (c);
+}
+
+/* Small and growing, so lookups also hit a resize in progress */
+static void *h_create (void)
+{
+    jsw_hash_t *htab = jsw_hnew (7, int_hash, int_cmp, const_identity,
+                                 const_identity, nop, nop);
+
+    if (htab != NULL && ! jsw_hgrowth (htab, 1.0, 1)) {
+        jsw_hdelete (htab);
+        htab = NULL;
+    }
+
+    return htab;
+}
+
+static int h_insert (void *c, void *data)
+{
+    return jsw_hinsert (c, data, data);
+}
+
+static void *h_find (void *c, void *data)
+{
+    return jsw_hfind (c, data);
+}
+
+static size_t h_find_many (void *c, void **data, size_t n, void **out)
+{
+    return jsw_hfind_many (c, data, n, out);
+}
+
+static void h_destroy (void *c)
+{
+    jsw_hdelete (c);
+}
+
+static const find_ops_t rb_find_ops = {
+    "rbtree", rb_create, rb_insert, rb_find, rb_find_many, rb_destroy
+};
+
+static const find_ops_t hlib_find_ops = {
+    "hlib", h_create, h_insert, h_find, h_find_many, h_destroy
+};
+
+static void *s_create (void)
+{
+    return slib_create (int_cmp, NULL, NULL);
+}
+
+static const find_ops_t slib_find_ops = {
+    "slib", s_create, slib_insert, slib_find, slib_find_many, slib_destroy
+};
+
+static int check (const find_ops_t *ops)
+{
+    void *c = ops->create();
+    void *batch[MAX_N];
+    void *out[MAX_N];
+    int order[N_KEYS];
+    int i, b;
+
+    if (c == NULL) {
+        fprintf (stderr, "test-find-many: failed to allocate %s\n",
+                 ops->name);
+        return 0;
+    }
+
+    for (i = 0; i < N_KEYS; i++) {
+        order[i] = 2 * i;
+    }
+
+    for (i = N_KEYS - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int save = order[i];
+
+        order[i] = order[j];
+        order[j] = save;
+    }
+
+    for (i = 0; i < N_KEYS; i++) {
+        if (! ops->insert (c, &keys[order[i]])) {
+            fprintf (stderr, "test-find-many: %s insert failed\n",
+                     ops->name);
+            return 0;
+        }
+    }
+
+    for (b = 0; b < N_BATCH; b++) {
+        size_t n = (size_t) (b < MAX_N ? b : rand() % MAX_N);
+        size_t found = 0, got;
+        size_t j;
+
+        for (j = 0; j < n; j++) {
+            batch[j] = &keys[rand() % (2 * N_KEYS)];
+            out[j] = &keys[0];
+        }
+
+        got = ops->find_many (c, batch, n, out);
+
+        for (j = 0; j < n; j++) {
+            if (out[j] != ops->find (c, batch[j])) {
+                fprintf (stderr, "test-find-many: %s wrong answer for %d\n",
+                         ops->name, *(int *) batch[j]);
+                return 0;
+            }
+            found += out[j] != NULL;
+        }
+
+        if (got != found) {
+            fprintf (stderr, "test-find-many: %s counted %lu of %lu\n",
+                     ops->name, (unsigned long) got, (unsigned long) found);
+            return 0;
+        }
+    }
+
+    ops->destroy (c);
+
+    return 1;
+}
+
+int main (int argc, char **argv)
+{
+    unsigned seed;
+    int i, ok;
+
+    if (argc < 2) {
+        seed = (unsigned) time(NULL);
+    } else {
+        seed = (unsigned) strtoul(argv[1], NULL, 0);
+    }
+
+    printf ("test-find-many: seed = %u\n", seed);
+    srand (seed);
+
+    for (i = 0; i < 2 * N_KEYS; i++) {
+        keys[i] = i;
+    }
+
+    ok = check (&rb_find_ops);
+    ok &= check (&hlib_find_ops);
+    ok &= check (&slib_find_ops);
+
+    if (! ok) {
+        return 2;
+    }
+
+    printf ("test-find-many: %sPASS%s\n", green, off);
+
+    return 0;
+}
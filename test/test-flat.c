@@ -0,0 +1,142 @@
+/*
+  Test for jsw-lib open addressing hash tables
+
+    > Created (agent): October 14, 2026
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "jsw_flat.h"
+#include "test-containers.h"
+
+static int somewhere;
+
+static unsigned hashfunc (const void *key)
+{
+    /* FNV-1a hash function for NUL-terminated strings */
+    const unsigned char *p = key;
+    unsigned h = 2166136261;
+    int i;
+
+    for (i = 0; p[i]; i++) {
+        h = (h ^ p[i]) * 16777619;
+    }
+
+    return h;
+}
+
+static void *identity (const void *item)
+{
+    return (void *) item;
+}
+
+static void nop (void *item)
+{
+}
+
+void *new_container (void)
+{
+    /* Start small so that the test exercises growth */
+    return jsw_fnew (10, hashfunc, (cmp_f) strcmp, (keydup_f) strdup,
+                     identity, (keyrel_f) free, nop);
+}
+
+void delete_container (void *c)
+{
+    jsw_fdelete ((jsw_flat_t *) c);
+}
+
+bool insert_item (void *c, const char *item)
+{
+    return (0 != jsw_finsert ((jsw_flat_t *) c, (void *) item,
+                              (void *) &somewhere));
+}
+
+bool remove_item (void *c, const char *item)
+{
+    return (0 != jsw_ferase ((jsw_flat_t *) c, (void *) item));
+}
+
+bool lookup_item (void *c, const char *item)
+{
+    return (NULL != jsw_ffind ((jsw_flat_t *) c, (void *) item));
+}
+
+/* The hash of an int key is the int itself */
+static unsigned int_hash (const void *key)
+{
+    return (unsigned) *(const int *) key;
+}
+
+static int int_cmp (const void *a, const void *b)
+{
+    return *(const int *) a - *(const int *) b;
+}
+
+/*
+  Hashes that differ only in their low bits must still get
+  homes of their own, so each of these keys sits in the
+  first group its probe looks at
+*/
+static bool check_spread (void)
+{
+    static int keys[900];
+    jsw_flat_t *ftab = jsw_fnew (1000, int_hash, int_cmp, identity,
+                                 identity, nop, nop);
+    jsw_fstat_t *stat;
+    bool ok;
+    int i;
+
+    if (ftab == NULL) {
+        return false;
+    }
+
+    for (i = 0; i < 900; i++) {
+        keys[i] = i;
+        if (! jsw_finsert (ftab, &keys[i], &somewhere)) {
+            jsw_fdelete (ftab);
+            return false;
+        }
+    }
+
+    stat = jsw_fstat (ftab);
+    ok = (stat != NULL && stat->lprobe == 1);
+
+    if (! ok) {
+        fprintf (stderr, "test-flat: consecutive hashes probe %lu groups\n",
+                 stat != NULL ? (unsigned long) stat->lprobe : 0UL);
+    }
+
+    free (stat);
+    jsw_fdelete (ftab);
+
+    return ok;
+}
+
+bool resize_container (void *c)
+{
+    return (check_spread ()
+            && 0 != jsw_fresize ((jsw_flat_t *) c, 37619));
+}
+
+const char *test_name (void)
+{
+    return "test-flat";
+}
+
+void set_seed (unsigned seed)
+{
+}
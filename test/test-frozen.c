@@ -0,0 +1,339 @@
+/*
+  Frozen search arrays made from jsw-lib trees
+
+    > Created (agent): October 14, 2026
+
+  Fills each balanced tree with a random set of even
+  numbers, copies it out with its traversal and freezes
+  the copy, for every size up to a few hundred and one
+  larger one, so that every shape of last level is seen.
+  In-order iteration has to match the traversal, and
+  find, the batch find, lower and upper have to agree
+  with the tree and the sorted copy for keys that are
+  there and keys that aren't.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "jsw_rbtree.h"
+#include "jsw_avltree.h"
+#include "jsw_atree.h"
+#include "jsw_frozen.h"
+
+#define MAX_SMALL 300
+#define N_LARGE   20000
+#define N_PROBES  200
+#define MAX_BATCH 40
+
+static const char green[] = "\033[32m";
+static const char off[]   = "\033[0m";
+
+typedef struct tree_ops {
+    const char *name;
+    void       *(*create) (void);
+    int         (*insert) (void *c, void *data);
+    void       *(*find) (void *c, void *data);
+    size_t      (*copy) (void *c, void **items);
+    void        (*destroy) (void *c);
+} tree_ops_t;
+
+static int keys[4 * N_LARGE + 2];
+
+static int int_cmp (const void *a, const void *b)
+{
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+
+    return (x > y) - (x < y);
+}
+
+static void *identity (void *item)
+{
+    return item;
+}
+
+static void nop (void *item)
+{
+}
+
+static void *rb_create (void)
+{
+    return jsw_rbnew (int_cmp, identity, nop);
+}
+
+static int rb_insert (void *c, void *data)
+{
+    return jsw_rbinsert (c, data);
+}
+
+static void *rb_find (void *c, void *data)
+{
+    return jsw_rbfind (c, data);
+}
+
+static size_t rb_copy (void *c, void **items)
+{
+    jsw_rbtrav_t *trav = jsw_rbtnew();
+    size_t n = 0;
+    void *it;
+
+    for (it = jsw_rbtfirst (trav, c); it != NULL; it = jsw_rbtnext (trav)) {
+        items[n++] = it;
+    }
+
+    jsw_rbtdelete (trav);
+    return n;
+}
+
+static void rb_destroy (void *c)
+{
+    jsw_rbdelete (c);
+}
+
+static void *avl_create (void)
+{
+    return jsw_avlnew (int_cmp, identity, nop);
+}
+
+static int avl_insert (void *c, void *data)
+{
+    return jsw_avlinsert (c, data);
+}
+
+static void *avl_find (void *c, void *data)
+{
+    return jsw_avlfind (c, data);
+}
+
+static size_t avl_copy (void *c, void **items)
+{
+    jsw_avltrav_t *trav = jsw_avltnew();
+    size_t n = 0;
+    void *it;
+
+    for (it = jsw_avltfirst (trav, c); it != NULL; it = jsw_avltnext (trav)) {
+        items[n++] = it;
+    }
+
+    jsw_avltdelete (trav);
+    return n;
+}
+
+static void avl_destroy (void *c)
+{
+    jsw_avldelete (c);
+}
+
+static void *a_create (void)
+{
+    return jsw_anew (int_cmp, identity, nop);
+}
+
+static int a_insert (void *c, void *data)
+{
+    return jsw_ainsert (c, data);
+}
+
+static void *a_find (void *c, void *data)
+{
+    return jsw_afind (c, data);
+}
+
+static size_t a_copy (void *c, void **items)
+{
+    jsw_atrav_t *trav = jsw_atnew();
+    size_t n = 0;
+    void *it;
+
+    for (it = jsw_atfirst (trav, c); it != NULL; it = jsw_atnext (trav)) {
+        items[n++] = it;
+    }
+
+    jsw_atdelete (trav);
+    return n;
+}
+
+static void a_destroy (void *c)
+{
+    jsw_adelete (c);
+}
+
+static const tree_ops_t tree_ops[] = {
+    { "rbtree", rb_create, rb_insert, rb_find, rb_copy, rb_destroy },
+    { "avltree", avl_create, avl_insert, avl_find, avl_copy, avl_destroy },
+    { "atree", a_create, a_insert, a_find, a_copy, a_destroy }
+};
+
+/* Index of the first copied item not less than key, by linear scan */
+static size_t lower_index (void **items, size_t n, int key)
+{
+    size_t i = 0;
+
+    while (i < n && *(int *) items[i] < key) {
+        ++i;
+    }
+
+    return i;
+}
+
+static int check (const tree_ops_t *ops, size_t size)
+{
+    void *c = ops->create();
+    void **items = malloc ((size + 1) * sizeof *items);
+    void *batch[MAX_BATCH];
+    void *out[MAX_BATCH];
+    jsw_frozen_t *fz;
+    size_t n, i, pos;
+    int range = (int) (4 * size + 2);
+
+    if (c == NULL || items == NULL) {
+        fprintf (stderr, "test-frozen: failed to allocate %s\n", ops->name);
+        return 0;
+    }
+
+    /* Not every tree turns duplicates away, so skip them here */
+    for (n = 0; n < size; ) {
+        int *key = &keys[2 * (rand() % (range / 2))];
+
+        if (ops->find (c, key) == NULL && ops->insert (c, key)) {
+            ++n;
+        }
+    }
+
+    n = ops->copy (c, items);
+    fz = jsw_fznew (int_cmp, identity, nop, items, n);
+
+    if (fz == NULL || jsw_fzsize (fz) != n) {
+        fprintf (stderr, "test-frozen: %s of %lu didn't freeze\n",
+                 ops->name, (unsigned long) n);
+        return 0;
+    }
+
+    /* In order, and exactly the items */
+    for (i = 0, pos = jsw_fzfirst (fz); pos != 0;
+         pos = jsw_fznext (fz, pos), i++) {
+        if (i >= n || jsw_fzitem (fz, pos) != items[i]) {
+            fprintf (stderr, "test-frozen: %s of %lu iterates wrongly at %lu\n",
+                     ops->name, (unsigned long) n, (unsigned long) i);
+            return 0;
+        }
+    }
+
+    if (i != n) {
+        fprintf (stderr, "test-frozen: %s of %lu iterated %lu\n",
+                 ops->name, (unsigned long) n, (unsigned long) i);
+        return 0;
+    }
+
+    for (i = 0; i < N_PROBES; i++) {
+        int *key = &keys[rand() % range];
+        size_t lo = lower_index (items, n, *key);
+        size_t hi = lower_index (items, n, *key + 1);
+
+        if (jsw_fzfind (fz, key) != ops->find (c, key)
+            || jsw_fzitem (fz, jsw_fzlower (fz, key)) != (lo < n ? items[lo] : NULL)
+            || jsw_fzitem (fz, jsw_fzupper (fz, key)) != (hi < n ? items[hi] : NULL)) {
+            fprintf (stderr, "test-frozen: %s of %lu disagrees on %d\n",
+                     ops->name, (unsigned long) n, *key);
+            return 0;
+        }
+    }
+
+    for (i = 0; i < MAX_BATCH; i++) {
+        size_t found = 0, j;
+
+        for (j = 0; j < i; j++) {
+            batch[j] = &keys[rand() % range];
+        }
+
+        if (jsw_fzfind_many (fz, batch, i, out) > i) {
+            return 0;
+        }
+
+        for (j = 0; j < i; j++) {
+            if (out[j] != jsw_fzfind (fz, batch[j])) {
+                fprintf (stderr, "test-frozen: %s of %lu batch disagrees on "
+                         "%d\n", ops->name, (unsigned long) n,
+                         *(int *) batch[j]);
+                return 0;
+            }
+            found += out[j] != NULL;
+        }
+
+        if (jsw_fzfind_many (fz, batch, i, out) != found) {
+            fprintf (stderr, "test-frozen: %s of %lu batch miscounted\n",
+                     ops->name, (unsigned long) n);
+            return 0;
+        }
+    }
+
+    jsw_fzdelete (fz);
+
+    /* Out of order items can't be frozen */
+    if (n >= 2) {
+        void *save = items[0];
+
+        items[0] = items[n - 1];
+        items[n - 1] = save;
+
+        if ((fz = jsw_fznew (int_cmp, identity, nop, items, n)) != NULL) {
+            fprintf (stderr, "test-frozen: %s froze unsorted items\n",
+                     ops->name);
+            return 0;
+        }
+    }
+
+    free (items);
+    ops->destroy (c);
+
+    return 1;
+}
+
+int main (int argc, char **argv)
+{
+    unsigned seed;
+    size_t t, size;
+    int i, ok = 1;
+
+    if (argc < 2) {
+        seed = (unsigned) time(NULL);
+    } else {
+        seed = (unsigned) strtoul(argv[1], NULL, 0);
+    }
+
+    printf ("test-frozen: seed = %u\n", seed);
+    srand (seed);
+
+    for (i = 0; i < 4 * N_LARGE + 2; i++) {
+        keys[i] = i;
+    }
+
+    for (t = 0; t < sizeof tree_ops / sizeof tree_ops[0]; t++) {
+        for (size = 0; size <= MAX_SMALL && ok; size += 1 + t) {
+            ok &= check (&tree_ops[t], size);
+        }
+
+        ok &= check (&tree_ops[t], N_LARGE);
+    }
+
+    if (! ok) {
+        return 2;
+    }
+
+    printf ("test-frozen: %sPASS%s\n", green, off);
+
+    return 0;
+}
@@ -0,0 +1,243 @@
+/*
+  Precomputed hash lookups for jsw-lib hash tables
+
+    > Created (agent): October 14, 2026
+
+  Stores NUL-terminated keys, then finds and erases them by
+  slices (a pointer and a length) of one long buffer with
+  no terminators, passing in a hash computed over the slice.
+  The table's own hash function counts its calls, which must
+  stay at zero through every hashed call, and the answers
+  have to agree with plain lookups. Runs on a table that
+  grows incrementally, with and without JSW_HPOW2.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "jsw_hlib.h"
+
+#define N_KEYS 2000
+#define KEY_LEN 8
+
+static const char green[] = "\033[32m";
+static const char off[]   = "\033[0m";
+
+/* Every key, back to back and unterminated */
+static char buffer[N_KEYS * KEY_LEN];
+static char keys[N_KEYS][KEY_LEN + 1];
+
+static unsigned long hash_calls;
+
+typedef struct slice {
+    const char *p;
+    size_t      len;
+} slice_t;
+
+/* FNV-1a, so a slice hashes like the string it spells */
+static unsigned fnv (const char *p, size_t len)
+{
+    unsigned h = 2166136261U;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        h = (h ^ (unsigned char) p[i]) * 16777619U;
+    }
+
+    return h;
+}
+
+static unsigned str_hash (const void *key)
+{
+    ++hash_calls;
+
+    return fnv (key, strlen (key));
+}
+
+static int str_cmp (const void *a, const void *b)
+{
+    return strcmp (a, b);
+}
+
+static int slice_eq (const void *probe, const void *key)
+{
+    const slice_t *s = probe;
+
+    return strncmp (s->p, key, s->len) == 0 && ((const char *) key)[s->len] == '\0';
+}
+
+static void *str_dup (const void *key)
+{
+    char *copy = malloc (strlen (key) + 1);
+
+    if (copy != NULL) {
+        strcpy (copy, key);
+    }
+
+    return copy;
+}
+
+static void *identity (const void *item)
+{
+    return (void *) item;
+}
+
+static slice_t slice_of (int i)
+{
+    slice_t s;
+
+    s.p = &buffer[i * KEY_LEN];
+    s.len = KEY_LEN - (size_t) (i % 3);
+
+    return s;
+}
+
+static int check (unsigned flags)
+{
+    jsw_hash_t *htab = jsw_hnew_flags (7, flags, str_hash, str_cmp, str_dup,
+                                       identity, free, NULL);
+    int i;
+
+    if (htab == NULL || ! jsw_hgrowth (htab, 1.0, 1)) {
+        fprintf (stderr, "test-hashed: failed to allocate a table\n");
+        return 0;
+    }
+
+    hash_calls = 0;
+
+    /* Even keys go in by hash, odd ones stay out */
+    for (i = 0; i < N_KEYS; i += 2) {
+        slice_t s = slice_of (i);
+
+        if (! jsw_hinsert_hashed (htab, fnv (s.p, s.len), keys[i], keys[i])
+            || jsw_hinsert_hashed (htab, fnv (s.p, s.len), keys[i], keys[i])) {
+            fprintf (stderr, "test-hashed: insert of %s was wrong\n", keys[i]);
+            return 0;
+        }
+    }
+
+    for (i = 0; i < N_KEYS; i++) {
+        slice_t s = slice_of (i);
+        void *want = i % 2 == 0 ? keys[i] : NULL;
+
+        if (jsw_hfind_hashed (htab, fnv (s.p, s.len), &s, slice_eq) != want
+            || jsw_hfind_hashed (htab, fnv (s.p, s.len), keys[i], NULL) != want) {
+            fprintf (stderr, "test-hashed: wrong answer for %s\n", keys[i]);
+            return 0;
+        }
+    }
+
+    if (hash_calls != 0) {
+        fprintf (stderr, "test-hashed: hashed %lu keys anyway\n", hash_calls);
+        return 0;
+    }
+
+    /* Plain lookups agree with the hashes given */
+    for (i = 0; i < N_KEYS; i++) {
+        if (jsw_hfind (htab, keys[i]) != (i % 2 == 0 ? keys[i] : NULL)) {
+            fprintf (stderr, "test-hashed: %s stored under the wrong hash\n",
+                     keys[i]);
+            return 0;
+        }
+    }
+
+    hash_calls = 0;
+
+    /* Erase every other stored key by slice */
+    for (i = 0; i < N_KEYS; i++) {
+        slice_t s = slice_of (i);
+        int want = i % 4 == 0;
+
+        if (i % 2 == 0 && i % 4 != 0) {
+            continue;
+        }
+
+        if (jsw_herase_hashed (htab, fnv (s.p, s.len), &s, slice_eq) != want) {
+            fprintf (stderr, "test-hashed: erase of %s was wrong\n", keys[i]);
+            return 0;
+        }
+    }
+
+    for (i = 0; i < N_KEYS; i++) {
+        slice_t s = slice_of (i);
+        void *want = i % 4 == 2 ? keys[i] : NULL;
+
+        if (jsw_hfind_hashed (htab, fnv (s.p, s.len), &s, slice_eq) != want) {
+            fprintf (stderr, "test-hashed: %s survived the wrong erase\n",
+                     keys[i]);
+            return 0;
+        }
+    }
+
+    if (hash_calls != 0 || jsw_hsize (htab) != N_KEYS / 4) {
+        fprintf (stderr, "test-hashed: %lu items left, %lu hash calls\n",
+                 (unsigned long) jsw_hsize (htab), hash_calls);
+        return 0;
+    }
+
+    jsw_hdelete (htab);
+
+    return 1;
+}
+
+int main (int argc, char **argv)
+{
+    unsigned seed;
+    int i, j, ok;
+
+    if (argc < 2) {
+        seed = (unsigned) time(NULL);
+    } else {
+        seed = (unsigned) strtoul(argv[1], NULL, 0);
+    }
+
+    printf ("test-hashed: seed = %u\n", seed);
+    srand (seed);
+
+    /* Random letters, shortened by a few for some keys */
+    for (i = 0; i < N_KEYS; i++) {
+        slice_t s;
+
+        for (j = 0; j < KEY_LEN; j++) {
+            buffer[i * KEY_LEN + j] = (char) ('a' + rand() % 26);
+        }
+
+        s = slice_of (i);
+        memcpy (keys[i], s.p, s.len);
+        keys[i][s.len] = '\0';
+    }
+
+    /* Random keys could collide, so make sure they don't */
+    for (i = 0; i < N_KEYS; i++) {
+        for (j = 0; j < i; j++) {
+            if (strcmp (keys[i], keys[j]) == 0) {
+                keys[i][0] = buffer[i * KEY_LEN] = (char) ('A' + i % 26);
+                j = -1;
+            }
+        }
+    }
+
+    ok = check (0);
+    ok &= check (JSW_HPOW2);
+
+    if (! ok) {
+        return 2;
+    }
+
+    printf ("test-hashed: %sPASS%s\n", green, off);
+
+    return 0;
+}
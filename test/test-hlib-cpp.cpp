@@ -0,0 +1,66 @@
+/*
+  Test for the jsw-lib C++ hash map template
+
+    > Created (agent): October 14, 2026
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <string>
+
+#include "jsw_hlib.hpp"
+#include "test-containers.h"
+
+typedef jsw::hash_map<std::string, int> map_t;
+
+void *new_container (void)
+{
+    /* Start small so that the test exercises growth */
+    return new map_t (8);
+}
+
+void delete_container (void *c)
+{
+    delete static_cast<map_t *> (c);
+}
+
+bool insert_item (void *c, const char *item)
+{
+    return static_cast<map_t *> (c)->emplace (item, 0).second;
+}
+
+bool remove_item (void *c, const char *item)
+{
+    return static_cast<map_t *> (c)->erase (std::string (item)) != 0;
+}
+
+bool lookup_item (void *c, const char *item)
+{
+    return static_cast<map_t *> (c)->count (std::string (item)) != 0;
+}
+
+bool resize_container (void *c)
+{
+    map_t *map = static_cast<map_t *> (c);
+
+    map->rehash (37619);
+    return map->bucket_count() >= 37619;
+}
+
+const char *test_name (void)
+{
+    return "test-hlib-cpp";
+}
+
+void set_seed (unsigned seed)
+{
+}
@@ -0,0 +1,117 @@
+/*
+  Test for jsw-lib hash tables on a pool allocator
+
+    > Created (agent): October 14, 2026
+
+  Runs the container test on a table made with
+  jsw_hnew_alloc, with its nodes and chain heads coming
+  from one jsw_pool_t that is deleted after the table.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "jsw_hlib.h"
+#include "test-containers.h"
+
+static int somewhere;
+static jsw_pool_t *pool;
+
+static unsigned hashfunc (const void *key)
+{
+    /* FNV-1a hash function for NUL-terminated strings */
+    const unsigned char *p = key;
+    unsigned h = 2166136261;
+    int i;
+
+    for (i = 0; p[i]; i++) {
+        h = (h ^ p[i]) * 16777619;
+    }
+
+    return h;
+}
+
+static void *identity (const void *item)
+{
+    return (void *) item;
+}
+
+static void nop (void *item)
+{
+}
+
+void *new_container (void)
+{
+    jsw_alloc_t alloc;
+    jsw_hash_t *htab;
+
+    /* Nodes and chain heads share one pool */
+    pool = jsw_poolnew (0);
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    jsw_poolhooks (pool, &alloc);
+    htab = jsw_hnew_alloc (67, 0, hashfunc, (cmp_f) strcmp,
+                           (keydup_f) strdup, identity,
+                           (keyrel_f) free, nop, &alloc);
+
+    /* Start small so that the test exercises incremental growth */
+    if (htab != NULL && ! jsw_hgrowth (htab, 0.75, 2)) {
+        jsw_hdelete (htab);
+        htab = NULL;
+    }
+
+    if (htab == NULL) {
+        jsw_pooldelete (pool);
+    }
+
+    return htab;
+}
+
+void delete_container (void *c)
+{
+    jsw_hdelete ((jsw_hash_t *) c);
+    jsw_pooldelete (pool);
+}
+
+bool insert_item (void *c, const char *item)
+{
+    return (0 != jsw_hinsert ((jsw_hash_t *) c, (void *) item,
+                              (void *) &somewhere));
+}
+
+bool remove_item (void *c, const char *item)
+{
+    return (0 != jsw_herase ((jsw_hash_t *) c, (void *) item));
+}
+
+bool lookup_item (void *c, const char *item)
+{
+    return (NULL != jsw_hfind ((jsw_hash_t *) c, (void *) item));
+}
+
+bool resize_container (void *c)
+{
+    return (0 != jsw_hresize ((jsw_hash_t *) c, 37619));
+}
+
+const char *test_name (void)
+{
+    return "test-hlib-pool";
+}
+
+void set_seed (unsigned seed)
+{
+}
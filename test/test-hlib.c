@@ -2,6 +2,8 @@
   Test for jsw-lib hash tables
 
     > Created (Patrick Pelletier): April 17, 2022
+    > Modified (agent): October 14, 2026
+      Starts small so that the table grows incrementally
 
   This code is in the public domain. Anyone may
   use it or change it in any way that they see
@@ -48,8 +50,17 @@ static void nop (void *item)
 
 void *new_container (void)
 {
-    return jsw_hnew (1993, hashfunc, (cmp_f) strcmp, (keydup_f) strdup,
-                     identity, (keyrel_f) free, nop);
+    jsw_hash_t *htab = jsw_hnew (67, hashfunc, (cmp_f) strcmp,
+                                 (keydup_f) strdup, identity,
+                                 (keyrel_f) free, nop);
+
+    /* Start small so that the test exercises incremental growth */
+    if (htab != NULL && ! jsw_hgrowth (htab, 0.75, 2)) {
+        jsw_hdelete (htab);
+        return NULL;
+    }
+
+    return htab;
 }
 
 void delete_container (void *c)
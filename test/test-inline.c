@@ -0,0 +1,295 @@
+/*
+  Inline keys for jsw-lib hash tables
+
+    > Created (agent): October 14, 2026
+
+  Stores string keys of mixed lengths with an inline limit,
+  so short keys live in their nodes and long ones still go
+  through keydup. Checks that keydup and keyrel only see the
+  long keys, that cmp is never called, that copies of a key
+  find it (also through jsw_hfind_hashed with no eq), and
+  that every node goes back to the allocator with the size
+  it was allocated with. Runs at a few limits,
+  with and without JSW_HPOW2, and once more from a pool.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "jsw_hlib.h"
+
+#define N_KEYS 2000
+#define MAX_LEN 40
+
+static const char green[] = "\033[32m";
+static const char off[]   = "\033[0m";
+
+static char keys[N_KEYS][MAX_LEN + 1];
+
+/* What the callbacks and allocator hooks have seen */
+static unsigned long dups, rels, cmps, live, bad_sizes;
+
+/* Blocks remember their size, to check it on release */
+typedef union header {
+    size_t      size;
+    long double align;
+} header_t;
+
+static unsigned str_hash (const void *key)
+{
+    const unsigned char *p = key;
+    unsigned h = 2166136261U;
+
+    while (*p != '\0') {
+        h = (h ^ *p++) * 16777619U;
+    }
+
+    return h;
+}
+
+static int str_cmp (const void *a, const void *b)
+{
+    ++cmps;
+
+    return strcmp (a, b);
+}
+
+static size_t str_len (const void *key)
+{
+    return strlen (key) + 1;
+}
+
+static void *str_dup (const void *key)
+{
+    char *copy = malloc (strlen (key) + 1);
+
+    ++dups;
+
+    if (copy != NULL) {
+        strcpy (copy, key);
+    }
+
+    return copy;
+}
+
+static void str_rel (void *key)
+{
+    ++rels;
+    free (key);
+}
+
+static void *identity (const void *item)
+{
+    return (void *) item;
+}
+
+static void *sized_alloc (void *ctx, size_t size)
+{
+    header_t *h = malloc (sizeof *h + size);
+
+    if (h == NULL) {
+        return NULL;
+    }
+
+    ++live;
+    h->size = size;
+
+    return h + 1;
+}
+
+static void sized_release (void *ctx, void *p, size_t size)
+{
+    header_t *h = (header_t *) p - 1;
+
+    --live;
+    bad_sizes += h->size != size;
+    free (h);
+}
+
+static int check (unsigned flags, size_t max, const jsw_alloc_t *alloc)
+{
+    jsw_hash_t *htab = jsw_hnew_alloc (7, flags, str_hash, str_cmp, str_dup,
+                                       identity, str_rel, NULL, alloc);
+    unsigned long longs = 0, erased = 0;
+    char probe[MAX_LEN + 1];
+    int i;
+
+    if (htab == NULL || ! jsw_hgrowth (htab, 1.0, 2)
+        || ! jsw_hinline (htab, str_len, max)) {
+        fprintf (stderr, "test-inline: failed to make a table\n");
+        return 0;
+    }
+
+    dups = rels = cmps = 0;
+
+    for (i = 0; i < N_KEYS; i++) {
+        if (! jsw_hinsert (htab, keys[i], keys[i])
+            || jsw_hinsert (htab, keys[i], keys[i])) {
+            fprintf (stderr, "test-inline: insert of %s was wrong\n", keys[i]);
+            return 0;
+        }
+
+        longs += str_len (keys[i]) > max;
+    }
+
+    if (dups != longs || jsw_hinline (htab, NULL, 0)) {
+        fprintf (stderr, "test-inline: %lu keys copied, %lu were long\n",
+                 dups, longs);
+        return 0;
+    }
+
+    /* Copies find keys, a prefix of one doesn't */
+    for (i = 0; i < N_KEYS; i++) {
+        strcpy (probe, keys[i]);
+
+        if (jsw_hfind (htab, probe) != keys[i]
+            || jsw_hfind_hashed (htab, str_hash (probe), probe,
+                                 NULL) != keys[i]) {
+            fprintf (stderr, "test-inline: lost %s\n", keys[i]);
+            return 0;
+        }
+
+        probe[strlen (probe) - 1] = '\0';
+
+        if (jsw_hfind (htab, probe) != NULL) {
+            fprintf (stderr, "test-inline: found %s for %s\n", probe, keys[i]);
+            return 0;
+        }
+    }
+
+    /* Every stored key is a copy with the same bytes */
+    jsw_hreset (htab);
+
+    for (i = 0; jsw_hitem (htab) != NULL; i++, jsw_hnext (htab)) {
+        if (jsw_hkey (htab) == jsw_hitem (htab)
+            || strcmp (jsw_hkey (htab), jsw_hitem (htab)) != 0) {
+            fprintf (stderr, "test-inline: key of %s is wrong\n",
+                     (char *) jsw_hitem (htab));
+            return 0;
+        }
+    }
+
+    if (i != N_KEYS) {
+        fprintf (stderr, "test-inline: traversed %d of %d\n", i, N_KEYS);
+        return 0;
+    }
+
+    for (i = 0; i < N_KEYS; i += 2) {
+        if (! jsw_herase (htab, keys[i])) {
+            fprintf (stderr, "test-inline: erase of %s failed\n", keys[i]);
+            return 0;
+        }
+
+        erased += str_len (keys[i]) > max;
+    }
+
+    if (rels != erased || jsw_hsize (htab) != N_KEYS / 2) {
+        fprintf (stderr, "test-inline: %lu keys released, %lu were long\n",
+                 rels, erased);
+        return 0;
+    }
+
+    jsw_hclear (htab);
+
+    if (rels != longs || ! jsw_hinline (htab, str_len, max)) {
+        fprintf (stderr, "test-inline: clear released %lu keys\n", rels);
+        return 0;
+    }
+
+    /* Fill again after the clear and delete with everything in */
+    for (i = 0; i < N_KEYS; i++) {
+        if (! jsw_hinsert (htab, keys[i], keys[i])) {
+            fprintf (stderr, "test-inline: reinsert of %s failed\n", keys[i]);
+            return 0;
+        }
+    }
+
+    jsw_hdelete (htab);
+
+    if (cmps != 0 || rels != 2 * longs) {
+        fprintf (stderr, "test-inline: %lu compares, %lu keys released\n",
+                 cmps, rels);
+        return 0;
+    }
+
+    return 1;
+}
+
+int main (int argc, char **argv)
+{
+    static const size_t limits[] = { 0, 8, 24, MAX_LEN + 1 };
+    jsw_alloc_t sized, pooled;
+    jsw_pool_t *pool;
+    unsigned seed;
+    size_t k;
+    int i, j, ok = 1;
+
+    if (argc < 2) {
+        seed = (unsigned) time(NULL);
+    } else {
+        seed = (unsigned) strtoul(argv[1], NULL, 0);
+    }
+
+    printf ("test-inline: seed = %u\n", seed);
+    srand (seed);
+
+    /* The index keeps keys unique, random letters pad them out */
+    for (i = 0; i < N_KEYS; i++) {
+        int len = sprintf (keys[i], "%d-", i);
+        int pad = rand() % (MAX_LEN - len + 1);
+
+        for (j = 0; j < pad; j++) {
+            keys[i][len + j] = (char) ('a' + rand() % 26);
+        }
+
+        keys[i][len + pad] = '\0';
+    }
+
+    sized.alloc = sized_alloc;
+    sized.release = sized_release;
+    sized.purge = NULL;
+    sized.ctx = NULL;
+
+    for (k = 0; k < sizeof limits / sizeof limits[0]; k++) {
+        ok &= check (0, limits[k], &sized);
+        ok &= check (JSW_HPOW2, limits[k], &sized);
+    }
+
+    if (live != 0 || bad_sizes != 0) {
+        fprintf (stderr, "test-inline: %lu blocks left, %lu wrong sizes\n",
+                 live, bad_sizes);
+        ok = 0;
+    }
+
+    pool = jsw_poolnew (0);
+
+    if (pool == NULL) {
+        fprintf (stderr, "test-inline: failed to make a pool\n");
+        return 2;
+    }
+
+    jsw_poolhooks (pool, &pooled);
+    ok &= check (0, 24, &pooled);
+    jsw_pooldelete (pool);
+
+    if (! ok) {
+        return 2;
+    }
+
+    printf ("test-inline: %sPASS%s\n", green, off);
+
+    return 0;
+}
@@ -0,0 +1,204 @@
+/*
+  Test for jsw-lib intrusive balanced trees
+
+    > Created (agent): October 14, 2026
+
+  Runs the container test with the nodes embedded in the
+  items, for the red black tree by default, or the AVL
+  or AA tree when built with INTRUSIVE_AVLTREE or
+  INTRUSIVE_ATREE. Halfway through, and again before the
+  tree is deleted, a traversal has to visit every item
+  once, in order, through its own embedded node. Every
+  item inserted has to come back to the release function
+  exactly once, from an erase or from the delete.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#if defined (INTRUSIVE_AVLTREE)
+#include "jsw_avltree.h"
+
+#define NAME          "test-intrusive-avltree"
+#define tree_new      jsw_avlnew_intrusive
+#define tree_delete   jsw_avldelete
+#define tree_insert   jsw_avlinsert
+#define tree_erase    jsw_avlerase
+#define tree_find     jsw_avlfind
+#define tree_size     jsw_avlsize
+#define trav_new      jsw_avltnew
+#define trav_delete   jsw_avltdelete
+#define trav_first    jsw_avltfirst
+#define trav_next     jsw_avltnext
+
+typedef jsw_avltree_t tree_t;
+typedef jsw_avltrav_t trav_t;
+typedef jsw_avlnode_t node_t;
+#elif defined (INTRUSIVE_ATREE)
+#include "jsw_atree.h"
+
+#define NAME          "test-intrusive-atree"
+#define tree_new      jsw_anew_intrusive
+#define tree_delete   jsw_adelete
+#define tree_insert   jsw_ainsert
+#define tree_erase    jsw_aerase
+#define tree_find     jsw_afind
+#define tree_size     jsw_asize
+#define trav_new      jsw_atnew
+#define trav_delete   jsw_atdelete
+#define trav_first    jsw_atfirst
+#define trav_next     jsw_atnext
+
+typedef jsw_atree_t tree_t;
+typedef jsw_atrav_t trav_t;
+typedef jsw_anode_t node_t;
+#else
+#include "jsw_rbtree.h"
+
+#define NAME          "test-intrusive"
+#define tree_new      jsw_rbnew_intrusive
+#define tree_delete   jsw_rbdelete
+#define tree_insert   jsw_rbinsert
+#define tree_erase    jsw_rberase
+#define tree_find     jsw_rbfind
+#define tree_size     jsw_rbsize
+#define trav_new      jsw_rbtnew
+#define trav_delete   jsw_rbtdelete
+#define trav_first    jsw_rbtfirst
+#define trav_next     jsw_rbtnext
+
+typedef jsw_rbtree_t tree_t;
+typedef jsw_rbtrav_t trav_t;
+typedef jsw_rbnode_t node_t;
+#endif
+
+#include "test-containers.h"
+
+/*
+  The key comes first, so an item can be compared with
+  strcmp against both other items and plain strings
+*/
+typedef struct item {
+    char   key[20];
+    node_t hook;
+} item_t;
+
+static unsigned long inserted, released;
+
+static void release_item (void *p)
+{
+    ++released;
+    free (p);
+}
+
+/* Every item once, in order, each the data of its own hook */
+static bool check_order (tree_t *tree)
+{
+    trav_t *trav = trav_new ();
+    item_t *it, *last = NULL;
+    size_t n = 0;
+
+    if (trav == NULL) {
+        return false;
+    }
+
+    for (it = trav_first (trav, tree); it != NULL; it = trav_next (trav)) {
+        if (it->hook.data != it
+            || (last != NULL && strcmp (last->key, it->key) >= 0)) {
+            break;
+        }
+        last = it;
+        n++;
+    }
+
+    trav_delete (trav);
+
+    if (it != NULL || n != tree_size (tree)) {
+        fprintf (stderr, "%s: traversal went wrong after %lu items\n", NAME,
+                 (unsigned long) n);
+        return false;
+    }
+
+    return true;
+}
+
+void *new_container (void)
+{
+    return tree_new ((cmp_f) strcmp, release_item, offsetof (item_t, hook));
+}
+
+void delete_container (void *c)
+{
+    if (! check_order ((tree_t *) c)) {
+        exit (2);
+    }
+
+    tree_delete ((tree_t *) c);
+
+    if (released != inserted) {
+        fprintf (stderr, "%s: %lu items inserted, %lu released\n", NAME,
+                 inserted, released);
+        exit (2);
+    }
+}
+
+bool insert_item (void *c, const char *item)
+{
+    item_t *it = malloc (sizeof (*it));
+
+    if (it == NULL) {
+        return false;
+    }
+
+    strncpy (it->key, item, sizeof (it->key) - 1);
+    it->key[sizeof (it->key) - 1] = '\0';
+
+    if (! tree_insert ((tree_t *) c, it)) {
+        free (it);
+        return false;
+    }
+
+    ++inserted;
+
+    return true;
+}
+
+bool remove_item (void *c, const char *item)
+{
+    return (0 != tree_erase ((tree_t *) c, (void *) item));
+}
+
+bool lookup_item (void *c, const char *item)
+{
+    item_t *it = tree_find ((tree_t *) c, (void *) item);
+
+    return (it != NULL && strcmp (it->key, item) == 0);
+}
+
+/* Nothing to resize, but a good time to walk the tree */
+bool resize_container (void *c)
+{
+    return check_order ((tree_t *) c);
+}
+
+const char *test_name (void)
+{
+    return NAME;
+}
+
+void set_seed (unsigned seed)
+{
+}
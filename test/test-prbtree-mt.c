@@ -0,0 +1,255 @@
+/*
+  Threaded test for the jsw-lib persistent red black tree
+
+    > Created (agent): October 14, 2026
+
+  One writer slides a window of keys along, inserting
+  the key past its end and erasing the one at its start,
+  and publishes after a few steps at a time. It also
+  inserts and erases a scratch key within each batch,
+  which no published version may hold. Reader threads
+  pin a version and check that everything they read
+  from it agrees: the items are one whole window, its
+  size matches, lookups agree with the traversal, and
+  windows never move backwards. Items are heap copies,
+  so memory released too early shows up as a bad read
+  under valgrind or a sanitizer.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "jsw_prbtree.h"
+
+#define N_READERS 4
+#define N_WINDOW  64
+#define N_STEPS   20000
+#define SCRATCH   -1
+
+static const char green[] = "\033[32m";
+static const char off[]   = "\033[0m";
+
+typedef struct worker {
+    jsw_prbtree_t *tree;
+    unsigned long  rng;
+    long           pins;
+    int            errors;
+} worker_t;
+
+static atomic_int writing;
+
+static int int_cmp (const void *a, const void *b)
+{
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+
+    return (x > y) - (x < y);
+}
+
+static void *int_dup (const void *item)
+{
+    int *copy = malloc (sizeof *copy);
+
+    if (copy != NULL) {
+        *copy = *(const int *) item;
+    }
+
+    return copy;
+}
+
+static unsigned long next_rand (worker_t *w)
+{
+    w->rng ^= w->rng << 13;
+    w->rng ^= w->rng >> 7;
+    w->rng ^= w->rng << 17;
+
+    return w->rng;
+}
+
+static void *writer (void *arg)
+{
+    worker_t *w = arg;
+    int scratch = SCRATCH;
+    int i, k;
+
+    for (i = 0; i < N_STEPS; ) {
+        unsigned long batch = next_rand (w) % 4 + 1;
+
+        if (! jsw_prbinsert (w->tree, &scratch)) {
+            w->errors++;
+        }
+
+        for (; batch > 0 && i < N_STEPS; batch--, i++) {
+            k = i + N_WINDOW;
+
+            if (! jsw_prbinsert (w->tree, &k)
+                || ! jsw_prberase (w->tree, &i)) {
+                w->errors++;
+            }
+        }
+
+        if (! jsw_prberase (w->tree, &scratch)
+            || jsw_prbsize (w->tree) != N_WINDOW
+            || ! jsw_prbpublish (w->tree)) {
+            w->errors++;
+        }
+    }
+
+    return NULL;
+}
+
+static void *reader (void *arg)
+{
+    worker_t *w = arg;
+    jsw_prbview_t *view = jsw_prbattach (w->tree);
+    int scratch = SCRATCH;
+    int start = 0;
+
+    if (view == NULL) {
+        w->errors++;
+        return NULL;
+    }
+
+    while (atomic_load (&writing)) {
+        int *item, *found;
+        int first, last, past, n = 0;
+
+        jsw_prbpin (view);
+        w->pins++;
+
+        item = jsw_prbfirst (view);
+        first = item != NULL ? *item : -2;
+        last = first - 1;
+
+        for (; item != NULL; item = jsw_prbnext (view)) {
+            if (*item != last + 1) {
+                w->errors++;
+            }
+            last = *item;
+            n++;
+        }
+
+        /* Lookups come from the same version as the traversal */
+        past = last + 1;
+        found = jsw_prbfind (view, &first);
+
+        if (n != N_WINDOW || jsw_prbvsize (view) != N_WINDOW
+            || found == NULL || *found != first || first < start
+            || jsw_prbfind (view, &past) != NULL
+            || jsw_prbfind (view, &scratch) != NULL) {
+            w->errors++;
+        }
+
+        start = first;
+        jsw_prbunpin (view);
+    }
+
+    jsw_prbdetach (view);
+
+    return NULL;
+}
+
+int main (int argc, char **argv)
+{
+    static worker_t w[N_READERS + 1];
+    pthread_t tids[N_READERS + 1];
+    jsw_prbtree_t *tree;
+    jsw_prbview_t *view;
+    unsigned seed;
+    int i, k;
+
+    if (argc < 2) {
+        seed = (unsigned) time(NULL);
+    } else {
+        seed = (unsigned) strtoul(argv[1], NULL, 0);
+    }
+
+    printf ("test-prbtree-mt: seed = %u\n", seed);
+
+    tree = jsw_prbnew (int_cmp, int_dup, free);
+    if (tree == NULL) {
+        fprintf (stderr, "test-prbtree-mt: failed to allocate tree\n");
+        return 1;
+    }
+
+    /* Readers start from a whole window */
+    for (k = 0; k < N_WINDOW; k++) {
+        if (! jsw_prbinsert (tree, &k)) {
+            fprintf (stderr, "test-prbtree-mt: failed to insert %d\n", k);
+            return 1;
+        }
+    }
+
+    if (! jsw_prbpublish (tree)) {
+        fprintf (stderr, "test-prbtree-mt: failed to publish\n");
+        return 1;
+    }
+
+    for (i = 0; i < N_READERS + 1; i++) {
+        w[i].tree = tree;
+        w[i].rng = seed * 2654435761UL + (unsigned long) i * 40503UL + 1;
+    }
+
+    atomic_store (&writing, 1);
+
+    for (i = 0; i < N_READERS + 1; i++) {
+        if (pthread_create (&tids[i], NULL, i == 0 ? writer : reader,
+                            &w[i]) != 0) {
+            fprintf (stderr, "test-prbtree-mt: pthread_create failed\n");
+            return 1;
+        }
+    }
+
+    pthread_join (tids[0], NULL);
+    atomic_store (&writing, 0);
+
+    for (i = 1; i < N_READERS + 1; i++) {
+        pthread_join (tids[i], NULL);
+    }
+
+    for (i = 0; i < N_READERS + 1; i++) {
+        if (w[i].errors != 0) {
+            fprintf (stderr, "test-prbtree-mt: thread %d saw %d errors "
+                     "in %ld pins\n", i, w[i].errors, w[i].pins);
+            return 2;
+        }
+    }
+
+    /* The last version ends the window where the writer stopped */
+    view = jsw_prbattach (tree);
+    if (view == NULL) {
+        fprintf (stderr, "test-prbtree-mt: failed to attach\n");
+        return 1;
+    }
+
+    for (k = 0; k < N_STEPS + N_WINDOW; k++) {
+        int *found = jsw_prbfind (view, &k);
+
+        if ((found != NULL) != (k >= N_STEPS) || (found && *found != k)) {
+            fprintf (stderr, "test-prbtree-mt: key %d is %s\n", k,
+                     found ? "present" : "missing");
+            return 2;
+        }
+    }
+
+    jsw_prbdetach (view);
+    jsw_prbdelete (tree);
+
+    printf ("test-prbtree-mt: %sPASS%s\n", green, off);
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+/*
+  Test for the jsw-lib persistent red black tree, from one thread
+
+    > Created (agent): October 14, 2026
+
+  Every update is published before it returns, so the
+  lookups, which go through a view, see it at once.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "jsw_prbtree.h"
+#include "test-containers.h"
+
+static jsw_prbview_t *view;
+
+void *new_container (void)
+{
+    jsw_prbtree_t *tree = jsw_prbnew ((cmp_f) strcmp, (dup_f) strdup,
+                                      (rel_f) free);
+
+    if (tree == NULL) {
+        return NULL;
+    }
+
+    view = jsw_prbattach (tree);
+    if (view == NULL) {
+        jsw_prbdelete (tree);
+        return NULL;
+    }
+
+    return tree;
+}
+
+void delete_container (void *c)
+{
+    jsw_prbdetach (view);
+    jsw_prbdelete ((jsw_prbtree_t *) c);
+}
+
+bool insert_item (void *c, const char *item)
+{
+    return (0 != jsw_prbinsert ((jsw_prbtree_t *) c, (void *) item)
+            && 0 != jsw_prbpublish ((jsw_prbtree_t *) c));
+}
+
+bool remove_item (void *c, const char *item)
+{
+    return (0 != jsw_prberase ((jsw_prbtree_t *) c, (void *) item)
+            && 0 != jsw_prbpublish ((jsw_prbtree_t *) c));
+}
+
+bool lookup_item (void *c, const char *item)
+{
+    return (NULL != jsw_prbfind (view, (void *) item));
+}
+
+bool resize_container (void *c)
+{
+    return true;
+}
+
+const char *test_name (void)
+{
+    return "test-prbtree";
+}
+
+void set_seed (unsigned seed)
+{
+}
@@ -0,0 +1,412 @@
+/*
+  Range queries for jsw-lib ordered containers
+
+    > Created (agent): October 14, 2026
+
+  Fills each ordered container with a shuffled set of
+  string keys, then checks lower and upper bound starters
+  and range visits on random windows against the sorted
+  key list, including visits that stop early.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <time.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "jsw_rbtree.h"
+#include "jsw_avltree.h"
+#include "jsw_atree.h"
+#include "jsw_btree.h"
+#include "test-slib-ops.h"
+
+#define N_KEYS    3000
+#define N_QUERIES 2000
+
+static const char green[] = "\033[32m";
+static const char off[]   = "\033[0m";
+
+/* Matches visit_f in each container's header */
+typedef int (*range_visit_f) (void *item, void *arg);
+
+/* State for range_visit */
+typedef struct walk {
+    unsigned next;  /* Index of the key the next visit should see */
+    unsigned limit; /* Visits allowed before stopping */
+    int      bad;   /* A visit saw the wrong key */
+} walk_t;
+
+typedef struct ordered_ops {
+    const char *name;
+    void       *(*create) (void);
+    int         (*insert) (void *c, void *data);
+    void       *(*lower) (void *c, void *data);
+    void       *(*upper) (void *c, void *data);
+    void       *(*next) (void *c);
+    size_t      (*range) (void *c, void *lo, void *hi, range_visit_f f,
+                          void *arg);
+    void        (*destroy) (void *c);
+} ordered_ops_t;
+
+/*
+  Sorted keys, each the zero-padded string of twice its
+  index. Only even numbers are stored, so odd probes fall
+  between keys
+*/
+static char keys[N_KEYS][12];
+static char *order[N_KEYS];
+
+static int cmp (const void *a, const void *b)
+{
+    return strcmp (a, b);
+}
+
+static void *identity (void *item)
+{
+    return item;
+}
+
+static void nop (void *item)
+{
+}
+
+static int range_visit (void *item, void *arg)
+{
+    walk_t *w = arg;
+
+    if (w->next >= N_KEYS || strcmp (item, keys[w->next]) != 0) {
+        w->bad = 1;
+    }
+
+    ++w->next;
+    return --w->limit != 0;
+}
+
+static jsw_rbtrav_t *rbtrav;
+static jsw_avltrav_t *avltrav;
+static jsw_atrav_t *atrav;
+static jsw_btrav_t *btrav;
+
+static void *rb_create (void)
+{
+    rbtrav = jsw_rbtnew();
+    return jsw_rbnew (cmp, identity, nop);
+}
+
+static int rb_insert (void *c, void *data)
+{
+    return jsw_rbinsert (c, data);
+}
+
+static void *rb_lower (void *c, void *data)
+{
+    return jsw_rbtlower (rbtrav, c, data);
+}
+
+static void *rb_upper (void *c, void *data)
+{
+    return jsw_rbtupper (rbtrav, c, data);
+}
+
+static void *rb_next (void *c)
+{
+    return jsw_rbtnext (rbtrav);
+}
+
+static size_t rb_range (void *c, void *lo, void *hi, visit_f f, void *arg)
+{
+    return jsw_rbrange (c, lo, hi, f, arg);
+}
+
+static void rb_destroy (void *c)
+{
+    jsw_rbtdelete (rbtrav);
+    jsw_rbdelete (c);
+}
+
+static void *avl_create (void)
+{
+    avltrav = jsw_avltnew();
+    return jsw_avlnew (cmp, identity, nop);
+}
+
+static int avl_insert (void *c, void *data)
+{
+    return jsw_avlinsert (c, data);
+}
+
+static void *avl_lower (void *c, void *data)
+{
+    return jsw_avltlower (avltrav, c, data);
+}
+
+static void *avl_upper (void *c, void *data)
+{
+    return jsw_avltupper (avltrav, c, data);
+}
+
+static void *avl_next (void *c)
+{
+    return jsw_avltnext (avltrav);
+}
+
+static size_t avl_range (void *c, void *lo, void *hi, visit_f f, void *arg)
+{
+    return jsw_avlrange (c, lo, hi, f, arg);
+}
+
+static void avl_destroy (void *c)
+{
+    jsw_avltdelete (avltrav);
+    jsw_avldelete (c);
+}
+
+static void *aa_create (void)
+{
+    atrav = jsw_atnew();
+    return jsw_anew (cmp, identity, nop);
+}
+
+static int aa_insert (void *c, void *data)
+{
+    return jsw_ainsert (c, data);
+}
+
+static void *aa_lower (void *c, void *data)
+{
+    return jsw_atlower (atrav, c, data);
+}
+
+static void *aa_upper (void *c, void *data)
+{
+    return jsw_atupper (atrav, c, data);
+}
+
+static void *aa_next (void *c)
+{
+    return jsw_atnext (atrav);
+}
+
+static size_t aa_range (void *c, void *lo, void *hi, visit_f f, void *arg)
+{
+    return jsw_arange (c, lo, hi, f, arg);
+}
+
+static void aa_destroy (void *c)
+{
+    jsw_atdelete (atrav);
+    jsw_adelete (c);
+}
+
+static void *b_create (void)
+{
+    btrav = jsw_btnew();
+    return jsw_bnew (cmp, identity, nop);
+}
+
+static int b_insert (void *c, void *data)
+{
+    return jsw_binsert (c, data);
+}
+
+static void *b_lower (void *c, void *data)
+{
+    return jsw_btlower (btrav, c, data);
+}
+
+static void *b_upper (void *c, void *data)
+{
+    return jsw_btupper (btrav, c, data);
+}
+
+static void *b_next (void *c)
+{
+    return jsw_btnext (btrav);
+}
+
+static size_t b_range (void *c, void *lo, void *hi, visit_f f, void *arg)
+{
+    return jsw_brange (c, lo, hi, f, arg);
+}
+
+static void b_destroy (void *c)
+{
+    jsw_btdelete (btrav);
+    jsw_bdelete (c);
+}
+
+/* Skip lists step with their own cursor, so there is no trav */
+static void *s_create (void)
+{
+    return slib_create (cmp, NULL, NULL);
+}
+
+static const ordered_ops_t containers[] = {
+    { "rbtree", rb_create, rb_insert, rb_lower, rb_upper, rb_next,
+      rb_range, rb_destroy },
+    { "avltree", avl_create, avl_insert, avl_lower, avl_upper, avl_next,
+      avl_range, avl_destroy },
+    { "atree", aa_create, aa_insert, aa_lower, aa_upper, aa_next,
+      aa_range, aa_destroy },
+    { "btree", b_create, b_insert, b_lower, b_upper, b_next,
+      b_range, b_destroy },
+    { "slib", s_create, slib_insert, slib_lower, slib_upper, slib_next,
+      slib_range, slib_destroy },
+};
+
+static void shuffle (void)
+{
+    unsigned i;
+
+    for (i = N_KEYS - 1; i > 0; i--) {
+        unsigned j = ((unsigned) rand()) % (i + 1);
+        char *save = order[i];
+
+        order[i] = order[j];
+        order[j] = save;
+    }
+}
+
+/* Probe as a string; 2 * index is a stored key, odd values are gaps */
+static void probe (char *buf, unsigned v)
+{
+    snprintf (buf, 12, "%06u", v);
+}
+
+static int fail (const char *name, const char *what, unsigned v)
+{
+    fprintf (stderr, "test-range: %s: %s wrong at %u\n", name, what, v);
+    return 0;
+}
+
+static int check_bounds (const ordered_ops_t *ops, void *c, unsigned v)
+{
+    /* First index whose key 2 * i is >= v, then > v */
+    unsigned lo = (v + 1) / 2;
+    unsigned hi = v / 2 + 1;
+    char buf[12];
+    void *it;
+    unsigned i;
+
+    probe (buf, v);
+
+    it = ops->lower (c, buf);
+    if (lo >= N_KEYS ? it != NULL : it != keys[lo]) {
+        return fail (ops->name, "lower bound", v);
+    }
+
+    /* The starter leaves the traversal ready to continue */
+    for (i = lo + 1; it != NULL && i < N_KEYS && i < lo + 5; i++) {
+        if ((it = ops->next (c)) != keys[i]) {
+            return fail (ops->name, "step after lower bound", v);
+        }
+    }
+
+    it = ops->upper (c, buf);
+    if (hi >= N_KEYS ? it != NULL : it != keys[hi]) {
+        return fail (ops->name, "upper bound", v);
+    }
+
+    return 1;
+}
+
+static int check_range (const ordered_ops_t *ops, void *c,
+                        unsigned a, unsigned b, unsigned limit)
+{
+    unsigned first = (a + 1) / 2, last = b / 2 + 1, expect;
+    char lo[12], hi[12];
+    walk_t w;
+    size_t n;
+
+    if (last > N_KEYS) {
+        last = N_KEYS;
+    }
+
+    expect = first < last ? last - first : 0;
+    if (limit < expect) {
+        expect = limit;
+    }
+
+    probe (lo, a);
+    probe (hi, b);
+    w.next = first;
+    w.limit = limit;
+    w.bad = 0;
+
+    n = ops->range (c, lo, hi, range_visit, &w);
+    if (w.bad || n != expect) {
+        return fail (ops->name, "range", a);
+    }
+
+    return 1;
+}
+
+int main (int argc, char **argv)
+{
+    unsigned seed, i, t;
+
+    if (argc < 2) {
+        seed = (unsigned) time(NULL);
+    } else {
+        seed = (unsigned) strtoul(argv[1], NULL, 0);
+    }
+
+    printf ("test-range: seed = %u\n", seed);
+    srand (seed);
+
+    for (i = 0; i < N_KEYS; i++) {
+        probe (keys[i], 2 * i);
+        order[i] = keys[i];
+    }
+
+    for (t = 0; t < sizeof containers / sizeof containers[0]; t++) {
+        const ordered_ops_t *ops = &containers[t];
+        void *c = ops->create();
+
+        if (c == NULL) {
+            fprintf (stderr, "test-range: failed to allocate %s\n",
+                     ops->name);
+            return 1;
+        }
+
+        shuffle();
+        for (i = 0; i < N_KEYS; i++) {
+            if (! ops->insert (c, order[i])) {
+                fprintf (stderr, "test-range: %s insert failed\n",
+                         ops->name);
+                return 2;
+            }
+        }
+
+        /* Probe past both ends, too */
+        for (i = 0; i < N_QUERIES; i++) {
+            unsigned a = ((unsigned) rand()) % (2 * N_KEYS + 4);
+            unsigned b = a + ((unsigned) rand()) % 64;
+            unsigned limit = ((unsigned) rand()) % 40 + 1;
+
+            if (! check_bounds (ops, c, a)
+                || ! check_range (ops, c, a, b, limit)
+                || ! check_range (ops, c, a, b, N_KEYS + 1)) {
+                return 3;
+            }
+        }
+
+        ops->destroy (c);
+        printf ("test-range: %s ok\n", ops->name);
+    }
+
+    printf ("test-range: %sPASS%s\n", green, off);
+
+    return 0;
+}
@@ -0,0 +1,250 @@
+/*
+  Order statistics for jsw-lib red black and AVL trees
+
+    > Created (agent): October 14, 2026
+
+  Built with JSW_RANK. Random inserts and erases are checked
+  against a membership array, and every so often the rank of
+  each key and the item at each position are compared with
+  the counts the array gives.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <time.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "jsw_rbtree.h"
+#include "jsw_avltree.h"
+
+#ifndef JSW_RANK
+#error "test-rank must be built with JSW_RANK"
+#endif
+
+#define N_KEYS  1024
+#define N_STEPS 40000
+
+static const char green[] = "\033[32m";
+static const char off[]   = "\033[0m";
+
+static char keys[N_KEYS][8];
+static int members[N_KEYS];
+
+typedef struct rank_ops {
+    const char *name;
+    void       *(*create) (void);
+    int         (*insert) (void *tree, void *data);
+    int         (*erase) (void *tree, void *data);
+    void       *(*select) (void *tree, size_t k);
+    size_t      (*rank) (void *tree, void *data);
+    size_t      (*size) (void *tree);
+    void        (*destroy) (void *tree);
+} rank_ops_t;
+
+static int cmp (const void *a, const void *b)
+{
+    return strcmp (a, b);
+}
+
+static void *identity (void *item)
+{
+    return item;
+}
+
+static void nop (void *item)
+{
+}
+
+static void *rb_create (void)
+{
+    return jsw_rbnew (cmp, identity, nop);
+}
+
+static int rb_insert (void *tree, void *data)
+{
+    return jsw_rbinsert (tree, data);
+}
+
+static int rb_erase (void *tree, void *data)
+{
+    return jsw_rberase (tree, data);
+}
+
+static void *rb_select (void *tree, size_t k)
+{
+    return jsw_rbselect (tree, k);
+}
+
+static size_t rb_rank (void *tree, void *data)
+{
+    return jsw_rbrank (tree, data);
+}
+
+static size_t rb_size (void *tree)
+{
+    return jsw_rbsize (tree);
+}
+
+static void rb_destroy (void *tree)
+{
+    jsw_rbdelete (tree);
+}
+
+static void *avl_create (void)
+{
+    return jsw_avlnew (cmp, identity, nop);
+}
+
+static int avl_insert (void *tree, void *data)
+{
+    return jsw_avlinsert (tree, data);
+}
+
+static int avl_erase (void *tree, void *data)
+{
+    return jsw_avlerase (tree, data);
+}
+
+static void *avl_select (void *tree, size_t k)
+{
+    return jsw_avlselect (tree, k);
+}
+
+static size_t avl_rank (void *tree, void *data)
+{
+    return jsw_avlrank (tree, data);
+}
+
+static size_t avl_size (void *tree)
+{
+    return jsw_avlsize (tree);
+}
+
+static void avl_destroy (void *tree)
+{
+    jsw_avldelete (tree);
+}
+
+static const rank_ops_t trees[] = {
+    { "rbtree", rb_create, rb_insert, rb_erase, rb_select, rb_rank,
+      rb_size, rb_destroy },
+    { "avltree", avl_create, avl_insert, avl_erase, avl_select, avl_rank,
+      avl_size, avl_destroy },
+};
+
+static int check (const rank_ops_t *ops, void *tree, unsigned step)
+{
+    size_t rank = 0;
+    unsigned j;
+
+    for (j = 0; j < N_KEYS; j++) {
+        if (ops->rank (tree, keys[j]) != rank) {
+            fprintf (stderr, "test-rank: %s: step %u: rank of %s wrong\n",
+                     ops->name, step, keys[j]);
+            return 0;
+        }
+
+        if (members[j]) {
+            if (ops->select (tree, rank) != keys[j]) {
+                fprintf (stderr,
+                         "test-rank: %s: step %u: select %u wrong\n",
+                         ops->name, step, (unsigned) rank);
+                return 0;
+            }
+
+            ++rank;
+        }
+    }
+
+    if (rank != ops->size (tree) || ops->select (tree, rank) != NULL) {
+        fprintf (stderr, "test-rank: %s: step %u: size wrong\n",
+                 ops->name, step);
+        return 0;
+    }
+
+    return 1;
+}
+
+int main (int argc, char **argv)
+{
+    unsigned seed, i, t;
+
+    if (argc < 2) {
+        seed = (unsigned) time(NULL);
+    } else {
+        seed = (unsigned) strtoul(argv[1], NULL, 0);
+    }
+
+    printf ("test-rank: seed = %u\n", seed);
+    srand (seed);
+
+    for (i = 0; i < N_KEYS; i++) {
+        snprintf (keys[i], sizeof (keys[i]), "%05u", i);
+    }
+
+    for (t = 0; t < sizeof trees / sizeof trees[0]; t++) {
+        const rank_ops_t *ops = &trees[t];
+        void *tree = ops->create();
+
+        if (tree == NULL) {
+            fprintf (stderr, "test-rank: failed to allocate %s\n",
+                     ops->name);
+            return 1;
+        }
+
+        memset (members, 0, sizeof (members));
+
+        for (i = 0; i < N_STEPS; i++) {
+            unsigned j = ((unsigned) rand()) % N_KEYS;
+
+            if (members[j]) {
+                if (! ops->erase (tree, keys[j])) {
+                    fprintf (stderr, "test-rank: %s: erase failed\n",
+                             ops->name);
+                    return 2;
+                }
+            } else if (! ops->insert (tree, keys[j])) {
+                fprintf (stderr, "test-rank: %s: insert failed\n",
+                         ops->name);
+                return 2;
+            }
+
+            members[j] = !members[j];
+
+            if (i % 1000 == 0 && ! check (ops, tree, i)) {
+                return 3;
+            }
+        }
+
+        /* Missing keys change nothing */
+        for (i = 0; i < N_KEYS; i++) {
+            if (! members[i] && ops->erase (tree, keys[i])) {
+                fprintf (stderr, "test-rank: %s: erased a missing key\n",
+                         ops->name);
+                return 2;
+            }
+        }
+
+        if (! check (ops, tree, N_STEPS)) {
+            return 3;
+        }
+
+        ops->destroy (tree);
+        printf ("test-rank: %s ok\n", ops->name);
+    }
+
+    printf ("test-rank: %sPASS%s\n", green, off);
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+/*
+  Test for the jsw-lib C++ red black tree template
+
+    > Created (agent): October 14, 2026
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <cstdlib>
+#include <string>
+
+#include "jsw_rbtree.hpp"
+#include "test-containers.h"
+
+typedef jsw::rbtree<std::string> tree_t;
+
+void *new_container (void)
+{
+    return new tree_t;
+}
+
+void delete_container (void *c)
+{
+    tree_t *tree = static_cast<tree_t *> (c);
+
+    /* Walk both ways to exercise the iterators */
+    size_t n = 0;
+    for (tree_t::const_iterator it = tree->begin(); it != tree->end(); ++it) {
+        ++n;
+    }
+    for (tree_t::const_reverse_iterator it = tree->rbegin();
+         it != tree->rend(); ++it) {
+        --n;
+    }
+
+    if (n != 0) {
+        abort();
+    }
+
+    delete tree;
+}
+
+bool insert_item (void *c, const char *item)
+{
+    return static_cast<tree_t *> (c)->insert (std::string (item)).second;
+}
+
+bool remove_item (void *c, const char *item)
+{
+    return static_cast<tree_t *> (c)->erase (std::string (item)) != 0;
+}
+
+bool lookup_item (void *c, const char *item)
+{
+    return static_cast<tree_t *> (c)->count (std::string (item)) != 0;
+}
+
+bool resize_container (void *c)
+{
+    return true;
+}
+
+const char *test_name (void)
+{
+    return "test-rbtree-cpp";
+}
+
+void set_seed (unsigned seed)
+{
+}
@@ -0,0 +1,769 @@
+/*
+  Set operations on jsw-lib balanced trees
+
+    > Created (agent): October 14, 2026
+
+  Each round fills two intrusive trees with random keys,
+  runs a union, intersection, difference, or split and join
+  on them (serially, or forking threads for the top levels)
+  and checks the result against the expected set: every
+  key in order, the size, the count of released items, and
+  which tree's copy of a shared key survived. Intrusive
+  items also let the test find each tree's root, so the
+  shape is checked too: red black or AVL balance, and the
+  subtree counts when built with JSW_RANK. Trees sharing a
+  pool only swap nodes when they don't purge it on delete.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "jsw_rbtree.h"
+#include "jsw_avltree.h"
+
+#define N_KEYS   3000
+#define N_ROUNDS 300
+
+enum { UNION, INTERSECT, DIFFERENCE, SPLIT, N_KINDS };
+
+static const char *kind_names[] = {
+    "union", "intersection", "difference", "split"
+};
+
+static const char green[] = "\033[32m";
+static const char off[]   = "\033[0m";
+
+/* The key comes first, so a pointer to one is a search key */
+typedef struct item {
+    int           key;
+    jsw_rbnode_t  rb;
+    jsw_avlnode_t avl;
+} item_t;
+
+/* One copy of each key for either tree */
+static item_t items[2][N_KEYS];
+static char in[2][N_KEYS];
+static char child[2 * N_KEYS];
+static item_t *order[2 * N_KEYS];
+
+static unsigned long rel_calls;
+
+static int item_cmp (const void *a, const void *b)
+{
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+
+    return (x > y) - (x < y);
+}
+
+static void counting_rel (void *item)
+{
+    ++rel_calls;
+}
+
+static void *identity (void *item)
+{
+    return item;
+}
+
+/* Runs a in a new thread and b in this one */
+typedef struct job {
+    jsw_task_f  task;
+    void       *arg;
+} job_t;
+
+static void *run_job (void *arg)
+{
+    job_t *job = arg;
+
+    job->task (job->arg);
+
+    return NULL;
+}
+
+static void thread_fork (void *ctx, jsw_task_f task, void *a, void *b)
+{
+    job_t job = { task, a };
+    pthread_t thread;
+
+    if (pthread_create (&thread, NULL, run_job, &job) != 0) {
+        task (a);
+        task (b);
+        return;
+    }
+
+    task (b);
+    pthread_join (thread, NULL);
+}
+
+static const jsw_fork_t threads = { thread_fork, NULL, 3 };
+
+typedef struct set_ops {
+    const char *name;
+    void       *(*create) (void);
+    void       *(*create_other) (void);
+    void       *(*create_alloc) (const jsw_alloc_t *alloc);
+    int         (*insert) (void *t, item_t *it);
+    int         (*op) (int kind, void *a, void *b, const jsw_fork_t *fork);
+    int         (*split) (void *t, item_t *key, void *right);
+    int         (*join) (void *a, void *b);
+    size_t      (*size) (void *t);
+    size_t      (*walk) (void *t, item_t **out);
+    int         (*shape) (item_t *root);
+    item_t     *(*left) (item_t *it);
+    item_t     *(*right) (item_t *it);
+    void        (*destroy) (void *t);
+} set_ops_t;
+
+static size_t index_of (item_t *it)
+{
+    return (size_t) (it - &items[0][0]);
+}
+
+/* The item in order that no other item has as a child */
+static item_t *find_root (const set_ops_t *ops, item_t **walk, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        child[index_of (walk[i])] = 0;
+    }
+
+    for (i = 0; i < n; i++) {
+        if (ops->left (walk[i]) != NULL) {
+            child[index_of (ops->left (walk[i]))] = 1;
+        }
+        if (ops->right (walk[i]) != NULL) {
+            child[index_of (ops->right (walk[i]))] = 1;
+        }
+    }
+
+    for (i = 0; i < n; i++) {
+        if (! child[index_of (walk[i])]) {
+            return walk[i];
+        }
+    }
+
+    return NULL;
+}
+
+static item_t *rb_item (jsw_rbnode_t *node)
+{
+    return node == NULL ? NULL : node->data;
+}
+
+static void *rb_create (void)
+{
+    return jsw_rbnew_intrusive (item_cmp, counting_rel,
+                                offsetof (item_t, rb));
+}
+
+/* Owns its nodes, so nothing can move to or from it */
+static void *rb_create_other (void)
+{
+    return jsw_rbnew (item_cmp, identity, counting_rel);
+}
+
+static void *rb_create_alloc (const jsw_alloc_t *alloc)
+{
+    return jsw_rbnew_alloc (item_cmp, identity, counting_rel, alloc);
+}
+
+static int rb_insert (void *t, item_t *it)
+{
+    return jsw_rbinsert (t, it);
+}
+
+static int rb_op (int kind, void *a, void *b, const jsw_fork_t *fork)
+{
+    switch (kind) {
+    case UNION:     return jsw_rbunion (a, b, fork);
+    case INTERSECT: return jsw_rbintersect (a, b, fork);
+    default:        return jsw_rbdifference (a, b, fork);
+    }
+}
+
+static int rb_split (void *t, item_t *key, void *right)
+{
+    return jsw_rbsplit (t, key, right);
+}
+
+static int rb_join (void *a, void *b)
+{
+    return jsw_rbjoin (a, b);
+}
+
+static size_t rb_size (void *t)
+{
+    return jsw_rbsize (t);
+}
+
+static size_t rb_walk (void *t, item_t **out)
+{
+    jsw_rbtrav_t *trav = jsw_rbtnew ();
+    size_t n = 0;
+    item_t *it;
+
+    for (it = jsw_rbtfirst (trav, t); it != NULL; it = jsw_rbtnext (trav)) {
+        out[n++] = it;
+    }
+
+    jsw_rbtdelete (trav);
+
+    return n;
+}
+
+static item_t *rb_left (item_t *it)
+{
+    return rb_item (it->rb.link[0]);
+}
+
+static item_t *rb_right (item_t *it)
+{
+    return rb_item (it->rb.link[1]);
+}
+
+/* Black height, or -1 if the subtree isn't a red black tree */
+static int rb_height (jsw_rbnode_t *node)
+{
+    int l, r;
+
+    if (node == NULL) {
+        return 0;
+    }
+
+    if (node->red && ((node->link[0] != NULL && node->link[0]->red)
+                      || (node->link[1] != NULL && node->link[1]->red))) {
+        return -1;
+    }
+
+#ifdef JSW_RANK
+    if (node->count != 1 + (node->link[0] ? node->link[0]->count : 0)
+                         + (node->link[1] ? node->link[1]->count : 0)) {
+        return -1;
+    }
+#endif
+
+    l = rb_height (node->link[0]);
+    r = rb_height (node->link[1]);
+
+    if (l < 0 || l != r) {
+        return -1;
+    }
+
+    return l + ! node->red;
+}
+
+static int rb_shape (item_t *root)
+{
+    return ! root->rb.red && rb_height (&root->rb) >= 0;
+}
+
+static void rb_destroy (void *t)
+{
+    jsw_rbdelete (t);
+}
+
+static item_t *avl_item (jsw_avlnode_t *node)
+{
+    return node == NULL ? NULL : node->data;
+}
+
+static void *avl_create (void)
+{
+    return jsw_avlnew_intrusive (item_cmp, counting_rel,
+                                 offsetof (item_t, avl));
+}
+
+static void *avl_create_other (void)
+{
+    return jsw_avlnew (item_cmp, identity, counting_rel);
+}
+
+static void *avl_create_alloc (const jsw_alloc_t *alloc)
+{
+    return jsw_avlnew_alloc (item_cmp, identity, counting_rel, alloc);
+}
+
+/* AVL trees take duplicates, these sets don't */
+static int avl_insert (void *t, item_t *it)
+{
+    return jsw_avlfind (t, it) == NULL && jsw_avlinsert (t, it);
+}
+
+static int avl_op (int kind, void *a, void *b, const jsw_fork_t *fork)
+{
+    switch (kind) {
+    case UNION:     return jsw_avlunion (a, b, fork);
+    case INTERSECT: return jsw_avlintersect (a, b, fork);
+    default:        return jsw_avldifference (a, b, fork);
+    }
+}
+
+static int avl_split (void *t, item_t *key, void *right)
+{
+    return jsw_avlsplit (t, key, right);
+}
+
+static int avl_join (void *a, void *b)
+{
+    return jsw_avljoin (a, b);
+}
+
+static size_t avl_size (void *t)
+{
+    return jsw_avlsize (t);
+}
+
+static size_t avl_walk (void *t, item_t **out)
+{
+    jsw_avltrav_t *trav = jsw_avltnew ();
+    size_t n = 0;
+    item_t *it;
+
+    for (it = jsw_avltfirst (trav, t); it != NULL; it = jsw_avltnext (trav)) {
+        out[n++] = it;
+    }
+
+    jsw_avltdelete (trav);
+
+    return n;
+}
+
+static item_t *avl_left (item_t *it)
+{
+    return avl_item (it->avl.link[0]);
+}
+
+static item_t *avl_right (item_t *it)
+{
+    return avl_item (it->avl.link[1]);
+}
+
+/* Height, or -1 if the subtree isn't an AVL tree */
+static int avl_height (jsw_avlnode_t *node)
+{
+    int l, r;
+
+    if (node == NULL) {
+        return 0;
+    }
+
+#ifdef JSW_RANK
+    if (node->count != 1 + (node->link[0] ? node->link[0]->count : 0)
+                         + (node->link[1] ? node->link[1]->count : 0)) {
+        return -1;
+    }
+#endif
+
+    l = avl_height (node->link[0]);
+    r = avl_height (node->link[1]);
+
+    if (l < 0 || r < 0 || node->balance != r - l
+        || node->balance < -1 || node->balance > 1) {
+        return -1;
+    }
+
+    return 1 + (l > r ? l : r);
+}
+
+static int avl_shape (item_t *root)
+{
+    return avl_height (&root->avl) >= 0;
+}
+
+static void avl_destroy (void *t)
+{
+    jsw_avldelete (t);
+}
+
+static const set_ops_t rb_set_ops = {
+    "rbtree", rb_create, rb_create_other, rb_create_alloc, rb_insert, rb_op,
+    rb_split, rb_join, rb_size, rb_walk, rb_shape, rb_left, rb_right,
+    rb_destroy
+};
+
+static const set_ops_t avl_set_ops = {
+    "avltree", avl_create, avl_create_other, avl_create_alloc, avl_insert,
+    avl_op, avl_split, avl_join, avl_size, avl_walk, avl_shape, avl_left,
+    avl_right, avl_destroy
+};
+
+/*
+  Checks a tree holds exactly the keys in want, using copies
+  from side, or from the first tree where it has one if side
+  is negative
+*/
+static int check_tree (const set_ops_t *ops, void *t, const char *want,
+                       int side, const char *what)
+{
+    size_t n = ops->walk (t, order);
+    size_t i, count = 0;
+    int k;
+
+    for (k = 0; k < N_KEYS; k++) {
+        count += want[k] != 0;
+    }
+
+    if (n != count || ops->size (t) != count) {
+        fprintf (stderr, "test-setops: %s %s has %lu items (size %lu),"
+                 " not %lu\n", ops->name, what, (unsigned long) n,
+                 (unsigned long) ops->size (t), (unsigned long) count);
+        return 0;
+    }
+
+    for (i = 0, k = 0; i < n; i++, k++) {
+        while (! want[k]) {
+            k++;
+        }
+
+        if (order[i] != &items[side >= 0 ? side : ! in[0][k]][k]) {
+            fprintf (stderr, "test-setops: %s %s has the wrong item for %d\n",
+                     ops->name, what, k);
+            return 0;
+        }
+    }
+
+    if (n > 0 && ! ops->shape (find_root (ops, order, n))) {
+        fprintf (stderr, "test-setops: %s %s is out of balance\n",
+                 ops->name, what);
+        return 0;
+    }
+
+    return 1;
+}
+
+static int fill (const set_ops_t *ops, void *t, int side, int n, int range)
+{
+    int i;
+
+    for (i = 0; i < n; i++) {
+        int k = rand() % range;
+
+        if (! in[side][k]) {
+            if (! ops->insert (t, &items[side][k])) {
+                fprintf (stderr, "test-setops: %s insert failed\n",
+                         ops->name);
+                return 0;
+            }
+            in[side][k] = 1;
+        }
+    }
+
+    return 1;
+}
+
+static int round_trip (const set_ops_t *ops, int round)
+{
+    char want[N_KEYS];
+    int kind = round % N_KINDS;
+    const jsw_fork_t *fork = round % 2 ? &threads : NULL;
+    int range = 1 + rand() % N_KEYS;
+    unsigned long dropped = 0;
+    void *a = ops->create ();
+    void *b = ops->create ();
+    int k;
+
+    memset (in, 0, sizeof in);
+
+    /* Sizes from equal to lopsided either way */
+    if (! fill (ops, a, 0, rand() % (round % 3 ? 100 : 2 * N_KEYS), range)
+        || ! fill (ops, b, 1, kind == SPLIT ? 0 : rand() % (2 * N_KEYS),
+                   range)) {
+        return 0;
+    }
+
+    rel_calls = 0;
+
+    if (kind == SPLIT) {
+        item_t key;
+
+        key.key = rand() % range;
+
+        if (! ops->split (a, &key, b)) {
+            fprintf (stderr, "test-setops: %s split failed\n", ops->name);
+            return 0;
+        }
+
+        for (k = 0; k < N_KEYS; k++) {
+            want[k] = in[0][k] && k < key.key;
+        }
+
+        if (! check_tree (ops, a, want, 0, "left part")) {
+            return 0;
+        }
+
+        for (k = 0; k < N_KEYS; k++) {
+            want[k] = in[0][k] && k >= key.key;
+        }
+
+        if (! check_tree (ops, b, want, 0, "right part")) {
+            return 0;
+        }
+
+        /* A non-empty right part can't join on the left */
+        if (ops->size (a) > 0 && ops->size (b) > 0 && ops->join (b, a)) {
+            fprintf (stderr, "test-setops: %s joined out of order\n",
+                     ops->name);
+            return 0;
+        }
+
+        if (! ops->join (a, b)) {
+            fprintf (stderr, "test-setops: %s join failed\n", ops->name);
+            return 0;
+        }
+
+        memcpy (want, in[0], sizeof want);
+    } else {
+        if (! ops->op (kind, a, b, fork)) {
+            fprintf (stderr, "test-setops: %s %s failed\n", ops->name,
+                     kind_names[kind]);
+            return 0;
+        }
+
+        for (k = 0; k < N_KEYS; k++) {
+            int x = in[0][k], y = in[1][k];
+
+            /* Every item that isn't kept is released once */
+            switch (kind) {
+            case UNION:
+                want[k] = x || y;
+                dropped += x && y;
+                break;
+            case INTERSECT:
+                want[k] = x && y;
+                dropped += x + y - want[k];
+                break;
+            default:
+                want[k] = x && ! y;
+                dropped += (x && y) + y;
+                break;
+            }
+        }
+    }
+
+    /* Shared keys keep the first tree's copy */
+    if (! check_tree (ops, a, want, -1, kind_names[kind])) {
+        return 0;
+    }
+
+    memset (want, 0, sizeof want);
+
+    if (! check_tree (ops, b, want, 0, "emptied tree")) {
+        return 0;
+    }
+
+    if (rel_calls != dropped) {
+        fprintf (stderr, "test-setops: %s %s released %lu items, not %lu\n",
+                 ops->name, kind_names[kind], rel_calls, dropped);
+        return 0;
+    }
+
+    ops->destroy (a);
+    ops->destroy (b);
+
+    return 1;
+}
+
+/* Trees that can't swap nodes are left alone */
+static int check_incompatible (const set_ops_t *ops)
+{
+    void *a = ops->create ();
+    void *b = ops->create_other ();
+    int kind, ok = 1;
+
+    memset (in, 0, sizeof in);
+
+    if (! fill (ops, a, 0, 100, N_KEYS) || ! fill (ops, b, 1, 100, N_KEYS)) {
+        return 0;
+    }
+
+    for (kind = UNION; kind < SPLIT; kind++) {
+        ok &= ! ops->op (kind, a, b, NULL) && ! ops->op (kind, a, a, NULL);
+    }
+
+    ok &= ! ops->join (a, b) && ! ops->split (a, &items[0][0], b);
+    ok &= check_tree (ops, a, in[0], 0, "incompatible tree");
+
+    if (! ok) {
+        fprintf (stderr, "test-setops: %s mixed incompatible trees\n",
+                 ops->name);
+    }
+
+    ops->destroy (a);
+    ops->destroy (b);
+
+    return ok;
+}
+
+/* Walks a tree that owns its nodes, which only has keys to check */
+static int check_keys (const set_ops_t *ops, void *t, const char *want,
+                       const char *what)
+{
+    size_t n = ops->walk (t, order);
+    size_t i, count = 0;
+    int k;
+
+    for (k = 0; k < N_KEYS; k++) {
+        count += want[k] != 0;
+    }
+
+    for (i = 0, k = 0; i < n && k < N_KEYS; i++, k++) {
+        while (k < N_KEYS && ! want[k]) {
+            k++;
+        }
+
+        if (k == N_KEYS || order[i]->key != k) {
+            break;
+        }
+    }
+
+    if (n != count || i != n || ops->size (t) != count) {
+        fprintf (stderr, "test-setops: %s %s has the wrong keys\n",
+                 ops->name, what);
+        return 0;
+    }
+
+    return 1;
+}
+
+/*
+  Trees on one pool. With its purge hook, deleting either tree
+  purges the pool, so nodes must never move between them. With
+  the purge hook left out they may, and after a union and a
+  split the tree left empty can be deleted under the others
+*/
+static int check_pooled (const set_ops_t *ops)
+{
+    jsw_pool_t *pool = jsw_poolnew (0);
+    jsw_alloc_t hooks;
+    char want[N_KEYS], hi[N_KEYS];
+    void *a, *b, *c;
+    int kind, k, ok = 1;
+
+    if (pool == NULL) {
+        fprintf (stderr, "test-setops: failed to make a pool\n");
+        return 0;
+    }
+
+    jsw_poolhooks (pool, &hooks);
+    a = ops->create_alloc (&hooks);
+    b = ops->create_alloc (&hooks);
+    memset (in, 0, sizeof in);
+
+    if (! fill (ops, a, 0, 100, N_KEYS) || ! fill (ops, b, 1, 100, N_KEYS)) {
+        return 0;
+    }
+
+    for (kind = UNION; kind < SPLIT; kind++) {
+        ok &= ! ops->op (kind, a, b, NULL);
+    }
+
+    ok &= ! ops->join (a, b) && ! ops->split (a, &items[0][N_KEYS / 2], b);
+    ok &= check_keys (ops, a, in[0], "purged tree");
+    ok &= check_keys (ops, b, in[1], "other purged tree");
+
+    ops->destroy (a);
+    ops->destroy (b);
+
+    hooks.purge = NULL;
+    a = ops->create_alloc (&hooks);
+    b = ops->create_alloc (&hooks);
+    c = ops->create_alloc (&hooks);
+    memset (in, 0, sizeof in);
+
+    if (! fill (ops, a, 0, 200, N_KEYS) || ! fill (ops, b, 1, 200, N_KEYS)) {
+        return 0;
+    }
+
+    for (k = 0; k < N_KEYS; k++) {
+        want[k] = in[0][k] | in[1][k];
+    }
+
+    ok &= ops->op (UNION, a, b, &threads);
+    ops->destroy (b);
+    ok &= ops->split (a, &items[0][N_KEYS / 2], c);
+
+    /* New nodes for a and c can't reuse any either one holds */
+    for (k = 0; k < N_KEYS; k++) {
+        if (! want[k] && rand () % 4 == 0) {
+            ok &= ops->insert (k < N_KEYS / 2 ? a : c, &items[0][k]);
+            want[k] = 1;
+        }
+    }
+
+    memcpy (hi, want, sizeof hi);
+    memset (want + N_KEYS / 2, 0, N_KEYS - N_KEYS / 2);
+    memset (hi, 0, N_KEYS / 2);
+    ok &= check_keys (ops, a, want, "union");
+    ok &= check_keys (ops, c, hi, "split");
+
+    ops->destroy (a);
+    ops->destroy (c);
+    jsw_pooldelete (pool);
+
+    if (! ok) {
+        fprintf (stderr, "test-setops: %s mixed trees on one pool\n",
+                 ops->name);
+    }
+
+    return ok;
+}
+
+static int check (const set_ops_t *ops)
+{
+    int round;
+
+    for (round = 0; round < N_ROUNDS; round++) {
+        if (! round_trip (ops, round)) {
+            return 0;
+        }
+    }
+
+    return check_incompatible (ops) && check_pooled (ops);
+}
+
+int main (int argc, char **argv)
+{
+    unsigned seed;
+    int k, ok;
+
+    if (argc < 2) {
+        seed = (unsigned) time(NULL);
+    } else {
+        seed = (unsigned) strtoul(argv[1], NULL, 0);
+    }
+
+    printf ("test-setops: seed = %u\n", seed);
+    srand (seed);
+
+    for (k = 0; k < N_KEYS; k++) {
+        items[0][k].key = items[1][k].key = k;
+    }
+
+    ok = check (&rb_set_ops);
+    ok &= check (&avl_set_ops);
+
+    if (! ok) {
+        return 2;
+    }
+
+    printf ("test-setops: %sPASS%s\n", green, off);
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+/*
+  Skip list calls for tests of several jsw-lib containers
+
+    > Created (agent): October 14, 2026
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include "jsw_slib.h"
+#include "test-slib-ops.h"
+
+static void *identity (const void *item)
+{
+    return (void *) item;
+}
+
+void *slib_create (int (*cmp) (const void *a, const void *b),
+                   void (*rel) (void *item), const jsw_alloc_t *alloc)
+{
+    return jsw_snew_alloc (16, cmp, identity, rel, alloc);
+}
+
+void slib_destroy (void *c)
+{
+    jsw_sdelete (c);
+}
+
+int slib_insert (void *c, void *data)
+{
+    return jsw_sinsert (c, data);
+}
+
+int slib_erase (void *c, void *data)
+{
+    return jsw_serase (c, data);
+}
+
+void *slib_find (void *c, void *data)
+{
+    return jsw_sfind (c, data);
+}
+
+size_t slib_find_many (void *c, void **data, size_t n, void **out)
+{
+    return jsw_sfind_many (c, data, n, out);
+}
+
+size_t slib_size (void *c)
+{
+    return jsw_ssize (c);
+}
+
+void slib_clear (void *c)
+{
+    jsw_sclear (c);
+}
+
+int slib_stats (void *c, jsw_stats_t *stats)
+{
+    return jsw_sstats (c, stats);
+}
+
+void *slib_lower (void *c, void *data)
+{
+    return jsw_slower (c, data);
+}
+
+void *slib_upper (void *c, void *data)
+{
+    return jsw_supper (c, data);
+}
+
+void *slib_next (void *c)
+{
+    return jsw_snext (c) ? jsw_sitem (c) : NULL;
+}
+
+size_t slib_range (void *c, void *lo, void *hi,
+                   int (*f) (void *item, void *arg), void *arg)
+{
+    return jsw_srange (c, lo, hi, f, arg);
+}
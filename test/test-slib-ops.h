@@ -0,0 +1,52 @@
+/*
+  Skip list calls for tests of several jsw-lib containers
+
+    > Created (agent): October 14, 2026
+
+  jsw_slib.h declares its own dup_f and rel_f, which
+  differ from the tree headers', so a test that includes
+  those can't include it as well. These wrappers take
+  and return only plain pointers, and every such test
+  builds its skip list ops from them.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#ifndef TEST_SLIB_OPS_H
+#define TEST_SLIB_OPS_H
+
+#include <stddef.h>
+
+#include "jsw_alloc.h"
+#include "jsw_common.h"
+
+/* Items are stored as given; a NULL rel leaves them to the caller */
+void   *slib_create (int (*cmp) (const void *a, const void *b),
+                     void (*rel) (void *item), const jsw_alloc_t *alloc);
+void    slib_destroy (void *c);
+
+int     slib_insert (void *c, void *data);
+int     slib_erase (void *c, void *data);
+void   *slib_find (void *c, void *data);
+size_t  slib_find_many (void *c, void **data, size_t n, void **out);
+size_t  slib_size (void *c);
+void    slib_clear (void *c);
+int     slib_stats (void *c, jsw_stats_t *stats);
+
+/* Bounds leave the list's cursor on the item, and next moves it on */
+void   *slib_lower (void *c, void *data);
+void   *slib_upper (void *c, void *data);
+void   *slib_next (void *c);
+size_t  slib_range (void *c, void *lo, void *hi,
+                    int (*f) (void *item, void *arg), void *arg);
+
+#endif  /* TEST_SLIB_OPS_H */
@@ -0,0 +1,88 @@
+/*
+  Test for jsw-lib skip lists on a pool allocator
+
+    > Created (agent): October 14, 2026
+
+  Runs the container test on a list made with
+  jsw_snew_alloc, with nodes of every height coming from
+  one jsw_pool_t that is deleted after the list.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "jsw_slib.h"
+#include "test-containers.h"
+
+static jsw_pool_t *pool;
+static unsigned level_seed;
+
+void *new_container (void)
+{
+    jsw_alloc_t alloc;
+    jsw_skip_t *skip;
+
+    /* Nodes of every height share one pool */
+    pool = jsw_poolnew (4096);
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    jsw_poolhooks (pool, &alloc);
+    skip = jsw_snew_alloc (12, (cmp_f) strcmp, (dup_f) strdup,
+                           (rel_f) free, &alloc);
+    if (skip == NULL) {
+        jsw_pooldelete (pool);
+    } else {
+        jsw_sseed (skip, level_seed);
+    }
+
+    return skip;
+}
+
+void delete_container (void *c)
+{
+    jsw_sdelete ((jsw_skip_t *) c);
+    jsw_pooldelete (pool);
+}
+
+bool insert_item (void *c, const char *item)
+{
+    return (0 != jsw_sinsert ((jsw_skip_t *) c, (void *) item));
+}
+
+bool remove_item (void *c, const char *item)
+{
+    return (0 != jsw_serase ((jsw_skip_t *) c, (void *) item));
+}
+
+bool lookup_item (void *c, const char *item)
+{
+    return (NULL != jsw_sfind ((jsw_skip_t *) c, (void *) item));
+}
+
+bool resize_container (void *c)
+{
+    return true;
+}
+
+const char *test_name (void)
+{
+    return "test-slib-pool";
+}
+
+void set_seed (unsigned seed)
+{
+    level_seed = seed;
+}
@@ -2,6 +2,8 @@
   Test for jsw-lib skip lists
 
     > Created (Patrick Pelletier): April 17, 2022
+    > Modified (agent): October 14, 2026
+      Seeds the list's own level generator
 
   This code is in the public domain. Anyone may
   use it or change it in any way that they see
@@ -19,12 +21,20 @@
 #include <stdlib.h>
 
 #include "jsw_slib.h"
-#include "jsw_rand.h"
 #include "test-containers.h"
 
+static unsigned level_seed;
+
 void *new_container (void)
 {
-    return jsw_snew (12, (cmp_f) strcmp, (dup_f) strdup, (rel_f) free);
+    jsw_skip_t *skip = jsw_snew (12, (cmp_f) strcmp, (dup_f) strdup,
+                                 (rel_f) free);
+
+    if (skip != NULL) {
+        jsw_sseed (skip, level_seed);
+    }
+
+    return skip;
 }
 
 void delete_container (void *c)
@@ -59,5 +69,5 @@ const char *test_name (void)
 
 void set_seed (unsigned seed)
 {
-    jsw_seed (seed);
+    level_seed = seed;
 }
@@ -0,0 +1,354 @@
+/*
+  Memory mapped snapshots of jsw-lib trees
+
+    > Created (agent): October 14, 2026
+
+  Fills a red black tree with random numbers as strings,
+  writes it to a snapshot with one traversal, and maps it
+  back. The snapshot has to hold the same records in the
+  same order, and find, lower and upper have to agree with
+  the tree for keys that are there and keys that aren't.
+  A second snapshot written over the first while it is
+  still open must leave the open one readable, and a
+  damaged file must be refused. A file whose records were
+  cut short, leaving keys without their terminator, must
+  still open, and every comparison has to be told the
+  shortened length.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "jsw_rbtree.h"
+#include "jsw_snap.h"
+
+#define N_KEYS  5000
+#define N_FINDS 20000
+
+static const char green[] = "\033[32m";
+static const char off[]   = "\033[0m";
+
+static const char path[] = "test-snap.snap";
+
+static int str_cmp (const void *a, const void *b)
+{
+    return strcmp (a, b);
+}
+
+/* Longest record any comparison was given */
+static size_t longest;
+
+/* strcmp for a record that may have lost its terminator */
+static int rec_cmp (const void *key, const void *rec, size_t len)
+{
+    size_t n = strlen (key) + 1;
+    int c = memcmp (key, rec, n < len ? n : len);
+
+    if (len > longest) {
+        longest = len;
+    }
+
+    return c != 0 ? c : (n > len) - (n < len);
+}
+
+static void *str_dup (void *p)
+{
+    return strdup (p);
+}
+
+static void make_key (char *buf, unsigned n)
+{
+    snprintf (buf, 16, "k%u", n);
+}
+
+static int write_tree (jsw_rbtree_t *tree)
+{
+    jsw_snapw_t *w = jsw_snapwopen (path);
+    jsw_rbtrav_t *trav = jsw_rbtnew();
+    char *it;
+
+    if (w == NULL || trav == NULL) {
+        return 0;
+    }
+
+    for (it = jsw_rbtfirst (trav, tree); it != NULL; it = jsw_rbtnext (trav)) {
+        if (! jsw_snapwadd (w, it, strlen (it) + 1)) {
+            jsw_snapwclose (w);
+            jsw_rbtdelete (trav);
+            return 0;
+        }
+    }
+
+    jsw_rbtdelete (trav);
+
+    return jsw_snapwclose (w);
+}
+
+static int check (jsw_snap_t *snap, jsw_rbtree_t *tree)
+{
+    jsw_rbtrav_t *trav = jsw_rbtnew();
+    char key[16];
+    char *it;
+    size_t i = 0;
+
+    if (jsw_snapsize (snap) != jsw_rbsize (tree)) {
+        fprintf (stderr, "test-snap: %lu records for %lu items\n",
+                 (unsigned long) jsw_snapsize (snap),
+                 (unsigned long) jsw_rbsize (tree));
+        return 0;
+    }
+
+    for (it = jsw_rbtfirst (trav, tree); it != NULL; it = jsw_rbtnext (trav)) {
+        size_t len;
+        const char *rec = jsw_snapitem (snap, i++, &len);
+
+        if (rec == NULL || len != strlen (it) + 1 || strcmp (rec, it) != 0) {
+            fprintf (stderr, "test-snap: record %lu isn't %s\n",
+                     (unsigned long) i - 1, it);
+            return 0;
+        }
+    }
+
+    if (jsw_snapitem (snap, i, NULL) != NULL) {
+        fprintf (stderr, "test-snap: record past the end\n");
+        return 0;
+    }
+
+    for (i = 0; i < N_FINDS; i++) {
+        const char *rec;
+        size_t lo, hi;
+
+        make_key (key, (unsigned) (rand() % (4 * N_KEYS)));
+        rec = jsw_snapfind (snap, key);
+        it = jsw_rbfind (tree, key);
+
+        if ((rec == NULL) != (it == NULL)
+            || (rec != NULL && strcmp (rec, it) != 0)) {
+            fprintf (stderr, "test-snap: find %s disagrees\n", key);
+            return 0;
+        }
+
+        lo = jsw_snaplower (snap, key);
+        hi = jsw_snapupper (snap, key);
+
+        if (hi != lo + (it != NULL)
+            || (lo > 0 && strcmp (jsw_snapitem (snap, lo - 1, NULL), key) >= 0)
+            || (lo < jsw_snapsize (snap)
+                && strcmp (jsw_snapitem (snap, lo, NULL), key) < 0)) {
+            fprintf (stderr, "test-snap: bounds of %s are %lu, %lu\n",
+                     key, (unsigned long) lo, (unsigned long) hi);
+            return 0;
+        }
+    }
+
+    jsw_rbtdelete (trav);
+
+    return 1;
+}
+
+/* Damaged files are refused at open */
+static int check_damage (void)
+{
+    FILE *f = fopen (path, "r+b");
+    jsw_snap_t *snap;
+    int c;
+
+    if (f == NULL) {
+        return 0;
+    }
+
+    /* Change the record count so it no longer fits the index */
+    fseek (f, 16, SEEK_SET);
+    c = fgetc (f);
+    fseek (f, 16, SEEK_SET);
+    fputc (c ^ 1, f);
+    fclose (f);
+
+    snap = jsw_snapopen (path, rec_cmp);
+    if (snap != NULL) {
+        jsw_snapclose (snap);
+        fprintf (stderr, "test-snap: opened a damaged snapshot\n");
+        return 0;
+    }
+
+    f = fopen (path, "wb");
+    if (f == NULL) {
+        return 0;
+    }
+    fputs ("not a snapshot", f);
+    fclose (f);
+
+    snap = jsw_snapopen (path, rec_cmp);
+    if (snap != NULL) {
+        jsw_snapclose (snap);
+        fprintf (stderr, "test-snap: opened a text file\n");
+        return 0;
+    }
+
+    return 1;
+}
+
+/*
+  Cuts every record down to its first byte, so no key is
+  terminated, and points the first one past the records
+*/
+static int check_truncated (jsw_rbtree_t *tree)
+{
+    FILE *f = fopen (path, "r+b");
+    unsigned char *buf;
+    uint64_t index, off, n = 1;
+    jsw_snap_t *snap;
+    char key[16];
+    size_t len, i, size;
+    long end;
+    int ok = 1;
+
+    if (f == NULL) {
+        return 0;
+    }
+
+    fseek (f, 0, SEEK_END);
+    end = ftell (f);
+    buf = malloc ((size_t) end);
+
+    fseek (f, 0, SEEK_SET);
+    if (buf == NULL || fread (buf, 1, (size_t) end, f) != (size_t) end) {
+        free (buf);
+        fclose (f);
+        return 0;
+    }
+
+    /* The index offset follows magic, version, order and count */
+    memcpy (&index, buf + 24, sizeof index);
+    size = ((size_t) end - (size_t) index) / sizeof off;
+
+    for (i = 0; i < size; i++) {
+        memcpy (&off, buf + index + i * sizeof off, sizeof off);
+        memcpy (buf + off, i == 0 ? &index : &n, sizeof n);
+    }
+
+    fseek (f, 0, SEEK_SET);
+    fwrite (buf, 1, (size_t) end, f);
+    fclose (f);
+    free (buf);
+
+    snap = jsw_snapopen (path, rec_cmp);
+    if (snap == NULL) {
+        fprintf (stderr, "test-snap: refused a snapshot of short records\n");
+        return 0;
+    }
+
+    if (jsw_snapitem (snap, 0, NULL) != NULL
+        || jsw_snapitem (snap, 1, &len) == NULL || len != 1) {
+        fprintf (stderr, "test-snap: short records read back wrong\n");
+        ok = 0;
+    }
+
+    longest = 0;
+
+    for (i = 0; i < N_FINDS; i++) {
+        make_key (key, (unsigned) (rand() % (4 * N_KEYS)));
+
+        if (jsw_snapfind (snap, key) != NULL
+            || jsw_snaplower (snap, key) > jsw_snapupper (snap, key)) {
+            fprintf (stderr, "test-snap: %s found in short records\n", key);
+            ok = 0;
+            break;
+        }
+    }
+
+    if (longest != 1) {
+        fprintf (stderr, "test-snap: compared %lu bytes of a 1 byte record\n",
+                 (unsigned long) longest);
+        ok = 0;
+    }
+
+    jsw_snapclose (snap);
+
+    return ok && jsw_rbsize (tree) == size;
+}
+
+int main (int argc, char **argv)
+{
+    jsw_rbtree_t *tree = jsw_rbnew (str_cmp, str_dup, free);
+    jsw_rbtree_t *empty = jsw_rbnew (str_cmp, str_dup, free);
+    jsw_snap_t *snap, *old;
+    char key[16];
+    unsigned seed;
+    int i, ok;
+
+    if (argc < 2) {
+        seed = (unsigned) time(NULL);
+    } else {
+        seed = (unsigned) strtoul(argv[1], NULL, 0);
+    }
+
+    printf ("test-snap: seed = %u\n", seed);
+    srand (seed);
+
+    if (tree == NULL || empty == NULL) {
+        fprintf (stderr, "test-snap: failed to allocate tree\n");
+        return 1;
+    }
+
+    /* Nothing to find in an empty snapshot */
+    if (! write_tree (empty) || (snap = jsw_snapopen (path, rec_cmp)) == NULL) {
+        fprintf (stderr, "test-snap: failed to write %s\n", path);
+        return 1;
+    }
+    ok = check (snap, empty);
+    jsw_snapclose (snap);
+
+    for (i = 0; i < N_KEYS; i++) {
+        make_key (key, (unsigned) (rand() % (4 * N_KEYS)));
+        jsw_rbinsert (tree, key);
+    }
+
+    if (! write_tree (tree) || (old = jsw_snapopen (path, rec_cmp)) == NULL) {
+        fprintf (stderr, "test-snap: failed to write %s\n", path);
+        return 1;
+    }
+    ok &= check (old, tree);
+
+    /* Replacing the file leaves the open snapshot alone */
+    if (! write_tree (empty) || (snap = jsw_snapopen (path, rec_cmp)) == NULL) {
+        fprintf (stderr, "test-snap: failed to rewrite %s\n", path);
+        return 1;
+    }
+    ok &= check (snap, empty);
+    ok &= check (old, tree);
+    jsw_snapclose (snap);
+    jsw_snapclose (old);
+
+    write_tree (tree);
+    ok &= check_truncated (tree);
+
+    write_tree (tree);
+    ok &= check_damage();
+
+    remove (path);
+    jsw_rbdelete (tree);
+    jsw_rbdelete (empty);
+
+    if (! ok) {
+        return 2;
+    }
+
+    printf ("test-snap: %sPASS%s\n", green, off);
+
+    return 0;
+}
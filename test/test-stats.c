@@ -0,0 +1,362 @@
+/*
+  Hot path counters for jsw-lib containers
+
+    > Created (agent): October 14, 2026
+
+  Built with JSW_STATS. Each container gets the same
+  inserts, erases and failed erases, all of them
+  comparing through a counting comparator, and
+  then its counters have to agree with what it was
+  asked to do: every comparator call counted, one
+  allocation per node (plus chain heads in a hash
+  table), rotations only in trees, search steps only
+  in hash tables and skip lists, resizes only in the
+  growing hash table.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "jsw_rbtree.h"
+#include "jsw_avltree.h"
+#include "jsw_atree.h"
+#include "jsw_hlib.h"
+#include "test-slib-ops.h"
+
+#define N_KEYS 2000
+
+enum stats_kind { TREE, HASH, SKIP };
+
+typedef struct stats_ops {
+    const char      *name;
+    enum stats_kind  kind;
+    void            *(*create) (void);
+    int              (*insert) (void *c, void *data);
+    int              (*erase) (void *c, void *data);
+    int              (*stats) (void *c, jsw_stats_t *stats);
+    void             (*destroy) (void *c);
+} stats_ops_t;
+
+static const char green[] = "\033[32m";
+static const char off[]   = "\033[0m";
+
+static int keys[2 * N_KEYS];
+
+/* Every container compares with this, so calls can be checked */
+static unsigned long cmp_calls;
+
+static int counting_cmp (const void *a, const void *b)
+{
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+
+    ++cmp_calls;
+
+    return (x > y) - (x < y);
+}
+
+static unsigned int_hash (const void *key)
+{
+    return (unsigned) *(const int *) key;
+}
+
+static void *identity (void *item)
+{
+    return item;
+}
+
+static void *const_identity (const void *item)
+{
+    return (void *) item;
+}
+
+static void nop (void *item)
+{
+}
+
+static void *rb_create (void)
+{
+    return jsw_rbnew (counting_cmp, identity, nop);
+}
+
+static int rb_insert (void *c, void *data)
+{
+    return jsw_rbinsert (c, data);
+}
+
+static int rb_erase (void *c, void *data)
+{
+    return jsw_rberase (c, data);
+}
+
+static int rb_stats (void *c, jsw_stats_t *stats)
+{
+    return jsw_rbstats (c, stats);
+}
+
+static void rb_destroy (void *c)
+{
+    jsw_rbdelete (c);
+}
+
+static void *avl_create (void)
+{
+    return jsw_avlnew (counting_cmp, identity, nop);
+}
+
+static int avl_insert (void *c, void *data)
+{
+    return jsw_avlinsert (c, data);
+}
+
+static int avl_erase (void *c, void *data)
+{
+    return jsw_avlerase (c, data);
+}
+
+static int avl_stats (void *c, jsw_stats_t *stats)
+{
+    return jsw_avlstats (c, stats);
+}
+
+static void avl_destroy (void *c)
+{
+    jsw_avldelete (c);
+}
+
+static void *a_create (void)
+{
+    return jsw_anew (counting_cmp, identity, nop);
+}
+
+static int a_insert (void *c, void *data)
+{
+    return jsw_ainsert (c, data);
+}
+
+static int a_erase (void *c, void *data)
+{
+    return jsw_aerase (c, data);
+}
+
+static int a_stats (void *c, jsw_stats_t *stats)
+{
+    return jsw_astats (c, stats);
+}
+
+static void a_destroy (void *c)
+{
+    jsw_adelete (c);
+}
+
+/* Small and growing a bucket at a time, so resizes are counted */
+static void *h_create (void)
+{
+    jsw_hash_t *htab = jsw_hnew (7, int_hash, counting_cmp, const_identity,
+                                 const_identity, nop, nop);
+
+    if (htab != NULL && ! jsw_hgrowth (htab, 1.0, 1)) {
+        jsw_hdelete (htab);
+        htab = NULL;
+    }
+
+    return htab;
+}
+
+static int h_insert (void *c, void *data)
+{
+    return jsw_hinsert (c, data, data);
+}
+
+static int h_erase (void *c, void *data)
+{
+    return jsw_herase (c, data);
+}
+
+static int h_stats (void *c, jsw_stats_t *stats)
+{
+    return jsw_hstats (c, stats);
+}
+
+static void h_destroy (void *c)
+{
+    jsw_hdelete (c);
+}
+
+static const stats_ops_t rb_stats_ops = {
+    "rbtree", TREE, rb_create, rb_insert, rb_erase, rb_stats, rb_destroy
+};
+
+static const stats_ops_t avl_stats_ops = {
+    "avltree", TREE, avl_create, avl_insert, avl_erase, avl_stats,
+    avl_destroy
+};
+
+static const stats_ops_t atree_stats_ops = {
+    "atree", TREE, a_create, a_insert, a_erase, a_stats, a_destroy
+};
+
+static const stats_ops_t hlib_stats_ops = {
+    "hlib", HASH, h_create, h_insert, h_erase, h_stats, h_destroy
+};
+
+static void *s_create (void)
+{
+    return slib_create (counting_cmp, NULL, NULL);
+}
+
+static const stats_ops_t slib_stats_ops = {
+    "slib", SKIP, s_create, slib_insert, slib_erase, slib_stats,
+    slib_destroy
+};
+
+static int fail (const stats_ops_t *ops, const char *what,
+                 unsigned long got)
+{
+    fprintf (stderr, "test-stats: %s %s (got %lu)\n", ops->name, what, got);
+    return 0;
+}
+
+static int check (const stats_ops_t *ops)
+{
+    void *c;
+    jsw_stats_t st;
+    int order[N_KEYS];
+    int i;
+
+    cmp_calls = 0;
+    c = ops->create();
+    if (c == NULL) {
+        fprintf (stderr, "test-stats: failed to allocate %s\n", ops->name);
+        return 0;
+    }
+
+    if (! ops->stats (c, &st)) {
+        return fail (ops, "has no counters compiled in", 0);
+    }
+    if (st.cmps != 0 || st.allocs != 0 || st.probes != 0) {
+        return fail (ops, "starts with counts", st.cmps);
+    }
+
+    for (i = 0; i < N_KEYS; i++) {
+        order[i] = 2 * i;
+    }
+
+    for (i = N_KEYS - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int save = order[i];
+
+        order[i] = order[j];
+        order[j] = save;
+    }
+
+    for (i = 0; i < N_KEYS; i++) {
+        if (! ops->insert (c, &keys[order[i]])) {
+            return fail (ops, "insert failed", (unsigned long) i);
+        }
+    }
+
+    /* Half of the keys, and as many odd keys that were never there */
+    for (i = 0; i < N_KEYS / 2; i++) {
+        if (! ops->erase (c, &keys[order[i]])) {
+            return fail (ops, "erase failed", (unsigned long) i);
+        }
+        if (ops->erase (c, &keys[order[i] + 1])) {
+            return fail (ops, "erased a missing key", (unsigned long) i);
+        }
+    }
+
+    ops->stats (c, &st);
+
+    if (st.cmps != cmp_calls) {
+        fprintf (stderr, "test-stats: %s counted %lu of %lu comparisons\n",
+                 ops->name, st.cmps, cmp_calls);
+        return 0;
+    }
+
+    if (ops->kind == HASH) {
+        /* Chain heads come and go with the nodes */
+        if (st.allocs < N_KEYS) {
+            return fail (ops, "missed allocations", st.allocs);
+        }
+        if (st.releases < N_KEYS / 2) {
+            return fail (ops, "missed releases", st.releases);
+        }
+        if (st.resizes == 0) {
+            return fail (ops, "never resized", st.resizes);
+        }
+        if (st.maxprobe == 0 || st.maxprobe > N_KEYS) {
+            return fail (ops, "has a bad longest probe", st.maxprobe);
+        }
+    } else {
+        if (st.allocs != N_KEYS) {
+            return fail (ops, "miscounted allocations", st.allocs);
+        }
+        if (st.releases != N_KEYS / 2) {
+            return fail (ops, "miscounted releases", st.releases);
+        }
+        if (st.resizes != 0 || st.maxprobe != 0) {
+            return fail (ops, "counted resizes", st.resizes);
+        }
+    }
+
+    if ((ops->kind == TREE) != (st.rotations != 0)) {
+        return fail (ops, "has the wrong rotations", st.rotations);
+    }
+
+    /* A search takes at least one step per comparison in a skip list */
+    if (ops->kind == TREE ? st.probes != 0
+        : ops->kind == SKIP ? st.probes < st.cmps
+        : st.probes == 0) {
+        return fail (ops, "has the wrong search steps", st.probes);
+    }
+
+    ops->destroy (c);
+
+    return 1;
+}
+
+int main (int argc, char **argv)
+{
+    unsigned seed;
+    int i, ok;
+
+    if (argc < 2) {
+        seed = (unsigned) time(NULL);
+    } else {
+        seed = (unsigned) strtoul(argv[1], NULL, 0);
+    }
+
+    printf ("test-stats: seed = %u\n", seed);
+    srand (seed);
+
+    for (i = 0; i < 2 * N_KEYS; i++) {
+        keys[i] = i;
+    }
+
+    ok = check (&rb_stats_ops);
+    ok &= check (&avl_stats_ops);
+    ok &= check (&atree_stats_ops);
+    ok &= check (&hlib_stats_ops);
+    ok &= check (&slib_stats_ops);
+
+    if (! ok) {
+        return 2;
+    }
+
+    printf ("test-stats: %sPASS%s\n", green, off);
+
+    return 0;
+}
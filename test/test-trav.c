@@ -0,0 +1,287 @@
+/*
+  Traversal objects for jsw-lib skip lists and hash tables
+
+    > Created (agent): October 14, 2026
+
+  Walks a skip list and a hash table with external
+  traversal objects while the built-in markers sit
+  elsewhere, and checks that every item turns up exactly
+  once. The hash table is walked in the middle of an
+  incremental resize so both bucket arrays get visited,
+  and the resize has to stay put while only finds run.
+  Sweeps that erase the current item must still visit
+  every other item once.
+
+  This code is in the public domain. Anyone may
+  use it or change it in any way that they see
+  fit. The author assumes no responsibility for
+  damages incurred through use of the original
+  code or any variations thereof.
+
+  It is requested, but not required, that due
+  credit is given to the original author and
+  anyone who has modified the code through
+  a header comment, such as this one.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "jsw_slib.h"
+#include "jsw_hlib.h"
+
+#define N_KEYS 2000
+
+static const char green[] = "\033[32m";
+static const char off[]   = "\033[0m";
+
+static int keys[N_KEYS];
+static int seen[N_KEYS];
+
+static int int_cmp (const void *a, const void *b)
+{
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+
+    return (x > y) - (x < y);
+}
+
+static unsigned int_hash (const void *key)
+{
+    return (unsigned) *(const int *) key;
+}
+
+static void *identity (const void *item)
+{
+    return (void *) item;
+}
+
+static void nop (void *item)
+{
+}
+
+static int fail (const char *what)
+{
+    fprintf (stderr, "test-trav: %s\n", what);
+    return 0;
+}
+
+static int test_skip (void)
+{
+    jsw_skip_t *skip = jsw_snew (16, int_cmp, identity, nop);
+    jsw_strav_t *a = jsw_stnew();
+    jsw_strav_t *b = jsw_stnew();
+    int *p, *q;
+    int i, n, ok = 1;
+
+    if (skip == NULL || a == NULL || b == NULL) {
+        return fail ("failed to allocate skip list");
+    }
+
+    /* Odd keys only, so every even key falls between two items */
+    for (i = 0; i < N_KEYS; i++) {
+        if ((keys[i] % 2) == 1 && ! jsw_sinsert (skip, &keys[i])) {
+            return fail ("skip list insert failed");
+        }
+    }
+
+    for (i = 0; i < N_KEYS; i++) {
+        if ((keys[i] % 2) == 1 && jsw_sinsert (skip, &keys[i])) {
+            return fail ("skip list took a duplicate");
+        }
+    }
+
+    if (jsw_ssize (skip) != N_KEYS / 2) {
+        return fail ("skip list has the wrong size");
+    }
+
+    if (jsw_stfirst (b, skip) == NULL
+        || *(int *) jsw_stlast (a, skip) != N_KEYS - 1) {
+        return fail ("skip list ends are wrong");
+    }
+
+    /* Two traversals at different places don't disturb each other */
+    jsw_sreset (skip);
+    n = 0;
+    for (p = jsw_stfirst (a, skip); p != NULL; p = jsw_stnext (a)) {
+        q = jsw_stnext (b);
+        if (*p != 2 * n + 1 || (q != NULL && *q != *p + 2)) {
+            ok = fail ("skip list traversal out of order");
+            break;
+        }
+        n++;
+    }
+
+    if (n != N_KEYS / 2 || *(int *) jsw_sitem (skip) != 1) {
+        ok = fail ("skip list traversal missed items");
+    }
+
+    for (i = 0; ok && i < N_KEYS; i++) {
+        int lo = i | 1;
+        int hi = (i + 1) | 1;
+
+        p = jsw_stlower (a, skip, &i);
+        q = jsw_stupper (b, skip, &i);
+
+        if (p == NULL || *p != lo
+            || (hi < N_KEYS ? (q == NULL || *q != hi) : q != NULL)) {
+            ok = fail ("skip list bounds are wrong");
+        }
+    }
+
+    jsw_stdelete (a);
+    jsw_stdelete (b);
+    jsw_sdelete (skip);
+
+    return ok;
+}
+
+static int test_hash (void)
+{
+    jsw_hash_t *htab = jsw_hnew (8, int_hash, int_cmp,
+                                 identity, identity, nop, nop);
+    jsw_htrav_t *trav = jsw_htnew();
+    jsw_hstat_t *before, *after;
+    int *p;
+    int i, n, ok = 1;
+
+    if (htab == NULL || trav == NULL
+        || ! jsw_hgrowth (htab, 1.0, 1)) {
+        return fail ("failed to allocate hash table");
+    }
+
+    for (i = 0; i < N_KEYS; i++) {
+        if (! jsw_hinsert (htab, &keys[i], &keys[i])) {
+            return fail ("hash table insert failed");
+        }
+    }
+
+    /*
+      Growing past 1151 items starts moving one bucket per
+      insert, which is still going when the inserts stop.
+      Finds have to leave it where it is
+    */
+    before = jsw_hstat (htab);
+    for (i = 0; i < N_KEYS; i++) {
+        if (jsw_hfind (htab, &keys[i]) != &keys[i]) {
+            return fail ("hash table find failed");
+        }
+    }
+
+    jsw_hreset (htab);
+    memset (seen, 0, sizeof seen);
+    n = 0;
+    for (p = jsw_htfirst (trav, htab); p != NULL; p = jsw_htnext (trav)) {
+        if (jsw_htkey (trav) != p || seen[*p]++ != 0) {
+            ok = fail ("hash table traversal repeated an item");
+            break;
+        }
+        n++;
+    }
+
+    if (n != N_KEYS || jsw_hitem (htab) == NULL) {
+        ok = fail ("hash table traversal missed items");
+    }
+
+    after = jsw_hstat (htab);
+    if (before == NULL || after == NULL || before->load != after->load) {
+        ok = fail ("hash table find moved buckets");
+    }
+
+    free (before);
+    free (after);
+
+    /* Sweep out every third key without stopping the resize */
+    n = 0;
+    jsw_hreset (htab);
+    while ((p = jsw_hitem (htab)) != NULL) {
+        if (*p % 3 == 0) {
+            if (! jsw_herase_current (htab)) {
+                ok = fail ("hash table sweep failed to erase");
+                break;
+            }
+        } else {
+            n++;
+            jsw_hnext (htab);
+        }
+    }
+
+    if (n != N_KEYS - (N_KEYS + 2) / 3 || jsw_hsize (htab) != (size_t) n
+        || jsw_herase_current (htab)) {
+        ok = fail ("hash table sweep missed items");
+    }
+
+    /* Erasing the current item by key moves the markers along */
+    if (! jsw_hgrowth (htab, 1.0, 0)) {
+        ok = fail ("hash table resize failed");
+    }
+
+    memset (seen, 0, sizeof seen);
+    jsw_hreset (htab);
+    while ((p = jsw_hitem (htab)) != NULL) {
+        if (*p % 3 == 0 || seen[*p]++ != 0) {
+            ok = fail ("hash table walk saw an erased item");
+            break;
+        }
+
+        if (*p % 3 == 1) {
+            jsw_herase (htab, p);
+        } else {
+            jsw_hnext (htab);
+        }
+    }
+
+    for (i = 0; i < N_KEYS; i++) {
+        if (seen[i] != (i % 3 != 0)
+            || (jsw_hfind (htab, &i) != NULL) != (i % 3 == 2)) {
+            ok = fail ("hash table walk missed items");
+            break;
+        }
+    }
+
+    jsw_htdelete (trav);
+    jsw_hdelete (htab);
+
+    return ok;
+}
+
+int main (int argc, char **argv)
+{
+    unsigned seed;
+    int i, ok;
+
+    if (argc < 2) {
+        seed = (unsigned) time(NULL);
+    } else {
+        seed = (unsigned) strtoul(argv[1], NULL, 0);
+    }
+
+    printf ("test-trav: seed = %u\n", seed);
+    srand (seed);
+
+    for (i = 0; i < N_KEYS; i++) {
+        keys[i] = i;
+    }
+
+    /* Insert in a random order */
+    for (i = N_KEYS - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int save = keys[i];
+
+        keys[i] = keys[j];
+        keys[j] = save;
+    }
+
+    ok = test_skip();
+    ok &= test_hash();
+
+    if (! ok) {
+        return 2;
+    }
+
+    printf ("test-trav: %sPASS%s\n", green, off);
+
+    return 0;
+}